@@ -0,0 +1,56 @@
+/**
+ * @file bench.h
+ * @brief Timing helpers shared by the benchmark programs
+ *
+ * Include this header before any system header so that the POSIX clock
+ * declarations are visible in strict C99 mode.
+ */
+
+#ifndef MYRTX_BENCH_H
+#define MYRTX_BENCH_H
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/**
+ * @brief Monotonic time in nanoseconds
+ */
+static inline uint64_t bench_now_ns(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Print one result line: name, nanoseconds per operation, operations per second
+ */
+static inline void bench_report(const char* name, uint64_t elapsed_ns, uint64_t ops) {
+    double ns_per_op = ops ? (double)elapsed_ns / (double)ops : 0.0;
+    double mops = elapsed_ns ? (double)ops * 1e3 / (double)elapsed_ns : 0.0;
+    printf("%-40s %10.2f ns/op %10.2f Mops/s\n", name, ns_per_op, mops);
+}
+
+/**
+ * @brief Keep the compiler from optimizing away a computed value
+ */
+static volatile uintptr_t bench_sink;
+#define BENCH_CONSUME(value) (bench_sink ^= (uintptr_t)(value))
+
+#endif /* MYRTX_BENCH_H */
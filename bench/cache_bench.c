@@ -0,0 +1,149 @@
+/**
+ * @file cache_bench.c
+ * @brief myrtx_cache_t (LRU, CLOCK) vs. a hash table plus an AVL recency tree
+ *
+ * Usage: cache_bench [capacity] [ops]
+ *
+ * Runs @p ops (default 4000000) read-through accesses over 1048576 integer
+ * keys with a skewed distribution: a get, followed by a put of a 32-byte
+ * value on a miss. The cache holds @p capacity (default 65536) entries. The
+ * baseline is the hand-rolled combination the cache replaces: a
+ * myrtx_hash_table_t mapping key to value and access stamp, and a
+ * myrtx_avl_tree_t ordered by stamp to find the least recently used key.
+ */
+
+#include "bench.h"
+#include "myrtx/collections/avl_tree.h"
+#include "myrtx/collections/cache.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_KEYS 1048576
+
+typedef struct {
+    uint64_t payload[3];
+    uint64_t stamp;
+} baseline_value_t;
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/* Skewed key: the cube of a uniform fraction favours small keys */
+static uint64_t next_key(uint64_t* state) {
+    double u = (double)(next_random(state) >> 11) / 9007199254740992.0;
+    return (uint64_t)(u * u * u * BENCH_KEYS);
+}
+
+/* Stamps and keys are stored in the tree's pointers themselves */
+static int compare_stamps(const void* a, const void* b, void* user_data) {
+    (void)user_data;
+    return (uintptr_t)a < (uintptr_t)b ? -1 : (uintptr_t)a > (uintptr_t)b;
+}
+
+static void bench_cache(const char* label, myrtx_cache_policy_t policy, size_t capacity,
+                        size_t ops) {
+    myrtx_cache_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = MYRTX_HASH_PROBING_SWISS;
+    options.policy = policy;
+    options.max_entries = capacity;
+    myrtx_cache_t* cache = myrtx_cache_create(&options);
+    if (!cache) {
+        return;
+    }
+
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    uint64_t value[4] = {0};
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < ops; i++) {
+        uint64_t key = next_key(&state);
+        const uint64_t* cached = myrtx_cache_get(cache, &key, sizeof(key), NULL);
+        if (cached) {
+            BENCH_CONSUME(cached[0]);
+        } else {
+            value[0] = key;
+            myrtx_cache_put(cache, &key, sizeof(key), value, sizeof(value));
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    myrtx_cache_stats_t stats;
+    myrtx_cache_stats(cache, &stats);
+    bench_report(label, elapsed, ops);
+    printf("    hit rate %.1f%%, %llu evictions\n", 100.0 * (double)stats.hits / (double)ops,
+           (unsigned long long)stats.evictions);
+    myrtx_cache_free(cache);
+}
+
+static void bench_baseline(size_t capacity, size_t ops) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = MYRTX_HASH_PROBING_SWISS;
+    options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+    myrtx_avl_tree_t* recency = myrtx_avl_tree_create(NULL, compare_stamps, NULL);
+    if (!table || !recency) {
+        return;
+    }
+
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    uint64_t clock = 1;
+    uint64_t hits = 0;
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < ops; i++) {
+        uint64_t key = next_key(&state);
+        void* found;
+        if (myrtx_hash_table_get(table, &key, sizeof(key), &found, NULL)) {
+            baseline_value_t* value = found;
+            BENCH_CONSUME(value->payload[0]);
+            myrtx_avl_tree_remove(recency, (void*)(uintptr_t)value->stamp, NULL, NULL);
+            value->stamp = clock++;
+            myrtx_avl_tree_insert(recency, (void*)(uintptr_t)value->stamp,
+                                  (void*)(uintptr_t)key, NULL);
+            hits++;
+            continue;
+        }
+
+        if (myrtx_hash_table_size(table) == capacity) {
+            void* victim;
+            myrtx_avl_tree_min(recency, NULL, &victim);
+            uint64_t victim_key = (uint64_t)(uintptr_t)victim;
+            void* victim_value;
+            myrtx_hash_table_get(table, &victim_key, sizeof(victim_key), &victim_value, NULL);
+            myrtx_avl_tree_remove(recency,
+                                  (void*)(uintptr_t)((baseline_value_t*)victim_value)->stamp,
+                                  NULL, NULL);
+            myrtx_hash_table_remove(table, &victim_key, sizeof(victim_key), true, true);
+        }
+        baseline_value_t value = {{key, 0, 0}, clock++};
+        myrtx_hash_table_put(table, &key, sizeof(key), &value, sizeof(value));
+        myrtx_avl_tree_insert(recency, (void*)(uintptr_t)value.stamp, (void*)(uintptr_t)key,
+                              NULL);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    bench_report("table + AVL tree LRU", elapsed, ops);
+    printf("    hit rate %.1f%%\n", 100.0 * (double)hits / (double)ops);
+    myrtx_avl_tree_free(recency, NULL, NULL);
+    myrtx_hash_table_free(table, true, true);
+}
+
+int main(int argc, char** argv) {
+    size_t capacity = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 65536;
+    size_t ops = argc > 2 ? (size_t)strtoull(argv[2], NULL, 10) : 4000000;
+    if (capacity == 0 || ops == 0) {
+        return 1;
+    }
+
+    printf("%zu entries of %d keys, %zu accesses\n\n", capacity, BENCH_KEYS, ops);
+    bench_cache("myrtx_cache_t LRU   ", MYRTX_CACHE_LRU, capacity, ops);
+    bench_cache("myrtx_cache_t CLOCK ", MYRTX_CACHE_CLOCK, capacity, ops);
+    bench_baseline(capacity, ops);
+    return 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file concurrent_hash_table_bench.c
+ * @brief Mixed read/write throughput of the concurrent table vs. a rwlock
+ *
+ * Usage: concurrent_hash_table_bench [write_percent] [ops]
+ *
+ * Prefills 65536 integer keys, then runs 1, 2, 4, ..., 64 threads that
+ * together perform @p ops operations (default 4000000) on random keys, of
+ * which @p write_percent (default 10) overwrite a value and the rest read
+ * one. Compares myrtx_concurrent_hash_table_t with a myrtx_hash_table_t
+ * behind one pthread rwlock, the usual way to share a table.
+ */
+
+#include "bench.h"
+#include "myrtx/collections/concurrent_hash_table.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+#define BENCH_KEYS 65536
+#define BENCH_MAX_THREADS 64
+
+typedef enum {
+    MODE_CONCURRENT,
+    MODE_RWLOCK
+} bench_mode_t;
+
+typedef struct {
+    bench_mode_t mode;
+    myrtx_concurrent_hash_table_t* concurrent;
+    myrtx_hash_table_t* table;
+    pthread_rwlock_t* lock;
+    size_t ops;
+    unsigned int write_percent;
+    uint64_t seed;
+    uint64_t checksum;
+} bench_worker_t;
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void* bench_worker(void* arg) {
+    bench_worker_t* worker = arg;
+    uint64_t state = worker->seed;
+    uint64_t checksum = 0;
+
+    for (size_t i = 0; i < worker->ops; i++) {
+        uint64_t r = next_random(&state);
+        uint64_t key = r % BENCH_KEYS;
+        bool write = (r >> 40) % 100 < worker->write_percent;
+
+        if (worker->mode == MODE_CONCURRENT) {
+            if (write) {
+                myrtx_concurrent_hash_table_put(worker->concurrent, &key, sizeof(key), &r,
+                                                sizeof(r));
+            } else {
+                uint64_t value = 0;
+                myrtx_concurrent_hash_table_get(worker->concurrent, &key, sizeof(key), &value,
+                                                sizeof(value), NULL);
+                checksum += value;
+            }
+        } else if (write) {
+            pthread_rwlock_wrlock(worker->lock);
+            myrtx_hash_table_put(worker->table, &key, sizeof(key), &r, sizeof(r));
+            pthread_rwlock_unlock(worker->lock);
+        } else {
+            void* value = NULL;
+            pthread_rwlock_rdlock(worker->lock);
+            if (myrtx_hash_table_get(worker->table, &key, sizeof(key), &value, NULL)) {
+                checksum += *(const uint64_t*)value;
+            }
+            pthread_rwlock_unlock(worker->lock);
+        }
+    }
+
+    worker->checksum = checksum;
+    return NULL;
+}
+
+static void bench_run(const char* label, bench_mode_t mode,
+                      myrtx_concurrent_hash_table_t* concurrent, myrtx_hash_table_t* table,
+                      pthread_rwlock_t* lock, unsigned int threads, size_t ops,
+                      unsigned int write_percent) {
+    static bench_worker_t workers[BENCH_MAX_THREADS];
+    pthread_t ids[BENCH_MAX_THREADS];
+
+    uint64_t start = bench_now_ns();
+    for (unsigned int i = 0; i < threads; i++) {
+        workers[i].mode = mode;
+        workers[i].concurrent = concurrent;
+        workers[i].table = table;
+        workers[i].lock = lock;
+        workers[i].ops = ops / threads;
+        workers[i].write_percent = write_percent;
+        workers[i].seed = 0x9E3779B97F4A7C15ull * (i + 1);
+        pthread_create(&ids[i], NULL, bench_worker, &workers[i]);
+    }
+    for (unsigned int i = 0; i < threads; i++) {
+        pthread_join(ids[i], NULL);
+        BENCH_CONSUME(workers[i].checksum);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    char name[64];
+    snprintf(name, sizeof(name), "%s %2u threads", label, threads);
+    bench_report(name, elapsed, (ops / threads) * threads);
+}
+
+int main(int argc, char** argv) {
+    unsigned int write_percent = argc > 1 ? (unsigned int)strtoul(argv[1], NULL, 10) : 10;
+    size_t ops = argc > 2 ? (size_t)strtoull(argv[2], NULL, 10) : 4000000;
+    if (write_percent > 100 || ops == 0) {
+        return 1;
+    }
+
+    myrtx_concurrent_hash_table_options_t concurrent_options = {0};
+    concurrent_options.initial_capacity = BENCH_KEYS * 2;
+    concurrent_options.hash64_function = myrtx_hash64_bytes;
+    concurrent_options.compare_function = myrtx_compare_integer_keys;
+    myrtx_concurrent_hash_table_t* concurrent =
+        myrtx_concurrent_hash_table_create(&concurrent_options);
+
+    myrtx_hash_table_options_t options = {0};
+    options.initial_capacity = BENCH_KEYS * 2;
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = MYRTX_HASH_PROBING_ROBIN_HOOD;
+    options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+
+    pthread_rwlock_t lock;
+    if (!concurrent || !table || pthread_rwlock_init(&lock, NULL) != 0) {
+        return 1;
+    }
+
+    for (uint64_t key = 0; key < BENCH_KEYS; key++) {
+        myrtx_concurrent_hash_table_put(concurrent, &key, sizeof(key), &key, sizeof(key));
+        myrtx_hash_table_put(table, &key, sizeof(key), &key, sizeof(key));
+    }
+
+    printf("%u%% writes, %zu operations, %d keys, %zu shards\n\n", write_percent, ops,
+           BENCH_KEYS, myrtx_concurrent_hash_table_shard_count(concurrent));
+    for (unsigned int threads = 1; threads <= BENCH_MAX_THREADS; threads *= 2) {
+        bench_run("sharded seqlock", MODE_CONCURRENT, concurrent, NULL, NULL, threads, ops,
+                  write_percent);
+        bench_run("single rwlock  ", MODE_RWLOCK, NULL, table, &lock, threads, ops,
+                  write_percent);
+    }
+
+    pthread_rwlock_destroy(&lock);
+    myrtx_hash_table_free(table, true, true);
+    myrtx_concurrent_hash_table_free(concurrent);
+    return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file error_bench.c
+ * @brief Cost of recording context errors, deferred versus eager formatting
+ *
+ * myrtx_context_set_error() formats every message immediately with
+ * vsnprintf; myrtx_context_set_error_static() records the format and the
+ * arguments and formats on read.
+ */
+
+#include "bench.h"
+#include "myrtx/context/context.h"
+
+#define ITERATIONS 2000000
+
+int main(void) {
+    myrtx_context_t* ctx = myrtx_context_create(NULL);
+    uint64_t start;
+
+    printf("=== Context error benchmark (%d iterations) ===\n\n", ITERATIONS);
+
+    start = bench_now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        myrtx_context_set_error(ctx, 1, "operation failed");
+    }
+    bench_report("eager, no arguments", bench_now_ns() - start, ITERATIONS);
+
+    start = bench_now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        myrtx_context_set_error_static(ctx, 1, "operation failed");
+    }
+    bench_report("deferred, no arguments", bench_now_ns() - start, ITERATIONS);
+
+    start = bench_now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        myrtx_context_set_error(ctx, 2, "retry %d of %s timed out after %.1f ms", i, "fetch", 2.5);
+    }
+    bench_report("eager, int/string/double", bench_now_ns() - start, ITERATIONS);
+
+    start = bench_now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        myrtx_context_set_error_static(ctx, 2, "retry %d of %s timed out after %.1f ms", i, "fetch",
+                                       2.5);
+    }
+    bench_report("deferred, int/string/double", bench_now_ns() - start, ITERATIONS);
+
+    /* Reading every error pays the formatting cost after all */
+    start = bench_now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        myrtx_context_set_error_static(ctx, 2, "retry %d of %s timed out after %.1f ms", i, "fetch",
+                                       2.5);
+        BENCH_CONSUME(myrtx_context_get_error(ctx));
+    }
+    bench_report("deferred, set + get", bench_now_ns() - start, ITERATIONS);
+
+    myrtx_context_destroy(ctx);
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file hash_file_bench.c
+ * @brief Startup and lookup cost of a mapped hash file vs. a rebuilt table
+ *
+ * Usage: hash_file_bench [entries] [path]
+ *
+ * Builds a table of @p entries (default 2000000) integer keys with 16-byte
+ * values through a put loop, the way a dictionary is loaded without a file,
+ * writes it to @p path (default hash_file_bench.tmp), maps the file and then
+ * times random hit lookups in both.
+ */
+
+#include "bench.h"
+#include "myrtx/collections/hash_file.h"
+#include <stdlib.h>
+
+#define BENCH_LOOKUPS 4000000
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+int main(int argc, char** argv) {
+    size_t entries = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 2000000;
+    const char* path = argc > 2 ? argv[2] : "hash_file_bench.tmp";
+    if (entries == 0) {
+        return 1;
+    }
+
+    myrtx_hash_table_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = MYRTX_HASH_PROBING_SWISS;
+    options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+
+    uint64_t start = bench_now_ns();
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+    if (!table) {
+        return 1;
+    }
+    for (uint64_t key = 0; key < entries; key++) {
+        uint64_t value[2] = {key, ~key};
+        myrtx_hash_table_put(table, &key, sizeof(key), value, sizeof(value));
+    }
+    uint64_t build_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    if (!myrtx_hash_file_write(table, path)) {
+        return 1;
+    }
+    uint64_t write_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    myrtx_hash_file_t* file = myrtx_hash_file_open(path);
+    uint64_t open_ns = bench_now_ns() - start;
+    if (!file) {
+        return 1;
+    }
+
+    printf("%zu entries\n", entries);
+    printf("put loop      %10.3f ms\n", (double)build_ns / 1e6);
+    printf("write file    %10.3f ms\n", (double)write_ns / 1e6);
+    printf("open file     %10.3f ms\n\n", (double)open_ns / 1e6);
+
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    uint64_t checksum = 0;
+    start = bench_now_ns();
+    for (size_t i = 0; i < BENCH_LOOKUPS; i++) {
+        uint64_t key = next_random(&state) % entries;
+        void* value;
+        if (myrtx_hash_table_get(table, &key, sizeof(key), &value, NULL)) {
+            checksum += *(const uint64_t*)value;
+        }
+    }
+    bench_report("table get (rebuilt)", bench_now_ns() - start, BENCH_LOOKUPS);
+
+    /* The first pass over the mapping includes page faults */
+    for (int pass = 0; pass < 2; pass++) {
+        state = 0x9E3779B97F4A7C15ull;
+        start = bench_now_ns();
+        for (size_t i = 0; i < BENCH_LOOKUPS; i++) {
+            uint64_t key = next_random(&state) % entries;
+            const void* value;
+            if (myrtx_hash_file_get(file, &key, sizeof(key), &value, NULL)) {
+                checksum += *(const uint64_t*)value;
+            }
+        }
+        bench_report(pass == 0 ? "file get (cold)    " : "file get (warm)    ",
+                     bench_now_ns() - start, BENCH_LOOKUPS);
+    }
+    BENCH_CONSUME(checksum);
+
+    myrtx_hash_file_close(file);
+    myrtx_hash_table_free(table, true, true);
+    remove(path);
+    return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file hash_function_bench.c
+ * @brief Throughput of the 32-bit and seeded 64-bit hash functions
+ *
+ * Usage: hash_function_bench
+ *
+ * Hashes keys of 4 to 1024 bytes with FNV-1a (myrtx_hash_string) and
+ * wyhash (myrtx_hash64_bytes), then compares string-key table lookups with
+ * either function, and lookups in three tables hashing once or per table.
+ */
+
+#include "bench.h"
+#include "myrtx/collections/hash_table.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ITERATIONS 2000000
+
+static void bench_sizes(void) {
+    static const size_t sizes[] = {4, 8, 16, 32, 64, 256, 1024};
+    unsigned char key[1024];
+    for (size_t i = 0; i < sizeof(key); i++) {
+        key[i] = (unsigned char)(i * 131 + 7);
+    }
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t size = sizes[s];
+        size_t iterations = ITERATIONS * 16 / (size + 16);
+        char name[64];
+
+        uint64_t start = bench_now_ns();
+        for (size_t i = 0; i < iterations; i++) {
+            key[0] = (unsigned char)i;
+            BENCH_CONSUME(myrtx_hash_string(key, size));
+        }
+        snprintf(name, sizeof(name), "fnv1a  %4zu bytes", size);
+        bench_report(name, bench_now_ns() - start, iterations);
+
+        start = bench_now_ns();
+        for (size_t i = 0; i < iterations; i++) {
+            key[0] = (unsigned char)i;
+            BENCH_CONSUME(myrtx_hash64_bytes(key, size, 42));
+        }
+        snprintf(name, sizeof(name), "wyhash %4zu bytes", size);
+        bench_report(name, bench_now_ns() - start, iterations);
+    }
+}
+
+static void bench_table(const char* label, myrtx_hash_function hash32, myrtx_hash64_function hash64,
+                        char** keys, size_t n) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash_function = hash32;
+    options.hash64_function = hash64;
+    options.compare_function = myrtx_compare_string_keys;
+    options.probing = MYRTX_HASH_PROBING_SWISS;
+    options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+
+    for (size_t i = 0; i < n; i++) {
+        myrtx_hash_table_put(table, keys[i], 0, &i, sizeof(i));
+    }
+
+    uint64_t start = bench_now_ns();
+    for (size_t round = 0; round < 4; round++) {
+        for (size_t i = 0; i < n; i++) {
+            void* value;
+            BENCH_CONSUME(myrtx_hash_table_get(table, keys[i], 0, &value, NULL));
+        }
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "%s table get %zu", label, n);
+    bench_report(name, bench_now_ns() - start, 4 * n);
+
+    myrtx_hash_table_free(table, true, true);
+}
+
+/* The same keys looked up in three tables that share a hash function:
+ * hashing (and strlen) per table, or once via the _with_hash functions */
+static void bench_shared_hash(const char* label, myrtx_hash_function hash32,
+                              myrtx_hash64_function hash64, char** keys, size_t n) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash_function = hash32;
+    options.hash64_function = hash64;
+    options.seed = 0x9E3779B97F4A7C15ull;
+    options.compare_function = myrtx_compare_string_keys;
+    options.probing = MYRTX_HASH_PROBING_SWISS;
+    options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+    myrtx_hash_table_t* tables[3];
+    for (int t = 0; t < 3; t++) {
+        tables[t] = myrtx_hash_table_create_ex(&options);
+        /* Table t holds every (t + 1)-th key, so lookups hit and miss */
+        for (size_t i = 0; i < n; i += (size_t)t + 1) {
+            myrtx_hash_table_put(tables[t], keys[i], 0, &i, sizeof(i));
+        }
+    }
+
+    char name[64];
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        for (int t = 0; t < 3; t++) {
+            void* value;
+            BENCH_CONSUME(myrtx_hash_table_get(tables[t], keys[i], 0, &value, NULL));
+        }
+    }
+    snprintf(name, sizeof(name), "%s 3 tables get", label);
+    bench_report(name, bench_now_ns() - start, n);
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        size_t size = strlen(keys[i]) + 1;
+        uint64_t hash = myrtx_hash_table_hash(tables[0], keys[i], size);
+        for (int t = 0; t < 3; t++) {
+            void* value;
+            BENCH_CONSUME(myrtx_hash_table_get_with_hash(tables[t], keys[i], size, hash, &value,
+                                                         NULL));
+        }
+    }
+    snprintf(name, sizeof(name), "%s 3 tables get_with_hash", label);
+    bench_report(name, bench_now_ns() - start, n);
+
+    for (int t = 0; t < 3; t++) {
+        myrtx_hash_table_free(tables[t], true, true);
+    }
+}
+
+int main(void) {
+    printf("=== Hash function benchmark ===\n\n");
+    bench_sizes();
+    printf("\n");
+
+    /* URL-like keys of 30-40 bytes */
+    size_t n = 200000;
+    char* storage = malloc(n * 48);
+    char** keys = malloc(n * sizeof(char*));
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = storage + i * 48;
+        snprintf(keys[i], 48, "https://example.com/item/%zu", i * 7919);
+    }
+    bench_table("fnv1a ", myrtx_hash_string, NULL, keys, n);
+    bench_table("wyhash", NULL, myrtx_hash64_string, keys, n);
+    printf("\n");
+    bench_shared_hash("fnv1a ", myrtx_hash_string, NULL, keys, n);
+    bench_shared_hash("wyhash", NULL, myrtx_hash64_string, keys, n);
+    free(keys);
+    free(storage);
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file hash_resize_bench.c
+ * @brief Per-put latency with stop-the-world and incremental resizing
+ *
+ * Usage: hash_resize_bench [count]
+ *
+ * Times every single put while a table grows from its initial capacity to
+ * @p count entries (default 1000000) and reports the mean, the 99.9th
+ * percentile and the worst put. Without MYRTX_HASH_TABLE_INCREMENTAL_RESIZE
+ * the worst put rehashes the whole table; with it, each put moves at most
+ * MYRTX_HASH_MIGRATE_SLOTS slots.
+ */
+
+#include "bench.h"
+#include "myrtx/collections/hash_table.h"
+#include <stdlib.h>
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void bench_latency(const char* label, myrtx_hash_probing_t probing, unsigned int flags,
+                          uint64_t* samples, size_t count) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = probing;
+    options.flags = flags | MYRTX_HASH_TABLE_INLINE_STORAGE;
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+    if (!table) {
+        printf("%-28s create failed\n", label);
+        return;
+    }
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key = i;
+        uint64_t start = bench_now_ns();
+        myrtx_hash_table_put(table, &key, sizeof(key), &key, sizeof(key));
+        samples[i] = bench_now_ns() - start;
+        total += samples[i];
+    }
+    myrtx_hash_table_free(table, true, true);
+
+    qsort(samples, count, sizeof(uint64_t), compare_u64);
+    printf("%-28s %9.1f ns mean %10.1f us p99.9 %10.1f us max\n", label,
+           (double)total / (double)count, (double)samples[count - count / 1000 - 1] / 1e3,
+           (double)samples[count - 1] / 1e3);
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 1000000;
+    if (count == 0) {
+        return 1;
+    }
+    uint64_t* samples = malloc(sizeof(uint64_t) * count);
+    if (!samples) {
+        return 1;
+    }
+
+    static const struct {
+        const char* name;
+        myrtx_hash_probing_t probing;
+    } backends[] = {
+        {"linear", MYRTX_HASH_PROBING_LINEAR},
+        {"swiss", MYRTX_HASH_PROBING_SWISS},
+        {"robin hood", MYRTX_HASH_PROBING_ROBIN_HOOD},
+    };
+
+    printf("=== Hash table put latency, %zu puts ===\n\n", count);
+    for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+        char name[64];
+        snprintf(name, sizeof(name), "%s", backends[b].name);
+        bench_latency(name, backends[b].probing, 0, samples, count);
+        snprintf(name, sizeof(name), "%s incremental", backends[b].name);
+        bench_latency(name, backends[b].probing, MYRTX_HASH_TABLE_INCREMENTAL_RESIZE, samples, count);
+    }
+
+    free(samples);
+    return 0;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file hash_set_bench.c
+ * @brief Deduplication with the hash set vs. a table with dummy values
+ *
+ * Usage: hash_set_bench [ops]
+ *
+ * Feeds @p ops (default 2000000) random integer keys drawn from 262144
+ * distinct ones into an arena-backed container and reports the time and
+ * the arena bytes used. Compares the set with a myrtx_hash_table_t holding
+ * a 1-byte dummy value per key, once with and once without inline storage,
+ * and finally groups the same stream into a multimap of 4-byte values.
+ */
+
+#include "bench.h"
+#include "myrtx/collections/hash_multimap.h"
+#include "myrtx/collections/hash_set.h"
+#include <stdlib.h>
+
+#define BENCH_DISTINCT 262144
+
+typedef enum {
+    MODE_TABLE,
+    MODE_SET,
+    MODE_MULTIMAP
+} bench_mode_t;
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void bench_run(const char* label, bench_mode_t mode, uint32_t flags, size_t ops) {
+    myrtx_arena_t arena = {0};
+    if (!myrtx_arena_init(&arena, 0)) {
+        return;
+    }
+
+    myrtx_hash_table_options_t options = {0};
+    options.arena = &arena;
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = MYRTX_HASH_PROBING_SWISS;
+    options.initial_capacity = BENCH_DISTINCT * 2;
+    options.flags = flags;
+
+    myrtx_hash_table_t* table = NULL;
+    myrtx_hash_set_t* set = NULL;
+    myrtx_hash_multimap_t* map = NULL;
+    if (mode == MODE_TABLE) {
+        table = myrtx_hash_table_create_ex(&options);
+    } else if (mode == MODE_SET) {
+        set = myrtx_hash_set_create(&options);
+    } else {
+        map = myrtx_hash_multimap_create(&options, sizeof(uint32_t));
+    }
+    if (!table && !set && !map) {
+        myrtx_arena_free(&arena);
+        return;
+    }
+
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    const unsigned char dummy = 1;
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < ops; i++) {
+        uint64_t key = next_random(&state) % BENCH_DISTINCT;
+        if (mode == MODE_TABLE) {
+            myrtx_hash_table_get_or_insert(table, &key, sizeof(key), &dummy, sizeof(dummy), NULL);
+        } else if (mode == MODE_SET) {
+            myrtx_hash_set_add(set, &key, sizeof(key), NULL);
+        } else {
+            uint32_t value = (uint32_t)i;
+            myrtx_hash_multimap_add(map, &key, sizeof(key), &value);
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    size_t used = 0;
+    myrtx_arena_stats(&arena, NULL, &used, NULL);
+    size_t keys = table ? myrtx_hash_table_size(table)
+                : set   ? myrtx_hash_set_size(set)
+                        : myrtx_hash_multimap_key_count(map);
+    BENCH_CONSUME(keys);
+    bench_report(label, elapsed, ops);
+    printf("    %zu keys, %zu arena bytes (%.1f per key)\n", keys, used, (double)used / keys);
+
+    myrtx_arena_free(&arena);
+}
+
+int main(int argc, char** argv) {
+    size_t ops = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 2000000;
+    if (ops == 0) {
+        return 1;
+    }
+
+    printf("%zu operations over %d distinct keys\n\n", ops, BENCH_DISTINCT);
+    bench_run("table, 1-byte values     ", MODE_TABLE, 0, ops);
+    bench_run("table, inline 1-byte vals", MODE_TABLE, MYRTX_HASH_TABLE_INLINE_STORAGE, ops);
+    bench_run("hash set                 ", MODE_SET, 0, ops);
+    bench_run("multimap, 4-byte values  ", MODE_MULTIMAP, 0, ops);
+    return 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file hash_table_bench.c
+ * @brief Put, hit, batched hit, miss, iteration and counting cost of the hash table
+ *        probing strategies
+ *
+ * Usage: hash_table_bench [max_entries]
+ *
+ * Runs table sizes from 1K entries up to max_entries (default 1M) in steps
+ * of 10x. Pass 100000000 for the 100M case; it needs about 16 GB of RAM.
+ * Lookup tables are arena-backed so that the numbers show probing rather
+ * than malloc; the churn runs use malloc. Rows marked "+i" use
+ * MYRTX_HASH_TABLE_INLINE_STORAGE.
+ */
+
+#include "bench.h"
+#include "myrtx/collections/hash_table.h"
+#include <stdlib.h>
+
+/* Bijective scramble so that keys are spread like real identifiers */
+static int bench_key(size_t i) {
+    return (int)((uint32_t)i * 2654435761u);
+}
+
+static void bench_probing(const char* label, myrtx_hash_probing_t probing, unsigned int flags,
+                          size_t n) {
+    myrtx_arena_t arena = {0};
+    myrtx_arena_init(&arena, 1 << 20);
+
+    myrtx_hash_table_options_t options = {0};
+    options.arena = &arena;
+    options.hash_function = myrtx_hash_integer;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = probing;
+    options.flags = flags;
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+
+    char name[64];
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        /* Even indices are stored, odd indices are the misses */
+        int key = bench_key(2 * i);
+        myrtx_hash_table_put(table, &key, sizeof(int), &key, sizeof(int));
+    }
+    snprintf(name, sizeof(name), "%s put %zu", label, n);
+    bench_report(name, bench_now_ns() - start, n);
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        int key = bench_key(2 * i);
+        void* value;
+        BENCH_CONSUME(myrtx_hash_table_get(table, &key, sizeof(int), &value, NULL));
+    }
+    snprintf(name, sizeof(name), "%s get hit %zu", label, n);
+    bench_report(name, bench_now_ns() - start, n);
+
+    /* The same hits through get_batch, which overlaps their cache misses */
+    int* keys = malloc(sizeof(int) * n);
+    const void** key_ptrs = malloc(sizeof(void*) * n);
+    size_t* key_sizes = malloc(sizeof(size_t) * n);
+    void** values = malloc(sizeof(void*) * n);
+    if (keys && key_ptrs && key_sizes && values) {
+        for (size_t i = 0; i < n; i++) {
+            keys[i] = bench_key(2 * i);
+            key_ptrs[i] = &keys[i];
+            key_sizes[i] = sizeof(int);
+        }
+        start = bench_now_ns();
+        BENCH_CONSUME(myrtx_hash_table_get_batch(table, n, key_ptrs, key_sizes, values, NULL));
+        snprintf(name, sizeof(name), "%s get batch %zu", label, n);
+        bench_report(name, bench_now_ns() - start, n);
+    }
+    free(keys);
+    free(key_ptrs);
+    free(key_sizes);
+    free(values);
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        int key = bench_key(2 * i + 1);
+        void* value;
+        BENCH_CONSUME(myrtx_hash_table_get(table, &key, sizeof(int), &value, NULL));
+    }
+    snprintf(name, sizeof(name), "%s get miss %zu", label, n);
+    bench_report(name, bench_now_ns() - start, n);
+
+    start = bench_now_ns();
+    myrtx_hash_table_iter_t iter;
+    myrtx_hash_table_iter_init(&iter, table);
+    void* value;
+    while (myrtx_hash_table_iter_next(&iter, NULL, NULL, &value, NULL)) {
+        BENCH_CONSUME(*(int*)value);
+    }
+    snprintf(name, sizeof(name), "%s iterate %zu", label, n);
+    bench_report(name, bench_now_ns() - start, n);
+
+    myrtx_arena_free(&arena);
+}
+
+/* Remove one key and insert a new one, keeping the size at @p n */
+static void bench_churn(const char* label, myrtx_hash_probing_t probing, unsigned int flags,
+                        size_t n) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash_function = myrtx_hash_integer;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = probing;
+    options.flags = flags;
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+
+    for (size_t i = 0; i < n; i++) {
+        int key = bench_key(i);
+        myrtx_hash_table_put(table, &key, sizeof(int), &key, sizeof(int));
+    }
+
+    size_t ops = 10 * n;
+    uint64_t start = bench_now_ns();
+    for (size_t i = n; i < n + ops; i++) {
+        int old_key = bench_key(i - n);
+        int key = bench_key(i);
+        myrtx_hash_table_remove(table, &old_key, sizeof(int), true, true);
+        myrtx_hash_table_put(table, &key, sizeof(int), &key, sizeof(int));
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    char name[64];
+    snprintf(name, sizeof(name), "%s churn %zu (capacity %zu)", label, n,
+             myrtx_hash_table_capacity(table));
+    bench_report(name, elapsed, ops);
+    myrtx_hash_table_free(table, true, true);
+}
+
+static void merge_add(void* stored_value, size_t stored_size, const void* value,
+                      size_t value_size, void* user_data) {
+    (void)stored_size;
+    (void)value_size;
+    (void)user_data;
+    *(int*)stored_value += *(const int*)value;
+}
+
+/* Count 10 * n occurrences of n distinct keys: get + put, get_or_insert, upsert */
+static void bench_count(const char* label, myrtx_hash_probing_t probing, unsigned int flags,
+                        size_t n) {
+    static const char* const methods[] = {"get+put", "get_or_insert", "upsert"};
+    size_t ops = 10 * n;
+    
+    for (int method = 0; method < 3; method++) {
+        myrtx_hash_table_options_t options = {0};
+        options.hash_function = myrtx_hash_integer;
+        options.compare_function = myrtx_compare_integer_keys;
+        options.probing = probing;
+        options.flags = flags;
+        myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+        
+        uint64_t start = bench_now_ns();
+        for (size_t i = 0; i < ops; i++) {
+            int key = bench_key(i % n);
+            int one = 1;
+            if (method == 0) {
+                void* value;
+                int count = 1;
+                if (myrtx_hash_table_get(table, &key, sizeof(int), &value, NULL)) {
+                    count = *(int*)value + 1;
+                }
+                myrtx_hash_table_put(table, &key, sizeof(int), &count, sizeof(int));
+            } else if (method == 1) {
+                int zero = 0;
+                int* count = myrtx_hash_table_get_or_insert(table, &key, sizeof(int), &zero,
+                                                            sizeof(int), NULL);
+                (*count)++;
+            } else {
+                myrtx_hash_table_upsert(table, &key, sizeof(int), &one, sizeof(int), merge_add,
+                                        NULL);
+            }
+        }
+        uint64_t elapsed = bench_now_ns() - start;
+        
+        char name[64];
+        snprintf(name, sizeof(name), "%s count %s %zu", label, methods[method], n);
+        bench_report(name, elapsed, ops);
+        myrtx_hash_table_free(table, true, true);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t max_entries = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 1000000;
+
+    printf("=== Hash table benchmark ===\n\n");
+    for (size_t n = 1000; n <= max_entries; n *= 10) {
+        bench_probing("linear  ", MYRTX_HASH_PROBING_LINEAR, 0, n);
+        bench_probing("swiss   ", MYRTX_HASH_PROBING_SWISS, 0, n);
+        bench_probing("robin   ", MYRTX_HASH_PROBING_ROBIN_HOOD, 0, n);
+        bench_probing("compact ", MYRTX_HASH_PROBING_COMPACT, 0, n);
+        bench_probing("linear+i", MYRTX_HASH_PROBING_LINEAR, MYRTX_HASH_TABLE_INLINE_STORAGE, n);
+        bench_probing("swiss+i ", MYRTX_HASH_PROBING_SWISS, MYRTX_HASH_TABLE_INLINE_STORAGE, n);
+        bench_probing("robin+i ", MYRTX_HASH_PROBING_ROBIN_HOOD, MYRTX_HASH_TABLE_INLINE_STORAGE, n);
+        bench_probing("compact+i", MYRTX_HASH_PROBING_COMPACT, MYRTX_HASH_TABLE_INLINE_STORAGE, n);
+        printf("\n");
+    }
+
+    for (size_t n = 1000; n <= max_entries && n <= 100000; n *= 10) {
+        bench_count("linear  ", MYRTX_HASH_PROBING_LINEAR, 0, n);
+        bench_count("robin+i ", MYRTX_HASH_PROBING_ROBIN_HOOD, MYRTX_HASH_TABLE_INLINE_STORAGE, n);
+        printf("\n");
+    }
+
+    for (size_t n = 1000; n <= max_entries && n <= 100000; n *= 10) {
+        bench_churn("linear  ", MYRTX_HASH_PROBING_LINEAR, 0, n);
+        bench_churn("swiss   ", MYRTX_HASH_PROBING_SWISS, 0, n);
+        bench_churn("robin   ", MYRTX_HASH_PROBING_ROBIN_HOOD, 0, n);
+        bench_churn("robin+i ", MYRTX_HASH_PROBING_ROBIN_HOOD, MYRTX_HASH_TABLE_INLINE_STORAGE, n);
+        bench_churn("compact ", MYRTX_HASH_PROBING_COMPACT, 0, n);
+        printf("\n");
+    }
+
+    return 0;
+}
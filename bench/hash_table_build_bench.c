@@ -0,0 +1,183 @@
+/**
+ * @file hash_table_build_bench.c
+ * @brief Bulk building and merging: put loops vs. build_parallel and merge
+ *
+ * Usage: hash_table_build_bench [count] [max_threads]
+ *
+ * Builds a table of @p count (default 1000000) random 8-byte keys with
+ * 8-byte values, per probing strategy: with a put loop into a table that
+ * grows as it fills, and with myrtx_hash_table_build_parallel() at 1, 2, 4
+ * ... up to @p max_threads (default 4) threads. Parallel speedup needs as
+ * many cores as threads.
+ *
+ * The merge part fills two tables with @p count / 2 keys each, a quarter of
+ * them shared, and moves one into the other: by iterating and putting, and
+ * with myrtx_hash_table_merge(). Values are 32 bytes and stored outside the
+ * slots, which the put loop copies and the merge moves.
+ */
+
+#include "bench.h"
+#include "myrtx/collections/hash_table.h"
+#include <stdlib.h>
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static myrtx_hash_table_options_t table_options(myrtx_hash_probing_t probing) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = probing;
+    options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+    return options;
+}
+
+static void bench_build(const char* name, myrtx_hash_probing_t probing, size_t count,
+                        unsigned int max_threads, const uint64_t* keys) {
+    const void** key_ptrs = malloc(count * sizeof(void*));
+    size_t* sizes = malloc(count * sizeof(size_t));
+    if (!key_ptrs || !sizes) {
+        free(key_ptrs);
+        free(sizes);
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        key_ptrs[i] = &keys[i];
+        sizes[i] = sizeof(uint64_t);
+    }
+
+    myrtx_hash_table_options_t options = table_options(probing);
+    char label[64];
+
+    uint64_t start = bench_now_ns();
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+    for (size_t i = 0; table && i < count; i++) {
+        myrtx_hash_table_put(table, &keys[i], sizeof(uint64_t), &keys[i], sizeof(uint64_t));
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    snprintf(label, sizeof(label), "%s, put loop", name);
+    bench_report(label, elapsed, count);
+    myrtx_hash_table_free(table, true, true);
+
+    for (unsigned int threads = 1; threads <= max_threads; threads *= 2) {
+        start = bench_now_ns();
+        table = myrtx_hash_table_build_parallel(&options, count, key_ptrs, sizes,
+                                                (const void* const*)key_ptrs, sizes, threads);
+        elapsed = bench_now_ns() - start;
+        snprintf(label, sizeof(label), "%s, build_parallel x%u", name, threads);
+        bench_report(label, elapsed, count);
+        if (table && myrtx_hash_table_size(table) > count) {
+            printf("    wrong size\n");
+        }
+        myrtx_hash_table_free(table, true, true);
+    }
+
+    free(key_ptrs);
+    free(sizes);
+}
+
+/* Two tables of half the keys each; the second shares every fourth key with the first */
+static void fill_halves(myrtx_hash_table_t* first, myrtx_hash_table_t* second, size_t count,
+                        const uint64_t* keys) {
+    uint64_t value[4] = {0};
+    for (size_t i = 0; i < count / 2; i++) {
+        value[0] = keys[i];
+        myrtx_hash_table_put(first, &keys[i], sizeof(uint64_t), value, sizeof(value));
+        const uint64_t* key = i % 4 == 0 ? &keys[i] : &keys[count / 2 + i];
+        myrtx_hash_table_put(second, key, sizeof(uint64_t), value, sizeof(value));
+    }
+}
+
+static void bench_merge(const char* name, myrtx_hash_probing_t probing, size_t count,
+                        const uint64_t* keys) {
+    myrtx_hash_table_options_t options = table_options(probing);
+    char label[64];
+
+    myrtx_hash_table_t* dst = myrtx_hash_table_create_ex(&options);
+    myrtx_hash_table_t* src = myrtx_hash_table_create_ex(&options);
+    if (!dst || !src) {
+        myrtx_hash_table_free(dst, true, true);
+        myrtx_hash_table_free(src, true, true);
+        return;
+    }
+    fill_halves(dst, src, count, keys);
+
+    uint64_t start = bench_now_ns();
+    myrtx_hash_table_iter_t iter;
+    const void* key;
+    size_t key_size, value_size;
+    void* value;
+    myrtx_hash_table_iter_init(&iter, src);
+    while (myrtx_hash_table_iter_next(&iter, &key, &key_size, &value, &value_size)) {
+        myrtx_hash_table_put(dst, key, key_size, value, value_size);
+    }
+    myrtx_hash_table_clear(src, true, true);
+    uint64_t elapsed = bench_now_ns() - start;
+    snprintf(label, sizeof(label), "%s, iterate and put", name);
+    bench_report(label, elapsed, count / 2);
+    myrtx_hash_table_free(dst, true, true);
+    myrtx_hash_table_free(src, true, true);
+
+    dst = myrtx_hash_table_create_ex(&options);
+    src = myrtx_hash_table_create_ex(&options);
+    if (!dst || !src) {
+        myrtx_hash_table_free(dst, true, true);
+        myrtx_hash_table_free(src, true, true);
+        return;
+    }
+    fill_halves(dst, src, count, keys);
+
+    start = bench_now_ns();
+    bool merged = myrtx_hash_table_merge(dst, src, NULL, NULL);
+    elapsed = bench_now_ns() - start;
+    snprintf(label, sizeof(label), "%s, merge", name);
+    bench_report(label, elapsed, count / 2);
+    if (!merged) {
+        printf("    merge failed\n");
+    }
+    myrtx_hash_table_free(dst, true, true);
+    myrtx_hash_table_free(src, true, true);
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 1000000;
+    unsigned int max_threads = argc > 2 ? (unsigned int)strtoul(argv[2], NULL, 10) : 4;
+    if (count == 0 || max_threads == 0) {
+        return 1;
+    }
+
+    uint64_t* keys = malloc(count * sizeof(uint64_t));
+    if (!keys) {
+        return 1;
+    }
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = next_random(&state);
+    }
+
+    static const struct {
+        const char* name;
+        myrtx_hash_probing_t probing;
+    } strategies[] = {
+        {"linear", MYRTX_HASH_PROBING_LINEAR},
+        {"swiss", MYRTX_HASH_PROBING_SWISS},
+        {"robin hood", MYRTX_HASH_PROBING_ROBIN_HOOD},
+        {"compact", MYRTX_HASH_PROBING_COMPACT}
+    };
+
+    printf("%zu keys, up to %u threads (ns/op per key)\n\n", count, max_threads);
+    for (size_t s = 0; s < sizeof(strategies) / sizeof(strategies[0]); s++) {
+        bench_build(strategies[s].name, strategies[s].probing, count, max_threads, keys);
+    }
+    printf("\n");
+    for (size_t s = 0; s < sizeof(strategies) / sizeof(strategies[0]); s++) {
+        bench_merge(strategies[s].name, strategies[s].probing, count, keys);
+    }
+
+    free(keys);
+    return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file hash_table_clear_bench.c
+ * @brief Per-request dedup tables: sweeping clear vs. generation-tagged clear
+ *
+ * Usage: hash_table_clear_bench [capacity] [keys_per_request] [requests]
+ *
+ * Each strategy gets a table presized to @p capacity slots (default
+ * 1048576). Every request inserts @p keys_per_request (default 64) random
+ * 8-byte keys, looks each up once more as a duplicate check, and clears
+ * the table. This runs @p requests times (default 2000), once with plain
+ * tables and once with MYRTX_HASH_TABLE_GENERATIONS. Reported is the time
+ * per request, clear included, and the mean clear time alone.
+ */
+
+#include "bench.h"
+#include "myrtx/collections/hash_table.h"
+#include <stdlib.h>
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void bench_requests(const char* label, myrtx_hash_probing_t probing, unsigned int flags,
+                           size_t capacity, uint64_t keys_per_request, uint64_t requests) {
+    myrtx_hash_table_options_t options = {0};
+    options.initial_capacity = capacity;
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = probing;
+    options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE | flags;
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+    if (!table) {
+        return;
+    }
+
+    /* Touch every slot once so that first-use page faults are not timed */
+    myrtx_hash_table_clear(table, true, true);
+
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    uint64_t clear_time = 0;
+    uint64_t start = bench_now_ns();
+    for (uint64_t request = 0; request < requests; request++) {
+        for (uint64_t i = 0; i < keys_per_request; i++) {
+            uint64_t key = next_random(&state);
+            myrtx_hash_table_put(table, &key, sizeof(key), &i, sizeof(i));
+            BENCH_CONSUME(myrtx_hash_table_contains_key(table, &key, sizeof(key)));
+        }
+
+        uint64_t clear_start = bench_now_ns();
+        myrtx_hash_table_clear(table, true, true);
+        clear_time += bench_now_ns() - clear_start;
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    bench_report(label, elapsed, requests);
+    printf("    %zu slots, mean clear %.2f us\n", myrtx_hash_table_capacity(table),
+           (double)clear_time / (double)requests / 1e3);
+    myrtx_hash_table_free(table, true, true);
+}
+
+int main(int argc, char** argv) {
+    size_t capacity = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 1048576;
+    uint64_t keys_per_request = argc > 2 ? strtoull(argv[2], NULL, 10) : 64;
+    uint64_t requests = argc > 3 ? strtoull(argv[3], NULL, 10) : 2000;
+    if (capacity == 0 || keys_per_request == 0 || requests == 0) {
+        return 1;
+    }
+
+    static const struct {
+        const char* name;
+        const char* tagged_name;
+        myrtx_hash_probing_t probing;
+    } strategies[] = {
+        {"linear, sweeping clear", "linear, generations", MYRTX_HASH_PROBING_LINEAR},
+        {"swiss, sweeping clear", "swiss, generations", MYRTX_HASH_PROBING_SWISS},
+        {"robin hood, sweeping clear", "robin hood, generations", MYRTX_HASH_PROBING_ROBIN_HOOD},
+        {"compact, sweeping clear", "compact, generations", MYRTX_HASH_PROBING_COMPACT}
+    };
+
+    printf("%zu slots requested, %llu keys per request, %llu requests (ns/op per request)\n\n",
+           capacity, (unsigned long long)keys_per_request, (unsigned long long)requests);
+    for (size_t s = 0; s < sizeof(strategies) / sizeof(strategies[0]); s++) {
+        bench_requests(strategies[s].name, strategies[s].probing, 0, capacity, keys_per_request,
+                       requests);
+        bench_requests(strategies[s].tagged_name, strategies[s].probing,
+                       MYRTX_HASH_TABLE_GENERATIONS, capacity, keys_per_request, requests);
+    }
+    return 0;
+}
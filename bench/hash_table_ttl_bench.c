@@ -0,0 +1,189 @@
+/**
+ * @file hash_table_ttl_bench.c
+ * @brief Timing-wheel expiry vs. a periodic scan over expiry stamps in the values
+ *
+ * Usage: hash_table_ttl_bench [ticks] [ops_per_tick] [ttl]
+ *
+ * Simulates a session table for @p ticks (default 200000) clock ticks. Each
+ * tick runs @p ops_per_tick (default 20) operations: half create a session
+ * that expires @p ttl (default 30000) ticks later, half look up a recent
+ * session and, if it is still alive, push its expiry back to now + ttl.
+ * About ttl * ops_per_tick / 2 sessions are alive at any time.
+ *
+ * The wheel variants call myrtx_hash_table_expire() once per tick, without
+ * and with a budget. The
+ * baseline keeps the expiry in the value, checks it on lookup and scans the
+ * whole table once every 1000 ticks to remove expired sessions. Besides the
+ * cost per operation, the longest single expiry call or scan is reported.
+ */
+
+#include "bench.h"
+#include "myrtx/collections/hash_table.h"
+#include <stdlib.h>
+
+#define BENCH_SCAN_INTERVAL 1000
+
+typedef struct {
+    uint64_t payload[2];
+    uint64_t expires_at; /* Baseline only */
+} session_t;
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static myrtx_hash_table_t* create_table(void) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = MYRTX_HASH_PROBING_SWISS;
+    options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+    return myrtx_hash_table_create_ex(&options);
+}
+
+/* Key of a recent session: one of the last 2 * ttl * ops_per_tick / 2 created */
+static uint64_t recent_key(uint64_t* state, uint64_t created, uint64_t window) {
+    uint64_t back = next_random(state) % window + 1;
+    return back <= created ? created - back : 0;
+}
+
+static void bench_wheel(const char* label, uint64_t ticks, uint64_t ops_per_tick, uint64_t ttl,
+                        size_t budget) {
+    myrtx_hash_table_t* table = create_table();
+    if (!table) {
+        return;
+    }
+
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    uint64_t created = 0, hits = 0, removed = 0, worst = 0;
+    uint64_t window = ttl * ops_per_tick;
+    session_t session = {{0, 0}, 0};
+
+    uint64_t start = bench_now_ns();
+    for (uint64_t now = 1; now <= ticks; now++) {
+        for (uint64_t op = 0; op < ops_per_tick; op++) {
+            if (op & 1) {
+                uint64_t key = recent_key(&state, created, window);
+                if (myrtx_hash_table_set_expiry(table, &key, sizeof(key), now + ttl)) {
+                    hits++;
+                }
+            } else {
+                uint64_t key = created++;
+                session.payload[0] = key;
+                myrtx_hash_table_put_ttl(table, &key, sizeof(key), &session, sizeof(session),
+                                         now + ttl);
+            }
+        }
+
+        uint64_t expire_start = bench_now_ns();
+        removed += myrtx_hash_table_expire(table, now, budget);
+        uint64_t expire_time = bench_now_ns() - expire_start;
+        if (expire_time > worst) {
+            worst = expire_time;
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    bench_report(label, elapsed, ticks * ops_per_tick);
+    printf("    %llu alive, %llu refreshed, %llu expired, longest expire %.1f us\n",
+           (unsigned long long)myrtx_hash_table_size(table), (unsigned long long)hits,
+           (unsigned long long)removed, (double)worst / 1e3);
+    myrtx_hash_table_free(table, true, true);
+}
+
+/* Removes every session whose stamp has passed; returns how many */
+static uint64_t scan_expired(myrtx_hash_table_t* table, uint64_t now, uint64_t** keys,
+                             size_t* keys_capacity) {
+    myrtx_hash_table_iter_t iter;
+    const void* key;
+    void* value;
+    size_t count = 0;
+
+    myrtx_hash_table_iter_init(&iter, table);
+    while (myrtx_hash_table_iter_next(&iter, &key, NULL, &value, NULL)) {
+        if (((session_t*)value)->expires_at > now) {
+            continue;
+        }
+        if (count == *keys_capacity) {
+            *keys_capacity = *keys_capacity ? *keys_capacity * 2 : 1024;
+            *keys = realloc(*keys, *keys_capacity * sizeof(uint64_t));
+        }
+        (*keys)[count++] = *(const uint64_t*)key;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        myrtx_hash_table_remove(table, &(*keys)[i], sizeof(uint64_t), true, true);
+    }
+    return count;
+}
+
+static void bench_scan(uint64_t ticks, uint64_t ops_per_tick, uint64_t ttl) {
+    myrtx_hash_table_t* table = create_table();
+    if (!table) {
+        return;
+    }
+
+    uint64_t* keys = NULL;
+    size_t keys_capacity = 0;
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    uint64_t created = 0, hits = 0, removed = 0, worst = 0;
+    uint64_t window = ttl * ops_per_tick;
+    session_t session = {{0, 0}, 0};
+
+    uint64_t start = bench_now_ns();
+    for (uint64_t now = 1; now <= ticks; now++) {
+        for (uint64_t op = 0; op < ops_per_tick; op++) {
+            if (op & 1) {
+                uint64_t key = recent_key(&state, created, window);
+                void* found;
+                if (myrtx_hash_table_get(table, &key, sizeof(key), &found, NULL) &&
+                    ((session_t*)found)->expires_at > now) {
+                    ((session_t*)found)->expires_at = now + ttl;
+                    hits++;
+                }
+            } else {
+                uint64_t key = created++;
+                session.payload[0] = key;
+                session.expires_at = now + ttl;
+                myrtx_hash_table_put(table, &key, sizeof(key), &session, sizeof(session));
+            }
+        }
+
+        if (now % BENCH_SCAN_INTERVAL == 0) {
+            uint64_t scan_start = bench_now_ns();
+            removed += scan_expired(table, now, &keys, &keys_capacity);
+            uint64_t scan_time = bench_now_ns() - scan_start;
+            if (scan_time > worst) {
+                worst = scan_time;
+            }
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    bench_report("stamp in value, scan every 1000 ticks", elapsed, ticks * ops_per_tick);
+    printf("    %llu stored, %llu refreshed, %llu expired, longest scan %.1f us\n",
+           (unsigned long long)myrtx_hash_table_size(table), (unsigned long long)hits,
+           (unsigned long long)removed, (double)worst / 1e3);
+    free(keys);
+    myrtx_hash_table_free(table, true, true);
+}
+
+int main(int argc, char** argv) {
+    uint64_t ticks = argc > 1 ? strtoull(argv[1], NULL, 10) : 200000;
+    uint64_t ops_per_tick = argc > 2 ? strtoull(argv[2], NULL, 10) : 20;
+    uint64_t ttl = argc > 3 ? strtoull(argv[3], NULL, 10) : 30000;
+    if (ticks == 0 || ops_per_tick == 0 || ttl == 0) {
+        return 1;
+    }
+
+    printf("%llu ticks, %llu operations per tick, TTL %llu ticks\n\n",
+           (unsigned long long)ticks, (unsigned long long)ops_per_tick,
+           (unsigned long long)ttl);
+    bench_wheel("timing wheel, expire every tick", ticks, ops_per_tick, ttl, 0);
+    bench_wheel("timing wheel, budget 256 per tick", ticks, ops_per_tick, ttl, 256);
+    bench_scan(ticks, ops_per_tick, ttl);
+    return 0;
+}
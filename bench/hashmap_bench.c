@@ -0,0 +1,161 @@
+/**
+ * @file hashmap_bench.c
+ * @brief Macro-generated typed maps against the generic hash table
+ *
+ * Usage: hashmap_bench [entries]
+ *
+ * Puts, hits and misses on int -> int and string -> int maps (default 1M
+ * entries). The generic table runs with its default options and with Robin
+ * Hood probing plus inline storage, its fastest configuration. All tables
+ * use malloc.
+ */
+
+#include "bench.h"
+#include "myrtx/collections/hash_table.h"
+#include "myrtx/collections/hashmap.h"
+#include <stdlib.h>
+
+MYRTX_HASHMAP_DEFINE(int_map, int, int, myrtx_hashmap_hash_int, myrtx_hashmap_eq_int)
+MYRTX_HASHMAP_DEFINE(str_map, const char*, int, myrtx_hashmap_hash_str, myrtx_hashmap_eq_str)
+
+/* Bijective scramble so that keys are spread like real identifiers */
+static int bench_key(size_t i) {
+    return (int)((uint32_t)i * 2654435761u);
+}
+
+static void report(const char* label, const char* op, uint64_t elapsed, size_t n) {
+    char name[64];
+    snprintf(name, sizeof(name), "%s %s %zu", label, op, n);
+    bench_report(name, elapsed, n);
+}
+
+static void bench_generic_int(const char* label, const myrtx_hash_table_options_t* options, size_t n) {
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(options);
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        /* Even indices are stored, odd indices are the misses */
+        int key = bench_key(2 * i);
+        myrtx_hash_table_put(table, &key, sizeof(int), &key, sizeof(int));
+    }
+    report(label, "put", bench_now_ns() - start, n);
+
+    for (int miss = 0; miss <= 1; miss++) {
+        start = bench_now_ns();
+        for (size_t i = 0; i < n; i++) {
+            int key = bench_key(2 * i + (size_t)miss);
+            void* value;
+            BENCH_CONSUME(myrtx_hash_table_get(table, &key, sizeof(int), &value, NULL));
+        }
+        report(label, miss ? "get miss" : "get hit", bench_now_ns() - start, n);
+    }
+
+    myrtx_hash_table_free(table, true, true);
+}
+
+static void bench_typed_int(size_t n) {
+    int_map map;
+    int_map_init(&map, NULL, 0);
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        int key = bench_key(2 * i);
+        int_map_put(&map, key, key);
+    }
+    report("int typed  ", "put", bench_now_ns() - start, n);
+
+    for (int miss = 0; miss <= 1; miss++) {
+        start = bench_now_ns();
+        for (size_t i = 0; i < n; i++) {
+            BENCH_CONSUME(int_map_get(&map, bench_key(2 * i + (size_t)miss)));
+        }
+        report("int typed  ", miss ? "get miss" : "get hit", bench_now_ns() - start, n);
+    }
+
+    int_map_destroy(&map);
+}
+
+/* Keys "k<index>" for indices 0..2n-1 in one buffer */
+static char** make_string_keys(size_t count, char** storage) {
+    char** keys = malloc(count * sizeof(char*));
+    *storage = malloc(count * 16);
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = *storage + i * 16;
+        snprintf(keys[i], 16, "k%zu", (size_t)(uint32_t)bench_key(i));
+    }
+    return keys;
+}
+
+static void bench_generic_str(const char* label, const myrtx_hash_table_options_t* options,
+                              char** keys, size_t n) {
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(options);
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        int value = (int)i;
+        myrtx_hash_table_put(table, keys[2 * i], 0, &value, sizeof(int));
+    }
+    report(label, "put", bench_now_ns() - start, n);
+
+    for (int miss = 0; miss <= 1; miss++) {
+        start = bench_now_ns();
+        for (size_t i = 0; i < n; i++) {
+            void* value;
+            BENCH_CONSUME(myrtx_hash_table_get(table, keys[2 * i + (size_t)miss], 0, &value, NULL));
+        }
+        report(label, miss ? "get miss" : "get hit", bench_now_ns() - start, n);
+    }
+
+    myrtx_hash_table_free(table, true, true);
+}
+
+static void bench_typed_str(char** keys, size_t n) {
+    str_map map;
+    str_map_init(&map, NULL, 0);
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        str_map_put(&map, keys[2 * i], (int)i);
+    }
+    report("str typed  ", "put", bench_now_ns() - start, n);
+
+    for (int miss = 0; miss <= 1; miss++) {
+        start = bench_now_ns();
+        for (size_t i = 0; i < n; i++) {
+            BENCH_CONSUME(str_map_get(&map, keys[2 * i + (size_t)miss]));
+        }
+        report("str typed  ", miss ? "get miss" : "get hit", bench_now_ns() - start, n);
+    }
+
+    str_map_destroy(&map);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 1000000;
+
+    myrtx_hash_table_options_t generic = {0};
+    myrtx_hash_table_options_t tuned = {0};
+    tuned.probing = MYRTX_HASH_PROBING_ROBIN_HOOD;
+    tuned.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+
+    printf("=== Typed hash map benchmark ===\n\n");
+
+    generic.hash_function = tuned.hash_function = myrtx_hash_integer;
+    generic.compare_function = tuned.compare_function = myrtx_compare_integer_keys;
+    bench_generic_int("int generic", &generic, n);
+    bench_generic_int("int rh+i   ", &tuned, n);
+    bench_typed_int(n);
+    printf("\n");
+
+    char* storage;
+    char** keys = make_string_keys(2 * n, &storage);
+    generic.hash_function = tuned.hash_function = myrtx_hash_string;
+    generic.compare_function = tuned.compare_function = myrtx_compare_string_keys;
+    bench_generic_str("str generic", &generic, keys, n);
+    bench_generic_str("str rh+i   ", &tuned, keys, n);
+    bench_typed_str(keys, n);
+    free(keys);
+    free(storage);
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file hashmap_cpp_bench.cpp
+ * @brief myrtx::hash_map against std::unordered_map
+ *
+ * Usage: hashmap_cpp_bench [entries]
+ *
+ * Puts, hits and misses on int -> int maps (default 1M entries).
+ */
+
+#include "bench.h"
+#include "myrtx/collections/hashmap.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+
+/* Bijective scramble so that keys are spread like real identifiers */
+static int bench_key(std::size_t i) {
+    return static_cast<int>(static_cast<uint32_t>(i) * 2654435761u);
+}
+
+static void report(const char* label, const char* op, uint64_t elapsed, std::size_t n) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s %s %zu", label, op, n);
+    bench_report(name, elapsed, n);
+}
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], NULL, 10)) : 1000000;
+
+    std::printf("=== C++ hash map benchmark ===\n\n");
+
+    {
+        myrtx::hash_map<int, int> map;
+        uint64_t start = bench_now_ns();
+        for (std::size_t i = 0; i < n; i++) {
+            map.put(bench_key(2 * i), static_cast<int>(i));
+        }
+        report("myrtx::hash_map   ", "put", bench_now_ns() - start, n);
+        for (int miss = 0; miss <= 1; miss++) {
+            start = bench_now_ns();
+            for (std::size_t i = 0; i < n; i++) {
+                BENCH_CONSUME(map.get(bench_key(2 * i + static_cast<std::size_t>(miss))));
+            }
+            report("myrtx::hash_map   ", miss ? "get miss" : "get hit", bench_now_ns() - start, n);
+        }
+    }
+
+    {
+        std::unordered_map<int, int> map;
+        uint64_t start = bench_now_ns();
+        for (std::size_t i = 0; i < n; i++) {
+            map[bench_key(2 * i)] = static_cast<int>(i);
+        }
+        report("std::unordered_map", "put", bench_now_ns() - start, n);
+        for (int miss = 0; miss <= 1; miss++) {
+            start = bench_now_ns();
+            for (std::size_t i = 0; i < n; i++) {
+                BENCH_CONSUME(map.count(bench_key(2 * i + static_cast<std::size_t>(miss))));
+            }
+            report("std::unordered_map", miss ? "get miss" : "get hit", bench_now_ns() - start, n);
+        }
+    }
+
+    return 0;
+}
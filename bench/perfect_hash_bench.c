@@ -0,0 +1,112 @@
+/**
+ * @file perfect_hash_bench.c
+ * @brief Build and lookup cost of the minimal perfect hash vs. a hash table
+ *
+ * Usage: perfect_hash_bench [keys]
+ *
+ * Builds a minimal perfect hash over @p keys (default 1000000) random
+ * 64-bit keys with 8-byte values for several gammas, and a Swiss table with
+ * inline storage over the same entries. Reports build time, bits per key of
+ * the function and the time of random hit lookups.
+ */
+
+#include "bench.h"
+#include "myrtx/collections/perfect_hash.h"
+#include <stdlib.h>
+
+#define BENCH_LOOKUPS 4000000
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 1000000;
+    if (count == 0) {
+        return 1;
+    }
+
+    uint64_t* keys = malloc(count * sizeof(uint64_t));
+    const void** key_pointers = malloc(count * sizeof(void*));
+    size_t* key_sizes = malloc(count * sizeof(size_t));
+    size_t* probes = malloc(BENCH_LOOKUPS * sizeof(size_t));
+    if (!keys || !key_pointers || !key_sizes || !probes) {
+        return 1;
+    }
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = next_random(&state);
+        key_pointers[i] = &keys[i];
+        key_sizes[i] = sizeof(uint64_t);
+    }
+    for (size_t i = 0; i < BENCH_LOOKUPS; i++) {
+        probes[i] = (size_t)(next_random(&state) % count);
+    }
+
+    printf("%zu keys, %d lookups\n\n", count, BENCH_LOOKUPS);
+
+    myrtx_hash_table_options_t table_options = {0};
+    table_options.hash64_function = myrtx_hash64_bytes;
+    table_options.compare_function = myrtx_compare_integer_keys;
+    table_options.probing = MYRTX_HASH_PROBING_SWISS;
+    table_options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+    uint64_t start = bench_now_ns();
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&table_options);
+    if (!table) {
+        return 1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        myrtx_hash_table_put(table, &keys[i], sizeof(uint64_t), &keys[i], sizeof(uint64_t));
+    }
+    printf("hash table    build %8.1f ms\n", (double)(bench_now_ns() - start) / 1e6);
+
+    uint64_t checksum = 0;
+    start = bench_now_ns();
+    for (size_t i = 0; i < BENCH_LOOKUPS; i++) {
+        void* value;
+        if (myrtx_hash_table_get(table, &keys[probes[i]], sizeof(uint64_t), &value, NULL)) {
+            checksum += *(const uint64_t*)value;
+        }
+    }
+    bench_report("  myrtx_hash_table_get", bench_now_ns() - start, BENCH_LOOKUPS);
+    myrtx_hash_table_free(table, true, true);
+
+    const double gammas[] = {1.0, 2.0, 4.0};
+    for (size_t g = 0; g < sizeof(gammas) / sizeof(gammas[0]); g++) {
+        myrtx_perfect_hash_options_t options = {0};
+        options.hash64_function = myrtx_hash64_bytes;
+        options.compare_function = myrtx_compare_integer_keys;
+        options.gamma = gammas[g];
+
+        start = bench_now_ns();
+        myrtx_perfect_hash_t* hash = myrtx_perfect_hash_build(&options, key_pointers, key_sizes,
+                                                              count, keys, sizeof(uint64_t));
+        uint64_t build_ns = bench_now_ns() - start;
+        if (!hash) {
+            return 1;
+        }
+        printf("gamma %.1f     build %8.1f ms, %.2f bits per key\n", gammas[g],
+               (double)build_ns / 1e6, myrtx_perfect_hash_bits_per_key(hash));
+
+        start = bench_now_ns();
+        for (size_t i = 0; i < BENCH_LOOKUPS; i++) {
+            const uint64_t* value =
+                myrtx_perfect_hash_get(hash, &keys[probes[i]], sizeof(uint64_t));
+            if (value) {
+                checksum += *value;
+            }
+        }
+        bench_report("  myrtx_perfect_hash_get", bench_now_ns() - start, BENCH_LOOKUPS);
+        myrtx_perfect_hash_free(hash);
+    }
+    BENCH_CONSUME(checksum);
+
+    free(keys);
+    free(key_pointers);
+    free(key_sizes);
+    free(probes);
+    return 0;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file scratch_pool_bench.c
+ * @brief Pooled scratch regions versus temporary markers on a shared arena
+ *
+ * Each iteration opens a scratch arena, allocates enough to spill past the
+ * first block, and closes it again. Marker-based scratch frees the spilled
+ * blocks on every close; pooled regions rewind and keep them.
+ */
+
+#include "bench.h"
+#include "myrtx/context/context.h"
+#include <stdlib.h>
+
+#define ITERATIONS 200000
+
+/* Allocate a working set of @p bytes in 4 KiB pieces */
+static void fill(myrtx_arena_t* arena, size_t bytes) {
+    for (size_t done = 0; done < bytes; done += 4096) {
+        BENCH_CONSUME(myrtx_arena_alloc(arena, 4096));
+    }
+}
+
+static void bench_markers(size_t bytes) {
+    myrtx_arena_t arena = {0};
+    myrtx_arena_init(&arena, MYRTX_SCRATCH_BLOCK_SIZE);
+    BENCH_CONSUME(myrtx_arena_alloc(&arena, 64));
+
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        myrtx_scratch_arena_t scratch;
+        myrtx_scratch_begin(&scratch, &arena);
+        fill(scratch.arena, bytes);
+        myrtx_scratch_end(&scratch);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    char name[64];
+    snprintf(name, sizeof(name), "temp markers, %zu KiB", bytes / 1024);
+    bench_report(name, elapsed, ITERATIONS);
+    myrtx_arena_free(&arena);
+}
+
+static void bench_pool(size_t bytes) {
+    myrtx_context_t* ctx = myrtx_context_create(NULL);
+
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        myrtx_scratch_arena_t scratch;
+        myrtx_context_scratch_begin(ctx, &scratch);
+        fill(scratch.arena, bytes);
+        myrtx_context_scratch_end(ctx, &scratch);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    char name[64];
+    snprintf(name, sizeof(name), "pooled regions, %zu KiB", bytes / 1024);
+    bench_report(name, elapsed, ITERATIONS);
+    myrtx_context_destroy(ctx);
+}
+
+int main(void) {
+    printf("=== Scratch pool benchmark (%d iterations) ===\n\n", ITERATIONS);
+
+    /* Within one block, then spilling into one and two extra blocks */
+    size_t sizes[] = {4 * 1024, 96 * 1024, 160 * 1024};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench_markers(sizes[i]);
+        bench_pool(sizes[i]);
+    }
+
+    return 0;
+}
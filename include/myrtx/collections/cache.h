@@ -0,0 +1,179 @@
+/**
+ * @file cache.h
+ * @brief Bounded key/value cache with LRU or CLOCK eviction
+ *
+ * A myrtx_cache_t keeps at most a fixed number of entries and/or bytes and
+ * evicts the least recently used entry (LRU) or one whose reference bit is
+ * clear (CLOCK) to make room. It needs one hash table lookup per access:
+ * the table maps each key to a slot in an array of cache nodes, and the
+ * recency list or reference bits live in those nodes.
+ */
+
+#ifndef MYRTX_CACHE_H
+#define MYRTX_CACHE_H
+
+#include "myrtx/collections/hash_table.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opaque cache
+ */
+typedef struct myrtx_cache_t myrtx_cache_t;
+
+/**
+ * @brief Eviction policies
+ */
+typedef enum {
+    MYRTX_CACHE_LRU = 0, /**< Evict the least recently used entry (default) */
+    MYRTX_CACHE_CLOCK    /**< Second chance: a clock hand skips and clears referenced entries */
+} myrtx_cache_policy_t;
+
+/**
+ * @brief Called for every entry that leaves the cache
+ *
+ * Runs on eviction, remove, clear and free, and for the old value when put
+ * replaces one. The key and value are the cache's copies and are released
+ * after the callback returns; use it to recycle memory the value refers to.
+ *
+ * @param key Key of the entry
+ * @param key_size Key size in bytes
+ * @param value Value of the entry
+ * @param value_size Value size in bytes
+ * @param user_data The options' user_data
+ */
+typedef void (*myrtx_cache_evict_function)(const void* key, size_t key_size, void* value,
+                                           size_t value_size, void* user_data);
+
+/**
+ * @brief Options for myrtx_cache_create()
+ *
+ * Zero-initialize and set the fields you need. The hash and compare fields
+ * mean the same as in myrtx_hash_table_options_t. At least one of
+ * max_entries and max_bytes must be set.
+ */
+typedef struct myrtx_cache_options {
+    myrtx_arena_t* arena;                        /**< Optional arena (NULL for malloc/free) */
+    myrtx_hash_function hash_function;           /**< 32-bit hash function for keys */
+    myrtx_key_compare_function compare_function; /**< Compare function for keys (required) */
+    myrtx_hash64_function hash64_function;       /**< Seeded 64-bit hash (instead of hash_function) */
+    uint64_t seed;                               /**< Seed for hash64_function (0 for a random seed) */
+    myrtx_hash_probing_t probing;                /**< Probing strategy of the key table */
+    myrtx_cache_policy_t policy;                 /**< Eviction policy */
+    size_t max_entries;                          /**< Entry budget (0 for no limit) */
+    size_t max_bytes;                            /**< Budget of key plus value bytes (0 for no limit) */
+    myrtx_cache_evict_function evict_function;   /**< Optional eviction callback */
+    void* user_data;                             /**< Passed to evict_function */
+} myrtx_cache_options_t;
+
+/**
+ * @brief Hit, miss and eviction counters of a cache
+ */
+typedef struct myrtx_cache_stats {
+    uint64_t hits;      /**< myrtx_cache_get calls that found their key */
+    uint64_t misses;    /**< myrtx_cache_get calls that did not */
+    uint64_t evictions; /**< Entries evicted to stay within the budget */
+    size_t entries;     /**< Current number of entries */
+    size_t bytes;       /**< Current key plus value bytes */
+} myrtx_cache_stats_t;
+
+/**
+ * @brief Creates a cache
+ *
+ * @param options Options
+ * @return Pointer to the new cache, or NULL on error or invalid options
+ */
+myrtx_cache_t* myrtx_cache_create(const myrtx_cache_options_t* options);
+
+/**
+ * @brief Frees a cache, passing every entry to the eviction callback
+ *
+ * @param cache Cache to free
+ */
+void myrtx_cache_free(myrtx_cache_t* cache);
+
+/**
+ * @brief Stores a copy of a key and value, evicting entries as needed
+ *
+ * The entry counts as most recently used. Entries are evicted after it is
+ * stored, so the new entry itself is never evicted by this call.
+ *
+ * @param cache Cache
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @param value Value
+ * @param value_size Value size in bytes
+ * @return true on success, false on invalid arguments, out of memory or an
+ *         entry larger than max_bytes
+ */
+bool myrtx_cache_put(myrtx_cache_t* cache, const void* key, size_t key_size,
+                     const void* value, size_t value_size);
+
+/**
+ * @brief Looks up a key and marks it as recently used
+ *
+ * Counts a hit or a miss.
+ *
+ * @param cache Cache
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @param[out] value_size Optional; receives the value size
+ * @return Pointer to the cached value, aligned to 8 bytes and valid until
+ *         the next put, remove or clear, or NULL on a miss
+ */
+void* myrtx_cache_get(myrtx_cache_t* cache, const void* key, size_t key_size,
+                      size_t* value_size);
+
+/**
+ * @brief Checks whether a key is cached, without counting or marking it
+ *
+ * @param cache Cache
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @return true if the key is cached
+ */
+bool myrtx_cache_contains_key(const myrtx_cache_t* cache, const void* key, size_t key_size);
+
+/**
+ * @brief Removes a key
+ *
+ * @param cache Cache
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @return true if the key was cached
+ */
+bool myrtx_cache_remove(myrtx_cache_t* cache, const void* key, size_t key_size);
+
+/**
+ * @brief Removes all entries; the counters are kept
+ *
+ * @param cache Cache
+ */
+void myrtx_cache_clear(myrtx_cache_t* cache);
+
+/**
+ * @brief Number of cached entries
+ *
+ * @param cache Cache
+ * @return Number of entries
+ */
+size_t myrtx_cache_size(const myrtx_cache_t* cache);
+
+/**
+ * @brief Reads the counters and current usage of a cache
+ *
+ * @param cache Cache
+ * @param[out] stats Receives the counters
+ */
+void myrtx_cache_stats(const myrtx_cache_t* cache, myrtx_cache_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MYRTX_CACHE_H */
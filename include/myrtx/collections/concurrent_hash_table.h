@@ -0,0 +1,150 @@
+/**
+ * @file concurrent_hash_table.h
+ * @brief Sharded hash table for concurrent readers and writers
+ *
+ * The keys are spread over a power-of-two number of shards by the high
+ * bits of their 64-bit hash. Each shard is a Robin Hood hash table with
+ * inline storage in its own arena, guarded by a mutex for writers and a
+ * sequence counter for readers. Readers take no lock: they probe the shard
+ * optimistically, copy the value out and retry if a writer changed the
+ * shard meanwhile. Writers to different shards never contend.
+ */
+
+#ifndef MYRTX_CONCURRENT_HASH_TABLE_H
+#define MYRTX_CONCURRENT_HASH_TABLE_H
+
+#include "myrtx/collections/hash_table.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opaque concurrent hash table
+ */
+typedef struct myrtx_concurrent_hash_table_t myrtx_concurrent_hash_table_t;
+
+/** Shards used when options.shard_count is 0 */
+#define MYRTX_CONCURRENT_HASH_DEFAULT_SHARDS 64
+
+/** Largest supported shard count */
+#define MYRTX_CONCURRENT_HASH_MAX_SHARDS 65536
+
+/**
+ * @brief Options for myrtx_concurrent_hash_table_create()
+ *
+ * Zero-initialize and set the fields you need; zero selects the defaults.
+ */
+typedef struct myrtx_concurrent_hash_table_options {
+    size_t shard_count;                          /**< Power of two (0 for the default) */
+    size_t initial_capacity;                     /**< Expected entries over all shards (0 for default) */
+    myrtx_hash_function hash_function;           /**< 32-bit hash function for keys */
+    myrtx_hash64_function hash64_function;       /**< Seeded 64-bit hash (instead of hash_function) */
+    uint64_t seed;                               /**< Seed for hash64_function (0 for a random seed) */
+    myrtx_key_compare_function compare_function; /**< Compare function for keys (required) */
+} myrtx_concurrent_hash_table_options_t;
+
+/**
+ * @brief Creates a concurrent hash table
+ *
+ * Exactly one of hash_function and hash64_function must be set. All shards
+ * share one seed. Readers may call compare_function on a key that a writer
+ * is replacing, so it must read no more than the sizes it is given.
+ *
+ * @param options Table options
+ * @return Pointer to the new table, or NULL on error or invalid options
+ */
+myrtx_concurrent_hash_table_t* myrtx_concurrent_hash_table_create(
+    const myrtx_concurrent_hash_table_options_t* options);
+
+/**
+ * @brief Frees a concurrent hash table and all its keys and values
+ *
+ * No other thread may use the table during or after this call.
+ *
+ * @param table Table to free
+ */
+void myrtx_concurrent_hash_table_free(myrtx_concurrent_hash_table_t* table);
+
+/**
+ * @brief Inserts or replaces an entry; key and value are copied
+ *
+ * @param table Table
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @param value Value
+ * @param value_size Value size in bytes
+ * @return true on success, false on invalid arguments or out of memory
+ */
+bool myrtx_concurrent_hash_table_put(myrtx_concurrent_hash_table_t* table,
+                                     const void* key, size_t key_size,
+                                     const void* value, size_t value_size);
+
+/**
+ * @brief Copies the value of a key out of the table
+ *
+ * Lock-free unless writers keep changing the key's shard, in which case
+ * the lookup falls back to the shard lock. Copies at most @p value_capacity
+ * bytes; @p value_size receives the full size of the stored value.
+ *
+ * @param table Table
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @param value_out Buffer for the value (may be NULL if value_capacity is 0)
+ * @param value_capacity Size of @p value_out in bytes
+ * @param value_size Optional output for the stored value size
+ * @return true if the key was found
+ */
+bool myrtx_concurrent_hash_table_get(const myrtx_concurrent_hash_table_t* table,
+                                     const void* key, size_t key_size,
+                                     void* value_out, size_t value_capacity,
+                                     size_t* value_size);
+
+/**
+ * @brief Checks whether a key is present, without locking
+ *
+ * @param table Table
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @return true if the key was found
+ */
+bool myrtx_concurrent_hash_table_contains_key(const myrtx_concurrent_hash_table_t* table,
+                                              const void* key, size_t key_size);
+
+/**
+ * @brief Removes an entry
+ *
+ * @param table Table
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @return true if the key was found and removed
+ */
+bool myrtx_concurrent_hash_table_remove(myrtx_concurrent_hash_table_t* table,
+                                        const void* key, size_t key_size);
+
+/**
+ * @brief Number of entries
+ *
+ * Locks each shard in turn, so concurrent writes may or may not be counted.
+ *
+ * @param table Table
+ * @return Number of entries
+ */
+size_t myrtx_concurrent_hash_table_size(const myrtx_concurrent_hash_table_t* table);
+
+/**
+ * @brief Number of shards
+ *
+ * @param table Table
+ * @return Shard count
+ */
+size_t myrtx_concurrent_hash_table_shard_count(const myrtx_concurrent_hash_table_t* table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MYRTX_CONCURRENT_HASH_TABLE_H */
@@ -0,0 +1,107 @@
+/**
+ * @file hash_file.h
+ * @brief Read-only hash table files that are looked up in place via mmap
+ *
+ * myrtx_hash_file_write() stores the entries of a myrtx_hash_table_t in a
+ * position-independent file: a header, an open-addressing slot array and
+ * the key/value records, linked by file offsets instead of pointers.
+ * myrtx_hash_file_open() maps such a file read-only and answers lookups
+ * directly from the mapping. Opening does not read or copy the entries, so
+ * it takes constant time, and processes that map the same file share its
+ * pages.
+ *
+ * Lookups in a file hash the key bytes with myrtx_hash64_bytes() and compare
+ * them with memcmp(), whatever functions the source table used. Keys must
+ * therefore be equal exactly when their bytes are equal. Files use the byte
+ * order of the machine that wrote them; a file from a machine with another
+ * byte order is rejected.
+ */
+
+#ifndef MYRTX_HASH_FILE_H
+#define MYRTX_HASH_FILE_H
+
+#include "myrtx/collections/hash_table.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opaque handle of a mapped hash table file
+ */
+typedef struct myrtx_hash_file_t myrtx_hash_file_t;
+
+/**
+ * @brief Writes all entries of a table to a hash table file
+ *
+ * Replaces @p path if it exists. Processes that have the old file mapped
+ * read garbage when it is overwritten in place, so write to a new path and
+ * rename it over the old one instead.
+ *
+ * @param table Source table; keys and values may each be up to 4 GB
+ * @param path Path of the file to write
+ * @return true on success, false on invalid arguments or I/O errors
+ */
+bool myrtx_hash_file_write(const myrtx_hash_table_t* table, const char* path);
+
+/**
+ * @brief Maps a hash table file read-only
+ *
+ * Checks the header and the layout of the file; a record that turns out to
+ * be out of bounds during a lookup is treated as missing.
+ *
+ * @param path Path of a file written by myrtx_hash_file_write()
+ * @return Handle of the mapped file, or NULL if it cannot be mapped or is
+ *         not a valid hash table file
+ */
+myrtx_hash_file_t* myrtx_hash_file_open(const char* path);
+
+/**
+ * @brief Unmaps a hash table file
+ *
+ * Value pointers returned by myrtx_hash_file_get() become invalid.
+ *
+ * @param file Handle to close (may be NULL)
+ */
+void myrtx_hash_file_close(myrtx_hash_file_t* file);
+
+/**
+ * @brief Looks up a key in a mapped file
+ *
+ * @param file Mapped file
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @param[out] value_out Receives a pointer to the value inside the mapping,
+ *             aligned to 8 bytes and valid until the file is closed
+ * @param[out] value_size_out Optional; receives the value size
+ * @return true if the key was found
+ */
+bool myrtx_hash_file_get(const myrtx_hash_file_t* file, const void* key, size_t key_size,
+                         const void** value_out, size_t* value_size_out);
+
+/**
+ * @brief Checks whether a key is in a mapped file
+ *
+ * @param file Mapped file
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @return true if the key was found
+ */
+bool myrtx_hash_file_contains_key(const myrtx_hash_file_t* file, const void* key,
+                                  size_t key_size);
+
+/**
+ * @brief Number of entries in a mapped file
+ *
+ * @param file Mapped file
+ * @return Number of entries
+ */
+size_t myrtx_hash_file_size(const myrtx_hash_file_t* file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MYRTX_HASH_FILE_H */
@@ -0,0 +1,133 @@
+/**
+ * @file hash_multimap.h
+ * @brief Hash map with any number of fixed-size values per key
+ *
+ * Each key owns one contiguous array of values, which doubles as it fills.
+ * The array's pointer and counts sit inline in the key's table entry, so a
+ * key with many values costs one table entry and one array, and looking up
+ * all values of a key is a single probe. Built on myrtx_hash_table_t; all
+ * probing strategies, flags and hash options apply unchanged.
+ */
+
+#ifndef MYRTX_HASH_MULTIMAP_H
+#define MYRTX_HASH_MULTIMAP_H
+
+#include "myrtx/collections/hash_table.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opaque hash multimap
+ */
+typedef struct myrtx_hash_multimap_t myrtx_hash_multimap_t;
+
+/**
+ * @brief Iterator over the keys of a multimap and their values
+ */
+typedef myrtx_hash_table_iter_t myrtx_hash_multimap_iter_t;
+
+/**
+ * @brief Creates a multimap
+ *
+ * Takes the same options as myrtx_hash_table_create_ex();
+ * MYRTX_HASH_TABLE_INLINE_STORAGE is always set, so the multimap owns
+ * copies of its keys and values.
+ *
+ * @param options Table options
+ * @param value_size Size of every value in bytes (greater than 0)
+ * @return Pointer to the new multimap, or NULL on error or invalid options
+ */
+myrtx_hash_multimap_t* myrtx_hash_multimap_create(const myrtx_hash_table_options_t* options,
+                                                  size_t value_size);
+
+/**
+ * @brief Frees a multimap with its keys and values (in arena mode the memory
+ *        stays in the arena)
+ *
+ * @param map Multimap to free
+ */
+void myrtx_hash_multimap_free(myrtx_hash_multimap_t* map);
+
+/**
+ * @brief Appends a value to the values of a key
+ *
+ * @param map Multimap
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @param value Value of the map's value size
+ * @return true on success, false on invalid arguments or out of memory
+ */
+bool myrtx_hash_multimap_add(myrtx_hash_multimap_t* map, const void* key, size_t key_size,
+                             const void* value);
+
+/**
+ * @brief All values of a key, in the order they were added
+ *
+ * The array stays valid until the multimap is next modified.
+ *
+ * @param map Multimap
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @param[out] count Optional; receives the number of values (0 if missing)
+ * @return Pointer to the first value, or NULL if the key is missing
+ */
+const void* myrtx_hash_multimap_get(const myrtx_hash_multimap_t* map, const void* key,
+                                    size_t key_size, size_t* count);
+
+/**
+ * @brief Removes a key with all its values
+ *
+ * @param map Multimap
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @return true if the key was present
+ */
+bool myrtx_hash_multimap_remove(myrtx_hash_multimap_t* map, const void* key, size_t key_size);
+
+/**
+ * @brief Number of distinct keys
+ *
+ * @param map Multimap
+ * @return Number of keys
+ */
+size_t myrtx_hash_multimap_key_count(const myrtx_hash_multimap_t* map);
+
+/**
+ * @brief Number of values over all keys
+ *
+ * @param map Multimap
+ * @return Number of values
+ */
+size_t myrtx_hash_multimap_value_count(const myrtx_hash_multimap_t* map);
+
+/**
+ * @brief Positions an iterator before the first key of a multimap
+ *
+ * @param iter Iterator
+ * @param map Multimap; it may not be modified while iterating
+ */
+void myrtx_hash_multimap_iter_init(myrtx_hash_multimap_iter_t* iter,
+                                   const myrtx_hash_multimap_t* map);
+
+/**
+ * @brief Advances to the next key
+ *
+ * @param iter Iterator
+ * @param[out] key Optional; receives the key
+ * @param[out] key_size Optional; receives the key size
+ * @param[out] values Optional; receives the key's value array
+ * @param[out] count Optional; receives the number of values
+ * @return true if a key was returned, false after the last one
+ */
+bool myrtx_hash_multimap_iter_next(myrtx_hash_multimap_iter_t* iter, const void** key,
+                                   size_t* key_size, const void** values, size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MYRTX_HASH_MULTIMAP_H */
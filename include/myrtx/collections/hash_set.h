@@ -0,0 +1,120 @@
+/**
+ * @file hash_set.h
+ * @brief Hash set of keys without values
+ *
+ * A set is a myrtx_hash_table_t with inline storage whose entries carry no
+ * value, behind an API with add/contains/remove and no value arguments. It
+ * uses the same slots as any inline table, so it takes as much memory as a
+ * table with a small dummy value. All probing strategies, flags and hash
+ * options of myrtx_hash_table_create_ex() apply unchanged.
+ */
+
+#ifndef MYRTX_HASH_SET_H
+#define MYRTX_HASH_SET_H
+
+#include "myrtx/collections/hash_table.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opaque hash set
+ */
+typedef struct myrtx_hash_set_t myrtx_hash_set_t;
+
+/**
+ * @brief Iterator over the keys of a set
+ */
+typedef myrtx_hash_table_iter_t myrtx_hash_set_iter_t;
+
+/**
+ * @brief Creates a hash set
+ *
+ * Takes the same options as myrtx_hash_table_create_ex();
+ * MYRTX_HASH_TABLE_INLINE_STORAGE is always set, so the set owns copies of
+ * its keys.
+ *
+ * @param options Table options
+ * @return Pointer to the new set, or NULL on error or invalid options
+ */
+myrtx_hash_set_t* myrtx_hash_set_create(const myrtx_hash_table_options_t* options);
+
+/**
+ * @brief Frees a set and its keys (in arena mode the memory stays in the arena)
+ *
+ * @param set Set to free
+ */
+void myrtx_hash_set_free(myrtx_hash_set_t* set);
+
+/**
+ * @brief Adds a key unless it is already present
+ *
+ * @param set Set
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @param[out] added Optional; set to whether the key was new
+ * @return true on success, false on invalid arguments or out of memory
+ */
+bool myrtx_hash_set_add(myrtx_hash_set_t* set, const void* key, size_t key_size, bool* added);
+
+/**
+ * @brief Checks whether a key is in the set
+ *
+ * @param set Set
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @return true if the key is present
+ */
+bool myrtx_hash_set_contains(const myrtx_hash_set_t* set, const void* key, size_t key_size);
+
+/**
+ * @brief Removes a key
+ *
+ * @param set Set
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @return true if the key was present
+ */
+bool myrtx_hash_set_remove(myrtx_hash_set_t* set, const void* key, size_t key_size);
+
+/**
+ * @brief Number of keys in the set
+ *
+ * @param set Set
+ * @return Number of keys
+ */
+size_t myrtx_hash_set_size(const myrtx_hash_set_t* set);
+
+/**
+ * @brief Removes all keys
+ *
+ * @param set Set
+ */
+void myrtx_hash_set_clear(myrtx_hash_set_t* set);
+
+/**
+ * @brief Positions an iterator before the first key of a set
+ *
+ * @param iter Iterator
+ * @param set Set; no keys may be added or removed while iterating
+ */
+void myrtx_hash_set_iter_init(myrtx_hash_set_iter_t* iter, const myrtx_hash_set_t* set);
+
+/**
+ * @brief Advances to the next key
+ *
+ * @param iter Iterator
+ * @param[out] key Optional; receives the key
+ * @param[out] key_size Optional; receives the key size
+ * @return true if a key was returned, false after the last one
+ */
+bool myrtx_hash_set_iter_next(myrtx_hash_set_iter_t* iter, const void** key, size_t* key_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MYRTX_HASH_SET_H */
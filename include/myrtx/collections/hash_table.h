@@ -33,6 +33,16 @@ typedef struct myrtx_hash_table_t myrtx_hash_table_t;
  */
 typedef uint32_t (*myrtx_hash_function)(const void* key, size_t key_size);
 
+/**
+ * @brief Seeded 64-bit hash function
+ *
+ * @param key Pointer to the key
+ * @param key_size Size of the key in bytes
+ * @param seed Per-table seed
+ * @return 64-bit hash value
+ */
+typedef uint64_t (*myrtx_hash64_function)(const void* key, size_t key_size, uint64_t seed);
+
 /**
  * @brief Schlüsselvergleichsfunktion
  * 
@@ -45,6 +55,82 @@ typedef uint32_t (*myrtx_hash_function)(const void* key, size_t key_size);
 typedef bool (*myrtx_key_compare_function)(const void* key1, size_t key1_size, 
                                           const void* key2, size_t key2_size);
 
+/**
+ * @brief Slot placement strategies
+ */
+typedef enum myrtx_hash_probing {
+    MYRTX_HASH_PROBING_LINEAR = 0, /**< Linear probing over full entries, tombstones on remove (default) */
+    MYRTX_HASH_PROBING_SWISS,      /**< Swiss table: 1-byte control array matched a group of slots at a time */
+    MYRTX_HASH_PROBING_ROBIN_HOOD, /**< Robin Hood linear probing with backward-shift removal, no tombstones */
+    MYRTX_HASH_PROBING_COMPACT     /**< Small index array over dense entries kept in insertion order */
+} myrtx_hash_probing_t;
+
+/**
+ * @brief Flags for myrtx_hash_table_options_t.flags
+ */
+typedef enum myrtx_hash_table_flags {
+    /**
+     * Keep keys and values of up to 16 bytes inside the slot and store a
+     * larger key together with a larger value in one allocation. The table
+     * owns all key/value storage and frees it itself; the free_key(s) and
+     * free_value(s) arguments are ignored. Value pointers returned by
+     * myrtx_hash_table_get() are valid only until the table is next modified.
+     */
+    MYRTX_HASH_TABLE_INLINE_STORAGE = 1u << 0,
+    /**
+     * Grow incrementally instead of rehashing every entry at once. When the
+     * table fills up, new arrays are allocated next to the old ones, and
+     * every following put or remove moves a bounded number of old slots
+     * (MYRTX_HASH_MIGRATE_SLOTS). Lookups check both arrays until the
+     * move is complete. This bounds the worst-case put latency at the cost
+     * of holding both arrays for a while. MYRTX_HASH_PROBING_COMPACT tables
+     * keep insertion order while growing this way, but still squeeze out
+     * removal holes in one pass when the full dense array is at least half
+     * holes.
+     */
+    MYRTX_HASH_TABLE_INCREMENTAL_RESIZE = 1u << 1,
+    /**
+     * Tag every slot with the generation of the table it was written in.
+     * myrtx_hash_table_clear() then only advances the generation, and
+     * slots from earlier generations read as empty, instead of marking
+     * every slot empty one by one. After MYRTX_HASH_TABLE_GENERATIONS_MAX
+     * clears the generation wraps around and one clear sweeps the slots.
+     * Clearing stays O(1) only while no entry has a key or value stored
+     * outside its slot (e.g. INLINE_STORAGE with small keys and values),
+     * since those buffers are released one by one. Swiss tables still
+     * reset their control bytes (one per slot) and compact tables their
+     * index; linear and Robin Hood tables touch no slot at all. Lookups
+     * pay one extra comparison per slot examined.
+     */
+    MYRTX_HASH_TABLE_GENERATIONS = 1u << 2
+} myrtx_hash_table_flags_t;
+
+/**
+ * @brief Number of slot generations; every this many clears of a GENERATIONS table, one sweeps the slots
+ */
+#define MYRTX_HASH_TABLE_GENERATIONS_MAX 1024
+
+/**
+ * @brief Old slots moved per put or remove during an incremental resize
+ */
+#define MYRTX_HASH_MIGRATE_SLOTS 64
+
+/**
+ * @brief Options for myrtx_hash_table_create_ex()
+ *
+ * Zero-initialize and set the fields you need; zero selects the defaults.
+ */
+typedef struct myrtx_hash_table_options {
+    myrtx_arena_t* arena;                        /**< Optional arena (NULL for malloc/free) */
+    size_t initial_capacity;                     /**< Initial number of slots (0 for default) */
+    myrtx_hash_function hash_function;           /**< 32-bit hash function for keys */
+    myrtx_key_compare_function compare_function; /**< Compare function for keys (required) */
+    myrtx_hash_probing_t probing;                /**< Slot placement strategy */
+    unsigned int flags;                          /**< myrtx_hash_table_flags_t bits */
+    myrtx_hash64_function hash64_function;       /**< Seeded 64-bit hash (instead of hash_function) */
+    uint64_t seed;                               /**< Seed for hash64_function (0 for a random seed) */
+} myrtx_hash_table_options_t;
+
 /**
  * @brief Erstellt eine neue Hash-Tabelle
  * 
@@ -59,6 +145,30 @@ myrtx_hash_table_t* myrtx_hash_table_create(myrtx_arena_t* arena,
                                            myrtx_hash_function hash_function, 
                                            myrtx_key_compare_function compare_function);
 
+/**
+ * @brief Creates a hash table with explicit options
+ * 
+ * All other myrtx_hash_table_* functions work the same on every probing
+ * strategy. The Swiss strategy keeps 7 bits of each hash in a separate
+ * control byte array and compares 16 slots per step with SSE2 or NEON
+ * (8 with the portable SWAR fallback), so most probes touch only the control
+ * bytes and one entry. The Robin Hood strategy keeps each run of entries
+ * sorted by home slot and shifts entries back on remove, so it never leaves
+ * tombstones and delete-heavy workloads do not grow the table.
+ * 
+ * Exactly one of hash_function and hash64_function must be set. A seeded
+ * hash64_function such as myrtx_hash64_bytes() is recommended for keys that
+ * come from untrusted input. Without an explicit seed, each table draws its
+ * own from myrtx_hash_random_seed(). Entries always store a 64-bit hash.
+ * 
+ * Updating an existing key writes the new value over the old one in place
+ * whenever it is no larger than the stored value, in every mode.
+ * 
+ * @param options Table options
+ * @return Pointer to the new table, or NULL on error or invalid options
+ */
+myrtx_hash_table_t* myrtx_hash_table_create_ex(const myrtx_hash_table_options_t* options);
+
 /**
  * @brief Gibt eine Hash-Tabelle frei
  * 
@@ -102,6 +212,69 @@ bool myrtx_hash_table_get(const myrtx_hash_table_t* table,
                          void** value_out, 
                          size_t* value_size_out);
 
+/**
+ * @brief Merges a new value into the stored value of an existing key
+ *
+ * Called by myrtx_hash_table_upsert() and, for keys in both tables, by
+ * myrtx_hash_table_merge(). Updates @p stored_value in place; its size
+ * cannot change.
+ *
+ * @param stored_value Value stored in the table
+ * @param stored_size Size of the stored value in bytes
+ * @param value Value passed to myrtx_hash_table_upsert(), or the value in
+ *              the source table of myrtx_hash_table_merge()
+ * @param value_size Size of @p value in bytes
+ * @param user_data Pointer passed to the calling function
+ */
+typedef void (*myrtx_hash_merge_function)(void* stored_value, size_t stored_size,
+                                          const void* value, size_t value_size,
+                                          void* user_data);
+
+/**
+ * @brief Returns the stored value of a key, inserting a default first if missing
+ *
+ * Hashes and probes once. If the key is missing, a copy of @p default_value
+ * is stored under it. The returned pointer may be used to update the value
+ * in place (without changing its size) until the table is next modified.
+ *
+ * @param table Hash table
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @param default_value Value to store if the key is missing
+ * @param value_size Size of @p default_value in bytes
+ * @param[out] inserted Optional; set to whether the key was inserted
+ * @return Pointer to the stored value, or NULL on error
+ */
+void* myrtx_hash_table_get_or_insert(myrtx_hash_table_t* table,
+                                     const void* key,
+                                     size_t key_size,
+                                     const void* default_value,
+                                     size_t value_size,
+                                     bool* inserted);
+
+/**
+ * @brief Inserts a value, or merges it into the value already stored
+ *
+ * Hashes and probes once. A missing key is stored with a copy of @p value;
+ * for an existing key, @p merge updates the stored value in place.
+ *
+ * @param table Hash table
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @param value Value to insert or merge
+ * @param value_size Size of @p value in bytes
+ * @param merge Merge function for existing keys
+ * @param user_data Passed through to @p merge
+ * @return true on success, false on error
+ */
+bool myrtx_hash_table_upsert(myrtx_hash_table_t* table,
+                             const void* key,
+                             size_t key_size,
+                             const void* value,
+                             size_t value_size,
+                             myrtx_hash_merge_function merge,
+                             void* user_data);
+
 /**
  * @brief Prüft, ob ein Schlüssel in der Hash-Tabelle existiert
  * 
@@ -114,6 +287,121 @@ bool myrtx_hash_table_contains_key(const myrtx_hash_table_t* table,
                                   const void* key, 
                                   size_t key_size);
 
+/**
+ * @brief Looks up many keys at once
+ *
+ * Hashes the keys a few at a time and prefetches their first slots before
+ * probing any of them, so the cache misses of independent lookups overlap
+ * instead of being paid one after another. Equivalent to calling
+ * myrtx_hash_table_get() for each key.
+ *
+ * @param table Hash table
+ * @param count Number of keys
+ * @param keys Array of @p count key pointers (none NULL)
+ * @param key_sizes Array of @p count key sizes (0 for a null-terminated
+ *                  string), or NULL if all keys are strings
+ * @param[out] values_out Receives each key's value, or NULL for a missing key
+ * @param[out] value_sizes_out Optional; receives each value size, 0 if missing
+ * @return Number of keys found
+ */
+size_t myrtx_hash_table_get_batch(const myrtx_hash_table_t* table,
+                                  size_t count,
+                                  const void* const* keys,
+                                  const size_t* key_sizes,
+                                  void** values_out,
+                                  size_t* value_sizes_out);
+
+/**
+ * @brief Inserts or updates many entries at once
+ *
+ * Same result as calling myrtx_hash_table_put() for each entry in order,
+ * with the first slots of each group of keys prefetched as in
+ * myrtx_hash_table_get_batch(). Stops at the first entry that cannot be
+ * stored.
+ *
+ * @param table Hash table
+ * @param count Number of entries
+ * @param keys Array of @p count key pointers (none NULL)
+ * @param key_sizes Array of @p count key sizes (0 for a null-terminated
+ *                  string), or NULL if all keys are strings
+ * @param values Array of @p count value pointers (none NULL)
+ * @param value_sizes Array of @p count value sizes
+ * @return Number of entries stored; less than @p count if entry
+ *         [return value] failed
+ */
+size_t myrtx_hash_table_put_batch(myrtx_hash_table_t* table,
+                                  size_t count,
+                                  const void* const* keys,
+                                  const size_t* key_sizes,
+                                  const void* const* values,
+                                  const size_t* value_sizes);
+
+/**
+ * @brief Builds a hash table from many entries on several threads
+ *
+ * Creates a table as myrtx_hash_table_create_ex() would, sized up front so
+ * that it holds all @p count entries without growing, and stores the
+ * entries with the same result as myrtx_hash_table_put() in input order:
+ * for a key given twice, the later value wins.
+ *
+ * The slot array is split into ranges of home slots. Each thread hashes
+ * and sorts a share of the input by range, then stores the entries of its
+ * own ranges, touching no other thread's slots. The few entries whose
+ * probe runs past the end of their range are stored by the calling thread
+ * afterwards. With one thread, for small tables and for
+ * MYRTX_HASH_PROBING_COMPACT (whose entries are kept in insertion order),
+ * the entries are put one after another into the presized table.
+ *
+ * Arena-backed tables take a lock around every key or value buffer
+ * allocation; MYRTX_HASH_TABLE_INLINE_STORAGE with small keys and values
+ * avoids it.
+ *
+ * @param options Options as for myrtx_hash_table_create_ex()
+ * @param count Number of entries
+ * @param keys Array of @p count key pointers (none NULL)
+ * @param key_sizes Array of @p count key sizes (0 for a null-terminated
+ *                  string), or NULL if all keys are strings
+ * @param values Array of @p count value pointers (none NULL)
+ * @param value_sizes Array of @p count value sizes
+ * @param threads Number of threads including the caller (0 counts as 1)
+ * @return New hash table or NULL on error
+ */
+myrtx_hash_table_t* myrtx_hash_table_build_parallel(const myrtx_hash_table_options_t* options,
+                                                    size_t count,
+                                                    const void* const* keys,
+                                                    const size_t* key_sizes,
+                                                    const void* const* values,
+                                                    const size_t* value_sizes,
+                                                    unsigned int threads);
+
+/**
+ * @brief Moves all entries of one hash table into another
+ *
+ * The entries change tables with their key and value buffers as they are;
+ * nothing is copied. Stored hashes are reused if both tables use the same
+ * hash function and seed. @p dst grows at most once, before the first
+ * entry moves. Expiry times move along; entries of @p src that have
+ * already expired are dropped.
+ *
+ * For a key in both tables, @p merge updates the value in @p dst and the
+ * entry of @p src is freed. Without a merge function, the entry of @p src
+ * replaces the one in @p dst as a put would.
+ *
+ * Both tables must use the same arena (or none) and agree on
+ * MYRTX_HASH_TABLE_INLINE_STORAGE. Afterwards @p src is empty.
+ *
+ * @param dst Hash table receiving the entries
+ * @param src Hash table giving them up
+ * @param merge Merge function for keys in both tables, or NULL
+ * @param user_data Passed through to @p merge
+ * @return true on success; false if the tables are incompatible or memory
+ *         ran out, in which case some entries may already have moved
+ */
+bool myrtx_hash_table_merge(myrtx_hash_table_t* dst,
+                            myrtx_hash_table_t* src,
+                            myrtx_hash_merge_function merge,
+                            void* user_data);
+
 /**
  * @brief Entfernt einen Eintrag aus der Hash-Tabelle
  * 
@@ -130,17 +418,221 @@ bool myrtx_hash_table_remove(myrtx_hash_table_t* table,
                             bool free_key, 
                             bool free_value);
 
+/**
+ * @brief The hash a table computes for a key
+ *
+ * The value to pass to the _with_hash functions. Tables created with the
+ * same hash function (and, for a 64-bit hash function, the same explicit
+ * seed) compute the same hash, so one call serves lookups in all of them.
+ *
+ * @param table Hash table
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @return 64-bit hash as stored in the table's entries
+ */
+uint64_t myrtx_hash_table_hash(const myrtx_hash_table_t* table, const void* key, size_t key_size);
+
+/**
+ * @brief myrtx_hash_table_put() with a precomputed hash
+ *
+ * @p hash must equal myrtx_hash_table_hash(table, key, key_size); a
+ * different value corrupts lookups of this key. Passing the key size
+ * skips the strlen() as well.
+ */
+bool myrtx_hash_table_put_with_hash(myrtx_hash_table_t* table,
+                                    const void* key,
+                                    size_t key_size,
+                                    const void* value,
+                                    size_t value_size,
+                                    uint64_t hash);
+
+/**
+ * @brief myrtx_hash_table_get() with a precomputed hash
+ *
+ * @p hash must equal myrtx_hash_table_hash(table, key, key_size).
+ */
+bool myrtx_hash_table_get_with_hash(const myrtx_hash_table_t* table,
+                                    const void* key,
+                                    size_t key_size,
+                                    uint64_t hash,
+                                    void** value_out,
+                                    size_t* value_size_out);
+
+/**
+ * @brief myrtx_hash_table_contains_key() with a precomputed hash
+ *
+ * @p hash must equal myrtx_hash_table_hash(table, key, key_size).
+ */
+bool myrtx_hash_table_contains_key_with_hash(const myrtx_hash_table_t* table,
+                                             const void* key,
+                                             size_t key_size,
+                                             uint64_t hash);
+
+/**
+ * @brief myrtx_hash_table_remove() with a precomputed hash
+ *
+ * @p hash must equal myrtx_hash_table_hash(table, key, key_size).
+ */
+bool myrtx_hash_table_remove_with_hash(myrtx_hash_table_t* table,
+                                       const void* key,
+                                       size_t key_size,
+                                       uint64_t hash,
+                                       bool free_key,
+                                       bool free_value);
+
+/**
+ * @brief Latest expiry time an entry can have
+ *
+ * Expiry times are in caller-defined ticks (milliseconds, for example) and
+ * are stored in 48 bits.
+ */
+#define MYRTX_HASH_TABLE_MAX_EXPIRY ((UINT64_C(1) << 48) - 1)
+
+/**
+ * @brief Stores a key/value pair that expires at a given time
+ *
+ * Like myrtx_hash_table_put(), then sets the entry's expiry as
+ * myrtx_hash_table_set_expiry() does.
+ *
+ * @param table Hash table
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @param value Value
+ * @param value_size Value size in bytes
+ * @param expires_at Tick from which the entry counts as missing, at most
+ *        MYRTX_HASH_TABLE_MAX_EXPIRY (0 for no expiry)
+ * @return true on success, false on invalid arguments or out of memory
+ */
+bool myrtx_hash_table_put_ttl(myrtx_hash_table_t* table,
+                              const void* key,
+                              size_t key_size,
+                              const void* value,
+                              size_t value_size,
+                              uint64_t expires_at);
+
+/**
+ * @brief Sets or clears the expiry of a stored key
+ *
+ * Once the table's clock, advanced by myrtx_hash_table_expire(), reaches
+ * @p expires_at, lookups, iteration and myrtx_hash_table_remove() treat the
+ * entry as missing, and a put stores a fresh entry in its place. Until
+ * then a plain put keeps the expiry. The memory is reclaimed by a later
+ * myrtx_hash_table_expire() call. Each key with an expiry is tracked by a
+ * timer in a hierarchical timing wheel, which costs about 32 bytes plus a
+ * copy of the key.
+ *
+ * @param table Hash table
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @param expires_at Expiry tick, at most MYRTX_HASH_TABLE_MAX_EXPIRY (0 to
+ *        make the entry permanent again)
+ * @return true on success, false if the key is missing or on out of memory
+ */
+bool myrtx_hash_table_set_expiry(myrtx_hash_table_t* table,
+                                 const void* key,
+                                 size_t key_size,
+                                 uint64_t expires_at);
+
+/**
+ * @brief Expiry of a stored key
+ *
+ * @param table Hash table
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @return Expiry tick, or 0 if the key has none or is missing
+ */
+uint64_t myrtx_hash_table_get_expiry(const myrtx_hash_table_t* table,
+                                     const void* key,
+                                     size_t key_size);
+
+/**
+ * @brief Advances the table's clock and removes expired entries
+ *
+ * Entries whose expiry is at or before @p now are treated as missing from
+ * this call on. The timing wheel then removes them, each at O(1) amortized
+ * cost; a call never walks the slot array. With a @p budget, a call handles
+ * at most that many timers and the next call continues where it stopped,
+ * so calling it once per tick spreads the work of a large batch of
+ * expiring keys over several ticks. The clock never moves backwards.
+ *
+ * Removed entries are released like myrtx_hash_table_remove(table, key,
+ * key_size, true, true) would.
+ *
+ * @param table Hash table
+ * @param now Current tick
+ * @param budget Maximum number of timers to handle (0 for no limit)
+ * @return Number of entries removed
+ */
+size_t myrtx_hash_table_expire(myrtx_hash_table_t* table, uint64_t now, size_t budget);
+
 /**
  * @brief Gibt die Anzahl der Einträge in der Hash-Tabelle zurück
  * 
+ * Expired entries count until myrtx_hash_table_expire() removes them.
+ * 
  * @param table Zeiger auf die Hash-Tabelle
  * @return Anzahl der Einträge
  */
 size_t myrtx_hash_table_size(const myrtx_hash_table_t* table);
 
+/**
+ * @brief Returns the number of slots currently allocated
+ * 
+ * @param table Pointer to the hash table
+ * @return Number of slots
+ */
+size_t myrtx_hash_table_capacity(const myrtx_hash_table_t* table);
+
+/**
+ * @brief Number of buckets in myrtx_hash_table_stats_t.probe_histogram
+ */
+#define MYRTX_HASH_STATS_BUCKETS 16
+
+/**
+ * @brief Occupancy and probe-length diagnostics of a hash table
+ *
+ * The probe length of an entry is the number of slots a lookup of its key
+ * examines before it finds the entry, so 1 means the entry sits in its home
+ * slot. Swiss tables count groups of control bytes instead of slots, and
+ * compact tables count slots of their index array. Long probes on a table
+ * that is not particularly full point to a hash function that clusters
+ * keys.
+ */
+typedef struct myrtx_hash_table_stats {
+    size_t capacity;             /**< Slots in the current arrays */
+    size_t size;                 /**< Entries, including expired ones not yet removed */
+    size_t tombstones;           /**< Slots marked deleted */
+    size_t expired;              /**< Entries that have expired but are still stored */
+    double load;                 /**< size / capacity */
+    double average_probe_length; /**< Mean probe length over all entries (0 if empty) */
+    size_t max_probe_length;     /**< Longest probe length of any entry */
+    /** Bucket i counts the entries with probe length i + 1; the last bucket
+     *  also counts all longer probes */
+    size_t probe_histogram[MYRTX_HASH_STATS_BUCKETS];
+    size_t slot_bytes;           /**< Entry arrays plus control or index arrays */
+    size_t key_bytes;            /**< Key bytes stored outside the slots */
+    size_t value_bytes;          /**< Value bytes stored outside the slots */
+} myrtx_hash_table_stats_t;
+
+/**
+ * @brief Computes occupancy and probe-length diagnostics
+ *
+ * Walks every slot and recomputes each entry's probe sequence, so it costs
+ * O(capacity) plus the probes themselves. Nothing is tracked during normal
+ * operations, so lookups and updates stay as fast as without it. During an
+ * incremental resize, both the current and the old arrays are included.
+ *
+ * @param table Hash table
+ * @param[out] stats Receives the diagnostics (all zero for a NULL table)
+ */
+void myrtx_hash_table_stats(const myrtx_hash_table_t* table, myrtx_hash_table_stats_t* stats);
+
 /**
  * @brief Leert die Hash-Tabelle, entfernt alle Einträge
  * 
+ * Marks every slot empty, which costs O(capacity), unless the table was
+ * created with MYRTX_HASH_TABLE_GENERATIONS. The capacity is kept.
+ * 
  * @param table Zeiger auf die Hash-Tabelle
  * @param free_keys Ob die Schlüssel freigegeben werden sollen
  * @param free_values Ob die Werte freigegeben werden sollen
@@ -149,6 +641,40 @@ void myrtx_hash_table_clear(myrtx_hash_table_t* table,
                            bool free_keys, 
                            bool free_values);
 
+/**
+ * @brief Iterator over the entries of a hash table
+ *
+ * MYRTX_HASH_PROBING_COMPACT tables are visited in insertion order, others
+ * in slot order. No entries may be added or removed while an iterator is in
+ * use; writing through the returned value pointers is fine.
+ */
+typedef struct myrtx_hash_table_iter {
+    const myrtx_hash_table_t* table; /**< Table being iterated */
+    size_t position;                 /**< Next slot to look at */
+} myrtx_hash_table_iter_t;
+
+/**
+ * @brief Positions an iterator before the first entry of a table
+ *
+ * @param iter Iterator to initialize
+ * @param table Table to iterate
+ */
+void myrtx_hash_table_iter_init(myrtx_hash_table_iter_t* iter, const myrtx_hash_table_t* table);
+
+/**
+ * @brief Advances an iterator to the next entry
+ *
+ * @param iter Iterator
+ * @param key Receives a pointer to the key (may be NULL)
+ * @param key_size Receives the key size (may be NULL)
+ * @param value Receives a pointer to the value (may be NULL)
+ * @param value_size Receives the value size (may be NULL)
+ * @return true if an entry was returned, false when all entries have been visited
+ */
+bool myrtx_hash_table_iter_next(myrtx_hash_table_iter_t* iter,
+                                const void** key, size_t* key_size,
+                                void** value, size_t* value_size);
+
 /**
  * @brief Standard-Hash-Funktion für Strings
  * 
@@ -162,7 +688,8 @@ uint32_t myrtx_hash_string(const void* key, size_t key_size);
  * @brief Standard-Hash-Funktion für Integer-Schlüssel
  * 
  * @param key Zeiger auf den Integer-Schlüssel
- * @param key_size Größe des Schlüssels (ignoriert, muss sizeof(int) sein)
+ * @param key_size Size of the key in bytes (0 means sizeof(int)); keys of
+ *                 other sizes, such as int64_t, are hashed in full
  * @return Hash-Wert
  */
 uint32_t myrtx_hash_integer(const void* key, size_t key_size);
@@ -183,14 +710,52 @@ bool myrtx_compare_string_keys(const void* key1, size_t key1_size,
  * @brief Standard-Vergleichsfunktion für Integer-Schlüssel
  * 
  * @param key1 Zeiger auf den ersten Integer-Schlüssel
- * @param key1_size Größe des ersten Schlüssels (ignoriert, muss sizeof(int) sein)
+ * @param key1_size Size of the first key (0 means sizeof(int))
  * @param key2 Zeiger auf den zweiten Integer-Schlüssel
- * @param key2_size Größe des zweiten Schlüssels (ignoriert, muss sizeof(int) sein)
+ * @param key2_size Size of the second key (0 means sizeof(int))
  * @return true wenn die Integer gleich sind, sonst false
  */
 bool myrtx_compare_integer_keys(const void* key1, size_t key1_size, 
                                const void* key2, size_t key2_size);
 
+/**
+ * @brief Seeded 64-bit hash of a byte string (wyhash)
+ *
+ * Processes 8 bytes per step, with dedicated paths for 4-, 8- and 16-byte
+ * keys. Equal keys hash equally only under the same seed, so an attacker
+ * who does not know a table's seed cannot construct colliding keys.
+ *
+ * @param key Pointer to the key bytes
+ * @param key_size Size of the key in bytes
+ * @param seed Seed
+ * @return 64-bit hash
+ */
+uint64_t myrtx_hash64_bytes(const void* key, size_t key_size, uint64_t seed);
+
+/**
+ * @brief Seeded 64-bit hash for string keys
+ *
+ * Same as myrtx_hash64_bytes(), except that a key_size of 0 hashes the
+ * null-terminated string up to its terminator.
+ *
+ * @param key Pointer to the string
+ * @param key_size Size of the string in bytes (0 means use strlen)
+ * @param seed Seed
+ * @return 64-bit hash
+ */
+uint64_t myrtx_hash64_string(const void* key, size_t key_size, uint64_t seed);
+
+/**
+ * @brief Random seed for a new table
+ *
+ * Mixes address-space and clock entropy with a process-wide counter, so
+ * every call returns a different, never-zero value. Not suitable for
+ * cryptographic use.
+ *
+ * @return 64-bit seed
+ */
+uint64_t myrtx_hash_random_seed(void);
+
 #ifdef __cplusplus
 }
 #endif
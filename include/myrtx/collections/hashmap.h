@@ -0,0 +1,311 @@
+/**
+ * @file hashmap.h
+ * @brief Type-specialized hash maps generated by a macro
+ *
+ * MYRTX_HASHMAP_DEFINE() expands to a complete open-addressing hash map for
+ * one key and one value type. Keys and values are stored by value in the
+ * slots, and the hash and equality functions are called directly, so the
+ * compiler can inline them. An int -> int map therefore pays neither for
+ * indirect calls nor for following key pointers, unlike myrtx_hash_table_t.
+ *
+ * @code
+ * MYRTX_HASHMAP_DEFINE(int_map, int, int, myrtx_hashmap_hash_int, myrtx_hashmap_eq_int)
+ *
+ * int_map map;
+ * int_map_init(&map, NULL, 0);
+ * int_map_put(&map, 42, 1);
+ * int* value = int_map_get(&map, 42);
+ * int_map_destroy(&map);
+ * @endcode
+ *
+ * The map uses linear probing with backward-shift removal and grows at 3/4
+ * load. Keys of pointer type (for example `const char*`) are stored as
+ * pointers; the caller keeps the pointed-to data alive. Value pointers
+ * returned by get() are valid until the map is next modified.
+ *
+ * A C++ template with the same layout lives in hashmap.hpp.
+ */
+
+#ifndef MYRTX_HASHMAP_H
+#define MYRTX_HASHMAP_H
+
+#include "myrtx/memory/arena_allocator.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Default number of slots of a new map
+ */
+#define MYRTX_HASHMAP_DEFAULT_CAPACITY 16
+
+/**
+ * @brief Hash for 32-bit integers (MurmurHash3 finalizer)
+ */
+static inline uint32_t myrtx_hashmap_hash_u32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+
+/**
+ * @brief Hash for 64-bit integers (MurmurHash3 finalizer)
+ */
+static inline uint64_t myrtx_hashmap_hash_u64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+/**
+ * @brief Hash for int keys
+ */
+static inline uint32_t myrtx_hashmap_hash_int(int key) {
+    return myrtx_hashmap_hash_u32((uint32_t)key);
+}
+
+/**
+ * @brief Equality for int keys
+ */
+static inline bool myrtx_hashmap_eq_int(int a, int b) {
+    return a == b;
+}
+
+/**
+ * @brief Hash for null-terminated string keys (FNV-1a)
+ */
+static inline uint32_t myrtx_hashmap_hash_str(const char* key) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)key; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    /* FNV-1a leaves the low bits weak; the map indexes with them */
+    return myrtx_hashmap_hash_u32(hash);
+}
+
+/**
+ * @brief Equality for null-terminated string keys
+ */
+static inline bool myrtx_hashmap_eq_str(const char* a, const char* b) {
+    return a == b || strcmp(a, b) == 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @brief Define a hash map type @p name and its functions
+ *
+ * Generates, all prefixed with @p name:
+ * - `name` (the map) and `name_slot`
+ * - `bool name_init(name* map, myrtx_arena_t* arena, size_t initial_capacity)`
+ * - `void name_destroy(name* map)`
+ * - `bool name_put(name* map, K key, V value)` (insert or overwrite)
+ * - `V* name_get(const name* map, K key)` (NULL if absent)
+ * - `bool name_contains(const name* map, K key)`
+ * - `bool name_remove(name* map, K key)`
+ * - `size_t name_size(const name* map)`
+ * - `void name_clear(name* map)`
+ * - `bool name_next(const name* map, size_t* cursor, K* key_out, V** value_out)`
+ *   (iterate from `*cursor = 0` until it returns false)
+ *
+ * With an arena, slot arrays come from the arena and are not freed
+ * individually; otherwise malloc/free are used.
+ *
+ * @param name Type and function prefix
+ * @param K Key type (assignable)
+ * @param V Value type (assignable)
+ * @param hash_fn Function or macro `integer hash_fn(K)`; low bits must be well mixed
+ * @param eq_fn Function or macro `bool eq_fn(K, K)`
+ */
+#define MYRTX_HASHMAP_DEFINE(name, K, V, hash_fn, eq_fn)                                   \
+    typedef struct name##_slot {                                                           \
+        K key;                                                                             \
+        V value;                                                                           \
+        bool used;                                                                         \
+    } name##_slot;                                                                         \
+                                                                                           \
+    typedef struct name {                                                                  \
+        name##_slot* slots;                                                                \
+        size_t capacity; /* Power of 2 */                                                  \
+        size_t size;                                                                       \
+        myrtx_arena_t* arena;                                                              \
+    } name;                                                                                \
+                                                                                           \
+    static inline name##_slot* name##_alloc_slots_(myrtx_arena_t* arena, size_t capacity) { \
+        if (capacity > SIZE_MAX / sizeof(name##_slot)) {                                   \
+            return NULL;                                                                   \
+        }                                                                                  \
+        size_t bytes = sizeof(name##_slot) * capacity;                                     \
+        name##_slot* slots = arena ? (name##_slot*)myrtx_arena_alloc(arena, bytes)         \
+                                   : (name##_slot*)malloc(bytes);                          \
+        if (slots) {                                                                       \
+            for (size_t i = 0; i < capacity; i++) {                                        \
+                slots[i].used = false;                                                     \
+            }                                                                              \
+        }                                                                                  \
+        return slots;                                                                      \
+    }                                                                                      \
+                                                                                           \
+    static inline bool name##_init(name* map, myrtx_arena_t* arena, size_t initial_capacity) { \
+        size_t capacity = MYRTX_HASHMAP_DEFAULT_CAPACITY;                                  \
+        while (capacity < initial_capacity && capacity <= SIZE_MAX / 2) {                  \
+            capacity *= 2;                                                                 \
+        }                                                                                  \
+        /* Capacities beyond the largest power of 2 are rejected */                        \
+        map->slots = capacity >= initial_capacity ? name##_alloc_slots_(arena, capacity)   \
+                                                  : NULL;                                  \
+        map->capacity = map->slots ? capacity : 0;                                         \
+        map->size = 0;                                                                     \
+        map->arena = arena;                                                                \
+        return map->slots != NULL;                                                         \
+    }                                                                                      \
+                                                                                           \
+    static inline void name##_destroy(name* map) {                                         \
+        if (!map->arena) {                                                                 \
+            free(map->slots);                                                              \
+        }                                                                                  \
+        map->slots = NULL;                                                                 \
+        map->capacity = 0;                                                                 \
+        map->size = 0;                                                                     \
+    }                                                                                      \
+                                                                                           \
+    /* Slot holding @p key, or the empty slot that ends its probe sequence */              \
+    static inline size_t name##_probe_(const name* map, K key) {                           \
+        size_t mask = map->capacity - 1;                                                   \
+        size_t index = (size_t)(hash_fn(key)) & mask;                                      \
+        while (map->slots[index].used && !(eq_fn(map->slots[index].key, key))) {           \
+            index = (index + 1) & mask;                                                    \
+        }                                                                                  \
+        return index;                                                                      \
+    }                                                                                      \
+                                                                                           \
+    static inline bool name##_grow_(name* map) {                                           \
+        if (map->capacity > SIZE_MAX / 2) {                                                \
+            return false;                                                                  \
+        }                                                                                  \
+        size_t new_capacity = map->capacity * 2;                                           \
+        name##_slot* slots = name##_alloc_slots_(map->arena, new_capacity);                \
+        if (!slots) {                                                                      \
+            return false;                                                                  \
+        }                                                                                  \
+        size_t mask = new_capacity - 1;                                                    \
+        for (size_t i = 0; i < map->capacity; i++) {                                       \
+            if (map->slots[i].used) {                                                      \
+                size_t index = (size_t)(hash_fn(map->slots[i].key)) & mask;                \
+                while (slots[index].used) {                                                \
+                    index = (index + 1) & mask;                                            \
+                }                                                                          \
+                slots[index] = map->slots[i];                                              \
+            }                                                                              \
+        }                                                                                  \
+        if (!map->arena) {                                                                 \
+            free(map->slots);                                                              \
+        }                                                                                  \
+        map->slots = slots;                                                                \
+        map->capacity = new_capacity;                                                      \
+        return true;                                                                       \
+    }                                                                                      \
+                                                                                           \
+    static inline bool name##_put(name* map, K key, V value) {                             \
+        if (!map->slots) {                                                                 \
+            return false;                                                                  \
+        }                                                                                  \
+        size_t index = name##_probe_(map, key);                                            \
+        if (map->slots[index].used) {                                                      \
+            map->slots[index].value = value;                                               \
+            return true;                                                                   \
+        }                                                                                  \
+        if ((map->size + 1) * 4 > map->capacity * 3) {                                     \
+            if (!name##_grow_(map)) {                                                      \
+                return false;                                                              \
+            }                                                                              \
+            index = name##_probe_(map, key);                                               \
+        }                                                                                  \
+        map->slots[index].key = key;                                                       \
+        map->slots[index].value = value;                                                   \
+        map->slots[index].used = true;                                                     \
+        map->size++;                                                                       \
+        return true;                                                                       \
+    }                                                                                      \
+                                                                                           \
+    static inline V* name##_get(const name* map, K key) {                                  \
+        if (!map->size) {                                                                  \
+            return NULL;                                                                   \
+        }                                                                                  \
+        size_t index = name##_probe_(map, key);                                            \
+        return map->slots[index].used ? &map->slots[index].value : NULL;                   \
+    }                                                                                      \
+                                                                                           \
+    static inline bool name##_contains(const name* map, K key) {                           \
+        return name##_get(map, key) != NULL;                                               \
+    }                                                                                      \
+                                                                                           \
+    static inline bool name##_remove(name* map, K key) {                                   \
+        if (!map->size) {                                                                  \
+            return false;                                                                  \
+        }                                                                                  \
+        size_t mask = map->capacity - 1;                                                   \
+        size_t hole = name##_probe_(map, key);                                             \
+        if (!map->slots[hole].used) {                                                      \
+            return false;                                                                  \
+        }                                                                                  \
+        /* Backward shift: move later entries of the run into the hole unless */          \
+        /* their home slot lies cyclically between the hole and their position */         \
+        for (size_t index = (hole + 1) & mask; map->slots[index].used;                     \
+             index = (index + 1) & mask) {                                                 \
+            size_t home = (size_t)(hash_fn(map->slots[index].key)) & mask;                 \
+            if (((index - home) & mask) >= ((index - hole) & mask)) {                      \
+                map->slots[hole] = map->slots[index];                                      \
+                hole = index;                                                              \
+            }                                                                              \
+        }                                                                                  \
+        map->slots[hole].used = false;                                                     \
+        map->size--;                                                                       \
+        return true;                                                                       \
+    }                                                                                      \
+                                                                                           \
+    static inline size_t name##_size(const name* map) {                                    \
+        return map->size;                                                                  \
+    }                                                                                      \
+                                                                                           \
+    static inline void name##_clear(name* map) {                                           \
+        for (size_t i = 0; i < map->capacity; i++) {                                       \
+            map->slots[i].used = false;                                                    \
+        }                                                                                  \
+        map->size = 0;                                                                     \
+    }                                                                                      \
+                                                                                           \
+    static inline bool name##_next(const name* map, size_t* cursor, K* key_out,            \
+                                   V** value_out) {                                        \
+        for (size_t i = *cursor; i < map->capacity; i++) {                                 \
+            if (map->slots[i].used) {                                                      \
+                if (key_out) {                                                             \
+                    *key_out = map->slots[i].key;                                          \
+                }                                                                          \
+                if (value_out) {                                                           \
+                    *value_out = &map->slots[i].value;                                     \
+                }                                                                          \
+                *cursor = i + 1;                                                           \
+                return true;                                                               \
+            }                                                                              \
+        }                                                                                  \
+        *cursor = map->capacity;                                                           \
+        return false;                                                                      \
+    }
+
+#endif /* MYRTX_HASHMAP_H */
@@ -0,0 +1,300 @@
+/**
+ * @file hashmap.hpp
+ * @brief C++ template equivalent of MYRTX_HASHMAP_DEFINE()
+ *
+ * myrtx::hash_map<K, V, Hash, Eq> uses the same layout and algorithm as the
+ * macro-generated maps in hashmap.h: keys and values stored by value in the
+ * slots, linear probing with backward-shift removal, growth at 3/4 load and
+ * optional arena-backed slot arrays. Hash and Eq are function objects, so
+ * both are inlined. Requires C++11.
+ *
+ * @code
+ * myrtx::hash_map<int, int> map;
+ * map.put(42, 1);
+ * int* value = map.get(42);
+ * @endcode
+ */
+
+#ifndef MYRTX_HASHMAP_HPP
+#define MYRTX_HASHMAP_HPP
+
+#include "myrtx/collections/hashmap.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace myrtx {
+
+/**
+ * @brief Default hash: std::hash followed by a mixing step
+ *
+ * Many standard library implementations hash integers to themselves, which
+ * would leave the low bits that index the table unmixed.
+ */
+template <typename K>
+struct hashmap_hash {
+    std::size_t operator()(const K& key) const {
+        return static_cast<std::size_t>(myrtx_hashmap_hash_u64(static_cast<uint64_t>(std::hash<K>()(key))));
+    }
+};
+
+/**
+ * @brief Open-addressing hash map with keys and values stored in the slots
+ *
+ * Value pointers returned by get() are valid until the map is next
+ * modified. The map is movable but not copyable.
+ */
+template <typename K, typename V, typename Hash = hashmap_hash<K>, typename Eq = std::equal_to<K> >
+class hash_map {
+public:
+    /**
+     * @param arena Optional arena for the slot arrays (NULL for malloc/free)
+     * @param initial_capacity Initial number of slots (rounded up to a power of 2);
+     *        if the slot array cannot be sized, capacity() is 0 and put() fails
+     */
+    explicit hash_map(myrtx_arena_t* arena = NULL, std::size_t initial_capacity = 0)
+        : slots_(NULL), capacity_(0), size_(0), arena_(arena) {
+        std::size_t capacity = MYRTX_HASHMAP_DEFAULT_CAPACITY;
+        while (capacity < initial_capacity && capacity <= SIZE_MAX / 2) {
+            capacity *= 2;
+        }
+        /* Capacities beyond the largest power of 2 leave the map empty */
+        slots_ = capacity >= initial_capacity ? alloc_slots(capacity) : NULL;
+        capacity_ = slots_ ? capacity : 0;
+    }
+
+    hash_map(hash_map&& other)
+        : slots_(other.slots_), capacity_(other.capacity_), size_(other.size_), arena_(other.arena_) {
+        other.slots_ = NULL;
+        other.capacity_ = 0;
+        other.size_ = 0;
+    }
+
+    hash_map& operator=(hash_map&& other) {
+        if (this != &other) {
+            release();
+            slots_ = other.slots_;
+            capacity_ = other.capacity_;
+            size_ = other.size_;
+            arena_ = other.arena_;
+            other.slots_ = NULL;
+            other.capacity_ = 0;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    hash_map(const hash_map&) = delete;
+    hash_map& operator=(const hash_map&) = delete;
+
+    ~hash_map() {
+        release();
+    }
+
+    /**
+     * @brief Insert or overwrite
+     * @return false if growing the slot array failed
+     */
+    bool put(const K& key, const V& value) {
+        if (!slots_) {
+            return false;
+        }
+        std::size_t index = probe(key);
+        if (slots_[index].used) {
+            slots_[index].value() = value;
+            return true;
+        }
+        if ((size_ + 1) * 4 > capacity_ * 3) {
+            if (!grow()) {
+                return false;
+            }
+            index = probe(key);
+        }
+        slots_[index].construct(key, value);
+        size_++;
+        return true;
+    }
+
+    /**
+     * @brief Pointer to the value for @p key, or NULL if absent
+     */
+    V* get(const K& key) {
+        if (!size_) {
+            return NULL;
+        }
+        std::size_t index = probe(key);
+        return slots_[index].used ? &slots_[index].value() : NULL;
+    }
+
+    const V* get(const K& key) const {
+        return const_cast<hash_map*>(this)->get(key);
+    }
+
+    bool contains(const K& key) const {
+        return get(key) != NULL;
+    }
+
+    /**
+     * @brief Remove @p key
+     * @return true if the key was present
+     */
+    bool remove(const K& key) {
+        if (!size_) {
+            return false;
+        }
+        std::size_t mask = capacity_ - 1;
+        std::size_t hole = probe(key);
+        if (!slots_[hole].used) {
+            return false;
+        }
+        slots_[hole].destroy();
+        /* Backward shift, as in MYRTX_HASHMAP_DEFINE() */
+        for (std::size_t index = (hole + 1) & mask; slots_[index].used; index = (index + 1) & mask) {
+            std::size_t home = hash_(slots_[index].key()) & mask;
+            if (((index - home) & mask) >= ((index - hole) & mask)) {
+                slots_[hole].move_from(slots_[index]);
+                hole = index;
+            }
+        }
+        size_--;
+        return true;
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    std::size_t capacity() const {
+        return capacity_;
+    }
+
+    void clear() {
+        for (std::size_t i = 0; i < capacity_; i++) {
+            if (slots_[i].used) {
+                slots_[i].destroy();
+            }
+        }
+        size_ = 0;
+    }
+
+    /**
+     * @brief Call @p fn(key, value) for every entry
+     */
+    template <typename Fn>
+    void for_each(Fn fn) {
+        for (std::size_t i = 0; i < capacity_; i++) {
+            if (slots_[i].used) {
+                fn(slots_[i].key(), slots_[i].value());
+            }
+        }
+    }
+
+private:
+    /* Key and value are constructed only while the slot is used */
+    struct slot {
+        typename std::aligned_storage<sizeof(K), alignof(K)>::type key_storage;
+        typename std::aligned_storage<sizeof(V), alignof(V)>::type value_storage;
+        bool used;
+
+        K& key() {
+            return *reinterpret_cast<K*>(&key_storage);
+        }
+        V& value() {
+            return *reinterpret_cast<V*>(&value_storage);
+        }
+        void construct(const K& k, const V& v) {
+            new (&key_storage) K(k);
+            new (&value_storage) V(v);
+            used = true;
+        }
+        void move_from(slot& other) {
+            new (&key_storage) K(std::move(other.key()));
+            new (&value_storage) V(std::move(other.value()));
+            used = true;
+            other.destroy();
+        }
+        void destroy() {
+            key().~K();
+            value().~V();
+            used = false;
+        }
+    };
+
+    slot* alloc_slots(std::size_t capacity) {
+        if (capacity > SIZE_MAX / sizeof(slot)) {
+            return NULL;
+        }
+        std::size_t bytes = sizeof(slot) * capacity;
+        slot* slots = static_cast<slot*>(arena_ ? myrtx_arena_alloc(arena_, bytes) : std::malloc(bytes));
+        if (slots) {
+            for (std::size_t i = 0; i < capacity; i++) {
+                slots[i].used = false;
+            }
+        }
+        return slots;
+    }
+
+    void release() {
+        if (!slots_) {
+            return;
+        }
+        clear();
+        if (!arena_) {
+            std::free(slots_);
+        }
+        slots_ = NULL;
+        capacity_ = 0;
+    }
+
+    /* Slot holding @p key, or the empty slot that ends its probe sequence */
+    std::size_t probe(const K& key) const {
+        std::size_t mask = capacity_ - 1;
+        std::size_t index = hash_(key) & mask;
+        while (slots_[index].used && !eq_(slots_[index].key(), key)) {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+
+    bool grow() {
+        if (capacity_ > SIZE_MAX / 2) {
+            return false;
+        }
+        std::size_t new_capacity = capacity_ * 2;
+        slot* slots = alloc_slots(new_capacity);
+        if (!slots) {
+            return false;
+        }
+        std::size_t mask = new_capacity - 1;
+        for (std::size_t i = 0; i < capacity_; i++) {
+            if (slots_[i].used) {
+                std::size_t index = hash_(slots_[i].key()) & mask;
+                while (slots[index].used) {
+                    index = (index + 1) & mask;
+                }
+                slots[index].move_from(slots_[i]);
+            }
+        }
+        if (!arena_) {
+            std::free(slots_);
+        }
+        slots_ = slots;
+        capacity_ = new_capacity;
+        return true;
+    }
+
+    slot* slots_;
+    std::size_t capacity_;
+    std::size_t size_;
+    myrtx_arena_t* arena_;
+    Hash hash_;
+    Eq eq_;
+};
+
+} /* namespace myrtx */
+
+#endif /* MYRTX_HASHMAP_HPP */
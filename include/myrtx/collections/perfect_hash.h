@@ -0,0 +1,129 @@
+/**
+ * @file perfect_hash.h
+ * @brief Minimal perfect hash over a static key set (BBHash)
+ *
+ * myrtx_perfect_hash_build() maps n distinct keys one-to-one onto the
+ * indices 0 to n-1 and stores the keys and optional fixed-size values in
+ * that order. The function itself is a cascade of bit arrays: a key belongs
+ * to the first level where its bit is set, and its index is the number of
+ * set bits before that one. With the default gamma of 2 it takes about 3.7
+ * bits per key, and about 85% of the keys are resolved in the first two
+ * levels.
+ *
+ * A lookup tests bits until it finds the key's level, then verifies the
+ * key with a single access to the stored keys. Keys that still collide
+ * after all levels (only those with equal hashes, in practice) go to a
+ * small fallback hash table.
+ */
+
+#ifndef MYRTX_PERFECT_HASH_H
+#define MYRTX_PERFECT_HASH_H
+
+#include "myrtx/collections/hash_table.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opaque minimal perfect hash
+ */
+typedef struct myrtx_perfect_hash_t myrtx_perfect_hash_t;
+
+/**
+ * @brief Options for myrtx_perfect_hash_build()
+ *
+ * Zero-initialize and set the fields you need; zero selects the defaults.
+ * Exactly one of hash_function and hash64_function must be set. A 32-bit
+ * hash_function cannot separate keys whose 32-bit hashes are equal, which
+ * becomes common from about 100,000 keys on; those keys end up in the
+ * fallback table, so prefer a hash64_function for large sets.
+ */
+typedef struct myrtx_perfect_hash_options {
+    myrtx_arena_t* arena;                        /**< Optional arena (NULL for malloc/free) */
+    myrtx_hash_function hash_function;           /**< 32-bit hash function for keys */
+    myrtx_key_compare_function compare_function; /**< Compare function for keys (required) */
+    myrtx_hash64_function hash64_function;       /**< Seeded 64-bit hash (instead of hash_function) */
+    uint64_t seed;                               /**< Seed for hash64_function (0 for a random seed) */
+    double gamma;                                /**< Level size in bits per key, >= 1 (0 for 2.0) */
+} myrtx_perfect_hash_options_t;
+
+/**
+ * @brief Builds a minimal perfect hash for a set of distinct keys
+ *
+ * Copies the keys and values, so the input arrays can be freed afterwards.
+ * In arena mode everything the function keeps is allocated from the arena;
+ * temporary build memory always comes from malloc. A smaller gamma gives
+ * fewer bits per key but more levels and a slower build.
+ *
+ * @param options Options
+ * @param keys Array of @p count keys
+ * @param key_sizes Array of @p count key sizes (0 for a null-terminated
+ *        string), or NULL if all keys are null-terminated strings
+ * @param count Number of keys
+ * @param values Optional array of @p count values of @p value_size bytes,
+ *        in the order of @p keys
+ * @param value_size Size of each value in bytes (0 without values)
+ * @return Pointer to the new function, or NULL on invalid options,
+ *         duplicate keys or out of memory
+ */
+myrtx_perfect_hash_t* myrtx_perfect_hash_build(const myrtx_perfect_hash_options_t* options,
+                                               const void* const* keys, const size_t* key_sizes,
+                                               size_t count, const void* values,
+                                               size_t value_size);
+
+/**
+ * @brief Frees a perfect hash (in arena mode the memory stays in the arena)
+ *
+ * @param hash Perfect hash to free
+ */
+void myrtx_perfect_hash_free(myrtx_perfect_hash_t* hash);
+
+/**
+ * @brief Index of a key
+ *
+ * @param hash Perfect hash
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @param[out] index_out Receives the key's index in [0, size)
+ * @return true if the key is in the set
+ */
+bool myrtx_perfect_hash_lookup(const myrtx_perfect_hash_t* hash, const void* key,
+                               size_t key_size, size_t* index_out);
+
+/**
+ * @brief Value of a key
+ *
+ * @param hash Perfect hash built with values
+ * @param key Key
+ * @param key_size Key size in bytes (0 for a null-terminated string)
+ * @return Pointer to the stored value, or NULL if the key is not in the set
+ */
+const void* myrtx_perfect_hash_get(const myrtx_perfect_hash_t* hash, const void* key,
+                                   size_t key_size);
+
+/**
+ * @brief Number of keys
+ *
+ * @param hash Perfect hash
+ * @return Number of keys
+ */
+size_t myrtx_perfect_hash_size(const myrtx_perfect_hash_t* hash);
+
+/**
+ * @brief Size of the hash function itself, without keys, values and the
+ *        fallback table
+ *
+ * @param hash Perfect hash
+ * @return Bits of the level arrays and their rank index per key
+ */
+double myrtx_perfect_hash_bits_per_key(const myrtx_perfect_hash_t* hash);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MYRTX_PERFECT_HASH_H */
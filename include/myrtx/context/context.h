@@ -29,15 +29,108 @@ extern "C" {
  */
 #define MYRTX_MAX_SCRATCH_POOL_SIZE 8
 
+/**
+ * @brief Bytes a forked context reserves from its parent's global arena at once
+ */
+#define MYRTX_CONTEXT_PROMOTE_BATCH (64 * 1024)
+
+/**
+ * @brief Opaque event trace ring (see myrtx/context/trace.h)
+ */
+struct myrtx_trace_buffer;
+
+/**
+ * @brief Opaque synchronization state of a context that has forks
+ */
+struct myrtx_context_shared;
+
+/**
+ * @brief Block size of the pooled scratch regions
+ */
+#define MYRTX_SCRATCH_BLOCK_SIZE (64 * 1024)
+
 /**
  * @brief Structure to hold scratch arenas for reuse
+ *
+ * Each pooled region is an arena of its own that keeps its blocks between
+ * uses: handing one out pops it from the idle stack and returning it
+ * rewinds it (myrtx_arena_rewind()), so neither step calls malloc or free.
+ * Regions are created on first demand. Once all of them are in use, further
+ * scratch arenas fall back to temporary markers in the parent arena.
  */
 typedef struct myrtx_scratch_pool {
-    myrtx_arena_t* parent_arena;                   /**< Parent arena for all scratch arenas */
-    myrtx_scratch_arena_t arenas[MYRTX_MAX_SCRATCH_POOL_SIZE]; /**< Array of scratch arenas */
-    size_t count;                                  /**< Number of active scratch arenas */
+    myrtx_arena_t* parent_arena;                   /**< Fallback arena once all regions are in use */
+    myrtx_arena_t regions[MYRTX_MAX_SCRATCH_POOL_SIZE]; /**< Pooled regions with retained blocks */
+    myrtx_arena_t* idle[MYRTX_MAX_SCRATCH_POOL_SIZE];   /**< Stack of idle regions */
+    size_t created;                                /**< Number of initialized regions */
+    size_t count;                                  /**< Number of idle regions in the pool */
+    uint64_t gets;                                 /**< Scratch arenas handed out */
+    uint64_t hits;                                 /**< Hand-outs served from the pool */
+    size_t depth;                                  /**< Scratch arenas currently in use */
+    size_t peak_depth;                             /**< Highest depth seen */
 } myrtx_scratch_pool_t;
 
+/**
+ * @brief Maximum number of format arguments captured by a deferred error
+ */
+#define MYRTX_ERROR_MAX_ARGS 8
+
+/**
+ * @brief Bytes reserved for copies of string arguments of a deferred error
+ */
+#define MYRTX_ERROR_STRING_SPACE 256
+
+/**
+ * @brief A captured format argument of a deferred error
+ */
+typedef union myrtx_error_arg {
+    intmax_t i;                       /**< Signed integer and character conversions */
+    uintmax_t u;                      /**< Unsigned integer conversions */
+    double d;                         /**< Floating point conversions */
+    const void* p;                    /**< %p conversions */
+    size_t offset;                    /**< %s conversions: offset into the string copy area */
+} myrtx_error_arg_t;
+
+/**
+ * @brief Unformatted error as recorded by myrtx_context_set_error()
+ *
+ * Setting an error stores the format pointer and the raw arguments; string
+ * arguments are copied, everything else is stored by value. The message is
+ * only formatted when myrtx_context_get_error() asks for it.
+ */
+typedef struct myrtx_error_record {
+    const char* format;               /**< Format string of the last error (NULL if none) */
+    bool formatted;                   /**< error_buffer already holds the message */
+    unsigned int arg_count;           /**< Number of captured arguments */
+    myrtx_error_arg_t args[MYRTX_ERROR_MAX_ARGS]; /**< Captured arguments in order */
+    size_t string_used;               /**< Bytes used in strings */
+    char strings[MYRTX_ERROR_STRING_SPACE]; /**< Copies of string arguments */
+} myrtx_error_record_t;
+
+/**
+ * @brief Allocation telemetry for one context or a set of contexts
+ *
+ * Reserved bytes are the sizes of the arena blocks; used bytes are the
+ * bytes handed out from them. A fork reports its parent's global arena as
+ * zero so that aggregates count it once.
+ */
+typedef struct myrtx_context_stats {
+    size_t context_count;             /**< Contexts included in these figures */
+    size_t global_reserved;           /**< Bytes reserved by global arena blocks */
+    size_t global_used;               /**< Bytes used in the global arena */
+    size_t global_blocks;             /**< Blocks in the global arena */
+    size_t temp_reserved;             /**< Bytes reserved by temporary arena blocks */
+    size_t temp_used;                 /**< Bytes used in the temporary arena */
+    size_t temp_blocks;               /**< Blocks in the temporary arena */
+    size_t scratch_reserved;          /**< Bytes reserved by pooled scratch regions */
+    uint64_t scratch_gets;            /**< Scratch arenas handed out */
+    uint64_t scratch_hits;            /**< Hand-outs served from the scratch pool */
+    double scratch_hit_rate;          /**< scratch_hits / scratch_gets (0 if none) */
+    size_t scratch_peak_depth;        /**< Highest number of simultaneous scratch arenas */
+    size_t extension_bytes;           /**< Bytes of extension data */
+    uint64_t error_count;             /**< Number of myrtx_context_set_error calls */
+} myrtx_context_stats_t;
+
 /**
  * @brief Extension type information
  */
@@ -60,8 +153,20 @@ typedef struct myrtx_context {
     void* extension_data[MYRTX_MAX_EXTENSION_TYPES]; /**< Extension storage */
     unsigned int flags;               /**< Context flags */
     
-    char error_buffer[256];           /**< Error message buffer */
+    char error_buffer[256];           /**< Error message buffer (filled on demand) */
     int error_code;                   /**< Last error code */
+    myrtx_error_record_t error_record; /**< Last error, not yet formatted */
+    
+    struct myrtx_trace_buffer* trace; /**< Event trace ring (NULL unless tracing is enabled) */
+    
+    struct myrtx_context* parent;     /**< Context this one was forked from (NULL if not forked) */
+    struct myrtx_context_shared* shared; /**< Lock state, set once the context has been forked */
+    uint8_t* promote_cursor;          /**< Next free byte in the reserved promotion batch */
+    uint8_t* promote_end;             /**< End of the reserved promotion batch */
+    
+    uint64_t error_count;             /**< Number of errors set on this context */
+    struct myrtx_context* registry_prev; /**< Previous live context (process registry) */
+    struct myrtx_context* registry_next; /**< Next live context (process registry) */
 } myrtx_context_t;
 
 /**
@@ -79,6 +184,38 @@ myrtx_context_t* myrtx_context_create(myrtx_arena_t* global_arena);
  */
 void myrtx_context_destroy(myrtx_context_t* context);
 
+/**
+ * @brief Create a lightweight fork of a context for use on another thread
+ *
+ * The fork aliases the parent's global arena for reading and gets its own
+ * temporary arena and scratch pool. It never frees the parent's arena.
+ * Allocations through myrtx_context_alloc() or myrtx_context_promote() on a
+ * fork persist in the parent's global arena: the fork reserves
+ * MYRTX_CONTEXT_PROMOTE_BATCH bytes at a time under the parent's lock and
+ * serves promotions from that batch without locking.
+ *
+ * Forking a fork forks its parent. Forks must be created on the parent's
+ * thread and destroyed before the parent. Once a context has been forked,
+ * its global arena must only be allocated from through myrtx_context_alloc().
+ *
+ * @param parent Context to fork
+ * @return myrtx_context_t* New fork or NULL on failure
+ */
+myrtx_context_t* myrtx_context_fork(myrtx_context_t* parent);
+
+/**
+ * @brief Copy data into persistent storage of a context
+ *
+ * For a fork the copy lands in the parent's global arena (thread-safe,
+ * batched); otherwise in the context's own global arena.
+ *
+ * @param context Context to use
+ * @param data Data to copy
+ * @param size Number of bytes to copy
+ * @return void* Persistent copy or NULL on failure
+ */
+void* myrtx_context_promote(myrtx_context_t* context, const void* data, size_t size);
+
 /**
  * @brief Register a new extension type
  * 
@@ -112,6 +249,9 @@ myrtx_context_t* myrtx_get_current_context(void);
 
 /**
  * @brief Allocate memory from the context's global arena
+ *
+ * On a fork this allocates from the parent's global arena via the
+ * promotion batch (see myrtx_context_fork()).
  * 
  * @param context Context to use
  * @param size Size to allocate
@@ -156,6 +296,9 @@ void myrtx_context_scratch_end(myrtx_context_t* context, myrtx_scratch_arena_t*
 /**
  * @brief Set an error in the context
  * 
+ * Formats the message into the context immediately, so @p format and the
+ * arguments may be temporary.
+ * 
  * @param context Context to update
  * @param error_code Error code
  * @param format Printf-style format string
@@ -163,14 +306,49 @@ void myrtx_context_scratch_end(myrtx_context_t* context, myrtx_scratch_arena_t*
  */
 void myrtx_context_set_error(myrtx_context_t* context, int error_code, const char* format, ...);
 
+/**
+ * @brief Set an error with a static format string, formatted on first read
+ * 
+ * The message is not formatted here: the format pointer and the arguments
+ * are recorded and formatted by myrtx_context_get_error(), so errors that
+ * are never read cost no formatting. @p format must be static, such as a
+ * string literal: it is read again when the error is formatted and its
+ * pointer is returned by myrtx_context_get_error_format(). Never pass a
+ * buffer that is reused or freed. String arguments are copied and may be
+ * temporary. Formats that cannot be captured (%n, %ls, %Lf, very long flag
+ * or digit sequences, more than MYRTX_ERROR_MAX_ARGS arguments) are
+ * formatted immediately.
+ * 
+ * @param context Context to update
+ * @param error_code Error code
+ * @param format Static printf-style format string
+ * @param ... Format arguments
+ */
+void myrtx_context_set_error_static(myrtx_context_t* context, int error_code,
+                                    const char* format, ...);
+
 /**
  * @brief Get the last error message from a context
  * 
+ * Formats the recorded error on first access after it was set.
+ * 
  * @param context Context to query
  * @return const char* Error message
  */
 const char* myrtx_context_get_error(myrtx_context_t* context);
 
+/**
+ * @brief Get the format string of the last error without formatting it
+ * 
+ * Lets callers classify errors by their format pointer cheaply.
+ * 
+ * @param context Context to query
+ * @return const char* Format string passed to myrtx_context_set_error_static(),
+ *         or NULL if no error has been set or the last one was set with
+ *         myrtx_context_set_error()
+ */
+const char* myrtx_context_get_error_format(const myrtx_context_t* context);
+
 /**
  * @brief Get the last error code from a context
  * 
@@ -179,6 +357,31 @@ const char* myrtx_context_get_error(myrtx_context_t* context);
  */
 int myrtx_context_get_error_code(myrtx_context_t* context);
 
+/**
+ * @brief Collect allocation telemetry for a context
+ *
+ * Walks the context's arenas; call it from the thread that uses the context.
+ *
+ * @param context Context to query
+ * @param out Receives the figures
+ * @return bool true on success
+ */
+bool myrtx_context_stats(myrtx_context_t* context, myrtx_context_stats_t* out);
+
+/**
+ * @brief Aggregate allocation telemetry over all live contexts
+ *
+ * Sums per-context counters under a process-wide registry lock without
+ * walking any arena, so it is cheap and safe to call from a monitoring
+ * thread. The counters are read with relaxed atomic loads: each one is a
+ * value its context held recently, but counters of a context busy on
+ * another thread need not be from the same instant. Used byte counts are
+ * not tracked per allocation and are reported as 0.
+ *
+ * @param out Receives the aggregated figures
+ */
+void myrtx_context_stats_all(myrtx_context_stats_t* out);
+
 #ifdef __cplusplus
 }
 #endif
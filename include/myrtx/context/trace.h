@@ -0,0 +1,179 @@
+/**
+ * @file trace.h
+ * @brief Low-overhead per-context event tracing
+ *
+ * Each context can own a fixed-size ring buffer of timestamped binary
+ * events. The library records arena block additions, temporary marker and
+ * scratch begin/end, and hash table resizes; applications can add their own
+ * spans. The ring never allocates after it has been enabled, so recording an
+ * event costs a timestamp read and a 32-byte store.
+ *
+ * Tracing is removed entirely unless the library is built with
+ * MYRTX_ENABLE_TRACING (CMake option of the same name): the recording
+ * macros then expand to nothing and myrtx_trace_enable() returns false.
+ */
+
+#ifndef MYRTX_TRACE_H
+#define MYRTX_TRACE_H
+
+#include "myrtx/context/context.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Default number of events in a trace ring
+ */
+#define MYRTX_TRACE_DEFAULT_CAPACITY 4096
+
+/**
+ * @brief Kinds of events recorded in a trace ring
+ */
+typedef enum myrtx_trace_event_type {
+    MYRTX_TRACE_ARENA_BLOCK = 1, /**< Arena block added (arg0: block size, arg1: arena total) */
+    MYRTX_TRACE_TEMP_BEGIN,      /**< Temporary marker set (arg0: marker, arg1: arena address) */
+    MYRTX_TRACE_TEMP_END,        /**< Temporary marker released (arg0: marker, arg1: arena address) */
+    MYRTX_TRACE_SCRATCH_BEGIN,   /**< Scratch arena handed out (arg0: 1 if an idle pooled region was reused, arg1: arena address) */
+    MYRTX_TRACE_SCRATCH_END,     /**< Scratch arena returned (arg1: arena address) */
+    MYRTX_TRACE_HASH_RESIZE,     /**< Hash table resized (arg0: old capacity, arg1: new capacity) */
+    MYRTX_TRACE_SPAN_BEGIN,      /**< User span opened (arg0: static name pointer) */
+    MYRTX_TRACE_SPAN_END         /**< User span closed (arg0: static name pointer) */
+} myrtx_trace_event_type_t;
+
+/**
+ * @brief A single recorded event (32 bytes)
+ */
+typedef struct myrtx_trace_event {
+    uint64_t timestamp; /**< Raw clock ticks (TSC where available) */
+    uint32_t type;      /**< myrtx_trace_event_type_t */
+    uint32_t reserved;  /**< Padding, always zero */
+    uint64_t arg0;      /**< First event argument */
+    uint64_t arg1;      /**< Second event argument */
+} myrtx_trace_event_t;
+
+/**
+ * @brief Enable tracing on a context
+ *
+ * Allocates the ring buffer. Calling it again on a traced context discards
+ * the recorded events and starts over with the new capacity.
+ *
+ * @param context Context to trace
+ * @param capacity Number of events to keep (rounded up to a power of 2,
+ *                 0 for MYRTX_TRACE_DEFAULT_CAPACITY)
+ * @return true on success, false on error or when tracing is compiled out
+ */
+bool myrtx_trace_enable(myrtx_context_t* context, size_t capacity);
+
+/**
+ * @brief Disable tracing on a context and free its ring buffer
+ *
+ * @param context Context to update
+ */
+void myrtx_trace_disable(myrtx_context_t* context);
+
+/**
+ * @brief Record an event in a context's trace ring
+ *
+ * Does nothing if tracing is not enabled on the context.
+ *
+ * @param context Context to record into
+ * @param type Event type
+ * @param arg0 First event argument
+ * @param arg1 Second event argument
+ */
+void myrtx_trace_record(myrtx_context_t* context, myrtx_trace_event_type_t type,
+                        uint64_t arg0, uint64_t arg1);
+
+/**
+ * @brief Record an event in the current thread-local context's trace ring
+ *
+ * Used by library code that has no context at hand (arenas, hash tables).
+ *
+ * @param type Event type
+ * @param arg0 First event argument
+ * @param arg1 Second event argument
+ */
+void myrtx_trace_emit(myrtx_trace_event_type_t type, uint64_t arg0, uint64_t arg1);
+
+/**
+ * @brief Number of events currently held in the ring
+ *
+ * @param context Context to query
+ * @return size_t Number of events (at most the ring capacity)
+ */
+size_t myrtx_trace_count(const myrtx_context_t* context);
+
+/**
+ * @brief Number of events overwritten because the ring was full
+ *
+ * @param context Context to query
+ * @return uint64_t Number of dropped events
+ */
+uint64_t myrtx_trace_dropped(const myrtx_context_t* context);
+
+/**
+ * @brief Copy the recorded events, oldest first
+ *
+ * @param context Context to query
+ * @param out Destination array
+ * @param max_events Capacity of the destination array
+ * @return size_t Number of events copied
+ */
+size_t myrtx_trace_snapshot(const myrtx_context_t* context, myrtx_trace_event_t* out,
+                            size_t max_events);
+
+/**
+ * @brief Write the recorded events as Chrome trace event JSON
+ *
+ * The output can be loaded in chrome://tracing or ui.perfetto.dev. Arena
+ * block events are also emitted as an "arena_bytes" counter track. Temp
+ * markers and scratch regions, which may end out of order, are async
+ * slices keyed by arena address (and marker); user spans are B/E slices.
+ *
+ * @param context Context to export
+ * @param out Destination stream
+ * @return true on success, false on error
+ */
+bool myrtx_trace_export_chrome(const myrtx_context_t* context, FILE* out);
+
+#if defined(MYRTX_ENABLE_TRACING) && MYRTX_ENABLE_TRACING
+/**
+ * @brief Record an event in the current thread-local context
+ */
+#define MYRTX_TRACE_EMIT(type, arg0, arg1) \
+    myrtx_trace_emit((type), (uint64_t)(arg0), (uint64_t)(arg1))
+
+/**
+ * @brief Record an event in an explicit context
+ */
+#define MYRTX_TRACE_RECORD(context, type, arg0, arg1) \
+    myrtx_trace_record((context), (type), (uint64_t)(arg0), (uint64_t)(arg1))
+
+/**
+ * @brief Open a user span; @p name must be a string literal or otherwise static
+ */
+#define MYRTX_TRACE_SPAN_BEGIN(context, name) \
+    myrtx_trace_record((context), MYRTX_TRACE_SPAN_BEGIN, (uint64_t)(uintptr_t)(name), 0)
+
+/**
+ * @brief Close a user span opened with MYRTX_TRACE_SPAN_BEGIN
+ */
+#define MYRTX_TRACE_SPAN_END(context, name) \
+    myrtx_trace_record((context), MYRTX_TRACE_SPAN_END, (uint64_t)(uintptr_t)(name), 0)
+#else
+#define MYRTX_TRACE_EMIT(type, arg0, arg1) ((void)0)
+#define MYRTX_TRACE_RECORD(context, type, arg0, arg1) ((void)0)
+#define MYRTX_TRACE_SPAN_BEGIN(context, name) ((void)0)
+#define MYRTX_TRACE_SPAN_END(context, name) ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MYRTX_TRACE_H */
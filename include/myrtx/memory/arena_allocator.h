@@ -74,6 +74,7 @@ typedef struct myrtx_arena {
     myrtx_arena_block_t* first;              /**< First block in the arena */
     size_t block_size;                       /**< Default size for new blocks */
     size_t total_allocated;                  /**< Total allocated memory */
+    size_t block_count;                      /**< Number of blocks in the chain */
     unsigned int temp_count;                 /**< Number of active temporary markers */
     myrtx_arena_marker_t temp_markers[MYRTX_ARENA_MAX_TEMP_MARKERS]; /**< Temporary markers */
 } myrtx_arena_t;
@@ -143,6 +144,18 @@ void* myrtx_arena_calloc(myrtx_arena_t* arena, size_t size);
  */
 void myrtx_arena_reset(myrtx_arena_t* arena);
 
+/**
+ * @brief Empties an arena while keeping all of its blocks
+ *
+ * Unlike myrtx_arena_reset(), no block is freed: allocation restarts in the
+ * first block and moves into the retained blocks as they are needed. This
+ * is O(1) and makes an arena reusable without touching malloc/free.
+ * All temporary markers are dropped.
+ *
+ * @param arena Pointer to the arena to rewind
+ */
+void myrtx_arena_rewind(myrtx_arena_t* arena);
+
 /**
  * @brief Marks a temporary state in an arena
  *
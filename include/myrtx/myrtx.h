@@ -11,8 +11,16 @@
 #include "myrtx/version.h"
 #include "myrtx/memory/arena_allocator.h"
 #include "myrtx/context/context.h"
+#include "myrtx/context/trace.h"
 #include "myrtx/string/string.h"
 #include "myrtx/collections/hash_table.h"
+#include "myrtx/collections/hashmap.h"
+#include "myrtx/collections/hash_set.h"
+#include "myrtx/collections/hash_multimap.h"
+#include "myrtx/collections/hash_file.h"
+#include "myrtx/collections/perfect_hash.h"
+#include "myrtx/collections/cache.h"
+#include "myrtx/collections/concurrent_hash_table.h"
 #include "myrtx/collections/avl_tree.h"
 
 #endif /* MYRTX_H */ 
\ No newline at end of file
@@ -0,0 +1,427 @@
+/**
+ * @file cache.c
+ * @brief Bounded cache on top of the hash table core
+ *
+ * The key table (inline storage) maps each key to the index of its node in
+ * a growable node array. A node owns one buffer with the only copy of the
+ * key, followed by the value; the table borrows the key from it
+ * (MYRTX_HASH_TABLE_KEYS_BORROWED) instead of storing a copy. The node also
+ * carries the eviction state: prev/next links of the LRU list or the CLOCK
+ * reference bit. Indices stay valid when the array grows, and
+ * the clock hand sweeps the array in index order. Buffers and the node
+ * array come from the table's allocator, so in arena mode they are
+ * recycled through the table's free lists.
+ */
+
+#include "myrtx/collections/cache.h"
+#include "hash_table_internal.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_NONE UINT32_MAX
+#define CACHE_INITIAL_NODES 64
+
+typedef struct {
+    unsigned char* data;  /* Key padded to 8 bytes, then value; NULL if free.
+                           * The key table's entry points at the key. */
+    uint64_t hash;
+    size_t key_size;
+    size_t value_size;
+    uint32_t prev;        /* LRU: next more recently used */
+    uint32_t next;        /* LRU: next less recently used; free list link */
+    uint32_t referenced;  /* CLOCK reference bit */
+} cache_node_t;
+
+struct myrtx_cache_t {
+    myrtx_hash_table_t* table;  /* Key -> uint32_t node index */
+    cache_node_t* nodes;
+    uint32_t node_capacity;
+    uint32_t node_count;        /* Nodes handed out so far, in use or free */
+    uint32_t free_list;
+    uint32_t head;              /* LRU: most recently used */
+    uint32_t tail;              /* LRU: least recently used */
+    uint32_t hand;              /* CLOCK: next node to look at */
+    myrtx_cache_policy_t policy;
+    size_t max_entries;
+    size_t max_bytes;
+    size_t bytes;
+    myrtx_cache_evict_function evict_function;
+    void* user_data;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+};
+
+static inline size_t pad8(size_t size) {
+    return (size + 7) & ~(size_t)7;
+}
+
+static inline size_t data_size(size_t key_size, size_t value_size) {
+    return pad8(key_size) + value_size;
+}
+
+static inline void* node_value(const cache_node_t* node) {
+    return node->data + pad8(node->key_size);
+}
+
+/* Passes an entry to the callback and frees its buffer */
+static void release_data(myrtx_cache_t* cache, unsigned char* data, size_t key_size,
+                         size_t value_size) {
+    if (cache->evict_function) {
+        cache->evict_function(data, key_size, data + pad8(key_size), value_size,
+                              cache->user_data);
+    }
+    hash_table_release(cache->table, data, data_size(key_size, value_size));
+}
+
+/* Table entry of a node index returned by a lookup; the index is stored in
+ * the slot */
+static inline myrtx_hash_entry_t* index_entry(void* found) {
+    return (myrtx_hash_entry_t*)((unsigned char*)found -
+                                 offsetof(myrtx_hash_entry_t, value.bytes));
+}
+
+static void lru_unlink(myrtx_cache_t* cache, uint32_t index) {
+    cache_node_t* node = &cache->nodes[index];
+    if (node->prev != CACHE_NONE) {
+        cache->nodes[node->prev].next = node->next;
+    } else {
+        cache->head = node->next;
+    }
+    if (node->next != CACHE_NONE) {
+        cache->nodes[node->next].prev = node->prev;
+    } else {
+        cache->tail = node->prev;
+    }
+}
+
+static void lru_push_front(myrtx_cache_t* cache, uint32_t index) {
+    cache_node_t* node = &cache->nodes[index];
+    node->prev = CACHE_NONE;
+    node->next = cache->head;
+    if (cache->head != CACHE_NONE) {
+        cache->nodes[cache->head].prev = index;
+    } else {
+        cache->tail = index;
+    }
+    cache->head = index;
+}
+
+/* Marks a node as just used */
+static inline void touch(myrtx_cache_t* cache, uint32_t index) {
+    if (cache->policy == MYRTX_CACHE_CLOCK) {
+        cache->nodes[index].referenced = 1;
+    } else if (cache->head != index) {
+        lru_unlink(cache, index);
+        lru_push_front(cache, index);
+    }
+}
+
+/* Takes a free node, growing the node array if needed */
+static uint32_t node_alloc(myrtx_cache_t* cache) {
+    if (cache->free_list != CACHE_NONE) {
+        uint32_t index = cache->free_list;
+        cache->free_list = cache->nodes[index].next;
+        return index;
+    }
+
+    if (cache->node_count == cache->node_capacity) {
+        if (cache->node_capacity >= (CACHE_NONE - 1) / 2) {
+            return CACHE_NONE;
+        }
+        uint32_t capacity = cache->node_capacity * 2;
+        cache_node_t* nodes = hash_table_malloc(cache->table, capacity * sizeof(cache_node_t));
+        if (!nodes) {
+            return CACHE_NONE;
+        }
+        memcpy(nodes, cache->nodes, cache->node_count * sizeof(cache_node_t));
+        hash_table_release(cache->table, cache->nodes,
+                           cache->node_capacity * sizeof(cache_node_t));
+        cache->nodes = nodes;
+        cache->node_capacity = capacity;
+    }
+    return cache->node_count++;
+}
+
+static void node_free(myrtx_cache_t* cache, uint32_t index) {
+    cache->nodes[index].data = NULL;
+    cache->nodes[index].next = cache->free_list;
+    cache->free_list = index;
+}
+
+/* Removes a node along with its table entry */
+static void drop_node(myrtx_cache_t* cache, uint32_t index) {
+    cache_node_t* node = &cache->nodes[index];
+    myrtx_hash_table_remove_with_hash(cache->table, node->data, node->key_size, node->hash,
+                                      true, true);
+    if (cache->policy == MYRTX_CACHE_LRU) {
+        lru_unlink(cache, index);
+    }
+    cache->bytes -= node->key_size + node->value_size;
+    release_data(cache, node->data, node->key_size, node->value_size);
+    node_free(cache, index);
+}
+
+static uint32_t choose_victim(myrtx_cache_t* cache, uint32_t keep) {
+    if (myrtx_hash_table_size(cache->table) <= 1) {
+        return CACHE_NONE;
+    }
+
+    if (cache->policy == MYRTX_CACHE_LRU) {
+        return cache->tail != keep ? cache->tail : cache->nodes[keep].prev;
+    }
+
+    /* Another entry is in use, so two sweeps always find one unreferenced */
+    for (;;) {
+        uint32_t index = cache->hand;
+        cache->hand = index + 1 < cache->node_count ? index + 1 : 0;
+        cache_node_t* node = &cache->nodes[index];
+        if (!node->data || index == keep) {
+            continue;
+        }
+        if (node->referenced) {
+            node->referenced = 0;
+            continue;
+        }
+        return index;
+    }
+}
+
+static inline bool over_budget(const myrtx_cache_t* cache) {
+    return (cache->max_entries && myrtx_hash_table_size(cache->table) > cache->max_entries) ||
+           (cache->max_bytes && cache->bytes > cache->max_bytes);
+}
+
+/* Evicts entries until the budget is met; keep stays */
+static void evict_to_budget(myrtx_cache_t* cache, uint32_t keep) {
+    while (over_budget(cache)) {
+        uint32_t victim = choose_victim(cache, keep);
+        if (victim == CACHE_NONE) {
+            return;
+        }
+        drop_node(cache, victim);
+        cache->evictions++;
+    }
+}
+
+myrtx_cache_t* myrtx_cache_create(const myrtx_cache_options_t* options) {
+    if (!options || (options->max_entries == 0 && options->max_bytes == 0) ||
+        (options->policy != MYRTX_CACHE_LRU && options->policy != MYRTX_CACHE_CLOCK)) {
+        return NULL;
+    }
+
+    myrtx_cache_t* cache = options->arena
+        ? myrtx_arena_alloc(options->arena, sizeof(myrtx_cache_t))
+        : malloc(sizeof(myrtx_cache_t));
+    if (!cache) {
+        return NULL;
+    }
+    memset(cache, 0, sizeof(*cache));
+
+    myrtx_hash_table_options_t table_options = {0};
+    table_options.arena = options->arena;
+    table_options.hash_function = options->hash_function;
+    table_options.compare_function = options->compare_function;
+    table_options.hash64_function = options->hash64_function;
+    table_options.seed = options->seed;
+    table_options.probing = options->probing;
+    table_options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+    cache->table = myrtx_hash_table_create_ex(&table_options);
+    if (cache->table) {
+        cache->table->flags |= MYRTX_HASH_TABLE_KEYS_BORROWED;
+    }
+
+    cache->node_capacity = CACHE_INITIAL_NODES;
+    if (options->max_entries && options->max_entries < CACHE_INITIAL_NODES) {
+        /* One node more than the budget: a put stores before it evicts */
+        cache->node_capacity = (uint32_t)options->max_entries + 1;
+    }
+    cache->nodes = cache->table
+        ? hash_table_malloc(cache->table, cache->node_capacity * sizeof(cache_node_t))
+        : NULL;
+    if (!cache->nodes) {
+        myrtx_hash_table_free(cache->table, true, true);
+        if (!options->arena) {
+            free(cache);
+        }
+        return NULL;
+    }
+
+    cache->free_list = CACHE_NONE;
+    cache->head = CACHE_NONE;
+    cache->tail = CACHE_NONE;
+    cache->policy = options->policy;
+    cache->max_entries = options->max_entries;
+    cache->max_bytes = options->max_bytes;
+    cache->evict_function = options->evict_function;
+    cache->user_data = options->user_data;
+    return cache;
+}
+
+void myrtx_cache_free(myrtx_cache_t* cache) {
+    if (!cache) {
+        return;
+    }
+
+    bool arena = cache->table->arena != NULL;
+    myrtx_cache_clear(cache);
+    hash_table_release(cache->table, cache->nodes, cache->node_capacity * sizeof(cache_node_t));
+    myrtx_hash_table_free(cache->table, true, true);
+    if (!arena) {
+        free(cache);
+    }
+}
+
+bool myrtx_cache_put(myrtx_cache_t* cache, const void* key, size_t key_size,
+                     const void* value, size_t value_size) {
+    if (!cache || !key || (!value && value_size > 0)) {
+        return false;
+    }
+
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
+    if (value_size > SIZE_MAX - pad8(key_size) ||
+        (cache->max_bytes && key_size + value_size > cache->max_bytes)) {
+        return false;
+    }
+
+    unsigned char* data = hash_table_malloc(cache->table, data_size(key_size, value_size));
+    if (!data) {
+        return false;
+    }
+    memcpy(data, key, key_size);
+    if (value_size > 0) {
+        memcpy(data + pad8(key_size), value, value_size);
+    }
+
+    /* One probe: a new key is stored with the index of a fresh node, which
+     * goes back to the free list if the key was already cached */
+    uint32_t index = node_alloc(cache);
+    bool inserted = false;
+    void* found = index != CACHE_NONE
+        ? myrtx_hash_table_get_or_insert(cache->table, data, key_size, &index, sizeof(index),
+                                         &inserted)
+        : NULL;
+    if (!found) {
+        if (index != CACHE_NONE) {
+            node_free(cache, index);
+        }
+        hash_table_release(cache->table, data, data_size(key_size, value_size));
+        return false;
+    }
+
+    if (!inserted) {
+        /* Replace the buffer; the node keeps its place until touched */
+        node_free(cache, index);
+        memcpy(&index, found, sizeof(index));
+        index_entry(found)->key.ptr = data;
+        cache_node_t* node = &cache->nodes[index];
+        cache->bytes -= node->value_size;
+        release_data(cache, node->data, node->key_size, node->value_size);
+        node->data = data;
+        node->value_size = value_size;
+        touch(cache, index);
+    } else {
+        cache_node_t* node = &cache->nodes[index];
+        node->data = data;
+        node->hash = index_entry(found)->hash;
+        node->key_size = key_size;
+        node->value_size = value_size;
+        node->referenced = 0;
+        cache->bytes += key_size;
+        if (cache->policy == MYRTX_CACHE_LRU) {
+            lru_push_front(cache, index);
+        }
+    }
+
+    cache->bytes += value_size;
+    evict_to_budget(cache, index);
+    return true;
+}
+
+void* myrtx_cache_get(myrtx_cache_t* cache, const void* key, size_t key_size,
+                      size_t* value_size) {
+    if (!cache || !key) {
+        return NULL;
+    }
+
+    void* found;
+    if (!myrtx_hash_table_get(cache->table, key, key_size, &found, NULL)) {
+        cache->misses++;
+        return NULL;
+    }
+
+    uint32_t index;
+    memcpy(&index, found, sizeof(index));
+    cache->hits++;
+    touch(cache, index);
+
+    const cache_node_t* node = &cache->nodes[index];
+    if (value_size) {
+        *value_size = node->value_size;
+    }
+    return node_value(node);
+}
+
+bool myrtx_cache_contains_key(const myrtx_cache_t* cache, const void* key, size_t key_size) {
+    return cache && myrtx_hash_table_contains_key(cache->table, key, key_size);
+}
+
+bool myrtx_cache_remove(myrtx_cache_t* cache, const void* key, size_t key_size) {
+    if (!cache || !key) {
+        return false;
+    }
+
+    void* found;
+    if (!myrtx_hash_table_get(cache->table, key, key_size, &found, NULL)) {
+        return false;
+    }
+
+    uint32_t index;
+    memcpy(&index, found, sizeof(index));
+    drop_node(cache, index);
+    return true;
+}
+
+void myrtx_cache_clear(myrtx_cache_t* cache) {
+    if (!cache) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < cache->node_count; i++) {
+        cache_node_t* node = &cache->nodes[i];
+        if (node->data) {
+            release_data(cache, node->data, node->key_size, node->value_size);
+        }
+    }
+    myrtx_hash_table_clear(cache->table, true, true);
+
+    cache->node_count = 0;
+    cache->free_list = CACHE_NONE;
+    cache->head = CACHE_NONE;
+    cache->tail = CACHE_NONE;
+    cache->hand = 0;
+    cache->bytes = 0;
+}
+
+size_t myrtx_cache_size(const myrtx_cache_t* cache) {
+    return cache ? myrtx_hash_table_size(cache->table) : 0;
+}
+
+void myrtx_cache_stats(const myrtx_cache_t* cache, myrtx_cache_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    if (!cache) {
+        return;
+    }
+    stats->hits = cache->hits;
+    stats->misses = cache->misses;
+    stats->evictions = cache->evictions;
+    stats->entries = myrtx_hash_table_size(cache->table);
+    stats->bytes = cache->bytes;
+}
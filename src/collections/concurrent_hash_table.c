@@ -0,0 +1,362 @@
+/**
+ * @file concurrent_hash_table.c
+ * @brief Sharded hash table with per-shard writer locks and seqlock reads
+ *
+ * Each shard owns an arena-backed Robin Hood table with inline storage and
+ * a sequence counter that is odd while a writer holds the shard. A reader
+ * loads the counter, probes the shard's entry array with relaxed loads,
+ * copying each entry whose hash matches, and accepts the result only if
+ * the counter is unchanged afterwards. Two properties make the racy loads safe
+ * to act on before that final check:
+ *
+ * - Nothing a reader can reach is ever unmapped while the table lives.
+ *   Released entry arrays, keys and values go to the shard table's arena
+ *   free lists and stay in the arena until the table is freed.
+ * - Before following a key or value pointer, the reader rechecks the
+ *   counter, so the pointer and its size belong to one consistent entry.
+ *
+ * A read that keeps failing validation takes the shard lock instead.
+ * Under ThreadSanitizer the optimistic attempts are excluded from race
+ * checking; the locked fallback and all writers are still checked.
+ */
+
+#include "myrtx/collections/concurrent_hash_table.h"
+#include "hash_table_internal.h"
+#include "platform/atomic.h"
+#include "platform/thread.h"
+#include <string.h>
+
+/* Lock-free attempts before a reader falls back to the shard lock */
+#define CONCURRENT_READ_ATTEMPTS 4
+
+/* Shards start on their own cache lines */
+#define CONCURRENT_CACHE_LINE 64
+
+typedef struct concurrent_shard {
+    uint64_t seq;                /* Odd while a writer changes the table */
+    myrtx_hash_table_t* table;   /* Robin Hood, inline storage, in arena */
+    myrtx_mutex_t lock;          /* Serializes writers */
+    myrtx_arena_t arena;         /* Backs the table and everything in it */
+} concurrent_shard_t;
+
+struct myrtx_concurrent_hash_table_t {
+    unsigned char* shard_memory; /* Allocation holding the shards */
+    concurrent_shard_t* shards;  /* shard_count shards, shard_stride bytes apart */
+    size_t shard_stride;
+    size_t shard_count;
+    unsigned int shard_shift;    /* 64 - log2(shard_count) */
+    myrtx_hash_function hash_func;
+    myrtx_hash64_function hash64_func;
+    uint64_t seed;
+    myrtx_key_compare_function compare_func;
+};
+
+typedef enum {
+    READ_MISSING,
+    READ_FOUND,
+    READ_RETRY
+} concurrent_read_result_t;
+
+static inline concurrent_shard_t* shard_at(const myrtx_concurrent_hash_table_t* table,
+                                           size_t index) {
+    return (concurrent_shard_t*)((unsigned char*)table->shards + index * table->shard_stride);
+}
+
+/* Same hash as each shard table computes, so it is passed on to them */
+static inline uint64_t concurrent_hash(const myrtx_concurrent_hash_table_t* table,
+                                       const void* key, size_t key_size) {
+    if (table->hash64_func) {
+        return table->hash64_func(key, key_size, table->seed);
+    }
+    return (uint64_t)table->hash_func(key, key_size) * 0x9E3779B97F4A7C15ull;
+}
+
+/* High hash bits pick the shard; the shard table uses the low bits */
+static inline concurrent_shard_t* shard_for(const myrtx_concurrent_hash_table_t* table,
+                                            uint64_t hash) {
+    size_t index = table->shard_count > 1 ? (size_t)(hash >> table->shard_shift) : 0;
+    return shard_at(table, index);
+}
+
+static void shard_write_begin(concurrent_shard_t* shard) {
+    myrtx_mutex_lock(&shard->lock);
+    myrtx_atomic_store_relaxed_u64(&shard->seq, shard->seq + 1);
+    myrtx_atomic_fence_release();
+}
+
+static void shard_write_end(concurrent_shard_t* shard) {
+    myrtx_atomic_store_release_u64(&shard->seq, shard->seq + 1);
+    myrtx_mutex_unlock(&shard->lock);
+}
+
+/* Whether no writer has touched the shard since the counter read @p seq */
+static inline bool shard_unchanged(const concurrent_shard_t* shard, uint64_t seq) {
+    myrtx_atomic_fence_acquire();
+    return myrtx_atomic_load_relaxed_u64(&shard->seq) == seq;
+}
+
+/* One optimistic lookup: a Robin Hood probe over copies of the entries */
+static concurrent_read_result_t shard_read(const myrtx_concurrent_hash_table_t* table,
+                                           const concurrent_shard_t* shard,
+                                           const void* key, size_t key_size, uint64_t hash,
+                                           void* value_out, size_t value_capacity,
+                                           size_t* value_size) {
+    uint64_t seq = myrtx_atomic_load_acquire_u64(&shard->seq);
+    if (seq & 1) {
+        return READ_RETRY;
+    }
+
+    const myrtx_hash_table_t* shard_table = shard->table;
+    const myrtx_hash_entry_t* entries = shard_table->entries;
+    size_t capacity = shard_table->capacity;
+    if (!shard_unchanged(shard, seq)) {
+        return READ_RETRY;
+    }
+
+    size_t mask = capacity - 1;
+    size_t index = hash & mask;
+    for (size_t distance = 0; distance <= mask; distance++, index = (index + 1) & mask) {
+        uint8_t status = myrtx_atomic_load_relaxed_u8(&entries[index].status);
+        uint64_t entry_hash = myrtx_atomic_load_relaxed_u64(&entries[index].hash);
+        if (status != MYRTX_HASH_ENTRY_OCCUPIED ||
+            ((index - (entry_hash & mask)) & mask) < distance) {
+            break;
+        }
+        if (entry_hash != hash) {
+            continue;
+        }
+        myrtx_hash_entry_t entry;
+        myrtx_atomic_copy_relaxed(&entry, &entries[index], sizeof(entry));
+
+        /* Pointers and sizes of this copy are consistent only if validated */
+        bool pointers = (entry.storage & (MYRTX_HASH_STORAGE_KEY_INLINE |
+                                          MYRTX_HASH_STORAGE_VALUE_INLINE)) !=
+                        (MYRTX_HASH_STORAGE_KEY_INLINE | MYRTX_HASH_STORAGE_VALUE_INLINE);
+        size_t entry_key_size = entry.key_size;
+        size_t entry_value_size = entry.value_size;
+        if (pointers) {
+            if (!shard_unchanged(shard, seq)) {
+                return READ_RETRY;
+            }
+        } else {
+            /* Torn sizes must not reach past the inline buffers of the copy */
+            if (entry_key_size > MYRTX_HASH_INLINE_SIZE) {
+                entry_key_size = MYRTX_HASH_INLINE_SIZE;
+            }
+            if (entry_value_size > MYRTX_HASH_INLINE_SIZE) {
+                entry_value_size = MYRTX_HASH_INLINE_SIZE;
+            }
+        }
+        if (!table->compare_func(hash_entry_key(&entry), entry_key_size, key, key_size)) {
+            continue;
+        }
+
+        if (value_capacity > 0) {
+            size_t copy = entry_value_size < value_capacity ? entry_value_size : value_capacity;
+            memcpy(value_out, hash_entry_value(&entry), copy);
+        }
+        if (!shard_unchanged(shard, seq)) {
+            return READ_RETRY;
+        }
+        if (value_size) {
+            *value_size = entry.value_size;
+        }
+        return READ_FOUND;
+    }
+
+    return shard_unchanged(shard, seq) ? READ_MISSING : READ_RETRY;
+}
+
+/* Lookup under the shard lock, for readers that keep losing to writers */
+static bool shard_read_locked(concurrent_shard_t* shard, const void* key, size_t key_size,
+                              uint64_t hash, void* value_out, size_t value_capacity,
+                              size_t* value_size) {
+    void* value = NULL;
+    size_t stored_size = 0;
+
+    myrtx_mutex_lock(&shard->lock);
+    bool found = myrtx_hash_table_get_with_hash(shard->table, key, key_size, hash, &value,
+                                                &stored_size);
+    if (found && value_capacity > 0) {
+        memcpy(value_out, value, stored_size < value_capacity ? stored_size : value_capacity);
+    }
+    myrtx_mutex_unlock(&shard->lock);
+
+    if (found && value_size) {
+        *value_size = stored_size;
+    }
+    return found;
+}
+
+myrtx_concurrent_hash_table_t* myrtx_concurrent_hash_table_create(
+    const myrtx_concurrent_hash_table_options_t* options) {
+    if (!options || !options->compare_function ||
+        (options->hash_function == NULL) == (options->hash64_function == NULL)) {
+        return NULL;
+    }
+
+    size_t shard_count = options->shard_count ? options->shard_count
+                                              : MYRTX_CONCURRENT_HASH_DEFAULT_SHARDS;
+    if ((shard_count & (shard_count - 1)) != 0 || shard_count > MYRTX_CONCURRENT_HASH_MAX_SHARDS) {
+        return NULL;
+    }
+
+    myrtx_concurrent_hash_table_t* table = calloc(1, sizeof(myrtx_concurrent_hash_table_t));
+    if (!table) {
+        return NULL;
+    }
+
+    table->shard_stride = (sizeof(concurrent_shard_t) + CONCURRENT_CACHE_LINE - 1) &
+                          ~(size_t)(CONCURRENT_CACHE_LINE - 1);
+    table->shard_memory = malloc(table->shard_stride * shard_count + CONCURRENT_CACHE_LINE - 1);
+    if (!table->shard_memory) {
+        free(table);
+        return NULL;
+    }
+    uintptr_t base = ((uintptr_t)table->shard_memory + CONCURRENT_CACHE_LINE - 1) &
+                     ~(uintptr_t)(CONCURRENT_CACHE_LINE - 1);
+    table->shards = (concurrent_shard_t*)base;
+
+    table->shard_shift = 64;
+    for (size_t n = shard_count; n > 1; n >>= 1) {
+        table->shard_shift--;
+    }
+    table->hash_func = options->hash_function;
+    table->hash64_func = options->hash64_function;
+    table->seed = options->seed;
+    if (table->hash64_func && table->seed == 0) {
+        table->seed = myrtx_hash_random_seed();
+    }
+    table->compare_func = options->compare_function;
+
+    myrtx_hash_table_options_t shard_options = {0};
+    shard_options.initial_capacity = options->initial_capacity / shard_count;
+    shard_options.hash_function = table->hash_func;
+    shard_options.hash64_function = table->hash64_func;
+    shard_options.seed = table->seed;
+    shard_options.compare_function = table->compare_func;
+    shard_options.probing = MYRTX_HASH_PROBING_ROBIN_HOOD;
+    shard_options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+
+    for (size_t i = 0; i < shard_count; i++) {
+        concurrent_shard_t* shard = shard_at(table, i);
+        shard->seq = 0;
+        shard->table = NULL;
+        if (!myrtx_arena_init(&shard->arena, 0)) {
+            table->shard_count = i;
+            myrtx_concurrent_hash_table_free(table);
+            return NULL;
+        }
+        myrtx_mutex_init(&shard->lock);
+        table->shard_count = i + 1;
+
+        shard_options.arena = &shard->arena;
+        shard->table = myrtx_hash_table_create_ex(&shard_options);
+        if (!shard->table) {
+            myrtx_concurrent_hash_table_free(table);
+            return NULL;
+        }
+    }
+
+    return table;
+}
+
+void myrtx_concurrent_hash_table_free(myrtx_concurrent_hash_table_t* table) {
+    if (!table) {
+        return;
+    }
+
+    /* The arenas hold the tables, their arrays, keys and values */
+    for (size_t i = 0; i < table->shard_count; i++) {
+        concurrent_shard_t* shard = shard_at(table, i);
+        myrtx_mutex_destroy(&shard->lock);
+        myrtx_arena_free(&shard->arena);
+    }
+    free(table->shard_memory);
+    free(table);
+}
+
+bool myrtx_concurrent_hash_table_put(myrtx_concurrent_hash_table_t* table,
+                                     const void* key, size_t key_size,
+                                     const void* value, size_t value_size) {
+    if (!table || !key || !value) {
+        return false;
+    }
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
+
+    uint64_t hash = concurrent_hash(table, key, key_size);
+    concurrent_shard_t* shard = shard_for(table, hash);
+    shard_write_begin(shard);
+    bool result = myrtx_hash_table_put_with_hash(shard->table, key, key_size, value, value_size,
+                                                 hash);
+    shard_write_end(shard);
+    return result;
+}
+
+bool myrtx_concurrent_hash_table_get(const myrtx_concurrent_hash_table_t* table,
+                                     const void* key, size_t key_size,
+                                     void* value_out, size_t value_capacity,
+                                     size_t* value_size) {
+    if (!table || !key || (!value_out && value_capacity > 0)) {
+        return false;
+    }
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
+
+    uint64_t hash = concurrent_hash(table, key, key_size);
+    concurrent_shard_t* shard = shard_for(table, hash);
+    for (int attempt = 0; attempt < CONCURRENT_READ_ATTEMPTS; attempt++) {
+        MYRTX_SPECULATIVE_READS_BEGIN();
+        concurrent_read_result_t result = shard_read(table, shard, key, key_size, hash,
+                                                     value_out, value_capacity, value_size);
+        MYRTX_SPECULATIVE_READS_END();
+        if (result != READ_RETRY) {
+            return result == READ_FOUND;
+        }
+    }
+    return shard_read_locked(shard, key, key_size, hash, value_out, value_capacity, value_size);
+}
+
+bool myrtx_concurrent_hash_table_contains_key(const myrtx_concurrent_hash_table_t* table,
+                                              const void* key, size_t key_size) {
+    return myrtx_concurrent_hash_table_get(table, key, key_size, NULL, 0, NULL);
+}
+
+bool myrtx_concurrent_hash_table_remove(myrtx_concurrent_hash_table_t* table,
+                                        const void* key, size_t key_size) {
+    if (!table || !key) {
+        return false;
+    }
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
+
+    uint64_t hash = concurrent_hash(table, key, key_size);
+    concurrent_shard_t* shard = shard_for(table, hash);
+    shard_write_begin(shard);
+    bool result = myrtx_hash_table_remove_with_hash(shard->table, key, key_size, hash, true, true);
+    shard_write_end(shard);
+    return result;
+}
+
+size_t myrtx_concurrent_hash_table_size(const myrtx_concurrent_hash_table_t* table) {
+    if (!table) {
+        return 0;
+    }
+
+    size_t size = 0;
+    for (size_t i = 0; i < table->shard_count; i++) {
+        concurrent_shard_t* shard = shard_at(table, i);
+        myrtx_mutex_lock(&shard->lock);
+        size += myrtx_hash_table_size(shard->table);
+        myrtx_mutex_unlock(&shard->lock);
+    }
+    return size;
+}
+
+size_t myrtx_concurrent_hash_table_shard_count(const myrtx_concurrent_hash_table_t* table) {
+    return table ? table->shard_count : 0;
+}
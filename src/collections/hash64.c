@@ -0,0 +1,157 @@
+/**
+ * @file hash64.c
+ * @brief Seeded 64-bit hash family (wyhash) and table seeds
+ *
+ * The core is wyhash (final version 4): keys are read 8 bytes at a time and
+ * folded with 64x64->128-bit multiplications. Keys of 4, 8 and 16 bytes,
+ * the common integer and pair-of-integers cases, get branch-free paths that
+ * produce the same values as the general code.
+ */
+
+#include "myrtx/collections/hash_table.h"
+#include "platform/thread.h"
+#include <string.h>
+#include <time.h>
+
+/* wyhash default secret */
+static const uint64_t wy_secret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+    0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+
+/* 128-bit product of *a and *b: low half into *a, high half into *b */
+static inline void wy_mum(uint64_t* a, uint64_t* b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ unsigned __int128 r = *a;
+    r *= *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    *a = lo;
+    *b = hi;
+#endif
+}
+
+static inline uint64_t wy_mix(uint64_t a, uint64_t b) {
+    wy_mum(&a, &b);
+    return a ^ b;
+}
+
+/* Unaligned little-endian reads; memcpy compiles to a single load */
+static inline uint64_t wy_read8(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t wy_read4(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+/* Final fold shared by all paths */
+static inline uint64_t wy_finish(uint64_t a, uint64_t b, uint64_t seed, size_t len) {
+    a ^= wy_secret[1];
+    b ^= seed;
+    wy_mum(&a, &b);
+    return wy_mix(a ^ wy_secret[0] ^ (uint64_t)len, b ^ wy_secret[1]);
+}
+
+uint64_t myrtx_hash64_bytes(const void* key, size_t key_size, uint64_t seed) {
+    const uint8_t* p = (const uint8_t*)key;
+    size_t len = key_size;
+    uint64_t a, b;
+
+    seed ^= wy_mix(seed ^ wy_secret[0], wy_secret[1]);
+
+    switch (len) {
+    case 4:
+        a = (wy_read4(p) << 32) | wy_read4(p);
+        return wy_finish(a, a, seed, len);
+    case 8: {
+        uint64_t v = wy_read8(p);
+        return wy_finish((v << 32) | (v >> 32), v, seed, len);
+    }
+    case 16: {
+        uint64_t lo = wy_read8(p), hi = wy_read8(p + 8);
+        a = (lo << 32) | (hi & 0xFFFFFFFFull);
+        b = (hi & 0xFFFFFFFF00000000ull) | (lo >> 32);
+        return wy_finish(a, b, seed, len);
+    }
+    default:
+        break;
+    }
+
+    if (len <= 16) {
+        if (len >= 4) {
+            size_t mid = (len >> 3) << 2;
+            a = (wy_read4(p) << 32) | wy_read4(p + mid);
+            b = (wy_read4(p + len - 4) << 32) | wy_read4(p + len - 4 - mid);
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = wy_mix(wy_read8(p) ^ wy_secret[1], wy_read8(p + 8) ^ seed);
+                see1 = wy_mix(wy_read8(p + 16) ^ wy_secret[2], wy_read8(p + 24) ^ see1);
+                see2 = wy_mix(wy_read8(p + 32) ^ wy_secret[3], wy_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = wy_mix(wy_read8(p) ^ wy_secret[1], wy_read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = wy_read8(p + i - 16);
+        b = wy_read8(p + i - 8);
+    }
+
+    return wy_finish(a, b, seed, len);
+}
+
+uint64_t myrtx_hash64_string(const void* key, size_t key_size, uint64_t seed) {
+    if (key_size == 0) {
+        key_size = strlen((const char*)key);
+    }
+    return myrtx_hash64_bytes(key, key_size, seed);
+}
+
+uint64_t myrtx_hash_random_seed(void) {
+    static myrtx_mutex_t lock = MYRTX_MUTEX_INITIALIZER;
+    static uint64_t state;
+    uint64_t local = 0;
+
+    myrtx_mutex_lock(&lock);
+    if (state == 0) {
+        /* Stack and data addresses vary with ASLR, the clocks with time */
+        state = wy_mix((uint64_t)(uintptr_t)&local ^ wy_secret[2],
+                       (uint64_t)(uintptr_t)&state ^ ((uint64_t)time(NULL) << 20) ^
+                           (uint64_t)clock());
+    }
+    state += 0x9E3779B97F4A7C15ull;
+    local = state;
+    myrtx_mutex_unlock(&lock);
+
+    /* splitmix64 finalizer */
+    local = (local ^ (local >> 30)) * 0xBF58476D1CE4E5B9ull;
+    local = (local ^ (local >> 27)) * 0x94D049BB133111EBull;
+    local ^= local >> 31;
+    return local ? local : 1;
+}
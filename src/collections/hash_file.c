@@ -0,0 +1,318 @@
+/**
+ * @file hash_file.c
+ * @brief Writer and mmap-based reader of read-only hash table files
+ *
+ * File layout, all integers in the writer's byte order:
+ *
+ *   header   64 bytes, see hash_file_header_t
+ *   slots    slot_count uint64_t, a power of two, at most 3/4 full; 0 marks
+ *            an empty slot, otherwise the top 16 bits hold the top 16 bits
+ *            of the key's hash and the low 48 bits the record's file offset
+ *   records  per entry: uint32_t key size, uint32_t value size, the key and
+ *            the value, each padded to a multiple of 8 bytes
+ *
+ * Slots are probed linearly from hash & (slot_count - 1). Records start at
+ * 8-byte aligned offsets and the mapping is page aligned, so values are
+ * 8-byte aligned in memory.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "myrtx/collections/hash_file.h"
+#include "hash_table_internal.h"
+#include "platform/file_map.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HASH_FILE_MAGIC "MYRTXHF"
+#define HASH_FILE_VERSION 1
+#define HASH_FILE_BYTE_ORDER 0x01020304u
+
+/* Fixed so that the same table always produces the same file */
+#define HASH_FILE_SEED 0x6D7972747848465full
+
+#define HASH_FILE_OFFSET_BITS 48
+#define HASH_FILE_OFFSET_MASK ((UINT64_C(1) << HASH_FILE_OFFSET_BITS) - 1)
+#define HASH_FILE_MIN_SLOTS 8
+
+typedef struct {
+    char magic[8];           /* HASH_FILE_MAGIC with its terminator */
+    uint32_t version;
+    uint32_t byte_order;     /* HASH_FILE_BYTE_ORDER as written */
+    uint64_t count;          /* Number of records */
+    uint64_t slot_count;
+    uint64_t seed;           /* Seed for myrtx_hash64_bytes */
+    uint64_t slots_offset;
+    uint64_t records_offset;
+    uint64_t file_size;
+} hash_file_header_t;
+
+typedef struct {
+    uint32_t key_size;
+    uint32_t value_size;
+} hash_file_record_t;
+
+struct myrtx_hash_file_t {
+    myrtx_file_map_t map;
+    const unsigned char* base;
+    const uint64_t* slots;
+    uint64_t mask;
+    uint64_t seed;
+    uint64_t count;
+    uint64_t records_offset;
+};
+
+static inline uint64_t pad8(uint64_t size) {
+    return (size + 7) & ~UINT64_C(7);
+}
+
+static inline uint64_t record_size(size_t key_size, size_t value_size) {
+    return sizeof(hash_file_record_t) + pad8(key_size) + pad8(value_size);
+}
+
+/* Writes data followed by zero bytes up to the next 8-byte boundary */
+static bool write_padded(FILE* out, const void* data, size_t size) {
+    static const unsigned char zeros[8];
+    if (size > 0 && fwrite(data, 1, size, out) != size) {
+        return false;
+    }
+    size_t padding = (size_t)(pad8(size) - size);
+    return padding == 0 || fwrite(zeros, 1, padding, out) == padding;
+}
+
+/* Enters all entries into the slots and computes the file size. Expired
+ * entries are skipped, so the count may be lower than the table's size. */
+static bool build_slots(const myrtx_hash_table_t* table, uint64_t* slots, uint64_t mask,
+                        uint64_t records_offset, uint64_t* count, uint64_t* file_size) {
+    myrtx_hash_table_iter_t iter;
+    const void* key;
+    size_t key_size;
+    void* value;
+    size_t value_size;
+    uint64_t offset = records_offset;
+    *count = 0;
+
+    myrtx_hash_table_iter_init(&iter, table);
+    while (myrtx_hash_table_iter_next(&iter, &key, &key_size, &value, &value_size)) {
+        if (key_size > UINT32_MAX || value_size > UINT32_MAX ||
+            offset > HASH_FILE_OFFSET_MASK) {
+            return false;
+        }
+
+        uint64_t hash = myrtx_hash64_bytes(key, key_size, HASH_FILE_SEED);
+        uint64_t index = hash & mask;
+        while (slots[index] != 0) {
+            index = (index + 1) & mask;
+        }
+        slots[index] = (hash & ~HASH_FILE_OFFSET_MASK) | offset;
+        offset += record_size(key_size, value_size);
+        (*count)++;
+    }
+
+    *file_size = offset;
+    return true;
+}
+
+static bool write_records(const myrtx_hash_table_t* table, FILE* out) {
+    myrtx_hash_table_iter_t iter;
+    const void* key;
+    size_t key_size;
+    void* value;
+    size_t value_size;
+
+    myrtx_hash_table_iter_init(&iter, table);
+    while (myrtx_hash_table_iter_next(&iter, &key, &key_size, &value, &value_size)) {
+        hash_file_record_t record = {(uint32_t)key_size, (uint32_t)value_size};
+        if (fwrite(&record, sizeof(record), 1, out) != 1 ||
+            !write_padded(out, key, key_size) || !write_padded(out, value, value_size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool myrtx_hash_file_write(const myrtx_hash_table_t* table, const char* path) {
+    if (!table || !path) {
+        return false;
+    }
+
+    size_t count = myrtx_hash_table_size(table);
+    if (count > SIZE_MAX / 2) {
+        return false;
+    }
+    size_t slot_count = next_power_of_2(count + count / 3 + 1);
+    if (slot_count < HASH_FILE_MIN_SLOTS) {
+        slot_count = HASH_FILE_MIN_SLOTS;
+    }
+    uint64_t* slots = calloc(slot_count, sizeof(uint64_t));
+    if (!slots) {
+        return false;
+    }
+
+    hash_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HASH_FILE_MAGIC, sizeof(HASH_FILE_MAGIC));
+    header.version = HASH_FILE_VERSION;
+    header.byte_order = HASH_FILE_BYTE_ORDER;
+    header.slot_count = slot_count;
+    header.seed = HASH_FILE_SEED;
+    header.slots_offset = sizeof(header);
+    header.records_offset = header.slots_offset + (uint64_t)slot_count * sizeof(uint64_t);
+
+    if (!build_slots(table, slots, slot_count - 1, header.records_offset, &header.count,
+                     &header.file_size)) {
+        free(slots);
+        return false;
+    }
+
+    FILE* out = fopen(path, "wb");
+    if (!out) {
+        free(slots);
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              fwrite(slots, sizeof(uint64_t), slot_count, out) == slot_count &&
+              write_records(table, out);
+    ok = fclose(out) == 0 && ok;
+    free(slots);
+
+    if (!ok) {
+        remove(path);
+    }
+    return ok;
+}
+
+/* Checks the header and layout of a mapped file */
+static bool header_valid(const hash_file_header_t* header, size_t size) {
+    if (memcmp(header->magic, HASH_FILE_MAGIC, sizeof(HASH_FILE_MAGIC)) != 0 ||
+        header->version != HASH_FILE_VERSION || header->byte_order != HASH_FILE_BYTE_ORDER ||
+        header->file_size != size) {
+        return false;
+    }
+
+    uint64_t slot_count = header->slot_count;
+    if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0 ||
+        header->count >= slot_count || header->slots_offset != sizeof(*header) ||
+        slot_count > (size - sizeof(*header)) / sizeof(uint64_t)) {
+        return false;
+    }
+    return header->records_offset == header->slots_offset + slot_count * sizeof(uint64_t);
+}
+
+myrtx_hash_file_t* myrtx_hash_file_open(const char* path) {
+    if (!path) {
+        return NULL;
+    }
+
+    myrtx_hash_file_t* file = malloc(sizeof(myrtx_hash_file_t));
+    if (!file) {
+        return NULL;
+    }
+    if (!myrtx_file_map_open(&file->map, path)) {
+        free(file);
+        return NULL;
+    }
+
+    const hash_file_header_t* header = file->map.data;
+    if (file->map.size < sizeof(*header) || !header_valid(header, file->map.size)) {
+        myrtx_file_map_close(&file->map);
+        free(file);
+        return NULL;
+    }
+
+    file->base = file->map.data;
+    file->slots = (const uint64_t*)(file->base + header->slots_offset);
+    file->mask = header->slot_count - 1;
+    file->seed = header->seed;
+    file->count = header->count;
+    file->records_offset = header->records_offset;
+    return file;
+}
+
+void myrtx_hash_file_close(myrtx_hash_file_t* file) {
+    if (!file) {
+        return;
+    }
+
+    myrtx_file_map_close(&file->map);
+    free(file);
+}
+
+/* Finds the record of a key; NULL if it is missing */
+static const hash_file_record_t* find_record(const myrtx_hash_file_t* file, const void* key,
+                                             size_t key_size) {
+    uint64_t hash = myrtx_hash64_bytes(key, key_size, file->seed);
+    uint64_t tag = hash & ~HASH_FILE_OFFSET_MASK;
+    uint64_t index = hash & file->mask;
+
+    /* Bounded by the slot count so that a corrupt, full slot array ends too */
+    for (uint64_t probes = 0; probes <= file->mask; probes++, index = (index + 1) & file->mask) {
+        uint64_t slot = file->slots[index];
+        if (slot == 0) {
+            return NULL;
+        }
+        if ((slot & ~HASH_FILE_OFFSET_MASK) != tag) {
+            continue;
+        }
+
+        /* The writer only produces 8-byte aligned record offsets */
+        uint64_t offset = slot & HASH_FILE_OFFSET_MASK;
+        if ((offset & 7) != 0 || offset < file->records_offset ||
+            offset > file->map.size - sizeof(hash_file_record_t)) {
+            return NULL;
+        }
+        const hash_file_record_t* record = (const hash_file_record_t*)(file->base + offset);
+        if (record->key_size != key_size) {
+            continue;
+        }
+        if (record_size(record->key_size, record->value_size) > file->map.size - offset) {
+            return NULL;
+        }
+        if (memcmp(record + 1, key, key_size) == 0) {
+            return record;
+        }
+    }
+    return NULL;
+}
+
+bool myrtx_hash_file_get(const myrtx_hash_file_t* file, const void* key, size_t key_size,
+                         const void** value_out, size_t* value_size_out) {
+    if (!file || !key || !value_out) {
+        return false;
+    }
+
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
+
+    const hash_file_record_t* record = find_record(file, key, key_size);
+    if (!record) {
+        return false;
+    }
+
+    *value_out = (const unsigned char*)(record + 1) + pad8(record->key_size);
+    if (value_size_out) {
+        *value_size_out = record->value_size;
+    }
+    return true;
+}
+
+bool myrtx_hash_file_contains_key(const myrtx_hash_file_t* file, const void* key,
+                                  size_t key_size) {
+    if (!file || !key) {
+        return false;
+    }
+
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
+
+    return find_record(file, key, key_size) != NULL;
+}
+
+size_t myrtx_hash_file_size(const myrtx_hash_file_t* file) {
+    return file ? (size_t)file->count : 0;
+}
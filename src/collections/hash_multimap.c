@@ -0,0 +1,195 @@
+/**
+ * @file hash_multimap.c
+ * @brief Hash multimap on top of the hash table core
+ *
+ * The multimap keeps a myrtx_hash_table_t with inline storage whose value
+ * for each key is a 16-byte multimap_values_t, held inline in the entry.
+ * It points to the key's value array, which is allocated through the
+ * table's own allocator so that arena mode recycles outgrown arrays.
+ */
+
+#include "myrtx/collections/hash_multimap.h"
+#include "hash_table_internal.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Value array of one key; fits the 16 inline value bytes of an entry */
+typedef struct {
+    unsigned char* data;
+    uint32_t count;
+    uint32_t capacity;
+} multimap_values_t;
+
+struct myrtx_hash_multimap_t {
+    myrtx_hash_table_t* table;
+    size_t value_size;
+    size_t value_count;
+};
+
+/* Frees the value array of a key */
+static void release_values(myrtx_hash_multimap_t* map, multimap_values_t* values) {
+    if (values->data) {
+        hash_table_release(map->table, values->data, (size_t)values->capacity * map->value_size);
+    }
+}
+
+myrtx_hash_multimap_t* myrtx_hash_multimap_create(const myrtx_hash_table_options_t* options,
+                                                  size_t value_size) {
+    if (!options || value_size == 0) {
+        return NULL;
+    }
+
+    myrtx_hash_multimap_t* map = options->arena
+        ? myrtx_arena_alloc(options->arena, sizeof(myrtx_hash_multimap_t))
+        : malloc(sizeof(myrtx_hash_multimap_t));
+    if (!map) {
+        return NULL;
+    }
+
+    myrtx_hash_table_options_t table_options = *options;
+    table_options.flags |= MYRTX_HASH_TABLE_INLINE_STORAGE;
+    map->table = myrtx_hash_table_create_ex(&table_options);
+    if (!map->table) {
+        if (!options->arena) {
+            free(map);
+        }
+        return NULL;
+    }
+
+    map->value_size = value_size;
+    map->value_count = 0;
+    return map;
+}
+
+void myrtx_hash_multimap_free(myrtx_hash_multimap_t* map) {
+    if (!map) {
+        return;
+    }
+
+    bool arena = map->table->arena != NULL;
+    if (!arena) {
+        myrtx_hash_table_iter_t iter;
+        void* value;
+        myrtx_hash_table_iter_init(&iter, map->table);
+        while (myrtx_hash_table_iter_next(&iter, NULL, NULL, &value, NULL)) {
+            release_values(map, value);
+        }
+    }
+
+    myrtx_hash_table_free(map->table, true, true);
+    if (!arena) {
+        free(map);
+    }
+}
+
+bool myrtx_hash_multimap_add(myrtx_hash_multimap_t* map, const void* key, size_t key_size,
+                             const void* value) {
+    if (!map || !key || !value) {
+        return false;
+    }
+
+    static const multimap_values_t empty = {NULL, 0, 0};
+    multimap_values_t* values = myrtx_hash_table_get_or_insert(map->table, key, key_size, &empty,
+                                                               sizeof(empty), NULL);
+    if (!values) {
+        return false;
+    }
+
+    if (values->count == values->capacity) {
+        if (values->capacity > UINT32_MAX / 2 ||
+            (size_t)values->capacity * 2 > SIZE_MAX / map->value_size) {
+            return false;
+        }
+
+        uint32_t capacity = values->capacity ? values->capacity * 2 : 1;
+        unsigned char* data = hash_table_malloc(map->table, (size_t)capacity * map->value_size);
+        if (!data) {
+            return false;
+        }
+        if (values->count > 0) {
+            memcpy(data, values->data, (size_t)values->count * map->value_size);
+        }
+        release_values(map, values);
+        values->data = data;
+        values->capacity = capacity;
+    }
+
+    memcpy(values->data + (size_t)values->count * map->value_size, value, map->value_size);
+    values->count++;
+    map->value_count++;
+    return true;
+}
+
+const void* myrtx_hash_multimap_get(const myrtx_hash_multimap_t* map, const void* key,
+                                    size_t key_size, size_t* count) {
+    if (count) {
+        *count = 0;
+    }
+    if (!map || !key) {
+        return NULL;
+    }
+
+    void* value;
+    if (!myrtx_hash_table_get(map->table, key, key_size, &value, NULL)) {
+        return NULL;
+    }
+
+    const multimap_values_t* values = value;
+    if (count) {
+        *count = values->count;
+    }
+    return values->data;
+}
+
+bool myrtx_hash_multimap_remove(myrtx_hash_multimap_t* map, const void* key, size_t key_size) {
+    if (!map || !key) {
+        return false;
+    }
+
+    /* Hash once, then fetch the value array and remove the entry */
+    uint64_t hash = myrtx_hash_table_hash(map->table, key, key_size);
+    void* value;
+    if (!myrtx_hash_table_get_with_hash(map->table, key, key_size, hash, &value, NULL)) {
+        return false;
+    }
+
+    multimap_values_t values = *(multimap_values_t*)value;
+    if (!myrtx_hash_table_remove_with_hash(map->table, key, key_size, hash, true, true)) {
+        return false;
+    }
+
+    release_values(map, &values);
+    map->value_count -= values.count;
+    return true;
+}
+
+size_t myrtx_hash_multimap_key_count(const myrtx_hash_multimap_t* map) {
+    return map ? myrtx_hash_table_size(map->table) : 0;
+}
+
+size_t myrtx_hash_multimap_value_count(const myrtx_hash_multimap_t* map) {
+    return map ? map->value_count : 0;
+}
+
+void myrtx_hash_multimap_iter_init(myrtx_hash_multimap_iter_t* iter,
+                                   const myrtx_hash_multimap_t* map) {
+    myrtx_hash_table_iter_init(iter, map ? map->table : NULL);
+}
+
+bool myrtx_hash_multimap_iter_next(myrtx_hash_multimap_iter_t* iter, const void** key,
+                                   size_t* key_size, const void** values, size_t* count) {
+    void* value;
+    if (!myrtx_hash_table_iter_next(iter, key, key_size, &value, NULL)) {
+        return false;
+    }
+
+    const multimap_values_t* entry = value;
+    if (values) {
+        *values = entry->data;
+    }
+    if (count) {
+        *count = entry->count;
+    }
+    return true;
+}
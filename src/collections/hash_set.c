@@ -0,0 +1,65 @@
+/**
+ * @file hash_set.c
+ * @brief Hash set on top of the hash table core
+ *
+ * A myrtx_hash_set_t is a myrtx_hash_table_t with inline storage whose
+ * entries have a value size of 0. With inline storage an empty value
+ * always counts as inline, so create_entry() allocates nothing for it and
+ * only keys longer than 16 bytes get a buffer of their own.
+ */
+
+#include "myrtx/collections/hash_set.h"
+
+/* Any non-NULL address serves as the empty value */
+static const unsigned char no_value;
+
+static inline myrtx_hash_table_t* set_table(myrtx_hash_set_t* set) {
+    return (myrtx_hash_table_t*)set;
+}
+
+static inline const myrtx_hash_table_t* set_table_const(const myrtx_hash_set_t* set) {
+    return (const myrtx_hash_table_t*)set;
+}
+
+myrtx_hash_set_t* myrtx_hash_set_create(const myrtx_hash_table_options_t* options) {
+    if (!options) {
+        return NULL;
+    }
+
+    myrtx_hash_table_options_t table_options = *options;
+    table_options.flags |= MYRTX_HASH_TABLE_INLINE_STORAGE;
+    return (myrtx_hash_set_t*)myrtx_hash_table_create_ex(&table_options);
+}
+
+void myrtx_hash_set_free(myrtx_hash_set_t* set) {
+    myrtx_hash_table_free(set_table(set), true, true);
+}
+
+bool myrtx_hash_set_add(myrtx_hash_set_t* set, const void* key, size_t key_size, bool* added) {
+    return myrtx_hash_table_get_or_insert(set_table(set), key, key_size, &no_value, 0,
+                                          added) != NULL;
+}
+
+bool myrtx_hash_set_contains(const myrtx_hash_set_t* set, const void* key, size_t key_size) {
+    return myrtx_hash_table_contains_key(set_table_const(set), key, key_size);
+}
+
+bool myrtx_hash_set_remove(myrtx_hash_set_t* set, const void* key, size_t key_size) {
+    return myrtx_hash_table_remove(set_table(set), key, key_size, true, true);
+}
+
+size_t myrtx_hash_set_size(const myrtx_hash_set_t* set) {
+    return myrtx_hash_table_size(set_table_const(set));
+}
+
+void myrtx_hash_set_clear(myrtx_hash_set_t* set) {
+    myrtx_hash_table_clear(set_table(set), true, true);
+}
+
+void myrtx_hash_set_iter_init(myrtx_hash_set_iter_t* iter, const myrtx_hash_set_t* set) {
+    myrtx_hash_table_iter_init(iter, set_table_const(set));
+}
+
+bool myrtx_hash_set_iter_next(myrtx_hash_set_iter_t* iter, const void** key, size_t* key_size) {
+    return myrtx_hash_table_iter_next(iter, key, key_size, NULL, NULL);
+}
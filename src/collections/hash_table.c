@@ -1,129 +1,208 @@
-#include "myrtx/collections/hash_table.h"
+#include "hash_table_internal.h"
+#include "myrtx/context/trace.h"
 #include <string.h>
 #include <stdlib.h>
 #include <assert.h>
 
-/* Konstanten für die Hash-Tabelle */
-#define MYRTX_DEFAULT_CAPACITY 16
-#define MYRTX_DEFAULT_LOAD_FACTOR 0.75f
-
-/* Status eines Hash-Tabelleneintrags */
-typedef enum {
-    MYRTX_HASH_ENTRY_EMPTY = 0,
-    MYRTX_HASH_ENTRY_OCCUPIED,
-    MYRTX_HASH_ENTRY_DELETED
-} myrtx_hash_entry_status_t;
-
-/* Eintrag in der Hash-Tabelle */
-typedef struct {
-    void* key;
-    size_t key_size;
-    void* value;
-    size_t value_size;
-    myrtx_hash_entry_status_t status;
-    uint32_t hash;
-} myrtx_hash_entry_t;
-
-/* Hash-Tabellen-Struktur */
-struct myrtx_hash_table_t {
-    myrtx_hash_entry_t* entries;
-    size_t capacity;          /* Kapazität (Anzahl der möglichen Einträge) */
-    size_t size;              /* Anzahl der tatsächlich belegten Einträge */
-    size_t tombstones;        /* Anzahl der gelöschten Einträge (Grabsteine) */
-    float load_factor;        /* Schwellenwert für Auslastung */
-    myrtx_hash_function hash_func;
-    myrtx_key_compare_function compare_func;
-    myrtx_arena_t* arena;
-};
-
 /* Private Funktionen für Hash-Tabellen-Operationen */
 
-/* Speicherallokationsfunktion, die entweder die Arena oder malloc verwendet */
-static void* hash_table_malloc(myrtx_hash_table_t* table, size_t size) {
-    if (table->arena) {
-        return myrtx_arena_alloc(table->arena, size);
-    } else {
-        return malloc(size);
-    }
-}
-
-/* Helfer-Funktion zum Freigeben von Speicher - wird aktuell nicht genutzt */
-#ifdef UNUSED_FUNCTION
-static void hash_table_free(myrtx_hash_table_t* table, void* ptr) {
-    if (!table->arena && ptr) {
-        free(ptr);
-    }
-}
-#endif
-
-/* Findet die nächsthöhere Potenz von 2 */
-static size_t next_power_of_2(size_t n) {
-    size_t power = 1;
-    while (power < n) {
-        power *= 2;
-    }
-    return power;
-}
+/* Value offset in a joined key+value block */
+#define HASH_VALUE_ALIGN 16
+#define HASH_JOINED_OFFSET(key_size) \
+    (((key_size) + HASH_VALUE_ALIGN - 1) & ~(size_t)(HASH_VALUE_ALIGN - 1))
 
 /* Erstellt einen neuen Hash-Tabelleneintrag */
 static myrtx_hash_entry_t create_entry(myrtx_hash_table_t* table, 
                                      const void* key, size_t key_size,
                                      const void* value, size_t value_size, 
-                                     uint32_t hash) {
+                                     uint64_t hash) {
     myrtx_hash_entry_t entry;
     
     /* Speicher für Schlüssel und Wert allozieren und kopieren */
     entry.key_size = key_size;
     entry.value_size = value_size;
     entry.status = MYRTX_HASH_ENTRY_OCCUPIED;
+    entry.storage = 0;
+    hash_entry_set_expiry(&entry, 0);
     entry.hash = hash;
     
+    if (table->flags & MYRTX_HASH_TABLE_INLINE_STORAGE) {
+        bool borrowed = (table->flags & MYRTX_HASH_TABLE_KEYS_BORROWED) != 0;
+        bool key_inline = !borrowed && key_size <= MYRTX_HASH_INLINE_SIZE;
+        bool value_inline = value_size <= MYRTX_HASH_INLINE_SIZE;
+        
+        if (!borrowed && !key_inline && !value_inline) {
+            /* One block: key, padding, value */
+            size_t offset = HASH_JOINED_OFFSET(key_size);
+            unsigned char* block = hash_table_malloc(table, offset + value_size);
+            if (!block) {
+                entry.status = MYRTX_HASH_ENTRY_EMPTY;
+                return entry;
+            }
+            memcpy(block, key, key_size);
+            memcpy(block + offset, value, value_size);
+            entry.key.ptr = block;
+            entry.value.ptr = block + offset;
+            entry.storage = MYRTX_HASH_STORAGE_VALUE_JOINED;
+            return entry;
+        }
+        
+        if (borrowed) {
+            entry.key.ptr = (void*)key;
+        } else if (key_inline) {
+            memcpy(entry.key.bytes, key, key_size);
+            entry.storage |= MYRTX_HASH_STORAGE_KEY_INLINE;
+        } else {
+            entry.key.ptr = hash_table_malloc(table, key_size);
+            if (!entry.key.ptr) {
+                entry.status = MYRTX_HASH_ENTRY_EMPTY;
+                return entry;
+            }
+            memcpy(entry.key.ptr, key, key_size);
+        }
+        
+        if (value_inline) {
+            memcpy(entry.value.bytes, value, value_size);
+            entry.storage |= MYRTX_HASH_STORAGE_VALUE_INLINE;
+        } else {
+            /* The key is inline or borrowed here, so nothing to undo on failure */
+            entry.value.ptr = hash_table_malloc(table, value_size);
+            if (!entry.value.ptr) {
+                entry.status = MYRTX_HASH_ENTRY_EMPTY;
+                return entry;
+            }
+            memcpy(entry.value.ptr, value, value_size);
+        }
+        return entry;
+    }
+    
     /* Schlüssel kopieren */
-    entry.key = hash_table_malloc(table, key_size);
-    if (!entry.key) {
+    entry.key.ptr = hash_table_malloc(table, key_size);
+    if (!entry.key.ptr) {
         entry.status = MYRTX_HASH_ENTRY_EMPTY;
         return entry;
     }
-    memcpy(entry.key, key, key_size);
+    memcpy(entry.key.ptr, key, key_size);
     
     /* Wert kopieren */
-    entry.value = hash_table_malloc(table, value_size);
-    if (!entry.value) {
-        if (!table->arena) {
-            free(entry.key);
-        }
+    entry.value.ptr = hash_table_malloc(table, value_size);
+    if (!entry.value.ptr) {
+        hash_table_release(table, entry.key.ptr, key_size);
         entry.status = MYRTX_HASH_ENTRY_EMPTY;
         return entry;
     }
-    memcpy(entry.value, value, value_size);
+    memcpy(entry.value.ptr, value, value_size);
     
     return entry;
 }
 
+/* Frees an entry's key and value buffers. Tables with INLINE_STORAGE own
+ * their buffers and ignore the flags; otherwise the caller decides. In
+ * arena mode the buffers are kept for reuse by the table. */
+static void release_entry(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry,
+                          bool free_key, bool free_value) {
+    if (table->flags & MYRTX_HASH_TABLE_INLINE_STORAGE) {
+        if (entry->storage & MYRTX_HASH_STORAGE_VALUE_JOINED) {
+            hash_table_release(table, entry->key.ptr,
+                               HASH_JOINED_OFFSET(entry->key_size) + entry->value_size);
+            return;
+        }
+        if (!(entry->storage & MYRTX_HASH_STORAGE_KEY_INLINE) &&
+            !(table->flags & MYRTX_HASH_TABLE_KEYS_BORROWED)) {
+            hash_table_release(table, entry->key.ptr, entry->key_size);
+        }
+        if (!(entry->storage & MYRTX_HASH_STORAGE_VALUE_INLINE)) {
+            hash_table_release(table, entry->value.ptr, entry->value_size);
+        }
+        return;
+    }
+    
+    if (free_key) {
+        hash_table_release(table, entry->key.ptr, entry->key_size);
+    }
+    if (free_value) {
+        hash_table_release(table, entry->value.ptr, entry->value_size);
+    }
+}
+
+/* Whether a new value of @p value_size can overwrite the current one in place */
+static bool value_fits(const myrtx_hash_table_t* table, const myrtx_hash_entry_t* entry,
+                       size_t value_size) {
+    if (entry->storage & MYRTX_HASH_STORAGE_VALUE_INLINE) {
+        return value_size <= MYRTX_HASH_INLINE_SIZE;
+    }
+    if (!table->arena) {
+        return value_size <= entry->value_size;
+    }
+    
+    /* Arena buffers are recycled by their recorded size, so the value must
+     * stay within the size class of its buffer */
+    size_t offset = (entry->storage & MYRTX_HASH_STORAGE_VALUE_JOINED) ? HASH_JOINED_OFFSET(entry->key_size) : 0;
+    return hash_recycle_class_size(offset + value_size) ==
+           hash_recycle_class_size(offset + entry->value_size);
+}
+
+/* Replaces the value of an existing entry, in place if it fits the current buffer */
+static bool update_entry_value(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry,
+                               const void* value, size_t value_size) {
+    if (value_fits(table, entry, value_size)) {
+        /* memmove: the caller may pass a pointer into the current value */
+        memmove(hash_entry_value(entry), value, value_size);
+        entry->value_size = value_size;
+        return true;
+    }
+    
+    /* Neuen Wert allozieren */
+    void* new_value = hash_table_malloc(table, value_size);
+    if (!new_value) {
+        return false;
+    }
+    memcpy(new_value, value, value_size);
+    if (!hash_entry_buffered(table, entry)) {
+        table->buffered++;
+    }
+    
+    /* Free the old value if it has an allocation of its own */
+    if (!(entry->storage & (MYRTX_HASH_STORAGE_VALUE_INLINE | MYRTX_HASH_STORAGE_VALUE_JOINED))) {
+        hash_table_release(table, entry->value.ptr, entry->value_size);
+    }
+    
+    /* A joined block stays alive through the key pointer */
+    entry->value.ptr = new_value;
+    entry->value_size = value_size;
+    entry->storage &= (uint8_t)~(MYRTX_HASH_STORAGE_VALUE_INLINE | MYRTX_HASH_STORAGE_VALUE_JOINED);
+    return true;
+}
+
+/* Lineare Sondierung (Standard-Backend) */
+
 /* Berechnet den Index für einen Hash in der Tabelle mit linearer Sondierung */
-static size_t get_index(uint32_t hash, size_t capacity, size_t probe) {
+static size_t get_index(uint64_t hash, size_t capacity, size_t probe) {
     return (hash + probe) % capacity;
 }
 
 /* Findet den Index eines Eintrags oder eine freie Stelle für Einfügungen */
 static size_t find_entry(const myrtx_hash_table_t* table, 
-                        const void* key, size_t key_size, uint32_t hash,
+                        const void* key, size_t key_size, uint64_t hash,
                         bool* found) {
     size_t index, tombstone_index = SIZE_MAX;
+    bool tagged = (table->flags & MYRTX_HASH_TABLE_GENERATIONS) != 0;
+    unsigned int generation = table->generation;
     
     /* Lineare Sondierung */
     for (size_t i = 0; i < table->capacity; i++) {
         index = get_index(hash, table->capacity, i);
+        uint8_t state = hash_slot_state_in(&table->entries[index], tagged, generation);
         
         /* Leerer Slot: Ende der Suche */
-        if (table->entries[index].status == MYRTX_HASH_ENTRY_EMPTY) {
+        if (state == MYRTX_HASH_ENTRY_EMPTY) {
             *found = false;
             /* Wenn wir einen Grabstein gefunden haben, verwenden wir diesen für Einfügungen */
             return tombstone_index != SIZE_MAX ? tombstone_index : index;
         }
         
         /* Grabstein merken für potenzielle Einfügungen */
-        if (table->entries[index].status == MYRTX_HASH_ENTRY_DELETED) {
+        if (state == MYRTX_HASH_ENTRY_DELETED) {
             if (tombstone_index == SIZE_MAX) {
                 tombstone_index = index;
             }
@@ -132,7 +211,7 @@ static size_t find_entry(const myrtx_hash_table_t* table,
         
         /* Besetzter Slot: Prüfen, ob es der gesuchte Schlüssel ist */
         if (table->entries[index].hash == hash && 
-            table->compare_func(table->entries[index].key, table->entries[index].key_size,
+            table->compare_func(hash_entry_key(&table->entries[index]), table->entries[index].key_size,
                               key, key_size)) {
             *found = true;
             return index;
@@ -144,65 +223,513 @@ static size_t find_entry(const myrtx_hash_table_t* table,
     return tombstone_index != SIZE_MAX ? tombstone_index : 0;
 }
 
-/* Vergrößert die Hash-Tabelle und ordnet alle Einträge neu an */
-static bool resize_hash_table(myrtx_hash_table_t* table, size_t new_capacity) {
-    if (new_capacity < MYRTX_DEFAULT_CAPACITY) {
-        new_capacity = MYRTX_DEFAULT_CAPACITY;
+/* Finds the first free slot (empty or tombstone) for a new entry */
+static size_t find_free_slot(const myrtx_hash_table_t* table, uint64_t hash) {
+    for (size_t i = 0; i < table->capacity; i++) {
+        size_t index = get_index(hash, table->capacity, i);
+        if (hash_slot_state(table, &table->entries[index]) != MYRTX_HASH_ENTRY_OCCUPIED) {
+            return index;
+        }
     }
-    
-    /* Neue Einträge-Array allozieren */
-    myrtx_hash_entry_t* new_entries = hash_table_malloc(table, sizeof(myrtx_hash_entry_t) * new_capacity);
-    if (!new_entries) {
+    return 0;
+}
+
+/* Allocates an empty entry array */
+static bool linear_init(myrtx_hash_table_t* table, size_t capacity) {
+    /* All entries start out empty */
+    myrtx_hash_entry_t* entries = hash_table_alloc_entries(table, capacity);
+    if (!entries) {
         return false;
     }
     
-    /* Alle Einträge als leer markieren */
-    for (size_t i = 0; i < new_capacity; i++) {
-        new_entries[i].status = MYRTX_HASH_ENTRY_EMPTY;
+    table->entries = entries;
+    table->capacity = capacity;
+    table->tombstones = 0;
+    return true;
+}
+
+/* Vergrößert die Hash-Tabelle und ordnet alle Einträge neu an */
+static bool resize_hash_table(myrtx_hash_table_t* table, size_t new_capacity) {
+    if (new_capacity < MYRTX_DEFAULT_CAPACITY) {
+        new_capacity = MYRTX_DEFAULT_CAPACITY;
     }
     
     /* Alte Einträge temporär speichern */
     myrtx_hash_entry_t* old_entries = table->entries;
     size_t old_capacity = table->capacity;
     
-    /* Tabelle aktualisieren */
-    table->entries = new_entries;
-    table->capacity = new_capacity;
-    table->tombstones = 0;
+    /* Allocate a new, empty entry array */
+    if (!linear_init(table, new_capacity)) {
+        return false;
+    }
+    
+    MYRTX_TRACE_EMIT(MYRTX_TRACE_HASH_RESIZE, old_capacity, new_capacity);
     
     /* Alte Einträge in die neue Tabelle einfügen */
     for (size_t i = 0; i < old_capacity; i++) {
-        if (old_entries[i].status == MYRTX_HASH_ENTRY_OCCUPIED) {
-            bool found;
-            size_t index = find_entry(table, old_entries[i].key, old_entries[i].key_size, 
-                                     old_entries[i].hash, &found);
-            
+        if (hash_slot_state(table, &old_entries[i]) == MYRTX_HASH_ENTRY_OCCUPIED) {
             /* Alten Eintrag an neue Position kopieren */
-            table->entries[index] = old_entries[i];
+            table->entries[find_free_slot(table, old_entries[i].hash)] = old_entries[i];
         }
     }
     
-    /* Alte Einträge-Array freigeben, wenn wir malloc verwenden */
-    if (!table->arena) {
-        free(old_entries);
-    }
+    /* Release the old entry array (kept for reuse in arena mode) */
+    hash_table_release(table, old_entries, sizeof(myrtx_hash_entry_t) * old_capacity);
     
     return true;
 }
 
-/* Sicherheitsüberprüfung, ob die Hash-Tabelle vergrößert werden muss */
-static bool ensure_capacity(myrtx_hash_table_t* table) {
+static void linear_prefetch(const myrtx_hash_table_t* table, uint64_t hash) {
+    MYRTX_HASH_PREFETCH(&table->entries[get_index(hash, table->capacity, 0)]);
+}
+
+/* New capacity if the table must grow before the next insertion, else 0 */
+static size_t linear_grow_capacity(const myrtx_hash_table_t* table) {
     /* Prüfen, ob die Tabelle überlastet ist */
     float load = (float)(table->size + table->tombstones) / (float)table->capacity;
     
-    if (load >= table->load_factor) {
-        /* Neue Kapazität ist doppelt so groß */
-        return resize_hash_table(table, table->capacity * 2);
+    /* Neue Kapazität ist doppelt so groß */
+    return load >= table->load_factor ? table->capacity * 2 : 0;
+}
+
+/* Sicherheitsüberprüfung, ob die Hash-Tabelle vergrößert werden muss */
+static bool ensure_capacity(myrtx_hash_table_t* table) {
+    size_t new_capacity = linear_grow_capacity(table);
+    return new_capacity == 0 || resize_hash_table(table, new_capacity);
+}
+
+static void linear_release(myrtx_hash_table_t* table) {
+    hash_table_release(table, table->entries, sizeof(myrtx_hash_entry_t) * table->capacity);
+}
+
+static myrtx_hash_entry_t* linear_find(const myrtx_hash_table_t* table, const void* key,
+                                       size_t key_size, uint64_t hash, size_t* hint) {
+    bool found;
+    size_t index = find_entry(table, key, key_size, hash, &found);
+    *hint = index;
+    return found ? &table->entries[index] : NULL;
+}
+
+static myrtx_hash_entry_t* linear_insert(myrtx_hash_table_t* table, uint64_t hash, size_t hint) {
+    size_t capacity = table->capacity;
+    if (!ensure_capacity(table)) {
+        return NULL;
+    }
+    
+    /* The position found by the lookup is stale after a resize */
+    size_t index = (capacity == table->capacity && hint < capacity) ? hint
+                                                                    : find_free_slot(table, hash);
+    
+    /* Wenn wir einen Grabstein überschreiben, Tombstone-Zähler reduzieren */
+    if (hash_slot_state(table, &table->entries[index]) == MYRTX_HASH_ENTRY_DELETED) {
+        table->tombstones--;
+    }
+    return &table->entries[index];
+}
+
+static void linear_erase(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry) {
+    /* Eintrag als gelöscht markieren (Grabstein) */
+    hash_slot_set_state(table, entry, MYRTX_HASH_ENTRY_DELETED);
+    table->tombstones++;
+}
+
+static void linear_reset(myrtx_hash_table_t* table) {
+    /* Slots of a generation-tagged table are stale after the clear already */
+    if (!(table->flags & MYRTX_HASH_TABLE_GENERATIONS)) {
+        for (size_t i = 0; i < table->capacity; i++) {
+            table->entries[i].status = MYRTX_HASH_ENTRY_EMPTY;
+        }
+    }
+    table->tombstones = 0;
+}
+
+static size_t linear_probe_length(const myrtx_hash_table_t* table,
+                                  const myrtx_hash_entry_t* entry) {
+    size_t index = (size_t)(entry - table->entries);
+    size_t home = get_index(entry->hash, table->capacity, 0);
+    return (index + table->capacity - home) % table->capacity + 1;
+}
+
+static size_t linear_array_bytes(const myrtx_hash_table_t* table) {
+    return sizeof(myrtx_hash_entry_t) * table->capacity;
+}
+
+static myrtx_hash_entry_t* linear_claim(myrtx_hash_table_t* table, const void* key,
+                                        size_t key_size, uint64_t hash, size_t lo, size_t hi,
+                                        bool* found) {
+    (void)lo;
+    
+    /* A build leaves no tombstones, so the first free slot ends the probe */
+    for (size_t index = get_index(hash, table->capacity, 0); index < hi; index++) {
+        myrtx_hash_entry_t* entry = &table->entries[index];
+        if (hash_slot_state(table, entry) != MYRTX_HASH_ENTRY_OCCUPIED) {
+            *found = false;
+            return entry;
+        }
+        if (entry->hash == hash &&
+            table->compare_func(hash_entry_key(entry), entry->key_size, key, key_size)) {
+            *found = true;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+const myrtx_hash_backend_t myrtx_hash_backend_linear = {
+    linear_init,
+    linear_release,
+    linear_find,
+    linear_prefetch,
+    linear_grow_capacity,
+    linear_insert,
+    linear_erase,
+    linear_reset,
+    linear_probe_length,
+    linear_array_bytes,
+    linear_claim,
+    NULL, /* Entries move to their home slots in the new arrays */
+    NULL
+};
+
+/* Incremental resize */
+
+/* Releases the key/value buffers of every entry in @p arrays (the table or its old shadow) */
+static void release_all_entries(myrtx_hash_table_t* table, myrtx_hash_table_t* arrays,
+                                bool free_keys, bool free_values) {
+    for (size_t i = 0; i < arrays->capacity; i++) {
+        if (hash_slot_state(arrays, &arrays->entries[i]) == MYRTX_HASH_ENTRY_OCCUPIED) {
+            release_entry(table, &arrays->entries[i], free_keys, free_values);
+        }
+    }
+}
+
+/* Move up to @p budget old slots into the current arrays */
+static void migrate_step(myrtx_hash_table_t* table, size_t budget) {
+    myrtx_hash_table_t* old = table->old;
+    
+    while (budget > 0 && table->migrate_pos < old->capacity) {
+        budget--;
+        myrtx_hash_entry_t* entry = &old->entries[table->migrate_pos];
+        if (hash_slot_state(old, entry) != MYRTX_HASH_ENTRY_OCCUPIED) {
+            table->migrate_pos++;
+            continue;
+        }
+        
+        myrtx_hash_entry_t* slot =
+            table->backend->migrate_slot
+                ? table->backend->migrate_slot(table, table->migrate_pos, entry->hash)
+                : table->backend->insert(table, entry->hash, SIZE_MAX);
+        if (!slot) {
+            /* Out of memory while growing; the next operation retries */
+            return;
+        }
+        *slot = *entry;
+        
+        /* Robin Hood may shift the next entry into this slot, so the
+         * position only advances once the slot is free */
+        table->backend->erase(old, entry);
+        old->size--;
+    }
+    
+    if (table->migrate_pos == old->capacity) {
+        table->backend->release(old);
+        table->migrating = false;
+    }
+}
+
+/* Swap in empty arrays of @p new_capacity slots and keep the current ones as the old shadow */
+static bool start_migration(myrtx_hash_table_t* table, size_t new_capacity) {
+    /* The shadow shares the free lists, so they must exist before it is copied */
+    if (table->arena && !hash_recycler_prepare(table)) {
+        return false;
+    }
+    if (!table->old) {
+        table->old = hash_table_malloc(table, sizeof(myrtx_hash_table_t));
+        if (!table->old) {
+            return false;
+        }
+    }
+    
+    myrtx_hash_table_t* old = table->old;
+    *old = *table;
+    old->old = NULL;
+    old->migrating = false;
+    
+    /* init() leaves the table untouched on failure */
+    if (!table->backend->init(table, new_capacity)) {
+        return false;
+    }
+    
+    if (table->backend->migrate_start) {
+        table->backend->migrate_start(table, old);
     }
     
+    MYRTX_TRACE_EMIT(MYRTX_TRACE_HASH_RESIZE, old->capacity, new_capacity);
+    
+    table->migrate_pos = 0;
+    table->migrating = true;
     return true;
 }
 
+/* Start an incremental resize if the next insert needs room. Sets
+ * @p arrays_changed when entries moved, which invalidates insert hints. */
+static bool grow_incrementally(myrtx_hash_table_t* table, bool* arrays_changed) {
+    *arrays_changed = false;
+    
+    size_t new_capacity = table->backend->grow_capacity(table);
+    if (new_capacity == 0) {
+        return true;
+    }
+    
+    *arrays_changed = true;
+    if (table->migrating) {
+        /* Filled up before the previous resize finished: finish it first */
+        migrate_step(table, SIZE_MAX);
+        if (table->migrating) {
+            return false;
+        }
+    }
+    return start_migration(table, new_capacity);
+}
+
+/* Whether @p entry lies in the old arrays of a running incremental resize */
+static bool entry_in_old(const myrtx_hash_table_t* table, const myrtx_hash_entry_t* entry) {
+    return table->migrating && entry >= table->old->entries &&
+           entry < table->old->entries + table->old->capacity;
+}
+
+/* Find an entry in the current arrays, then in the old ones; @p hint
+ * refers to the current arrays */
+static myrtx_hash_entry_t* find_any(const myrtx_hash_table_t* table, const void* key,
+                                    size_t key_size, uint64_t hash, size_t* hint) {
+    myrtx_hash_entry_t* entry = table->backend->find(table, key, key_size, hash, hint);
+    if (!entry && table->migrating) {
+        size_t old_hint;
+        entry = table->backend->find(table->old, key, key_size, hash, &old_hint);
+    }
+    return entry;
+}
+
+/* find_any() for lookups: an expired entry counts as missing */
+static inline myrtx_hash_entry_t* find_live(const myrtx_hash_table_t* table, const void* key,
+                                           size_t key_size, uint64_t hash) {
+    size_t hint;
+    myrtx_hash_entry_t* entry = find_any(table, key, key_size, hash, &hint);
+    return entry && !hash_entry_expired(table, entry) ? entry : NULL;
+}
+
+myrtx_hash_entry_t* hash_table_find_entry(const myrtx_hash_table_t* table, const void* key,
+                                          size_t key_size, uint64_t hash) {
+    size_t hint;
+    return find_any(table, key, key_size, hash, &hint);
+}
+
+/* Removes an entry from whichever arrays hold it; its buffers are left alone */
+static void unlink_entry(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry) {
+    if (hash_entry_buffered(table, entry)) {
+        table->buffered--;
+    }
+    if (entry_in_old(table, entry)) {
+        table->backend->erase(table->old, entry);
+        table->old->size--;
+    } else {
+        table->backend->erase(table, entry);
+    }
+    table->size--;
+}
+
+/* Frees an entry's buffers and removes it from whichever arrays hold it */
+void hash_table_erase_entry(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry) {
+    release_entry(table, entry, true, true);
+    unlink_entry(table, entry);
+}
+
+/* Stores a ready entry for a key that find_any() did not find; @p hint is
+ * the position it returned. Returns the filled slot, or NULL, in which case
+ * the entry's buffers still belong to the caller. */
+static myrtx_hash_entry_t* place_entry(myrtx_hash_table_t* table,
+                                       const myrtx_hash_entry_t* entry, size_t hint) {
+    /* Start growing step by step instead of rehashing everything at once */
+    if (table->flags & MYRTX_HASH_TABLE_INCREMENTAL_RESIZE) {
+        bool arrays_changed;
+        if (!grow_incrementally(table, &arrays_changed)) {
+            return NULL;
+        }
+        if (arrays_changed) {
+            hint = SIZE_MAX;
+        }
+    }
+    
+    /* Make room, growing the table if needed */
+    myrtx_hash_entry_t* slot = table->backend->insert(table, entry->hash, hint);
+    if (!slot) {
+        return NULL;
+    }
+    
+    /* Eintrag in die Tabelle einfügen */
+    *slot = *entry;
+    hash_slot_set_state(table, slot, MYRTX_HASH_ENTRY_OCCUPIED);
+    table->size++;
+    if (hash_entry_buffered(table, slot)) {
+        table->buffered++;
+    }
+    
+    return slot;
+}
+
+/* Stores a new entry for a key that find_any() did not find; @p hint is
+ * the position it returned. Returns the filled slot, or NULL. */
+static myrtx_hash_entry_t* insert_new(myrtx_hash_table_t* table, const void* key,
+                                      size_t key_size, const void* value, size_t value_size,
+                                      uint64_t hash, size_t hint) {
+    /* Neuen Eintrag erstellen */
+    myrtx_hash_entry_t entry = create_entry(table, key, key_size, value, value_size, hash);
+    
+    /* Prüfen, ob der Eintrag erfolgreich erstellt wurde */
+    if (entry.status != MYRTX_HASH_ENTRY_OCCUPIED) {
+        return NULL;
+    }
+    
+    myrtx_hash_entry_t* slot = place_entry(table, &entry, hint);
+    if (!slot) {
+        release_entry(table, &entry, true, true);
+    }
+    return slot;
+}
+
+/* Puts a ready entry in place of the occupied @p slot of an equal key and
+ * frees the slot's old buffers. With @p keep_expiry (a put to a live key)
+ * the old expiry stays; otherwise the entry starts without one. A pending
+ * timer stays marked either way, since it still refers to the key. */
+static void replace_entry(myrtx_hash_table_t* table, myrtx_hash_entry_t* slot,
+                          const myrtx_hash_entry_t* entry, bool keep_expiry) {
+    myrtx_hash_entry_t old = *slot;
+    if (hash_entry_buffered(table, &old)) {
+        table->buffered--;
+    }
+    
+    const unsigned int kept = MYRTX_HASH_STORAGE_TIMER | ~MYRTX_HASH_STORAGE_MASK;
+    *slot = *entry;
+    slot->status = old.status;
+    slot->storage = (uint8_t)((entry->storage & ~kept) | (old.storage & kept));
+    hash_entry_set_expiry(slot, keep_expiry ? hash_entry_expiry(&old) : 0);
+    if (hash_entry_buffered(table, slot)) {
+        table->buffered++;
+    }
+    
+    release_entry(table, &old, true, true);
+}
+
+myrtx_hash_entry_t hash_table_new_entry(myrtx_hash_table_t* table, const void* key,
+                                        size_t key_size, const void* value,
+                                        size_t value_size, uint64_t hash) {
+    return create_entry(table, key, key_size, value, value_size, hash);
+}
+
+void hash_table_free_entry(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry) {
+    release_entry(table, entry, true, true);
+}
+
+/* Put of a ready-made entry */
+bool hash_table_put_entry(myrtx_hash_table_t* table, const myrtx_hash_entry_t* entry) {
+    if (table->migrating) {
+        migrate_step(table, MYRTX_HASH_MIGRATE_SLOTS);
+    }
+    
+    size_t hint;
+    myrtx_hash_entry_t* slot = find_any(table, hash_entry_key(entry), entry->key_size,
+                                        entry->hash, &hint);
+    if (slot) {
+        replace_entry(table, slot, entry, !hash_entry_expired(table, slot));
+        return true;
+    }
+    return place_entry(table, entry, hint) != NULL;
+}
+
+/* Grows the table once so that count entries fit without further growth */
+bool hash_table_reserve(myrtx_hash_table_t* table, size_t count) {
+    if (table->migrating) {
+        migrate_step(table, SIZE_MAX);
+        if (table->migrating) {
+            return false;
+        }
+    }
+
+    /* The current arrays keep their tombstones and compact holes; new ones
+     * start without, unless the backend keeps positions while migrating */
+    myrtx_hash_table_t probe = *table;
+    probe.size = count > 0 ? count - 1 : 0;
+    size_t used = table->index ? table->dense_count - table->size : 0;
+    size_t capacity = table->capacity;
+    while (capacity < count + used || table->backend->grow_capacity(&probe) != 0) {
+        capacity *= 2;
+        probe.capacity = capacity;
+        probe.tombstones = 0;
+        if (!table->backend->migrate_start) {
+            used = 0;
+        }
+    }
+    if (capacity == table->capacity) {
+        return true;
+    }
+
+    if (table->size == 0) {
+        /* Nothing to move: swap the arrays; init() leaves the table untouched on failure */
+        myrtx_hash_table_t old = *table;
+        if (!table->backend->init(table, capacity)) {
+            return false;
+        }
+        table->backend->release(&old);
+        return true;
+    }
+    if (!start_migration(table, capacity)) {
+        return false;
+    }
+    migrate_step(table, SIZE_MAX);
+    return !table->migrating;
+}
+
+/* The entry of a key, stored with @p value first if it is missing. One
+ * probe either way; @p inserted tells which case happened. */
+static myrtx_hash_entry_t* find_or_insert(myrtx_hash_table_t* table, const void* key,
+                                          size_t key_size, const void* value,
+                                          size_t value_size, uint64_t hash, bool* inserted) {
+    /* Do part of a resize in progress */
+    if (table->migrating) {
+        migrate_step(table, MYRTX_HASH_MIGRATE_SLOTS);
+    }
+    
+    size_t hint;
+    myrtx_hash_entry_t* slot = find_any(table, key, key_size, hash, &hint);
+    *inserted = slot == NULL;
+    if (slot) {
+        if (hash_entry_expired(table, slot)) {
+            /* An expired entry is reused as a new one: new value, no expiry */
+            if (!update_entry_value(table, slot, value, value_size)) {
+                return NULL;
+            }
+            hash_entry_set_expiry(slot, 0);
+            *inserted = true;
+        }
+        return slot;
+    }
+    return insert_new(table, key, key_size, value, value_size, hash, hint);
+}
+
+/* Put with the key size resolved and the hash already computed */
+static bool put_hashed(myrtx_hash_table_t* table, const void* key, size_t key_size,
+                       const void* value, size_t value_size, uint64_t hash) {
+    bool inserted;
+    myrtx_hash_entry_t* slot = find_or_insert(table, key, key_size, value, value_size, hash,
+                                              &inserted);
+    if (!slot) {
+        return false;
+    }
+    
+    /* Wenn Schlüssel bereits existiert, Wert aktualisieren */
+    return inserted || update_entry_value(table, slot, value, value_size);
+}
+
 /* Öffentliche API-Funktionen */
 
 /* Erstellt eine neue Hash-Tabelle */
@@ -210,19 +737,59 @@ myrtx_hash_table_t* myrtx_hash_table_create(myrtx_arena_t* arena,
                                           size_t initial_capacity,
                                           myrtx_hash_function hash_function, 
                                           myrtx_key_compare_function compare_function) {
+    myrtx_hash_table_options_t options = {0};
+    options.arena = arena;
+    options.initial_capacity = initial_capacity;
+    options.hash_function = hash_function;
+    options.compare_function = compare_function;
+    return myrtx_hash_table_create_ex(&options);
+}
+
+/* Creates a hash table with extended options */
+myrtx_hash_table_t* myrtx_hash_table_create_ex(const myrtx_hash_table_options_t* options) {
     /* Parameter validieren */
-    if (!hash_function || !compare_function) {
+    if (!options || !options->compare_function) {
+        return NULL;
+    }
+    
+    /* Exactly one hash function */
+    if (!options->hash_function == !options->hash64_function) {
+        return NULL;
+    }
+    if (options->flags & ~(unsigned int)(MYRTX_HASH_TABLE_INLINE_STORAGE |
+                                         MYRTX_HASH_TABLE_INCREMENTAL_RESIZE |
+                                         MYRTX_HASH_TABLE_GENERATIONS)) {
+        return NULL;
+    }
+    
+    const myrtx_hash_backend_t* backend;
+    switch (options->probing) {
+    case MYRTX_HASH_PROBING_LINEAR:
+        backend = &myrtx_hash_backend_linear;
+        break;
+    case MYRTX_HASH_PROBING_SWISS:
+        backend = &myrtx_hash_backend_swiss;
+        break;
+    case MYRTX_HASH_PROBING_ROBIN_HOOD:
+        backend = &myrtx_hash_backend_robin_hood;
+        break;
+    case MYRTX_HASH_PROBING_COMPACT:
+        backend = &myrtx_hash_backend_compact;
+        break;
+    default:
         return NULL;
     }
     
     /* Anfangskapazität auf Standardwert setzen, wenn 0 */
-    if (initial_capacity == 0) {
+    size_t initial_capacity = options->initial_capacity;
+    if (initial_capacity < MYRTX_DEFAULT_CAPACITY) {
         initial_capacity = MYRTX_DEFAULT_CAPACITY;
     } else {
         /* Auf nächste Potenz von 2 aufrunden */
         initial_capacity = next_power_of_2(initial_capacity);
     }
     
+    myrtx_arena_t* arena = options->arena;
     myrtx_hash_table_t* table;
     
     /* Hash-Tabellen-Struktur allozieren */
@@ -236,36 +803,28 @@ myrtx_hash_table_t* myrtx_hash_table_create(myrtx_arena_t* arena,
         return NULL;
     }
     
-    /* Einträge-Array allozieren */
-    myrtx_hash_entry_t* entries;
-    if (arena) {
-        entries = myrtx_arena_alloc(arena, sizeof(myrtx_hash_entry_t) * initial_capacity);
-    } else {
-        entries = malloc(sizeof(myrtx_hash_entry_t) * initial_capacity);
+    /* Tabelle initialisieren */
+    memset(table, 0, sizeof(*table));
+    table->load_factor = MYRTX_DEFAULT_LOAD_FACTOR;
+    table->hash_func = options->hash_function;
+    table->hash64_func = options->hash64_function;
+    table->seed = options->seed;
+    if (table->hash64_func && table->seed == 0) {
+        table->seed = myrtx_hash_random_seed();
     }
+    table->compare_func = options->compare_function;
+    table->arena = arena;
+    table->backend = backend;
+    table->flags = options->flags;
     
-    if (!entries) {
+    /* Einträge-Array allozieren */
+    if (!backend->init(table, initial_capacity)) {
         if (!arena) {
             free(table);
         }
         return NULL;
     }
     
-    /* Tabelle initialisieren */
-    table->entries = entries;
-    table->capacity = initial_capacity;
-    table->size = 0;
-    table->tombstones = 0;
-    table->load_factor = MYRTX_DEFAULT_LOAD_FACTOR;
-    table->hash_func = hash_function;
-    table->compare_func = compare_function;
-    table->arena = arena;
-    
-    /* Alle Einträge als leer markieren */
-    for (size_t i = 0; i < initial_capacity; i++) {
-        table->entries[i].status = MYRTX_HASH_ENTRY_EMPTY;
-    }
-    
     return table;
 }
 
@@ -279,20 +838,18 @@ void myrtx_hash_table_free(myrtx_hash_table_t* table,
     
     /* Inhalte freigeben, wenn wir malloc verwendet haben */
     if (!table->arena) {
+        hash_wheel_free(table);
+        
         /* Schlüssel und Werte freigeben, wenn angefordert */
-        for (size_t i = 0; i < table->capacity; i++) {
-            if (table->entries[i].status == MYRTX_HASH_ENTRY_OCCUPIED) {
-                if (free_keys) {
-                    free(table->entries[i].key);
-                }
-                if (free_values) {
-                    free(table->entries[i].value);
-                }
-            }
+        release_all_entries(table, table, free_keys, free_values);
+        if (table->migrating) {
+            release_all_entries(table, table->old, free_keys, free_values);
+            table->backend->release(table->old);
         }
+        free(table->old);
         
         /* Einträge-Array freigeben */
-        free(table->entries);
+        table->backend->release(table);
         
         /* Hash-Tabellen-Struktur freigeben */
         free(table);
@@ -314,55 +871,81 @@ bool myrtx_hash_table_put(myrtx_hash_table_t* table,
         key_size = strlen(key) + 1;
     }
     
-    /* Hash berechnen */
-    uint32_t hash = table->hash_func(key, key_size);
-    
-    /* Sicherstellen, dass genug Kapazität vorhanden ist */
-    if (!ensure_capacity(table)) {
+    return put_hashed(table, key, key_size, value, value_size,
+                      hash_table_hash(table, key, key_size));
+}
+
+/* Put with a hash computed by the caller */
+bool myrtx_hash_table_put_with_hash(myrtx_hash_table_t* table,
+                                    const void* key,
+                                    size_t key_size,
+                                    const void* value,
+                                    size_t value_size,
+                                    uint64_t hash) {
+    if (!table || !key || !value) {
         return false;
     }
     
-    /* Position zum Einfügen suchen */
-    bool found;
-    size_t index = find_entry(table, key, key_size, hash, &found);
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
     
-    /* Wenn Schlüssel bereits existiert, Wert aktualisieren */
-    if (found) {
-        /* Alten Wert freigeben, wenn wir malloc verwenden */
-        if (!table->arena) {
-            free(table->entries[index].value);
-        }
-        
-        /* Neuen Wert allozieren */
-        table->entries[index].value = hash_table_malloc(table, value_size);
-        if (!table->entries[index].value) {
-            return false;
-        }
-        
-        /* Wert aktualisieren */
-        memcpy(table->entries[index].value, value, value_size);
-        table->entries[index].value_size = value_size;
-        
-        return true;
+    return put_hashed(table, key, key_size, value, value_size, hash);
+}
+
+/* Returns the stored value of a key, inserting the default first if missing */
+void* myrtx_hash_table_get_or_insert(myrtx_hash_table_t* table,
+                                     const void* key,
+                                     size_t key_size,
+                                     const void* default_value,
+                                     size_t value_size,
+                                     bool* inserted) {
+    if (!table || !key || !default_value) {
+        return NULL;
+    }
+    
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
     }
     
-    /* Neuen Eintrag erstellen */
-    myrtx_hash_entry_t entry = create_entry(table, key, key_size, value, value_size, hash);
-    
-    /* Prüfen, ob der Eintrag erfolgreich erstellt wurde */
-    if (entry.status != MYRTX_HASH_ENTRY_OCCUPIED) {
+    bool was_inserted;
+    myrtx_hash_entry_t* slot = find_or_insert(table, key, key_size, default_value, value_size,
+                                              hash_table_hash(table, key, key_size),
+                                              &was_inserted);
+    if (!slot) {
+        return NULL;
+    }
+    if (inserted) {
+        *inserted = was_inserted;
+    }
+    return hash_entry_value(slot);
+}
+
+/* Inserts a value or merges it into the stored one */
+bool myrtx_hash_table_upsert(myrtx_hash_table_t* table,
+                             const void* key,
+                             size_t key_size,
+                             const void* value,
+                             size_t value_size,
+                             myrtx_hash_merge_function merge,
+                             void* user_data) {
+    if (!table || !key || !value || !merge) {
         return false;
     }
     
-    /* Wenn wir einen Grabstein überschreiben, Tombstone-Zähler reduzieren */
-    if (table->entries[index].status == MYRTX_HASH_ENTRY_DELETED) {
-        table->tombstones--;
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
     }
     
-    /* Eintrag in die Tabelle einfügen */
-    table->entries[index] = entry;
-    table->size++;
-    
+    bool inserted;
+    myrtx_hash_entry_t* slot = find_or_insert(table, key, key_size, value, value_size,
+                                              hash_table_hash(table, key, key_size), &inserted);
+    if (!slot) {
+        return false;
+    }
+    if (!inserted) {
+        merge(hash_entry_value(slot), slot->value_size, value, value_size, user_data);
+    }
     return true;
 }
 
@@ -381,22 +964,38 @@ bool myrtx_hash_table_get(const myrtx_hash_table_t* table,
         key_size = strlen(key) + 1;
     }
     
-    /* Hash berechnen */
-    uint32_t hash = table->hash_func(key, key_size);
+    return myrtx_hash_table_get_with_hash(table, key, key_size,
+                                          hash_table_hash(table, key, key_size),
+                                          value_out, value_size_out);
+}
+
+/* Get with a hash computed by the caller */
+bool myrtx_hash_table_get_with_hash(const myrtx_hash_table_t* table,
+                                    const void* key,
+                                    size_t key_size,
+                                    uint64_t hash,
+                                    void** value_out,
+                                    size_t* value_size_out) {
+    if (!table || !key || !value_out) {
+        return false;
+    }
+    
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
     
     /* Eintrag suchen */
-    bool found;
-    size_t index = find_entry(table, key, key_size, hash, &found);
+    const myrtx_hash_entry_t* entry = find_live(table, key, key_size, hash);
     
     /* Prüfen, ob Schlüssel gefunden wurde */
-    if (!found) {
+    if (!entry) {
         return false;
     }
     
     /* Wert zurückgeben */
-    *value_out = table->entries[index].value;
+    *value_out = hash_entry_value(entry);
     if (value_size_out) {
-        *value_size_out = table->entries[index].value_size;
+        *value_size_out = entry->value_size;
     }
     
     return true;
@@ -415,16 +1014,116 @@ bool myrtx_hash_table_contains_key(const myrtx_hash_table_t* table,
         key_size = strlen(key) + 1;
     }
     
-    /* Hash berechnen */
-    uint32_t hash = table->hash_func(key, key_size);
+    return myrtx_hash_table_contains_key_with_hash(table, key, key_size,
+                                                   hash_table_hash(table, key, key_size));
+}
+
+/* Contains with a hash computed by the caller */
+bool myrtx_hash_table_contains_key_with_hash(const myrtx_hash_table_t* table,
+                                             const void* key,
+                                             size_t key_size,
+                                             uint64_t hash) {
+    if (!table || !key) {
+        return false;
+    }
     
-    /* Eintrag suchen */
-    bool found;
-    find_entry(table, key, key_size, hash, &found);
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
     
+    /* Eintrag suchen */
+    return find_live(table, key, key_size, hash) != NULL;
+}
+
+/* How many keys ahead of the one being resolved a batch hashes and
+ * prefetches, i.e. how many cache misses it keeps in flight */
+#define HASH_BATCH_DEPTH 16
+
+/* Resolves the size of a batch key and starts loading its first slot */
+static inline void batch_prepare(const myrtx_hash_table_t* table, const void* key,
+                                 size_t key_size, size_t* size_out, uint64_t* hash_out) {
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
+    *size_out = key_size;
+    *hash_out = hash_table_hash(table, key, key_size);
+    table->backend->prefetch(table, *hash_out);
+}
+
+/* Looks up many keys, overlapping their cache misses */
+size_t myrtx_hash_table_get_batch(const myrtx_hash_table_t* table,
+                                  size_t count,
+                                  const void* const* keys,
+                                  const size_t* key_sizes,
+                                  void** values_out,
+                                  size_t* value_sizes_out) {
+    if (!table || !keys || !values_out) {
+        return 0;
+    }
+
+    /* Ring of prepared keys: key i sits at i % HASH_BATCH_DEPTH */
+    size_t sizes[HASH_BATCH_DEPTH];
+    uint64_t hashes[HASH_BATCH_DEPTH];
+    size_t found = 0;
+
+    for (size_t i = 0; i < count && i < HASH_BATCH_DEPTH; i++) {
+        batch_prepare(table, keys[i], key_sizes ? key_sizes[i] : 0, &sizes[i], &hashes[i]);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        size_t ring = i % HASH_BATCH_DEPTH;
+        const myrtx_hash_entry_t* entry = find_live(table, keys[i], sizes[ring], hashes[ring]);
+        values_out[i] = entry ? hash_entry_value(entry) : NULL;
+        if (value_sizes_out) {
+            value_sizes_out[i] = entry ? entry->value_size : 0;
+        }
+        found += entry != NULL;
+
+        size_t next = i + HASH_BATCH_DEPTH;
+        if (next < count) {
+            batch_prepare(table, keys[next], key_sizes ? key_sizes[next] : 0, &sizes[ring],
+                          &hashes[ring]);
+        }
+    }
+
     return found;
 }
 
+/* Stores many entries in order, overlapping the cache misses of their lookups */
+size_t myrtx_hash_table_put_batch(myrtx_hash_table_t* table,
+                                  size_t count,
+                                  const void* const* keys,
+                                  const size_t* key_sizes,
+                                  const void* const* values,
+                                  const size_t* value_sizes) {
+    if (!table || !keys || !values || !value_sizes) {
+        return 0;
+    }
+
+    size_t sizes[HASH_BATCH_DEPTH];
+    uint64_t hashes[HASH_BATCH_DEPTH];
+
+    for (size_t i = 0; i < count && i < HASH_BATCH_DEPTH; i++) {
+        batch_prepare(table, keys[i], key_sizes ? key_sizes[i] : 0, &sizes[i], &hashes[i]);
+    }
+
+    /* A put that grows the table makes the pending prefetches useless, not wrong */
+    for (size_t i = 0; i < count; i++) {
+        size_t ring = i % HASH_BATCH_DEPTH;
+        if (!put_hashed(table, keys[i], sizes[ring], values[i], value_sizes[i], hashes[ring])) {
+            return i;
+        }
+
+        size_t next = i + HASH_BATCH_DEPTH;
+        if (next < count) {
+            batch_prepare(table, keys[next], key_sizes ? key_sizes[next] : 0, &sizes[ring],
+                          &hashes[ring]);
+        }
+    }
+
+    return count;
+}
+
 /* Entfernt einen Eintrag aus der Hash-Tabelle */
 bool myrtx_hash_table_remove(myrtx_hash_table_t* table, 
                            const void* key, 
@@ -440,36 +1139,132 @@ bool myrtx_hash_table_remove(myrtx_hash_table_t* table,
         key_size = strlen(key) + 1;
     }
     
-    /* Hash berechnen */
-    uint32_t hash = table->hash_func(key, key_size);
+    return myrtx_hash_table_remove_with_hash(table, key, key_size,
+                                            hash_table_hash(table, key, key_size),
+                                            free_key, free_value);
+}
+
+/* Remove with a hash computed by the caller */
+bool myrtx_hash_table_remove_with_hash(myrtx_hash_table_t* table,
+                                       const void* key,
+                                       size_t key_size,
+                                       uint64_t hash,
+                                       bool free_key,
+                                       bool free_value) {
+    if (!table || !key) {
+        return false;
+    }
+    
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
+    
+    /* Do part of a resize in progress */
+    if (table->migrating) {
+        migrate_step(table, MYRTX_HASH_MIGRATE_SLOTS);
+    }
     
     /* Eintrag suchen */
-    bool found;
-    size_t index = find_entry(table, key, key_size, hash, &found);
+    size_t hint;
+    myrtx_hash_entry_t* entry = find_any(table, key, key_size, hash, &hint);
     
     /* Prüfen, ob Schlüssel gefunden wurde */
-    if (!found) {
+    if (!entry) {
+        return false;
+    }
+    
+    /* Expired entries are reclaimed here too, but count as missing */
+    if (hash_entry_expired(table, entry)) {
+        hash_table_erase_entry(table, entry);
         return false;
     }
     
     /* Schlüssel und Wert freigeben, wenn angefordert und wir malloc verwenden */
-    if (!table->arena) {
-        if (free_key) {
-            free(table->entries[index].key);
-        }
-        if (free_value) {
-            free(table->entries[index].value);
-        }
+    release_entry(table, entry, free_key, free_value);
+    unlink_entry(table, entry);
+    
+    return true;
+}
+
+/* Put that also sets the entry's expiry */
+bool myrtx_hash_table_put_ttl(myrtx_hash_table_t* table,
+                              const void* key,
+                              size_t key_size,
+                              const void* value,
+                              size_t value_size,
+                              uint64_t expires_at) {
+    if (!table || !key || !value || expires_at > MYRTX_HASH_TABLE_MAX_EXPIRY) {
+        return false;
     }
     
-    /* Eintrag als gelöscht markieren (Grabstein) */
-    table->entries[index].status = MYRTX_HASH_ENTRY_DELETED;
-    table->size--;
-    table->tombstones++;
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
     
+    bool inserted;
+    myrtx_hash_entry_t* slot = find_or_insert(table, key, key_size, value, value_size,
+                                              hash_table_hash(table, key, key_size), &inserted);
+    if (!slot || (!inserted && !update_entry_value(table, slot, value, value_size))) {
+        return false;
+    }
+    if (!hash_wheel_schedule(table, slot, expires_at)) {
+        /* No timer: a new entry must not stay without its expiry */
+        if (inserted) {
+            hash_table_erase_entry(table, slot);
+        }
+        return false;
+    }
     return true;
 }
 
+/* Sets or clears the expiry of a key */
+bool myrtx_hash_table_set_expiry(myrtx_hash_table_t* table,
+                                 const void* key,
+                                 size_t key_size,
+                                 uint64_t expires_at) {
+    if (!table || !key || expires_at > MYRTX_HASH_TABLE_MAX_EXPIRY) {
+        return false;
+    }
+    
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
+    
+    myrtx_hash_entry_t* entry = find_live(table, key, key_size,
+                                          hash_table_hash(table, key, key_size));
+    return entry && hash_wheel_schedule(table, entry, expires_at);
+}
+
+/* Returns the expiry of a key */
+uint64_t myrtx_hash_table_get_expiry(const myrtx_hash_table_t* table,
+                                     const void* key,
+                                     size_t key_size) {
+    if (!table || !key) {
+        return 0;
+    }
+    
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
+    
+    const myrtx_hash_entry_t* entry = find_live(table, key, key_size,
+                                                hash_table_hash(table, key, key_size));
+    return entry ? hash_entry_expiry(entry) : 0;
+}
+
+/* The hash a table computes for a key, for the _with_hash functions */
+uint64_t myrtx_hash_table_hash(const myrtx_hash_table_t* table, const void* key, size_t key_size) {
+    if (!table || !key) {
+        return 0;
+    }
+    
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
+    
+    return hash_table_hash(table, key, key_size);
+}
+
 /* Gibt die Anzahl der Einträge in der Hash-Tabelle zurück */
 size_t myrtx_hash_table_size(const myrtx_hash_table_t* table) {
     if (!table) {
@@ -479,6 +1274,15 @@ size_t myrtx_hash_table_size(const myrtx_hash_table_t* table) {
     return table->size;
 }
 
+/* Returns the number of slots of the hash table */
+size_t myrtx_hash_table_capacity(const myrtx_hash_table_t* table) {
+    if (!table) {
+        return 0;
+    }
+    
+    return table->capacity;
+}
+
 /* Leert die Hash-Tabelle, entfernt alle Einträge */
 void myrtx_hash_table_clear(myrtx_hash_table_t* table, 
                           bool free_keys, 
@@ -487,31 +1291,274 @@ void myrtx_hash_table_clear(myrtx_hash_table_t* table,
         return;
     }
     
-    /* Schlüssel und Werte freigeben, wenn angefordert und wir malloc verwenden */
-    if (!table->arena) {
-        for (size_t i = 0; i < table->capacity; i++) {
-            if (table->entries[i].status == MYRTX_HASH_ENTRY_OCCUPIED) {
-                if (free_keys) {
-                    free(table->entries[i].key);
-                }
-                if (free_values) {
-                    free(table->entries[i].value);
-                }
-            }
-            
-            /* Eintrag als leer markieren */
-            table->entries[i].status = MYRTX_HASH_ENTRY_EMPTY;
+    /* Free keys and values if requested and we use malloc; without any
+     * buffers of their own there is nothing to walk */
+    bool release = free_keys || free_values || (table->flags & MYRTX_HASH_TABLE_INLINE_STORAGE);
+    if (release && table->buffered > 0) {
+        release_all_entries(table, table, free_keys, free_values);
+        if (table->migrating) {
+            release_all_entries(table, table->old, free_keys, free_values);
         }
-    } else {
-        /* Bei Arena-Allokation einfach alle Einträge als leer markieren */
-        for (size_t i = 0; i < table->capacity; i++) {
-            table->entries[i].status = MYRTX_HASH_ENTRY_EMPTY;
+    }
+    
+    /* Abandon a resize in progress; the old arrays are empty */
+    if (table->migrating) {
+        table->backend->release(table->old);
+        table->migrating = false;
+    }
+    
+    /* The timers no longer refer to any entries */
+    hash_wheel_free(table);
+    
+    /* Generation-tagged slots go stale by advancing the generation. Only
+     * when it wraps around must old slots stop matching it explicitly. */
+    if (table->flags & MYRTX_HASH_TABLE_GENERATIONS) {
+        if (++table->generation == MYRTX_HASH_TABLE_GENERATIONS_MAX) {
+            table->generation = 0;
+            for (size_t i = 0; i < table->capacity; i++) {
+                hash_slot_set_state(table, &table->entries[i], MYRTX_HASH_ENTRY_EMPTY);
+            }
         }
     }
     
-    /* Zähler zurücksetzen */
+    /* Mark all entries empty and reset the counters */
+    table->backend->reset(table);
     table->size = 0;
     table->tombstones = 0;
+    table->buffered = 0;
+}
+
+/* Entries of @p arrays worth walking: compact tables stop after the last appended entry */
+static size_t iteration_limit(const myrtx_hash_table_t* arrays) {
+    return arrays->index ? arrays->dense_count : arrays->capacity;
+}
+
+void myrtx_hash_table_iter_init(myrtx_hash_table_iter_t* iter, const myrtx_hash_table_t* table) {
+    if (!iter) {
+        return;
+    }
+    iter->table = table;
+    iter->position = 0;
+}
+
+bool myrtx_hash_table_iter_next(myrtx_hash_table_iter_t* iter,
+                                const void** key, size_t* key_size,
+                                void** value, size_t* value_size) {
+    if (!iter || !iter->table) {
+        return false;
+    }
+    
+    const myrtx_hash_table_t* table = iter->table;
+    size_t limit = iteration_limit(table);
+    for (;;) {
+        /* Positions past the current arrays continue in the old ones */
+        const myrtx_hash_table_t* arrays = table;
+        size_t position = iter->position;
+        if (position >= limit) {
+            if (!table->migrating || table->backend->migrate_start ||
+                position - limit >= table->old->capacity) {
+                return false;
+            }
+            arrays = table->old;
+            position -= limit;
+        }
+        iter->position++;
+        
+        /* Backends that keep positions while migrating: an entry not moved
+         * yet is still at its position in the old arrays */
+        if (arrays == table && table->migrating && table->backend->migrate_start &&
+            position < iteration_limit(table->old) &&
+            hash_slot_state(table->old, &table->old->entries[position]) ==
+                MYRTX_HASH_ENTRY_OCCUPIED) {
+            arrays = table->old;
+        }
+        const myrtx_hash_entry_t* entry = &arrays->entries[position];
+        if (hash_slot_state(arrays, entry) == MYRTX_HASH_ENTRY_OCCUPIED &&
+            !hash_entry_expired(table, entry)) {
+            if (key) {
+                *key = hash_entry_key(entry);
+            }
+            if (key_size) {
+                *key_size = entry->key_size;
+            }
+            if (value) {
+                *value = hash_entry_value(entry);
+            }
+            if (value_size) {
+                *value_size = entry->value_size;
+            }
+            return true;
+        }
+    }
+}
+
+/* Adds the entries of @p arrays (the table or its old shadow) to the stats */
+static void collect_stats(const myrtx_hash_table_t* table, const myrtx_hash_table_t* arrays,
+                          myrtx_hash_table_stats_t* stats, size_t* total_probes) {
+    size_t limit = iteration_limit(arrays);
+    for (size_t i = 0; i < limit; i++) {
+        const myrtx_hash_entry_t* entry = &arrays->entries[i];
+        if (hash_slot_state(arrays, entry) != MYRTX_HASH_ENTRY_OCCUPIED) {
+            continue;
+        }
+        
+        size_t length = table->backend->probe_length(arrays, entry);
+        *total_probes += length;
+        if (length > stats->max_probe_length) {
+            stats->max_probe_length = length;
+        }
+        stats->probe_histogram[length < MYRTX_HASH_STATS_BUCKETS ? length - 1
+                                                                : MYRTX_HASH_STATS_BUCKETS - 1]++;
+        stats->expired += hash_entry_expired(table, entry);
+        
+        if (!(entry->storage & MYRTX_HASH_STORAGE_KEY_INLINE)) {
+            stats->key_bytes += entry->key_size;
+        }
+        if (!(entry->storage & MYRTX_HASH_STORAGE_VALUE_INLINE)) {
+            stats->value_bytes += entry->value_size;
+        }
+    }
+}
+
+/* Computes occupancy and probe statistics */
+void myrtx_hash_table_stats(const myrtx_hash_table_t* table, myrtx_hash_table_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+    
+    memset(stats, 0, sizeof(*stats));
+    if (!table) {
+        return;
+    }
+    
+    stats->capacity = table->capacity;
+    stats->size = table->size;
+    stats->tombstones = table->tombstones;
+    stats->load = (double)table->size / (double)table->capacity;
+    stats->slot_bytes = table->backend->array_bytes(table);
+    
+    size_t total_probes = 0;
+    collect_stats(table, table, stats, &total_probes);
+    if (table->migrating) {
+        stats->tombstones += table->old->tombstones;
+        stats->slot_bytes += table->backend->array_bytes(table->old);
+        collect_stats(table, table->old, stats, &total_probes);
+    }
+    
+    if (table->size > 0) {
+        stats->average_probe_length = (double)total_probes / (double)table->size;
+    }
+}
+
+/* Moves one occupied entry of @p src into @p dst. Returns false if @p dst
+ * ran out of memory; the entry then stays in @p src. */
+static bool merge_entry(myrtx_hash_table_t* dst, myrtx_hash_table_t* src,
+                        myrtx_hash_entry_t* entry, bool same_hash,
+                        myrtx_hash_merge_function merge, void* user_data) {
+    if (hash_entry_expired(src, entry)) {
+        hash_table_erase_entry(src, entry);
+        return true;
+    }
+    
+    /* The buffers move as they are; the expiry needs a timer of dst */
+    myrtx_hash_entry_t moved = *entry;
+    uint64_t expiry = hash_entry_expiry(&moved);
+    moved.storage &= (uint8_t)~MYRTX_HASH_STORAGE_TIMER;
+    hash_entry_set_expiry(&moved, 0);
+    if (!same_hash) {
+        moved.hash = hash_table_hash(dst, hash_entry_key(&moved), moved.key_size);
+    }
+    
+    if (dst->migrating) {
+        migrate_step(dst, MYRTX_HASH_MIGRATE_SLOTS);
+    }
+    
+    size_t hint;
+    myrtx_hash_entry_t* slot = find_any(dst, hash_entry_key(&moved), moved.key_size, moved.hash,
+                                        &hint);
+    if (slot && !hash_entry_expired(dst, slot)) {
+        /* Conflict: merge into the stored value, or replace it as a put would */
+        if (merge) {
+            merge(hash_entry_value(slot), slot->value_size, hash_entry_value(entry),
+                  entry->value_size, user_data);
+            hash_table_erase_entry(src, entry);
+        } else {
+            replace_entry(dst, slot, &moved, true);
+            unlink_entry(src, entry);
+        }
+        return true;
+    }
+    
+    if (slot) {
+        replace_entry(dst, slot, &moved, false);
+    } else {
+        slot = place_entry(dst, &moved, hint);
+        if (!slot) {
+            return false;
+        }
+    }
+    unlink_entry(src, entry);
+    
+    if (expiry != 0 && !hash_wheel_schedule(dst, slot, expiry)) {
+        /* Without a timer the entry still counts as missing once expired */
+        hash_entry_set_expiry(slot, expiry);
+        return false;
+    }
+    return true;
+}
+
+/* Moves all entries from src to dst */
+bool myrtx_hash_table_merge(myrtx_hash_table_t* dst,
+                            myrtx_hash_table_t* src,
+                            myrtx_hash_merge_function merge,
+                            void* user_data) {
+    if (!dst || !src || dst == src) {
+        return false;
+    }
+    
+    /* Buffers change tables as they are, so both must allocate them alike */
+    if (dst->arena != src->arena ||
+        ((dst->flags ^ src->flags) & MYRTX_HASH_TABLE_INLINE_STORAGE)) {
+        return false;
+    }
+    
+    /* Only the current arrays of src are walked */
+    if (src->migrating) {
+        migrate_step(src, SIZE_MAX);
+        if (src->migrating) {
+            return false;
+        }
+    }
+
+    /* Grow dst once up front, as if no key were shared, instead of
+     * doubling it repeatedly while the entries arrive */
+    if (!hash_table_reserve(dst, dst->size + src->size)) {
+        return false;
+    }
+
+    /* Stored hashes are reused if both tables hash alike */
+    bool same_hash = dst->hash_func == src->hash_func && dst->hash64_func == src->hash64_func &&
+                     dst->seed == src->seed;
+    
+    size_t limit = iteration_limit(src);
+    size_t position = 0;
+    while (position < limit) {
+        myrtx_hash_entry_t* entry = &src->entries[position];
+        if (hash_slot_state(src, entry) != MYRTX_HASH_ENTRY_OCCUPIED) {
+            position++;
+            continue;
+        }
+        
+        /* Robin Hood may shift the next entry into this slot, so the
+         * position only advances once the slot is free */
+        if (!merge_entry(dst, src, entry, same_hash, merge, user_data)) {
+            return false;
+        }
+    }
+    
+    /* Resets the arrays; the entries have all moved */
+    myrtx_hash_table_clear(src, false, false);
+    return true;
 }
 
 /* FNV-1a Hash-Algorithmus für Strings */
@@ -538,13 +1585,22 @@ uint32_t myrtx_hash_string(const void* key, size_t key_size) {
 
 /* Hash-Funktion für Integer-Schlüssel */
 uint32_t myrtx_hash_integer(const void* key, size_t key_size) {
-    (void)key_size; /* Unused parameter */
+    if (key_size == 0 || key_size == sizeof(int)) {
+        /* Integer direkt als Hash-Wert verwenden */
+        int value = *(const int*)key;
+        
+        /* Knuth's Multiplikationsmethode für bessere Verteilung */
+        return (uint32_t)(value * 2654435761u);
+    }
     
-    /* Integer direkt als Hash-Wert verwenden */
-    int value = *(const int*)key;
+    if (key_size <= sizeof(uint64_t)) {
+        /* Wider or narrower integers: fold all bytes into the high half */
+        uint64_t value = 0;
+        memcpy(&value, key, key_size);
+        return (uint32_t)((value * 0x9E3779B97F4A7C15ull) >> 32);
+    }
     
-    /* Knuth's Multiplikationsmethode für bessere Verteilung */
-    return (uint32_t)(value * 2654435761u);
+    return myrtx_hash_string(key, key_size);
 }
 
 /* Vergleichsfunktion für String-Schlüssel */
@@ -582,12 +1638,19 @@ bool myrtx_compare_string_keys(const void* key1, size_t key1_size,
 /* Vergleichsfunktion für Integer-Schlüssel */
 bool myrtx_compare_integer_keys(const void* key1, size_t key1_size,
                                const void* key2, size_t key2_size) {
-    (void)key1_size; /* Unused parameter */
-    (void)key2_size; /* Unused parameter */
-    
-    /* Vergleiche die Integer-Werte direkt */
-    int int1 = *(const int*)key1;
-    int int2 = *(const int*)key2;
+    if (key1_size == 0) {
+        key1_size = sizeof(int);
+    }
+    if (key2_size == 0) {
+        key2_size = sizeof(int);
+    }
+    if (key1_size != key2_size) {
+        return false;
+    }
     
-    return int1 == int2;
-} 
\ No newline at end of file
+    if (key1_size == sizeof(int)) {
+        /* Vergleiche die Integer-Werte direkt */
+        return *(const int*)key1 == *(const int*)key2;
+    }
+    return memcmp(key1, key2, key1_size) == 0;
+}
\ No newline at end of file
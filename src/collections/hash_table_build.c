@@ -0,0 +1,367 @@
+/**
+ * @file hash_table_build.c
+ * @brief Parallel bulk construction of hash tables
+ *
+ * The table is created at the capacity that holds every entry without
+ * growing, and its slot array is cut into partitions: contiguous ranges of
+ * home slots, i.e. hash prefixes. The build runs in three parallel phases
+ * over the same worker threads:
+ *
+ * 1. Each thread hashes a contiguous chunk of the input and counts the
+ *    entries per partition.
+ * 2. Each thread scatters the entry numbers of its chunk into one array
+ *    sorted by partition. The order within a partition stays the input
+ *    order, so later duplicates still win.
+ * 3. Each thread owns some of the partitions and stores their entries,
+ *    reading and writing only the slots of the partition (backend claim()).
+ *    An entry whose probe would run past the end of its range is set
+ *    aside.
+ *
+ * The calling thread then stores the set-aside entries with ordinary
+ * puts. These are the stitches between neighbouring ranges, a small
+ * fraction of the input. All later occurrences of a set-aside key are set
+ * aside too: slots only fill up during the build, so their probes hit the
+ * same full run.
+ */
+
+#include "hash_table_internal.h"
+#include "platform/thread.h"
+#include <string.h>
+
+/* Partitions per thread, so that uneven partitions even out */
+#define BUILD_PARTITIONS_PER_THREAD 4
+
+/* Smallest slot range worth a partition of its own */
+#define BUILD_MIN_REGION 4096
+
+typedef struct build_job build_job_t;
+
+/* One thread's share of the build */
+typedef struct {
+    build_job_t* job;
+    unsigned int index;
+    size_t* counts;                /* Entries per partition in the chunk, then scatter positions */
+    size_t size;                   /* Entries stored */
+    size_t buffered;               /* Stored entries with a buffer of their own */
+    myrtx_hash_entry_t* deferred;  /* Entries whose probe left their range */
+    size_t deferred_count;
+    size_t deferred_capacity;
+    bool failed;                   /* Ran out of memory */
+} build_worker_t;
+
+struct build_job {
+    myrtx_hash_table_t* table;
+    size_t count;
+    const void* const* keys;
+    const size_t* key_sizes;
+    const void* const* values;
+    const size_t* value_sizes;
+    uint64_t* hashes;
+    size_t* order;                 /* Entry numbers grouped by partition */
+    size_t* partition_start;       /* partitions + 1 offsets into order */
+    size_t partitions;
+    size_t region;                 /* Slots per partition */
+    unsigned int threads;
+    build_worker_t* workers;
+    myrtx_mutex_t alloc_lock;      /* Arena mode: the arena is not thread-safe */
+};
+
+static inline size_t build_key_size(const build_job_t* job, size_t i) {
+    if (job->key_sizes && job->key_sizes[i] != 0) {
+        return job->key_sizes[i];
+    }
+    return strlen(job->keys[i]) + 1;
+}
+
+static inline size_t build_partition(const build_job_t* job, uint64_t hash) {
+    return (size_t)(hash & (job->table->capacity - 1)) / job->region;
+}
+
+/* First entry number of thread @p index's chunk */
+static inline size_t chunk_start(const build_job_t* job, unsigned int index) {
+    size_t base = job->count / job->threads;
+    size_t extra = job->count % job->threads;
+    return base * index + (index < extra ? index : extra);
+}
+
+/* Phase 1: hash the chunk and count its entries per partition */
+static void build_hash(void* arg) {
+    build_worker_t* worker = arg;
+    build_job_t* job = worker->job;
+    size_t end = chunk_start(job, worker->index + 1);
+
+    for (size_t i = chunk_start(job, worker->index); i < end; i++) {
+        uint64_t hash = hash_table_hash(job->table, job->keys[i], build_key_size(job, i));
+        job->hashes[i] = hash;
+        worker->counts[build_partition(job, hash)]++;
+    }
+}
+
+/* Phase 2: scatter the chunk's entry numbers to their partitions */
+static void build_scatter(void* arg) {
+    build_worker_t* worker = arg;
+    build_job_t* job = worker->job;
+    size_t end = chunk_start(job, worker->index + 1);
+
+    for (size_t i = chunk_start(job, worker->index); i < end; i++) {
+        job->order[worker->counts[build_partition(job, job->hashes[i])]++] = i;
+    }
+}
+
+/* Whether an entry of these sizes needs buffers outside its slot */
+static inline bool build_needs_buffer(const myrtx_hash_table_t* table, size_t key_size,
+                                      size_t value_size) {
+    return (table->flags & (MYRTX_HASH_TABLE_INLINE_STORAGE | MYRTX_HASH_TABLE_KEYS_BORROWED)) !=
+               MYRTX_HASH_TABLE_INLINE_STORAGE ||
+           key_size > MYRTX_HASH_INLINE_SIZE || value_size > MYRTX_HASH_INLINE_SIZE;
+}
+
+/* Sets an entry aside for the calling thread */
+static bool build_defer(build_worker_t* worker, const myrtx_hash_entry_t* entry) {
+    if (worker->deferred_count == worker->deferred_capacity) {
+        size_t capacity = worker->deferred_capacity ? worker->deferred_capacity * 2 : 64;
+        myrtx_hash_entry_t* deferred = realloc(worker->deferred,
+                                               capacity * sizeof(myrtx_hash_entry_t));
+        if (!deferred) {
+            return false;
+        }
+        worker->deferred = deferred;
+        worker->deferred_capacity = capacity;
+    }
+    worker->deferred[worker->deferred_count++] = *entry;
+    return true;
+}
+
+/* Stores an entry within the range [lo, hi) */
+static bool build_store(build_worker_t* worker, size_t i, size_t lo, size_t hi) {
+    build_job_t* job = worker->job;
+    myrtx_hash_table_t* table = job->table;
+    size_t key_size = build_key_size(job, i);
+    size_t value_size = job->value_sizes[i];
+    bool lock = table->arena && build_needs_buffer(table, key_size, value_size);
+
+    if (lock) {
+        myrtx_mutex_lock(&job->alloc_lock);
+    }
+    myrtx_hash_entry_t entry = hash_table_new_entry(table, job->keys[i], key_size, job->values[i],
+                                                    value_size, job->hashes[i]);
+    if (lock) {
+        myrtx_mutex_unlock(&job->alloc_lock);
+    }
+    if (entry.status != MYRTX_HASH_ENTRY_OCCUPIED) {
+        return false;
+    }
+
+    bool found;
+    myrtx_hash_entry_t* slot = table->backend->claim(table, job->keys[i], key_size,
+                                                     job->hashes[i], lo, hi, &found);
+    if (!slot) {
+        if (!build_defer(worker, &entry)) {
+            hash_table_free_entry(table, &entry);
+            return false;
+        }
+        return true;
+    }
+
+    myrtx_hash_entry_t old = *slot;
+    *slot = entry;
+    hash_slot_set_state(table, slot, MYRTX_HASH_ENTRY_OCCUPIED);
+    if (hash_entry_buffered(table, slot)) {
+        worker->buffered++;
+    }
+    if (!found) {
+        worker->size++;
+        return true;
+    }
+
+    /* A later duplicate replaces the stored entry */
+    if (hash_entry_buffered(table, &old)) {
+        worker->buffered--;
+        lock = table->arena != NULL;
+        if (lock) {
+            myrtx_mutex_lock(&job->alloc_lock);
+        }
+        hash_table_free_entry(table, &old);
+        if (lock) {
+            myrtx_mutex_unlock(&job->alloc_lock);
+        }
+    }
+    return true;
+}
+
+/* Phase 3: store the entries of the thread's partitions */
+static void build_place(void* arg) {
+    build_worker_t* worker = arg;
+    build_job_t* job = worker->job;
+
+    for (size_t p = worker->index; p < job->partitions; p += job->threads) {
+        size_t lo = p * job->region;
+        for (size_t k = job->partition_start[p]; k < job->partition_start[p + 1]; k++) {
+            if (!build_store(worker, job->order[k], lo, lo + job->region)) {
+                worker->failed = true;
+                return;
+            }
+        }
+    }
+}
+
+/* Runs @p phase on every worker, the first one on the calling thread */
+static void build_run(build_job_t* job, void (*phase)(void*)) {
+    myrtx_thread_t* threads = malloc(job->threads * sizeof(myrtx_thread_t));
+    bool* started = calloc(job->threads, sizeof(bool));
+
+    for (unsigned int t = 1; t < job->threads; t++) {
+        if (threads && started) {
+            started[t] = myrtx_thread_start(&threads[t], phase, &job->workers[t]);
+        }
+    }
+    phase(&job->workers[0]);
+
+    /* Workers whose thread did not start run here */
+    for (unsigned int t = 1; t < job->threads; t++) {
+        if (started && started[t]) {
+            myrtx_thread_join(&threads[t]);
+        } else {
+            phase(&job->workers[t]);
+        }
+    }
+    free(threads);
+    free(started);
+}
+
+/* Partitioned build of a presized table */
+static bool build_partitioned(build_job_t* job) {
+    myrtx_hash_table_t* table = job->table;
+    bool ok = false;
+
+    job->hashes = malloc(job->count * sizeof(uint64_t));
+    job->order = malloc(job->count * sizeof(size_t));
+    job->partition_start = calloc(job->partitions + 1, sizeof(size_t));
+    job->workers = calloc(job->threads, sizeof(build_worker_t));
+    size_t* counts = calloc((size_t)job->threads * job->partitions, sizeof(size_t));
+    if (!job->hashes || !job->order || !job->partition_start || !job->workers || !counts) {
+        goto done;
+    }
+    myrtx_mutex_init(&job->alloc_lock);
+
+    for (unsigned int t = 0; t < job->threads; t++) {
+        job->workers[t].job = job;
+        job->workers[t].index = t;
+        job->workers[t].counts = counts + (size_t)t * job->partitions;
+    }
+
+    build_run(job, build_hash);
+
+    /* Partition by partition, each thread's entries follow the previous
+     * thread's, which keeps the input order */
+    size_t position = 0;
+    for (size_t p = 0; p < job->partitions; p++) {
+        job->partition_start[p] = position;
+        for (unsigned int t = 0; t < job->threads; t++) {
+            size_t count = job->workers[t].counts[p];
+            job->workers[t].counts[p] = position;
+            position += count;
+        }
+    }
+    job->partition_start[job->partitions] = position;
+
+    build_run(job, build_scatter);
+    build_run(job, build_place);
+    myrtx_mutex_destroy(&job->alloc_lock);
+
+    ok = true;
+    for (unsigned int t = 0; t < job->threads; t++) {
+        table->size += job->workers[t].size;
+        table->buffered += job->workers[t].buffered;
+        ok = ok && !job->workers[t].failed;
+    }
+
+    /* Stitch: the set-aside entries, in input order per key */
+    for (unsigned int t = 0; t < job->threads; t++) {
+        build_worker_t* worker = &job->workers[t];
+        for (size_t i = 0; i < worker->deferred_count; i++) {
+            if (!ok || !hash_table_put_entry(table, &worker->deferred[i])) {
+                hash_table_free_entry(table, &worker->deferred[i]);
+                ok = false;
+            }
+        }
+    }
+
+done:
+    if (job->workers) {
+        for (unsigned int t = 0; t < job->threads; t++) {
+            free(job->workers[t].deferred);
+        }
+    }
+    free(counts);
+    free(job->workers);
+    free(job->partition_start);
+    free(job->order);
+    free(job->hashes);
+    return ok;
+}
+
+/* Builds a hash table from many entries in parallel */
+myrtx_hash_table_t* myrtx_hash_table_build_parallel(const myrtx_hash_table_options_t* options,
+                                                    size_t count,
+                                                    const void* const* keys,
+                                                    const size_t* key_sizes,
+                                                    const void* const* values,
+                                                    const size_t* value_sizes,
+                                                    unsigned int threads) {
+    if (!options || (count > 0 && (!keys || !values || !value_sizes))) {
+        return NULL;
+    }
+
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(options);
+    if (!table) {
+        return NULL;
+    }
+    if (count == 0) {
+        return table;
+    }
+    if (!hash_table_reserve(table, count)) {
+        myrtx_hash_table_free(table, true, true);
+        return NULL;
+    }
+
+    if (threads == 0) {
+        threads = 1;
+    }
+    size_t partitions = 1;
+    while (partitions < (size_t)threads * BUILD_PARTITIONS_PER_THREAD &&
+           table->capacity / (partitions * 2) >= BUILD_MIN_REGION) {
+        partitions *= 2;
+    }
+
+    /* One thread, a small table or a backend that cannot place entries by
+     * range: plain puts, which no longer need to grow the table */
+    if (threads == 1 || partitions == 1 || !table->backend->claim) {
+        for (size_t i = 0; i < count; i++) {
+            size_t key_size = key_sizes ? key_sizes[i] : 0;
+            if (!myrtx_hash_table_put(table, keys[i], key_size, values[i], value_sizes[i])) {
+                myrtx_hash_table_free(table, true, true);
+                return NULL;
+            }
+        }
+        return table;
+    }
+
+    build_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.table = table;
+    job.count = count;
+    job.keys = keys;
+    job.key_sizes = key_sizes;
+    job.values = values;
+    job.value_sizes = value_sizes;
+    job.partitions = partitions;
+    job.region = table->capacity / partitions;
+    job.threads = threads;
+
+    if (!build_partitioned(&job)) {
+        myrtx_hash_table_free(table, true, true);
+        return NULL;
+    }
+    return table;
+}
@@ -0,0 +1,285 @@
+/**
+ * @file hash_table_compact.c
+ * @brief Compact backend: small index array over dense, insertion-ordered entries
+ *
+ * Entries are appended to a dense array in insertion order. A separate
+ * index array of int32 (int64 for huge tables) slot numbers, twice as long
+ * as the entry array, is probed linearly and points into it. Removing an
+ * entry leaves a hole in the entry array and a DUMMY in the index. When
+ * the entry array is full, it is either compacted in place (many holes) or
+ * copied into a larger array; in both cases only the index is rehashed.
+ *
+ * Walking the entry array visits entries in insertion order and touches no
+ * empty slots, except for the holes left by removals.
+ */
+
+#include "hash_table_internal.h"
+#include "myrtx/context/trace.h"
+#include <string.h>
+
+/* Index slot values besides entry numbers */
+#define COMPACT_EMPTY ((int64_t)-1)
+#define COMPACT_DUMMY ((int64_t)-2)
+
+/* Index slots per entry slot; keeps the index at most half full */
+#define COMPACT_INDEX_RATIO 2
+
+static inline size_t index_capacity(size_t capacity) {
+    return capacity * COMPACT_INDEX_RATIO;
+}
+
+/* Whether entry numbers need 64-bit index slots */
+static inline bool index_wide(size_t capacity) {
+    return index_capacity(capacity) > (size_t)INT32_MAX;
+}
+
+static inline size_t index_bytes(size_t capacity) {
+    return index_capacity(capacity) * (index_wide(capacity) ? sizeof(int64_t) : sizeof(int32_t));
+}
+
+static inline int64_t index_get(const myrtx_hash_table_t* table, size_t slot) {
+    if (index_wide(table->capacity)) {
+        return ((const int64_t*)table->index)[slot];
+    }
+    return ((const int32_t*)table->index)[slot];
+}
+
+static inline void index_set(myrtx_hash_table_t* table, size_t slot, int64_t value) {
+    if (index_wide(table->capacity)) {
+        ((int64_t*)table->index)[slot] = value;
+    } else {
+        ((int32_t*)table->index)[slot] = (int32_t)value;
+    }
+}
+
+/* First EMPTY or DUMMY index slot for @p hash */
+static size_t find_index_slot(const myrtx_hash_table_t* table, uint64_t hash) {
+    size_t mask = index_capacity(table->capacity) - 1;
+    size_t slot = hash & mask;
+    while (index_get(table, slot) >= 0) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/* Refill the index from the live entries; every index slot must be EMPTY */
+static void rebuild_index(myrtx_hash_table_t* table) {
+    for (size_t i = 0; i < table->dense_count; i++) {
+        index_set(table, find_index_slot(table, table->entries[i].hash), (int64_t)i);
+    }
+}
+
+static bool compact_init(myrtx_hash_table_t* table, size_t capacity) {
+    myrtx_hash_entry_t* entries = hash_table_alloc_entries(table, capacity);
+    void* index = hash_table_malloc(table, index_bytes(capacity));
+    if (!entries || !index) {
+        hash_table_release(table, entries, sizeof(myrtx_hash_entry_t) * capacity);
+        hash_table_release(table, index, index_bytes(capacity));
+        return false;
+    }
+
+    /* All-ones bytes read as COMPACT_EMPTY in either width */
+    memset(index, 0xFF, index_bytes(capacity));
+
+    table->entries = entries;
+    table->index = index;
+    table->capacity = capacity;
+    table->dense_count = 0;
+    table->tombstones = 0;
+    return true;
+}
+
+/* Squeeze the holes out of the entry array, keeping the order */
+static void compact_in_place(myrtx_hash_table_t* table) {
+    size_t count = 0;
+    for (size_t i = 0; i < table->dense_count; i++) {
+        if (hash_slot_state(table, &table->entries[i]) == MYRTX_HASH_ENTRY_OCCUPIED) {
+            table->entries[count++] = table->entries[i];
+        }
+    }
+    for (size_t i = count; i < table->dense_count; i++) {
+        hash_slot_set_state(table, &table->entries[i], MYRTX_HASH_ENTRY_EMPTY);
+    }
+
+    table->dense_count = count;
+    table->tombstones = 0;
+    memset(table->index, 0xFF, index_bytes(table->capacity));
+    rebuild_index(table);
+}
+
+/* Copy the live entries, in order, into arrays of @p new_capacity slots */
+static bool compact_resize(myrtx_hash_table_t* table, size_t new_capacity) {
+    myrtx_hash_entry_t* old_entries = table->entries;
+    void* old_index = table->index;
+    size_t old_capacity = table->capacity;
+    size_t old_count = table->dense_count;
+
+    if (!compact_init(table, new_capacity)) {
+        return false;
+    }
+
+    MYRTX_TRACE_EMIT(MYRTX_TRACE_HASH_RESIZE, old_capacity, new_capacity);
+
+    for (size_t i = 0; i < old_count; i++) {
+        if (hash_slot_state(table, &old_entries[i]) == MYRTX_HASH_ENTRY_OCCUPIED) {
+            table->entries[table->dense_count++] = old_entries[i];
+        }
+    }
+    rebuild_index(table);
+
+    hash_table_release(table, old_entries, sizeof(myrtx_hash_entry_t) * old_capacity);
+    hash_table_release(table, old_index, index_bytes(old_capacity));
+    return true;
+}
+
+static void compact_release(myrtx_hash_table_t* table) {
+    hash_table_release(table, table->entries, sizeof(myrtx_hash_entry_t) * table->capacity);
+    hash_table_release(table, table->index, index_bytes(table->capacity));
+}
+
+static myrtx_hash_entry_t* compact_find(const myrtx_hash_table_t* table, const void* key,
+                                        size_t key_size, uint64_t hash, size_t* hint) {
+    size_t mask = index_capacity(table->capacity) - 1;
+    size_t slot = hash & mask;
+
+    *hint = SIZE_MAX;
+
+    /* The index is at most half full, so an EMPTY slot always ends the probe */
+    for (;;) {
+        int64_t value = index_get(table, slot);
+        if (value == COMPACT_EMPTY) {
+            if (*hint == SIZE_MAX) {
+                *hint = slot;
+            }
+            return NULL;
+        }
+        if (value == COMPACT_DUMMY) {
+            if (*hint == SIZE_MAX) {
+                *hint = slot;
+            }
+        } else {
+            myrtx_hash_entry_t* entry = &table->entries[value];
+            if (entry->hash == hash &&
+                table->compare_func(hash_entry_key(entry), entry->key_size, key, key_size)) {
+                return entry;
+            }
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+/* Only the index slot; the entry it names is not known yet */
+static void compact_prefetch(const myrtx_hash_table_t* table, uint64_t hash) {
+    size_t slot = hash & (index_capacity(table->capacity) - 1);
+    if (index_wide(table->capacity)) {
+        MYRTX_HASH_PREFETCH((const int64_t*)table->index + slot);
+    } else {
+        MYRTX_HASH_PREFETCH((const int32_t*)table->index + slot);
+    }
+}
+
+/* A full dense array that is mostly live doubles; one with many holes is
+ * compacted in place by insert() instead */
+static size_t compact_grow_capacity(const myrtx_hash_table_t* table) {
+    if (table->dense_count < table->capacity || table->size <= table->capacity / 2) {
+        return 0;
+    }
+    return table->capacity * 2;
+}
+
+static myrtx_hash_entry_t* compact_insert(myrtx_hash_table_t* table, uint64_t hash,
+                                          size_t hint) {
+    if (table->dense_count == table->capacity) {
+        /* Mostly holes: reuse the arrays; otherwise double them */
+        size_t new_capacity = compact_grow_capacity(table);
+        if (new_capacity == 0) {
+            compact_in_place(table);
+        } else if (!compact_resize(table, new_capacity)) {
+            return NULL;
+        }
+        hint = SIZE_MAX;
+    }
+
+    size_t slot = hint < index_capacity(table->capacity) ? hint : find_index_slot(table, hash);
+    index_set(table, slot, (int64_t)table->dense_count);
+    return &table->entries[table->dense_count++];
+}
+
+static void compact_erase(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry) {
+    size_t mask = index_capacity(table->capacity) - 1;
+    int64_t position = (int64_t)(entry - table->entries);
+
+    size_t slot = entry->hash & mask;
+    while (index_get(table, slot) != position) {
+        slot = (slot + 1) & mask;
+    }
+    index_set(table, slot, COMPACT_DUMMY);
+
+    /* Every DUMMY is matched by a hole until the next rebuild, which keeps
+     * the index at most half full */
+    hash_slot_set_state(table, entry, MYRTX_HASH_ENTRY_DELETED);
+    table->tombstones++;
+}
+
+static void compact_reset(myrtx_hash_table_t* table) {
+    /* Slots of a generation-tagged table are stale after the clear
+     * already; only the index needs resetting */
+    if (!(table->flags & MYRTX_HASH_TABLE_GENERATIONS)) {
+        for (size_t i = 0; i < table->dense_count; i++) {
+            table->entries[i].status = MYRTX_HASH_ENTRY_EMPTY;
+        }
+    }
+    memset(table->index, 0xFF, index_bytes(table->capacity));
+    table->dense_count = 0;
+    table->tombstones = 0;
+}
+
+/* Index slots from the home slot up to the one naming the entry */
+static size_t compact_probe_length(const myrtx_hash_table_t* table,
+                                   const myrtx_hash_entry_t* entry) {
+    size_t mask = index_capacity(table->capacity) - 1;
+    int64_t position = (int64_t)(entry - table->entries);
+
+    size_t slot = entry->hash & mask;
+    size_t length = 1;
+    while (index_get(table, slot) != position) {
+        slot = (slot + 1) & mask;
+        length++;
+    }
+    return length;
+}
+
+/* Incremental growth keeps insertion order by keeping positions: the old
+ * positions start out as holes and are filled as the migration reaches
+ * them, while new entries are appended after them */
+static void compact_migrate_start(myrtx_hash_table_t* table, const myrtx_hash_table_t* old) {
+    table->dense_count = old->dense_count;
+    table->tombstones = old->dense_count;
+}
+
+static myrtx_hash_entry_t* compact_migrate_slot(myrtx_hash_table_t* table, size_t position,
+                                                uint64_t hash) {
+    index_set(table, find_index_slot(table, hash), (int64_t)position);
+    table->tombstones--;
+    return &table->entries[position];
+}
+
+static size_t compact_array_bytes(const myrtx_hash_table_t* table) {
+    return sizeof(myrtx_hash_entry_t) * table->capacity + index_bytes(table->capacity);
+}
+
+const myrtx_hash_backend_t myrtx_hash_backend_compact = {
+    compact_init,
+    compact_release,
+    compact_find,
+    compact_prefetch,
+    compact_grow_capacity,
+    compact_insert,
+    compact_erase,
+    compact_reset,
+    compact_probe_length,
+    compact_array_bytes,
+    NULL, /* Entries stay in insertion order, so builds are sequential */
+    compact_migrate_start,
+    compact_migrate_slot
+};
@@ -0,0 +1,319 @@
+/**
+ * @file hash_table_internal.h
+ * @brief Private layout shared by the hash table front end and its backends
+ *
+ * The public functions in hash_table.c handle key/value storage and size
+ * accounting; a backend only decides where entries live in the slot array.
+ * Every backend keeps `status` valid in all `capacity` entries so that
+ * freeing and clearing can walk the array without knowing the backend.
+ * Backends read and write it through hash_slot_state() and
+ * hash_slot_set_state(), which also handle generation-tagged tables.
+ */
+
+#ifndef MYRTX_HASH_TABLE_INTERNAL_H
+#define MYRTX_HASH_TABLE_INTERNAL_H
+
+#include "myrtx/collections/hash_table.h"
+#include <stdlib.h>
+
+/* Konstanten für die Hash-Tabelle */
+#define MYRTX_DEFAULT_CAPACITY 16
+#define MYRTX_DEFAULT_LOAD_FACTOR 0.75f
+
+/* Status eines Hash-Tabelleneintrags */
+typedef enum {
+    MYRTX_HASH_ENTRY_EMPTY = 0,
+    MYRTX_HASH_ENTRY_OCCUPIED,
+    MYRTX_HASH_ENTRY_DELETED
+} myrtx_hash_entry_status_t;
+
+/* Keys and values up to this size are stored in the entry (INLINE_STORAGE) */
+#define MYRTX_HASH_INLINE_SIZE 16
+
+/* Where an entry's key and value live (bits of myrtx_hash_entry_t.storage) */
+#define MYRTX_HASH_STORAGE_KEY_INLINE   0x1u /* Key bytes are in the entry */
+#define MYRTX_HASH_STORAGE_VALUE_INLINE 0x2u /* Value bytes are in the entry */
+#define MYRTX_HASH_STORAGE_VALUE_JOINED 0x4u /* Value shares the key's allocation */
+#define MYRTX_HASH_STORAGE_TIMER        0x8u /* A wheel timer may still refer to the entry */
+
+/* Internal flag, never accepted by myrtx_hash_table_create_ex(): an
+ * INLINE_STORAGE table stores a pointer to the caller's key instead of a
+ * copy and never frees it. The caller keeps the key alive and unchanged for
+ * as long as the entry exists (cache.c). */
+#define MYRTX_HASH_TABLE_KEYS_BORROWED (1u << 31)
+
+/* Generation-tagged tables keep the slot generation in the spare bits:
+ * the low 6 bits above the status, the high 4 bits above the storage bits */
+#define MYRTX_HASH_STATUS_MASK  0x03u
+#define MYRTX_HASH_STORAGE_MASK 0x0Fu
+
+/* Eintrag in der Hash-Tabelle */
+typedef struct {
+    union {
+        void* ptr;                                   /* Out-of-line key */
+        unsigned char bytes[MYRTX_HASH_INLINE_SIZE]; /* Inline key */
+    } key;
+    union {
+        void* ptr;                                   /* Out-of-line value */
+        unsigned char bytes[MYRTX_HASH_INLINE_SIZE]; /* Inline value */
+    } value;
+    size_t key_size;
+    size_t value_size;
+    uint8_t status;           /* myrtx_hash_entry_status_t, generation in bits 2-7 */
+    uint8_t storage;          /* MYRTX_HASH_STORAGE_* bits, generation in bits 4-7 */
+    uint16_t expiry_high;     /* Expiry tick, 48 bits split over the padding */
+    uint32_t expiry_low;      /* before hash; 0 for none */
+    uint64_t hash;            /* Full hash, so growth never needs the key */
+} myrtx_hash_entry_t;
+
+/* Expiry tick of an entry, or 0 */
+static inline uint64_t hash_entry_expiry(const myrtx_hash_entry_t* entry) {
+    return ((uint64_t)entry->expiry_high << 32) | entry->expiry_low;
+}
+
+static inline void hash_entry_set_expiry(myrtx_hash_entry_t* entry, uint64_t expires_at) {
+    entry->expiry_high = (uint16_t)(expires_at >> 32);
+    entry->expiry_low = (uint32_t)expires_at;
+}
+
+/* Key bytes of an occupied entry */
+static inline void* hash_entry_key(const myrtx_hash_entry_t* entry) {
+    return (entry->storage & MYRTX_HASH_STORAGE_KEY_INLINE) ? (void*)entry->key.bytes
+                                                            : entry->key.ptr;
+}
+
+/* Value bytes of an occupied entry */
+static inline void* hash_entry_value(const myrtx_hash_entry_t* entry) {
+    return (entry->storage & MYRTX_HASH_STORAGE_VALUE_INLINE) ? (void*)entry->value.bytes
+                                                              : entry->value.ptr;
+}
+
+/* Free lists of an arena-backed table (hash_table_recycle.c) */
+typedef struct myrtx_hash_recycler myrtx_hash_recycler_t;
+
+/* Timing wheel of the expiry timers (hash_table_ttl.c) */
+typedef struct myrtx_hash_wheel myrtx_hash_wheel_t;
+
+/* Slot placement strategy of a table */
+typedef struct myrtx_hash_backend {
+    /* Allocate the slot arrays for @p capacity entries, all empty */
+    bool (*init)(myrtx_hash_table_t* table, size_t capacity);
+    /* Free the slot arrays (recycled in arena mode) */
+    void (*release)(myrtx_hash_table_t* table);
+    /* Find an occupied entry; @p hint receives an insertion position for insert() */
+    myrtx_hash_entry_t* (*find)(const myrtx_hash_table_t* table, const void* key,
+                                size_t key_size, uint64_t hash, size_t* hint);
+    /* Start loading the slots a find() for @p hash touches first */
+    void (*prefetch)(const myrtx_hash_table_t* table, uint64_t hash);
+    /* Capacity the next insert would rebuild the table at, or 0 if it fits */
+    size_t (*grow_capacity)(const myrtx_hash_table_t* table);
+    /* Make room for a new entry with @p hash, growing the table if needed.
+     * Returns the slot to fill, or NULL if growing failed. */
+    myrtx_hash_entry_t* (*insert)(myrtx_hash_table_t* table, uint64_t hash, size_t hint);
+    /* Remove an occupied entry from the slot array */
+    void (*erase)(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry);
+    /* Mark every slot empty */
+    void (*reset)(myrtx_hash_table_t* table);
+    /* Slots (Swiss: groups) a lookup of an occupied entry examines, at least 1 */
+    size_t (*probe_length)(const myrtx_hash_table_t* table, const myrtx_hash_entry_t* entry);
+    /* Bytes of the slot arrays: entries plus control or index bytes */
+    size_t (*array_bytes)(const myrtx_hash_table_t* table);
+    /* Parallel build: the entry of a key whose home slot lies in [lo, hi)
+     * (*found set), or a slot opened for it, reading and writing only
+     * slots in that range. NULL if the probe or a shift would leave it.
+     * NULL hook: the backend cannot place entries by range. */
+    myrtx_hash_entry_t* (*claim)(myrtx_hash_table_t* table, const void* key, size_t key_size,
+                                 uint64_t hash, size_t lo, size_t hi, bool* found);
+    /* Incremental resize: prepare the fresh arrays so that every entry of
+     * @p old keeps its position. NULL hook: migrated entries are placed
+     * with insert(). */
+    void (*migrate_start)(myrtx_hash_table_t* table, const myrtx_hash_table_t* old);
+    /* With migrate_start: the slot at @p position for the migrating entry
+     * with @p hash, already reachable through the table */
+    myrtx_hash_entry_t* (*migrate_slot)(myrtx_hash_table_t* table, size_t position,
+                                        uint64_t hash);
+} myrtx_hash_backend_t;
+
+/* Hash-Tabellen-Struktur */
+struct myrtx_hash_table_t {
+    myrtx_hash_entry_t* entries;
+    size_t capacity;          /* Kapazität (Anzahl der möglichen Einträge) */
+    size_t size;              /* Anzahl der tatsächlich belegten Einträge */
+    size_t tombstones;        /* Anzahl der gelöschten Einträge (Grabsteine) */
+    float load_factor;        /* Schwellenwert für Auslastung */
+    myrtx_hash_function hash_func;     /* 32-bit hash, or NULL if hash64_func is set */
+    myrtx_hash64_function hash64_func; /* Seeded 64-bit hash */
+    uint64_t seed;                     /* Seed passed to hash64_func */
+    myrtx_key_compare_function compare_func;
+    myrtx_arena_t* arena;
+    const myrtx_hash_backend_t* backend; /* Slot placement strategy */
+    uint8_t* ctrl;            /* Swiss control bytes (capacity + group width), else NULL */
+    void* index;              /* Compact: int32/int64 entry numbers (2 * capacity), else NULL */
+    size_t dense_count;       /* Compact: entries appended so far, holes included */
+    unsigned int flags;       /* myrtx_hash_table_flags_t */
+    /* Incremental resize: the previous arrays, drained from migrate_pos on */
+    struct myrtx_hash_table_t* old; /* Shadow table holding the old arrays */
+    size_t migrate_pos;             /* Next old slot to migrate */
+    bool migrating;                 /* Whether old still holds entries */
+    myrtx_hash_recycler_t* recycler; /* Arena mode: released buffers for reuse, or NULL */
+    /* Expiry: entries with an expiry at or before now count as missing */
+    uint64_t now;                    /* Clock of the last myrtx_hash_table_expire() */
+    myrtx_hash_wheel_t* wheel;       /* Expiry timers, or NULL before the first expiry */
+    unsigned int generation;         /* GENERATIONS: generation of the live slots, else 0 */
+    size_t buffered;                 /* Entries with a key or value outside their slot */
+};
+
+/* Generation a slot was last written in */
+static inline unsigned int hash_entry_generation(const myrtx_hash_entry_t* entry) {
+    return (unsigned int)(entry->status >> 2) | ((unsigned int)(entry->storage >> 4) << 6);
+}
+
+/* State of a slot (myrtx_hash_entry_status_t) for a table with @p tagged
+ * = GENERATIONS and current @p generation. Probe loops read both once up
+ * front, since the compare callback keeps the compiler from hoisting them. */
+static inline uint8_t hash_slot_state_in(const myrtx_hash_entry_t* entry, bool tagged,
+                                         unsigned int generation) {
+    if (!tagged) {
+        return entry->status;
+    }
+    return hash_entry_generation(entry) == generation
+               ? (uint8_t)(entry->status & MYRTX_HASH_STATUS_MASK)
+               : (uint8_t)MYRTX_HASH_ENTRY_EMPTY;
+}
+
+/* State of a slot; in a generation-tagged table, a slot written before
+ * the last clear is empty */
+static inline uint8_t hash_slot_state(const myrtx_hash_table_t* table,
+                                      const myrtx_hash_entry_t* entry) {
+    return hash_slot_state_in(entry, (table->flags & MYRTX_HASH_TABLE_GENERATIONS) != 0,
+                              table->generation);
+}
+
+/* Sets a slot's state and stamps it with the current generation */
+static inline void hash_slot_set_state(const myrtx_hash_table_t* table,
+                                       myrtx_hash_entry_t* entry, uint8_t state) {
+    entry->status = (uint8_t)(state | ((table->generation & 0x3Fu) << 2));
+    entry->storage = (uint8_t)((entry->storage & MYRTX_HASH_STORAGE_MASK) |
+                               ((table->generation >> 6) << 4));
+}
+
+/* Whether an entry keeps its key or value in a buffer of its own */
+static inline bool hash_entry_buffered(const myrtx_hash_table_t* table,
+                                       const myrtx_hash_entry_t* entry) {
+    const unsigned int both = MYRTX_HASH_STORAGE_KEY_INLINE | MYRTX_HASH_STORAGE_VALUE_INLINE;
+    return !(table->flags & MYRTX_HASH_TABLE_INLINE_STORAGE) || (entry->storage & both) != both;
+}
+
+/* Whether an entry has expired by the table's clock */
+static inline bool hash_entry_expired(const myrtx_hash_table_t* table,
+                                      const myrtx_hash_entry_t* entry) {
+    uint64_t expiry = hash_entry_expiry(entry);
+    return expiry != 0 && expiry <= table->now;
+}
+
+/* Buffer recycling for arena-backed tables (hash_table_recycle.c) */
+bool hash_recycler_prepare(myrtx_hash_table_t* table);
+void* hash_recycle_alloc(myrtx_hash_table_t* table, size_t size);
+void hash_recycle_free(myrtx_hash_table_t* table, void* ptr, size_t size);
+size_t hash_recycle_class_size(size_t size);
+
+/* Entry lookup and removal for the timing wheel (hash_table.c); the entry
+ * may have expired */
+myrtx_hash_entry_t* hash_table_find_entry(const myrtx_hash_table_t* table, const void* key,
+                                          size_t key_size, uint64_t hash);
+void hash_table_erase_entry(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry);
+
+/* Entries for bulk builds (hash_table_build.c). hash_table_new_entry()
+ * copies a key and value into an unplaced entry, with status EMPTY if out
+ * of memory; hash_table_free_entry() frees such an entry's buffers. Neither
+ * touches the table, so unless it is arena-backed, several threads may call
+ * them at once. hash_table_put_entry() stores a ready entry like a put; on
+ * failure the entry is still the caller's. hash_table_reserve() grows the
+ * table in one step so that @p count entries fit without further growth. */
+myrtx_hash_entry_t hash_table_new_entry(myrtx_hash_table_t* table, const void* key,
+                                        size_t key_size, const void* value,
+                                        size_t value_size, uint64_t hash);
+void hash_table_free_entry(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry);
+bool hash_table_put_entry(myrtx_hash_table_t* table, const myrtx_hash_entry_t* entry);
+bool hash_table_reserve(myrtx_hash_table_t* table, size_t count);
+
+/* Expiry timers (hash_table_ttl.c). hash_wheel_schedule() sets an entry's
+ * expiry and arms a timer for it if no pending one fires early enough. */
+bool hash_wheel_schedule(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry,
+                         uint64_t expires_at);
+void hash_wheel_free(myrtx_hash_table_t* table);
+
+/* Speicherallokationsfunktion, die entweder die Arena oder malloc verwendet */
+static inline void* hash_table_malloc(myrtx_hash_table_t* table, size_t size) {
+    if (table->arena) {
+        return hash_recycle_alloc(table, size);
+    } else {
+        return malloc(size);
+    }
+}
+
+/* An entry array with every slot EMPTY. In malloc mode calloc hands out
+ * large arrays as untouched zero pages, so a fresh array costs nothing
+ * until its slots are used; incremental resizing relies on that. */
+static inline myrtx_hash_entry_t* hash_table_alloc_entries(myrtx_hash_table_t* table,
+                                                           size_t capacity) {
+    if (!table->arena) {
+        return calloc(capacity, sizeof(myrtx_hash_entry_t));
+    }
+    
+    myrtx_hash_entry_t* entries = hash_recycle_alloc(table, sizeof(myrtx_hash_entry_t) * capacity);
+    if (entries) {
+        for (size_t i = 0; i < capacity; i++) {
+            hash_slot_set_state(table, &entries[i], MYRTX_HASH_ENTRY_EMPTY);
+        }
+    }
+    return entries;
+}
+
+/* Frees memory from hash_table_malloc; in arena mode the buffer is kept for
+ * reuse. @p size may be smaller than the allocation, never larger. */
+static inline void hash_table_release(myrtx_hash_table_t* table, void* ptr, size_t size) {
+    if (!table->arena) {
+        free(ptr);
+    } else if (ptr) {
+        hash_recycle_free(table, ptr, size);
+    }
+}
+
+/* Hash of a key as stored in the entries. A 32-bit hash is spread over
+ * 64 bits so that the Swiss control bytes (top bits) stay informative. */
+static inline uint64_t hash_table_hash(const myrtx_hash_table_t* table, const void* key,
+                                       size_t key_size) {
+    if (table->hash64_func) {
+        return table->hash64_func(key, key_size, table->seed);
+    }
+    return (uint64_t)table->hash_func(key, key_size) * 0x9E3779B97F4A7C15ull;
+}
+
+/* Cache hint for a slot that will be read soon; no effect where unsupported */
+#if defined(__GNUC__)
+#define MYRTX_HASH_PREFETCH(addr) __builtin_prefetch((addr), 0, 3)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define MYRTX_HASH_PREFETCH(addr) _mm_prefetch((const char*)(addr), _MM_HINT_T0)
+#else
+#define MYRTX_HASH_PREFETCH(addr) ((void)(addr))
+#endif
+
+/* Findet die nächsthöhere Potenz von 2 */
+static inline size_t next_power_of_2(size_t n) {
+    size_t power = 1;
+    while (power < n) {
+        power *= 2;
+    }
+    return power;
+}
+
+/* Backends (hash_table.c, hash_table_swiss.c, hash_table_robin_hood.c,
+ * hash_table_compact.c) */
+extern const myrtx_hash_backend_t myrtx_hash_backend_linear;
+extern const myrtx_hash_backend_t myrtx_hash_backend_swiss;
+extern const myrtx_hash_backend_t myrtx_hash_backend_robin_hood;
+extern const myrtx_hash_backend_t myrtx_hash_backend_compact;
+
+#endif /* MYRTX_HASH_TABLE_INTERNAL_H */
@@ -0,0 +1,168 @@
+/**
+ * @file hash_table_recycle.c
+ * @brief Reuse of released buffers in arena-backed hash tables
+ *
+ * An arena cannot free single allocations, so an arena-backed table used to
+ * abandon every entry array it outgrew and every value buffer it replaced.
+ * Instead, released buffers go onto per-table free lists, one per size
+ * class, and later allocations are served from them first. Classes step by
+ * 8 bytes up to 128 bytes and by a quarter power of two above that. A
+ * request with no buffer of its own class splits the smallest larger one
+ * and keeps the exact rest, so the arrays left behind by growing end up
+ * holding keys and values. Buffers are never merged again.
+ */
+
+#include "hash_table_internal.h"
+
+#define RECYCLE_SIZE_BITS (sizeof(size_t) * 8)
+
+/* Classes 0-15: 8, 16, ..., 128 bytes */
+#define RECYCLE_SMALL_STEP 8
+#define RECYCLE_SMALL_CLASSES 16
+#define RECYCLE_SMALL_MAX (RECYCLE_SMALL_STEP * RECYCLE_SMALL_CLASSES)
+
+/* Above that, four classes per doubling up to 2^(bits-2) bytes; larger
+ * buffers come straight from the arena and are not recycled */
+#define RECYCLE_CLASSES (RECYCLE_SMALL_CLASSES + 4 * (RECYCLE_SIZE_BITS - 9))
+#define RECYCLE_MAX_SIZE ((size_t)1 << (RECYCLE_SIZE_BITS - 2))
+#define RECYCLE_MASK_WORDS ((RECYCLE_CLASSES + 63) / 64)
+
+/* A released buffer; the header lives in the buffer itself. Buffers in the
+ * small classes are exactly their class size and have room for the link
+ * only; larger ones record their size, which may exceed their class. */
+typedef struct recycled_block {
+    struct recycled_block* next;
+    size_t size;
+} recycled_block_t;
+
+struct myrtx_hash_recycler {
+    uint64_t nonempty[RECYCLE_MASK_WORDS]; /* Bit set per class with free buffers */
+    recycled_block_t* lists[RECYCLE_CLASSES];
+};
+
+static unsigned int floor_log2(size_t n) {
+#if defined(__GNUC__)
+    return 63u - (unsigned int)__builtin_clzll((unsigned long long)n);
+#else
+    unsigned int k = 0;
+    while (n >>= 1) {
+        k++;
+    }
+    return k;
+#endif
+}
+
+/* Smallest class whose buffers hold @p size bytes */
+static size_t class_index(size_t size) {
+    if (size <= RECYCLE_SMALL_MAX) {
+        return size <= RECYCLE_SMALL_STEP ? 0 : (size - 1) / RECYCLE_SMALL_STEP;
+    }
+    unsigned int k = floor_log2(size - 1);
+    size_t step = (size_t)1 << (k - 2);
+    size_t quarter = (size - ((size_t)1 << k) + step - 1) / step;
+    return RECYCLE_SMALL_CLASSES + (size_t)(k - 7) * 4 + (quarter - 1);
+}
+
+static size_t class_size(size_t index) {
+    if (index < RECYCLE_SMALL_CLASSES) {
+        return (index + 1) * RECYCLE_SMALL_STEP;
+    }
+    unsigned int k = 7 + (unsigned int)((index - RECYCLE_SMALL_CLASSES) / 4);
+    size_t quarter = (index - RECYCLE_SMALL_CLASSES) % 4 + 1;
+    return ((size_t)1 << k) + quarter * ((size_t)1 << (k - 2));
+}
+
+/* File a buffer of @p size bytes (a multiple of 8) under the largest class it fills */
+static void push_block(myrtx_hash_recycler_t* recycler, void* ptr, size_t size) {
+    size_t index = class_index(size);
+    if (class_size(index) > size) {
+        index--;
+    }
+    
+    recycled_block_t* block = ptr;
+    if (index >= RECYCLE_SMALL_CLASSES) {
+        block->size = size;
+    }
+    block->next = recycler->lists[index];
+    recycler->lists[index] = block;
+    recycler->nonempty[index / 64] |= (uint64_t)1 << (index % 64);
+}
+
+static void* pop_block(myrtx_hash_recycler_t* recycler, size_t index) {
+    recycled_block_t* block = recycler->lists[index];
+    recycler->lists[index] = block->next;
+    if (!block->next) {
+        recycler->nonempty[index / 64] &= ~((uint64_t)1 << (index % 64));
+    }
+    return block;
+}
+
+/* First class at or above @p index with a free buffer, or RECYCLE_CLASSES */
+static size_t find_nonempty(const myrtx_hash_recycler_t* recycler, size_t index) {
+    size_t word = index / 64;
+    uint64_t bits = recycler->nonempty[word] & (~(uint64_t)0 << (index % 64));
+    for (;;) {
+        if (bits) {
+#if defined(__GNUC__)
+            return word * 64 + (size_t)__builtin_ctzll(bits);
+#else
+            size_t bit = 0;
+            while (!(bits & 1)) {
+                bits >>= 1;
+                bit++;
+            }
+            return word * 64 + bit;
+#endif
+        }
+        if (++word == RECYCLE_MASK_WORDS) {
+            return RECYCLE_CLASSES;
+        }
+        bits = recycler->nonempty[word];
+    }
+}
+
+/* Bytes actually reserved for a request of @p size */
+size_t hash_recycle_class_size(size_t size) {
+    return size > RECYCLE_MAX_SIZE ? size : class_size(class_index(size));
+}
+
+bool hash_recycler_prepare(myrtx_hash_table_t* table) {
+    if (!table->recycler) {
+        table->recycler = myrtx_arena_calloc(table->arena, sizeof(myrtx_hash_recycler_t));
+    }
+    return table->recycler != NULL;
+}
+
+void* hash_recycle_alloc(myrtx_hash_table_t* table, size_t size) {
+    if (size > RECYCLE_MAX_SIZE) {
+        return myrtx_arena_alloc(table->arena, size);
+    }
+
+    size_t index = class_index(size);
+    size_t rounded = class_size(index);
+    myrtx_hash_recycler_t* recycler = table->recycler;
+    if (recycler) {
+        size_t found = find_nonempty(recycler, index);
+        if (found < RECYCLE_CLASSES) {
+            recycled_block_t* block = pop_block(recycler, found);
+            size_t block_size = found < RECYCLE_SMALL_CLASSES ? class_size(found) : block->size;
+
+            /* Keep the tail of a larger buffer */
+            if (block_size > rounded) {
+                push_block(recycler, (unsigned char*)block + rounded, block_size - rounded);
+            }
+            return block;
+        }
+    }
+
+    /* Whole class sizes, so that the buffer can serve any request of its class later */
+    return myrtx_arena_alloc(table->arena, rounded);
+}
+
+void hash_recycle_free(myrtx_hash_table_t* table, void* ptr, size_t size) {
+    if (size > RECYCLE_MAX_SIZE || !hash_recycler_prepare(table)) {
+        /* Left to the arena, as before recycling */
+        return;
+    }
+    push_block(table->recycler, ptr, hash_recycle_class_size(size));
+}
@@ -0,0 +1,226 @@
+/**
+ * @file hash_table_robin_hood.c
+ * @brief Robin Hood backend: linear probing ordered by home slot, no tombstones
+ *
+ * Entries in a run are kept sorted by their home slot, so an entry is never
+ * further from home than any entry after it. A lookup can stop as soon as
+ * it meets an entry that is closer to home than the probe distance so far.
+ * Removal shifts the rest of the run back by one slot instead of leaving a
+ * tombstone, so churn never grows the table.
+ */
+
+#include "hash_table_internal.h"
+#include "myrtx/context/trace.h"
+
+/* Grow at 7/8 load; without tombstones only live entries count */
+#define ROBIN_HOOD_MAX_LOAD_NUM 7
+#define ROBIN_HOOD_MAX_LOAD_DEN 8
+
+/* Distance of the entry in slot @p index from its home slot */
+static inline size_t probe_distance(const myrtx_hash_table_t* table, size_t index) {
+    return (index - (table->entries[index].hash & (table->capacity - 1))) & (table->capacity - 1);
+}
+
+/* Slot where an entry with @p hash belongs: the first empty slot, or the
+ * first entry that is closer to its home than the new entry would be */
+static size_t find_insert_position(const myrtx_hash_table_t* table, uint64_t hash) {
+    size_t mask = table->capacity - 1;
+    size_t index = hash & mask;
+
+    for (size_t distance = 0;; distance++, index = (index + 1) & mask) {
+        if (hash_slot_state(table, &table->entries[index]) != MYRTX_HASH_ENTRY_OCCUPIED ||
+            probe_distance(table, index) < distance) {
+            return index;
+        }
+    }
+}
+
+/* Open slot @p index by shifting the run starting there forward by one */
+static void shift_forward(myrtx_hash_table_t* table, size_t index) {
+    size_t mask = table->capacity - 1;
+
+    size_t end = index;
+    while (hash_slot_state(table, &table->entries[end]) == MYRTX_HASH_ENTRY_OCCUPIED) {
+        end = (end + 1) & mask;
+    }
+    while (end != index) {
+        size_t prev = (end - 1) & mask;
+        table->entries[end] = table->entries[prev];
+        end = prev;
+    }
+}
+
+static bool robin_hood_init(myrtx_hash_table_t* table, size_t capacity) {
+    myrtx_hash_entry_t* entries = hash_table_alloc_entries(table, capacity);
+    if (!entries) {
+        return false;
+    }
+
+    table->entries = entries;
+    table->capacity = capacity;
+    table->tombstones = 0;
+    return true;
+}
+
+static bool robin_hood_resize(myrtx_hash_table_t* table, size_t new_capacity) {
+    myrtx_hash_entry_t* old_entries = table->entries;
+    size_t old_capacity = table->capacity;
+
+    if (!robin_hood_init(table, new_capacity)) {
+        return false;
+    }
+
+    MYRTX_TRACE_EMIT(MYRTX_TRACE_HASH_RESIZE, old_capacity, new_capacity);
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (hash_slot_state(table, &old_entries[i]) == MYRTX_HASH_ENTRY_OCCUPIED) {
+            size_t index = find_insert_position(table, old_entries[i].hash);
+            shift_forward(table, index);
+            table->entries[index] = old_entries[i];
+        }
+    }
+
+    hash_table_release(table, old_entries, sizeof(myrtx_hash_entry_t) * old_capacity);
+    return true;
+}
+
+static void robin_hood_release(myrtx_hash_table_t* table) {
+    hash_table_release(table, table->entries, sizeof(myrtx_hash_entry_t) * table->capacity);
+}
+
+static myrtx_hash_entry_t* robin_hood_find(const myrtx_hash_table_t* table, const void* key,
+                                           size_t key_size, uint64_t hash, size_t* hint) {
+    size_t mask = table->capacity - 1;
+    size_t index = hash & mask;
+
+    bool tagged = (table->flags & MYRTX_HASH_TABLE_GENERATIONS) != 0;
+    unsigned int generation = table->generation;
+
+    *hint = SIZE_MAX;
+
+    for (size_t distance = 0; distance <= mask; distance++, index = (index + 1) & mask) {
+        myrtx_hash_entry_t* entry = &table->entries[index];
+        if (hash_slot_state_in(entry, tagged, generation) != MYRTX_HASH_ENTRY_OCCUPIED ||
+            probe_distance(table, index) < distance) {
+            /* The key would have been placed here */
+            *hint = index;
+            return NULL;
+        }
+        if (entry->hash == hash && table->compare_func(hash_entry_key(entry), entry->key_size, key, key_size)) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static void robin_hood_prefetch(const myrtx_hash_table_t* table, uint64_t hash) {
+    MYRTX_HASH_PREFETCH(&table->entries[hash & (table->capacity - 1)]);
+}
+
+static size_t robin_hood_grow_capacity(const myrtx_hash_table_t* table) {
+    if ((table->size + 1) * ROBIN_HOOD_MAX_LOAD_DEN > table->capacity * ROBIN_HOOD_MAX_LOAD_NUM) {
+        return table->capacity * 2;
+    }
+    return 0;
+}
+
+static myrtx_hash_entry_t* robin_hood_insert(myrtx_hash_table_t* table, uint64_t hash,
+                                             size_t hint) {
+    size_t new_capacity = robin_hood_grow_capacity(table);
+    if (new_capacity) {
+        if (!robin_hood_resize(table, new_capacity)) {
+            return NULL;
+        }
+        hint = SIZE_MAX;
+    }
+
+    size_t index = hint < table->capacity ? hint : find_insert_position(table, hash);
+    shift_forward(table, index);
+    return &table->entries[index];
+}
+
+static void robin_hood_erase(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry) {
+    size_t mask = table->capacity - 1;
+    size_t index = (size_t)(entry - table->entries);
+
+    /* Backward shift: pull following entries one slot closer to home until
+     * the run ends or an entry already sits in its home slot */
+    for (;;) {
+        size_t next = (index + 1) & mask;
+        if (hash_slot_state(table, &table->entries[next]) != MYRTX_HASH_ENTRY_OCCUPIED ||
+            probe_distance(table, next) == 0) {
+            break;
+        }
+        table->entries[index] = table->entries[next];
+        index = next;
+    }
+
+    hash_slot_set_state(table, &table->entries[index], MYRTX_HASH_ENTRY_EMPTY);
+}
+
+static void robin_hood_reset(myrtx_hash_table_t* table) {
+    /* Slots of a generation-tagged table are stale after the clear already */
+    if (!(table->flags & MYRTX_HASH_TABLE_GENERATIONS)) {
+        for (size_t i = 0; i < table->capacity; i++) {
+            table->entries[i].status = MYRTX_HASH_ENTRY_EMPTY;
+        }
+    }
+}
+
+static size_t robin_hood_probe_length(const myrtx_hash_table_t* table,
+                                      const myrtx_hash_entry_t* entry) {
+    return probe_distance(table, (size_t)(entry - table->entries)) + 1;
+}
+
+static size_t robin_hood_array_bytes(const myrtx_hash_table_t* table) {
+    return sizeof(myrtx_hash_entry_t) * table->capacity;
+}
+
+static myrtx_hash_entry_t* robin_hood_claim(myrtx_hash_table_t* table, const void* key,
+                                            size_t key_size, uint64_t hash, size_t lo, size_t hi,
+                                            bool* found) {
+    (void)lo;
+    size_t index = hash & (table->capacity - 1);
+
+    for (size_t distance = 0; index < hi; distance++, index++) {
+        myrtx_hash_entry_t* entry = &table->entries[index];
+        if (hash_slot_state(table, entry) != MYRTX_HASH_ENTRY_OCCUPIED ||
+            probe_distance(table, index) < distance) {
+            /* The run shifted forward must end before hi */
+            size_t end = index;
+            while (end < hi && hash_slot_state(table, &table->entries[end]) ==
+                                   MYRTX_HASH_ENTRY_OCCUPIED) {
+                end++;
+            }
+            if (end == hi) {
+                return NULL;
+            }
+            shift_forward(table, index);
+            *found = false;
+            return entry;
+        }
+        if (entry->hash == hash &&
+            table->compare_func(hash_entry_key(entry), entry->key_size, key, key_size)) {
+            *found = true;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+const myrtx_hash_backend_t myrtx_hash_backend_robin_hood = {
+    robin_hood_init,
+    robin_hood_release,
+    robin_hood_find,
+    robin_hood_prefetch,
+    robin_hood_grow_capacity,
+    robin_hood_insert,
+    robin_hood_erase,
+    robin_hood_reset,
+    robin_hood_probe_length,
+    robin_hood_array_bytes,
+    robin_hood_claim,
+    NULL, /* Entries move to their home slots in the new arrays */
+    NULL
+};
@@ -0,0 +1,412 @@
+/**
+ * @file hash_table_swiss.c
+ * @brief Swiss table backend: control bytes matched a group at a time
+ *
+ * Each slot has a control byte next to the entry array: EMPTY, DELETED, or
+ * the top 7 bits of the entry's hash (H2). A probe loads a group of control
+ * bytes, compares all of them with H2 at once and only touches entries whose
+ * control byte matches. The first group_width control bytes are mirrored
+ * after the end of the array so that a group load never wraps.
+ */
+
+#include "hash_table_internal.h"
+#include "myrtx/context/trace.h"
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SWISS_SSE2 1
+#define SWISS_GROUP_WIDTH 16
+#define SWISS_SLOT_SHIFT 0   /* One mask bit per slot */
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define SWISS_NEON 1
+#define SWISS_GROUP_WIDTH 16
+#define SWISS_SLOT_SHIFT 2   /* One mask nibble per slot */
+#else
+#define SWISS_GROUP_WIDTH 8
+#define SWISS_SLOT_SHIFT 3   /* One mask byte per slot */
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#define SWISS_EMPTY   ((uint8_t)0x80)
+#define SWISS_DELETED ((uint8_t)0xFE)
+
+/* Top 7 bits of the hash, stored in the control byte of a full slot */
+#define SWISS_H2(hash) ((uint8_t)((hash) >> 57))
+
+/* Index of the lowest set bit (x != 0) */
+static inline unsigned swiss_ctz(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (unsigned)index;
+#else
+    unsigned n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/* Slot offset within the group of the lowest match in @p mask */
+#define SWISS_MASK_SLOT(mask) (swiss_ctz(mask) >> SWISS_SLOT_SHIFT)
+
+/* Group operations: each returns a mask with one set bit per matching slot */
+
+#if defined(SWISS_SSE2)
+
+typedef __m128i swiss_group_t;
+
+static inline swiss_group_t group_load(const uint8_t* ctrl) {
+    return _mm_loadu_si128((const __m128i*)ctrl);
+}
+
+static inline uint64_t group_match(swiss_group_t group, uint8_t h2) {
+    return (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)h2)));
+}
+
+static inline uint64_t group_match_empty(swiss_group_t group) {
+    return (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)SWISS_EMPTY)));
+}
+
+static inline uint64_t group_match_empty_or_deleted(swiss_group_t group) {
+    /* Both special values have the sign bit set, full slots do not */
+    return (uint64_t)_mm_movemask_epi8(group);
+}
+
+#elif defined(SWISS_NEON)
+
+typedef uint8x16_t swiss_group_t;
+
+/* Narrow a byte-wise comparison to one bit per 4-bit nibble */
+static inline uint64_t neon_mask(uint8x16_t cmp) {
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ull;
+}
+
+static inline swiss_group_t group_load(const uint8_t* ctrl) {
+    return vld1q_u8(ctrl);
+}
+
+static inline uint64_t group_match(swiss_group_t group, uint8_t h2) {
+    return neon_mask(vceqq_u8(group, vdupq_n_u8(h2)));
+}
+
+static inline uint64_t group_match_empty(swiss_group_t group) {
+    return neon_mask(vceqq_u8(group, vdupq_n_u8(SWISS_EMPTY)));
+}
+
+static inline uint64_t group_match_empty_or_deleted(swiss_group_t group) {
+    return neon_mask(vcltq_s8(vreinterpretq_s8_u8(group), vdupq_n_s8(0)));
+}
+
+#else
+
+/* Portable SWAR: eight control bytes in a little-endian 64-bit word */
+typedef uint64_t swiss_group_t;
+
+#define SWAR_LSB 0x0101010101010101ull
+#define SWAR_MSB 0x8080808080808080ull
+
+static inline swiss_group_t group_load(const uint8_t* ctrl) {
+    uint64_t word = 0;
+    for (int i = 7; i >= 0; i--) {
+        word = (word << 8) | ctrl[i];
+    }
+    return word;
+}
+
+static inline uint64_t group_match(swiss_group_t group, uint8_t h2) {
+    /* Zero-byte test; may report a false match next to a real one, which the
+     * hash comparison in the caller filters out */
+    uint64_t x = group ^ (SWAR_LSB * h2);
+    return (x - SWAR_LSB) & ~x & SWAR_MSB;
+}
+
+static inline uint64_t group_match_empty(swiss_group_t group) {
+    /* EMPTY is the only value with bit 7 set and bit 6 clear */
+    return group & ~(group << 1) & SWAR_MSB;
+}
+
+static inline uint64_t group_match_empty_or_deleted(swiss_group_t group) {
+    return group & SWAR_MSB;
+}
+
+#endif
+
+/* Set a control byte and its mirror behind the end of the array */
+static inline void set_ctrl(myrtx_hash_table_t* table, size_t index, uint8_t value) {
+    size_t mask = table->capacity - 1;
+    table->ctrl[index] = value;
+    table->ctrl[((index - SWISS_GROUP_WIDTH) & mask) + SWISS_GROUP_WIDTH] = value;
+}
+
+/* First empty or deleted slot on the probe sequence of @p hash */
+static size_t find_first_non_full(const myrtx_hash_table_t* table, uint64_t hash) {
+    size_t mask = table->capacity - 1;
+    size_t pos = hash & mask;
+    size_t stride = 0;
+
+    for (;;) {
+        uint64_t free_slots = group_match_empty_or_deleted(group_load(table->ctrl + pos));
+        if (free_slots) {
+            return (pos + SWISS_MASK_SLOT(free_slots)) & mask;
+        }
+        stride += SWISS_GROUP_WIDTH;
+        pos = (pos + stride) & mask;
+    }
+}
+
+/* Allocate empty entry and control arrays */
+static bool swiss_alloc(myrtx_hash_table_t* table, size_t capacity,
+                        myrtx_hash_entry_t** entries_out, uint8_t** ctrl_out) {
+    myrtx_hash_entry_t* entries = hash_table_alloc_entries(table, capacity);
+    uint8_t* ctrl = hash_table_malloc(table, capacity + SWISS_GROUP_WIDTH);
+    if (!entries || !ctrl) {
+        hash_table_release(table, entries, sizeof(myrtx_hash_entry_t) * capacity);
+        hash_table_release(table, ctrl, capacity + SWISS_GROUP_WIDTH);
+        return false;
+    }
+
+    memset(ctrl, SWISS_EMPTY, capacity + SWISS_GROUP_WIDTH);
+
+    *entries_out = entries;
+    *ctrl_out = ctrl;
+    return true;
+}
+
+/* Move all entries into fresh arrays of @p new_capacity slots */
+static bool swiss_rehash(myrtx_hash_table_t* table, size_t new_capacity) {
+    myrtx_hash_entry_t* new_entries;
+    uint8_t* new_ctrl;
+    if (!swiss_alloc(table, new_capacity, &new_entries, &new_ctrl)) {
+        return false;
+    }
+
+    myrtx_hash_entry_t* old_entries = table->entries;
+    uint8_t* old_ctrl = table->ctrl;
+    size_t old_capacity = table->capacity;
+
+    MYRTX_TRACE_EMIT(MYRTX_TRACE_HASH_RESIZE, old_capacity, new_capacity);
+
+    table->entries = new_entries;
+    table->ctrl = new_ctrl;
+    table->capacity = new_capacity;
+    table->tombstones = 0;
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (hash_slot_state(table, &old_entries[i]) == MYRTX_HASH_ENTRY_OCCUPIED) {
+            size_t index = find_first_non_full(table, old_entries[i].hash);
+            set_ctrl(table, index, SWISS_H2(old_entries[i].hash));
+            table->entries[index] = old_entries[i];
+        }
+    }
+
+    hash_table_release(table, old_entries, sizeof(myrtx_hash_entry_t) * old_capacity);
+    hash_table_release(table, old_ctrl, old_capacity + SWISS_GROUP_WIDTH);
+    return true;
+}
+
+static bool swiss_init(myrtx_hash_table_t* table, size_t capacity) {
+    if (capacity < SWISS_GROUP_WIDTH) {
+        capacity = SWISS_GROUP_WIDTH;
+    }
+    if (!swiss_alloc(table, capacity, &table->entries, &table->ctrl)) {
+        return false;
+    }
+    table->capacity = capacity;
+    table->tombstones = 0;
+    return true;
+}
+
+static void swiss_release(myrtx_hash_table_t* table) {
+    hash_table_release(table, table->entries, sizeof(myrtx_hash_entry_t) * table->capacity);
+    hash_table_release(table, table->ctrl, table->capacity + SWISS_GROUP_WIDTH);
+}
+
+static myrtx_hash_entry_t* swiss_find(const myrtx_hash_table_t* table, const void* key,
+                                      size_t key_size, uint64_t hash, size_t* hint) {
+    size_t mask = table->capacity - 1;
+    size_t pos = hash & mask;
+    uint8_t h2 = SWISS_H2(hash);
+
+    *hint = SIZE_MAX;
+
+    /* Every group is visited once the stride has covered the array */
+    for (size_t stride = 0; stride <= table->capacity; ) {
+        swiss_group_t group = group_load(table->ctrl + pos);
+
+        for (uint64_t match = group_match(group, h2); match; match &= match - 1) {
+            myrtx_hash_entry_t* entry = &table->entries[(pos + SWISS_MASK_SLOT(match)) & mask];
+            if (entry->hash == hash &&
+                table->compare_func(hash_entry_key(entry), entry->key_size, key, key_size)) {
+                return entry;
+            }
+        }
+
+        if (group_match_empty(group)) {
+            return NULL;
+        }
+
+        stride += SWISS_GROUP_WIDTH;
+        pos = (pos + stride) & mask;
+    }
+
+    return NULL;
+}
+
+/* The first group of control bytes and the entry a match there would hit */
+static void swiss_prefetch(const myrtx_hash_table_t* table, uint64_t hash) {
+    size_t pos = hash & (table->capacity - 1);
+    MYRTX_HASH_PREFETCH(table->ctrl + pos);
+    MYRTX_HASH_PREFETCH(&table->entries[pos]);
+}
+
+static size_t swiss_grow_capacity(const myrtx_hash_table_t* table) {
+    /* Keep at least 1/8 of the slots empty so that every probe terminates */
+    size_t limit = table->capacity - table->capacity / 8;
+    if (table->size + table->tombstones + 1 <= limit) {
+        return 0;
+    }
+    /* Mostly tombstones: rebuild at the same size instead of doubling */
+    return (table->size + 1) * 2 <= limit ? table->capacity : table->capacity * 2;
+}
+
+static myrtx_hash_entry_t* swiss_insert(myrtx_hash_table_t* table, uint64_t hash, size_t hint) {
+    (void)hint;
+
+    size_t new_capacity = swiss_grow_capacity(table);
+    if (new_capacity && !swiss_rehash(table, new_capacity)) {
+        return NULL;
+    }
+
+    size_t index = find_first_non_full(table, hash);
+    if (table->ctrl[index] == SWISS_DELETED) {
+        table->tombstones--;
+    }
+    set_ctrl(table, index, SWISS_H2(hash));
+    return &table->entries[index];
+}
+
+static void swiss_erase(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry) {
+    size_t mask = table->capacity - 1;
+    size_t index = (size_t)(entry - table->entries);
+
+    /* If no group-sized window around the slot was ever completely full, no
+     * probe sequence can have passed over it, and the slot can become EMPTY
+     * instead of leaving a tombstone */
+    size_t full_before = 0;
+    while (full_before < SWISS_GROUP_WIDTH &&
+           table->ctrl[(index - full_before - 1) & mask] != SWISS_EMPTY) {
+        full_before++;
+    }
+    size_t full_after = 0;
+    while (full_after < SWISS_GROUP_WIDTH &&
+           table->ctrl[(index + full_after + 1) & mask] != SWISS_EMPTY) {
+        full_after++;
+    }
+
+    hash_slot_set_state(table, entry, MYRTX_HASH_ENTRY_DELETED);
+    if (full_before + full_after + 1 < SWISS_GROUP_WIDTH) {
+        hash_slot_set_state(table, entry, MYRTX_HASH_ENTRY_EMPTY);
+        set_ctrl(table, index, SWISS_EMPTY);
+    } else {
+        set_ctrl(table, index, SWISS_DELETED);
+        table->tombstones++;
+    }
+}
+
+static void swiss_reset(myrtx_hash_table_t* table) {
+    /* Slots of a generation-tagged table are stale after the clear
+     * already; only the control bytes (one per slot) need resetting */
+    if (!(table->flags & MYRTX_HASH_TABLE_GENERATIONS)) {
+        for (size_t i = 0; i < table->capacity; i++) {
+            table->entries[i].status = MYRTX_HASH_ENTRY_EMPTY;
+        }
+    }
+    memset(table->ctrl, SWISS_EMPTY, table->capacity + SWISS_GROUP_WIDTH);
+    table->tombstones = 0;
+}
+
+/* Groups on the probe sequence up to the one that holds the entry */
+static size_t swiss_probe_length(const myrtx_hash_table_t* table,
+                                 const myrtx_hash_entry_t* entry) {
+    size_t mask = table->capacity - 1;
+    size_t index = (size_t)(entry - table->entries);
+    size_t pos = entry->hash & mask;
+    size_t groups = 1;
+
+    for (size_t stride = 0; stride <= table->capacity; groups++) {
+        if (((index - pos) & mask) < SWISS_GROUP_WIDTH) {
+            return groups;
+        }
+        stride += SWISS_GROUP_WIDTH;
+        pos = (pos + stride) & mask;
+    }
+    return groups;
+}
+
+static size_t swiss_array_bytes(const myrtx_hash_table_t* table) {
+    return sizeof(myrtx_hash_entry_t) * table->capacity + table->capacity + SWISS_GROUP_WIDTH;
+}
+
+static myrtx_hash_entry_t* swiss_claim(myrtx_hash_table_t* table, const void* key,
+                                       size_t key_size, uint64_t hash, size_t lo, size_t hi,
+                                       bool* found) {
+    size_t mask = table->capacity - 1;
+    size_t pos = hash & mask;
+    uint8_t h2 = SWISS_H2(hash);
+
+    /* Only groups that lie wholly in the range are loaded. The mirrored
+     * control bytes past the end are written but never read here. */
+    for (size_t stride = 0; pos >= lo && pos + SWISS_GROUP_WIDTH <= hi; ) {
+        swiss_group_t group = group_load(table->ctrl + pos);
+
+        for (uint64_t match = group_match(group, h2); match; match &= match - 1) {
+            myrtx_hash_entry_t* entry = &table->entries[pos + SWISS_MASK_SLOT(match)];
+            if (entry->hash == hash &&
+                table->compare_func(hash_entry_key(entry), entry->key_size, key, key_size)) {
+                *found = true;
+                return entry;
+            }
+        }
+
+        /* A build leaves no tombstones: the first empty slot is the one
+         * find_first_non_full() would pick */
+        uint64_t empty = group_match_empty(group);
+        if (empty) {
+            size_t index = pos + SWISS_MASK_SLOT(empty);
+            set_ctrl(table, index, h2);
+            *found = false;
+            return &table->entries[index];
+        }
+
+        stride += SWISS_GROUP_WIDTH;
+        pos = (pos + stride) & mask;
+    }
+    return NULL;
+}
+
+const myrtx_hash_backend_t myrtx_hash_backend_swiss = {
+    swiss_init,
+    swiss_release,
+    swiss_find,
+    swiss_prefetch,
+    swiss_grow_capacity,
+    swiss_insert,
+    swiss_erase,
+    swiss_reset,
+    swiss_probe_length,
+    swiss_array_bytes,
+    swiss_claim,
+    NULL, /* Entries move to their home slots in the new arrays */
+    NULL
+};
@@ -0,0 +1,302 @@
+/**
+ * @file hash_table_ttl.c
+ * @brief Entry expiry with a hierarchical timing wheel
+ *
+ * The wheel has HASH_WHEEL_LEVELS levels of 64 slots. Level l covers ticks
+ * in units of 64^l, so eight levels span the full 48-bit expiry range. A
+ * timer sits in the level that matches its distance from the wheel's
+ * position, in the slot of its expiry at that level's resolution. When the
+ * position reaches a multiple of 64^l, the matching level-l slot is
+ * cascaded: its timers move down to finer levels. A timer thus moves at
+ * most HASH_WHEEL_LEVELS - 1 times before it fires from level 0, which
+ * makes expiry O(1) amortized per key. Per-level occupancy bitmaps let the
+ * position jump straight to the next slot that holds timers.
+ *
+ * Entries move between slots (growth, Robin Hood shifts), so timers do not
+ * point at them. A timer holds a copy of the key and looks the entry up
+ * when it fires; the entry's own expiry decides what happens. If it was
+ * pushed back, the timer is re-armed instead of the entry being removed, so
+ * refreshing a key's expiry costs no timer as long as the new time is not
+ * earlier than the old one.
+ */
+
+#include "hash_table_internal.h"
+#include <string.h>
+
+#define HASH_WHEEL_BITS 6
+#define HASH_WHEEL_SLOTS (1u << HASH_WHEEL_BITS)
+#define HASH_WHEEL_MASK (HASH_WHEEL_SLOTS - 1)
+#define HASH_WHEEL_LEVELS 8
+
+/* A pending expiry check for one key; the key bytes follow the struct */
+typedef struct hash_timer {
+    struct hash_timer* next;
+    uint64_t expires_at;
+    uint64_t hash;
+    size_t key_size;
+} hash_timer_t;
+
+struct myrtx_hash_wheel {
+    hash_timer_t* slots[HASH_WHEEL_LEVELS][HASH_WHEEL_SLOTS];
+    uint64_t occupied[HASH_WHEEL_LEVELS]; /* Bit s: slots[l][s] is not empty */
+    uint64_t now;                         /* Position; never ahead of the table's clock */
+    hash_timer_t* moving;                 /* Timers of a cascade interrupted by the budget */
+    unsigned int cascade_level;           /* Next level to cascade at now (0 = none) */
+};
+
+static inline void* timer_key(hash_timer_t* timer) {
+    return timer + 1;
+}
+
+static inline void timer_release(myrtx_hash_table_t* table, hash_timer_t* timer) {
+    hash_table_release(table, timer, sizeof(hash_timer_t) + timer->key_size);
+}
+
+/* Index of the lowest set bit (bits != 0) */
+static inline unsigned int lowest_bit(uint64_t bits) {
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_ctzll(bits);
+#else
+    unsigned int index = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/* Links a timer into the slot that matches its distance from the position */
+static void wheel_insert(myrtx_hash_wheel_t* wheel, hash_timer_t* timer) {
+    /* Timers that are already due go to the slot drained next */
+    uint64_t at = timer->expires_at > wheel->now ? timer->expires_at : wheel->now;
+    uint64_t distance = at - wheel->now;
+
+    unsigned int level = 0;
+    while (distance >= HASH_WHEEL_SLOTS && level < HASH_WHEEL_LEVELS - 1) {
+        distance >>= HASH_WHEEL_BITS;
+        level++;
+    }
+
+    unsigned int slot = (unsigned int)(at >> (level * HASH_WHEEL_BITS)) & HASH_WHEEL_MASK;
+    timer->next = wheel->slots[level][slot];
+    wheel->slots[level][slot] = timer;
+    wheel->occupied[level] |= UINT64_C(1) << slot;
+}
+
+/* Unlinks all timers of a slot */
+static hash_timer_t* wheel_detach(myrtx_hash_wheel_t* wheel, unsigned int level, unsigned int slot) {
+    hash_timer_t* list = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+    wheel->occupied[level] &= ~(UINT64_C(1) << slot);
+    return list;
+}
+
+/* Earliest position after now at which a slot needs attention: a level-0
+ * slot fires, a higher one cascades. UINT64_MAX if the wheel is empty. */
+static uint64_t wheel_next_event(const myrtx_hash_wheel_t* wheel) {
+    uint64_t next = UINT64_MAX;
+
+    for (unsigned int level = 0; level < HASH_WHEEL_LEVELS; level++) {
+        uint64_t bits = wheel->occupied[level];
+        if (bits == 0) {
+            continue;
+        }
+
+        unsigned int shift = level * HASH_WHEEL_BITS;
+        uint64_t block = wheel->now >> shift;
+        unsigned int current = (unsigned int)block & HASH_WHEEL_MASK;
+
+        /* Rotate the current slot to bit 0. A timer there belongs to the
+         * next turn of this level: level 0 has just been drained, and a
+         * higher level has been cascaded when the position entered it. */
+        uint64_t rotated = current ? (bits >> current) | (bits << (HASH_WHEEL_SLOTS - current))
+                                   : bits;
+        rotated &= ~UINT64_C(1);
+        uint64_t ahead = rotated ? lowest_bit(rotated) : HASH_WHEEL_SLOTS;
+
+        uint64_t at = (block + ahead) << shift;
+        if (at < next) {
+            next = at;
+        }
+    }
+    return next;
+}
+
+/* Handles a due timer. Returns true if it removed an entry. */
+static bool fire_timer(myrtx_hash_table_t* table, hash_timer_t* timer) {
+    myrtx_hash_entry_t* entry = hash_table_find_entry(table, timer_key(timer), timer->key_size,
+                                                      timer->hash);
+    uint64_t expiry = entry ? hash_entry_expiry(entry) : 0;
+
+    if (entry && expiry != 0 && expiry > table->now) {
+        /* Pushed back since the timer was armed */
+        timer->expires_at = expiry;
+        wheel_insert(table->wheel, timer);
+        return false;
+    }
+
+    if (entry && expiry == 0) {
+        /* The expiry was cleared; the next one needs a new timer */
+        entry->storage &= (uint8_t)~MYRTX_HASH_STORAGE_TIMER;
+    }
+    timer_release(table, timer);
+
+    if (entry && expiry != 0) {
+        hash_table_erase_entry(table, entry);
+        return true;
+    }
+    return false;
+}
+
+/* Moves the timers of the slots cascading at the position down to finer
+ * levels. Returns false if the budget ran out first. */
+static bool wheel_cascade(myrtx_hash_wheel_t* wheel, size_t* budget) {
+    for (;;) {
+        while (wheel->moving) {
+            if (*budget == 0) {
+                return false;
+            }
+            (*budget)--;
+
+            hash_timer_t* timer = wheel->moving;
+            wheel->moving = timer->next;
+            wheel_insert(wheel, timer);
+        }
+
+        /* Coarser levels first: their timers may land in a finer slot that
+         * cascades at the same position */
+        if (wheel->cascade_level == 0) {
+            return true;
+        }
+        unsigned int level = wheel->cascade_level--;
+        unsigned int slot = (unsigned int)(wheel->now >> (level * HASH_WHEEL_BITS)) & HASH_WHEEL_MASK;
+        wheel->moving = wheel_detach(wheel, level, slot);
+    }
+}
+
+/* Fires the level-0 slot of the position. Returns false if the budget ran out first. */
+static bool wheel_drain(myrtx_hash_table_t* table, size_t* budget, size_t* removed) {
+    myrtx_hash_wheel_t* wheel = table->wheel;
+    unsigned int slot = (unsigned int)wheel->now & HASH_WHEEL_MASK;
+
+    while (wheel->slots[0][slot]) {
+        if (*budget == 0) {
+            return false;
+        }
+        (*budget)--;
+
+        hash_timer_t* timer = wheel->slots[0][slot];
+        wheel->slots[0][slot] = timer->next;
+        if (!wheel->slots[0][slot]) {
+            wheel->occupied[0] &= ~(UINT64_C(1) << slot);
+        }
+
+        /* Re-armed timers never go back into this slot, so the loop ends */
+        if (fire_timer(table, timer)) {
+            (*removed)++;
+        }
+    }
+    return true;
+}
+
+bool hash_wheel_schedule(myrtx_hash_table_t* table, myrtx_hash_entry_t* entry,
+                         uint64_t expires_at) {
+    /* A pending timer fires no later than the current expiry, and one that
+     * fires early is re-armed, so only an earlier expiry needs a new one */
+    uint64_t current = hash_entry_expiry(entry);
+    bool arm = expires_at != 0 && (!(entry->storage & MYRTX_HASH_STORAGE_TIMER) ||
+                                   current == 0 || expires_at < current);
+
+    if (arm) {
+        if (!table->wheel) {
+            table->wheel = hash_table_malloc(table, sizeof(myrtx_hash_wheel_t));
+            if (!table->wheel) {
+                return false;
+            }
+            memset(table->wheel, 0, sizeof(myrtx_hash_wheel_t));
+            table->wheel->now = table->now;
+        }
+
+        hash_timer_t* timer = hash_table_malloc(table, sizeof(hash_timer_t) + entry->key_size);
+        if (!timer) {
+            return false;
+        }
+        timer->expires_at = expires_at;
+        timer->hash = entry->hash;
+        timer->key_size = entry->key_size;
+        memcpy(timer_key(timer), hash_entry_key(entry), entry->key_size);
+        wheel_insert(table->wheel, timer);
+        entry->storage |= MYRTX_HASH_STORAGE_TIMER;
+    }
+
+    hash_entry_set_expiry(entry, expires_at);
+    return true;
+}
+
+/* Frees a list of timers */
+static void release_timers(myrtx_hash_table_t* table, hash_timer_t* timer) {
+    while (timer) {
+        hash_timer_t* next = timer->next;
+        timer_release(table, timer);
+        timer = next;
+    }
+}
+
+void hash_wheel_free(myrtx_hash_table_t* table) {
+    myrtx_hash_wheel_t* wheel = table->wheel;
+    if (!wheel) {
+        return;
+    }
+
+    for (unsigned int level = 0; level < HASH_WHEEL_LEVELS; level++) {
+        for (unsigned int slot = 0; slot < HASH_WHEEL_SLOTS; slot++) {
+            release_timers(table, wheel->slots[level][slot]);
+        }
+    }
+    release_timers(table, wheel->moving);
+    hash_table_release(table, wheel, sizeof(myrtx_hash_wheel_t));
+    table->wheel = NULL;
+}
+
+/* Advances the clock and removes expired entries */
+size_t myrtx_hash_table_expire(myrtx_hash_table_t* table, uint64_t now, size_t budget) {
+    if (!table) {
+        return 0;
+    }
+
+    if (now > table->now) {
+        table->now = now;
+    }
+    if (!table->wheel) {
+        return 0;
+    }
+    if (budget == 0) {
+        budget = SIZE_MAX;
+    }
+
+    myrtx_hash_wheel_t* wheel = table->wheel;
+    size_t removed = 0;
+    for (;;) {
+        if (!wheel_cascade(wheel, &budget) || !wheel_drain(table, &budget, &removed)) {
+            break;
+        }
+
+        /* Skipping positions without events needs no cascades on the way */
+        uint64_t next = wheel_next_event(wheel);
+        if (next > table->now) {
+            wheel->now = table->now;
+            break;
+        }
+
+        /* Every level whose unit divides the new position cascades there */
+        wheel->now = next;
+        unsigned int level = 0;
+        while (level < HASH_WHEEL_LEVELS - 1 &&
+               (next & ((UINT64_C(1) << ((level + 1) * HASH_WHEEL_BITS)) - 1)) == 0) {
+            level++;
+        }
+        wheel->cascade_level = level;
+    }
+    return removed;
+}
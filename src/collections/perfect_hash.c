@@ -0,0 +1,480 @@
+/**
+ * @file perfect_hash.c
+ * @brief BBHash minimal perfect hash with verified keys and values
+ *
+ * Level l holds a bit array of about gamma * r bits, where r keys are still
+ * unplaced. Each such key hashes to one bit of the level; bits hit by
+ * exactly one key stay set, and the keys of bits hit more than once move on
+ * to the next level. All levels live in one bit array with a rank entry per
+ * 512 bits, so a key's index is the rank of its bit. Keys left after the
+ * last level are numbered after all level bits through a fallback table.
+ *
+ * Key and value of an index are stored together in one record, padded so
+ * that the value starts 8-byte aligned, and a lookup verifies the key and
+ * returns the value from the same cache line. When all keys have the same
+ * size, records have a fixed stride and need no offset table; otherwise each
+ * record starts with its key size and is found through record_offsets.
+ */
+
+#include "myrtx/collections/perfect_hash.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define PERFECT_HASH_MAX_LEVELS 32
+#define PERFECT_HASH_DEFAULT_GAMMA 2.0
+
+/* Rank entries cover 8 words (512 bits) of the level bits */
+#define PERFECT_HASH_RANK_SHIFT 3
+#define PERFECT_HASH_RANK_COUNT(words) (((words) >> PERFECT_HASH_RANK_SHIFT) + 1)
+
+struct myrtx_perfect_hash_t {
+    myrtx_arena_t* arena;
+    myrtx_hash_function hash_func;
+    myrtx_hash64_function hash64_func;
+    myrtx_key_compare_function compare_func;
+    uint64_t seed;
+
+    size_t count;
+    unsigned int level_count;
+    size_t level_start[PERFECT_HASH_MAX_LEVELS]; /* First bit of each level */
+    size_t level_bits[PERFECT_HASH_MAX_LEVELS];  /* Bits in each level */
+    uint64_t* bits;                              /* All levels, concatenated */
+    size_t word_count;
+    uint64_t* ranks;                             /* Set bits before each 512-bit block */
+    myrtx_hash_table_t* fallback;                /* Key -> index, NULL if unused */
+    size_t fallback_base;                        /* Index of the first fallback key */
+
+    unsigned char* records;                      /* Key and value of each index */
+    size_t* record_offsets;                      /* Per index, NULL if key_size is fixed */
+    size_t key_size;                             /* Size of every key, 0 if they differ */
+    size_t record_stride;                        /* Record size for a fixed key_size */
+    size_t value_size;
+};
+
+/* The builtin is a library call unless the target has a popcount instruction */
+static inline unsigned int popcount64(uint64_t x) {
+#if defined(__POPCNT__) || defined(__ARM_NEON)
+    return (unsigned int)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (unsigned int)((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/* Allocation from the arena or with malloc */
+static void* perfect_hash_malloc(myrtx_arena_t* arena, size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    return arena ? myrtx_arena_alloc(arena, size) : malloc(size);
+}
+
+static inline uint64_t key_hash(const myrtx_perfect_hash_t* hash, const void* key,
+                                size_t key_size) {
+    if (hash->hash64_func) {
+        return hash->hash64_func(key, key_size, hash->seed);
+    }
+    return (uint64_t)hash->hash_func(key, key_size) * 0x9E3779B97F4A7C15ull;
+}
+
+/* Independent per-level hash of a key hash (murmur3 finalizer). Level 0
+ * uses the key hash itself, which is already well mixed. */
+static inline uint64_t level_hash(uint64_t hash, unsigned int level) {
+    if (level == 0) {
+        return hash;
+    }
+    uint64_t h = hash + (uint64_t)level * 0x9E3779B97F4A7C15ull;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+/* Maps a hash onto [0, bits) with a multiply where the range allows it */
+static inline size_t level_position(uint64_t h, size_t bits) {
+    if ((uint64_t)bits <= UINT32_MAX) {
+        return (size_t)(((h >> 32) * (uint64_t)bits) >> 32);
+    }
+    return (size_t)(h % (uint64_t)bits);
+}
+
+static inline bool test_bit(const uint64_t* bits, size_t position) {
+    return (bits[position >> 6] >> (position & 63)) & 1;
+}
+
+static inline void set_bit(uint64_t* bits, size_t position) {
+    bits[position >> 6] |= UINT64_C(1) << (position & 63);
+}
+
+/* Number of set bits before a position */
+static size_t rank(const myrtx_perfect_hash_t* hash, size_t position) {
+    size_t word = position >> 6;
+    size_t block = word >> PERFECT_HASH_RANK_SHIFT;
+    size_t result = (size_t)hash->ranks[block];
+    for (size_t w = block << PERFECT_HASH_RANK_SHIFT; w < word; w++) {
+        result += popcount64(hash->bits[w]);
+    }
+    uint64_t below = (UINT64_C(1) << (position & 63)) - 1;
+    return result + popcount64(hash->bits[word] & below);
+}
+
+/* Index of a key by its hash, without verifying the key */
+static bool index_of(const myrtx_perfect_hash_t* hash, const void* key, size_t key_size,
+                     uint64_t key_hash_value, size_t* index) {
+    for (unsigned int level = 0; level < hash->level_count; level++) {
+        size_t position = hash->level_start[level] +
+                          level_position(level_hash(key_hash_value, level),
+                                         hash->level_bits[level]);
+        if (test_bit(hash->bits, position)) {
+            *index = rank(hash, position);
+            return true;
+        }
+    }
+
+    void* value;
+    if (hash->fallback && myrtx_hash_table_get(hash->fallback, key, key_size, &value, NULL)) {
+        uint64_t fallback_index;
+        memcpy(&fallback_index, value, sizeof(fallback_index));
+        *index = (size_t)fallback_index;
+        return true;
+    }
+    return false;
+}
+
+/* Distributes the keys over the levels; the ones left over go to remaining */
+static bool build_levels(myrtx_perfect_hash_t* hash, const uint64_t* hashes, size_t* remaining,
+                         size_t* remaining_count, double gamma) {
+    size_t count = *remaining_count;
+    uint64_t* bits = NULL;
+    size_t word_count = 0;
+
+    for (unsigned int level = 0; level < PERFECT_HASH_MAX_LEVELS && count > 0; level++) {
+        double wanted = gamma * (double)count / 64.0 + 1.0;
+        if (wanted > (double)(SIZE_MAX / 128 - word_count)) {
+            free(bits);
+            return false;
+        }
+        size_t level_words = (size_t)wanted;
+        size_t level_bits = level_words * 64;
+
+        uint64_t* grown = realloc(bits, (word_count + level_words) * sizeof(uint64_t));
+        uint64_t* collisions = calloc(level_words, sizeof(uint64_t));
+        if (!grown || !collisions) {
+            free(grown ? grown : bits);
+            free(collisions);
+            return false;
+        }
+        bits = grown;
+        uint64_t* level_array = bits + word_count;
+        memset(level_array, 0, level_words * sizeof(uint64_t));
+
+        for (size_t i = 0; i < count; i++) {
+            size_t position = level_position(level_hash(hashes[remaining[i]], level), level_bits);
+            if (test_bit(level_array, position)) {
+                set_bit(collisions, position);
+            } else {
+                set_bit(level_array, position);
+            }
+        }
+
+        size_t next_count = 0;
+        for (size_t i = 0; i < count; i++) {
+            size_t position = level_position(level_hash(hashes[remaining[i]], level), level_bits);
+            if (test_bit(collisions, position)) {
+                remaining[next_count++] = remaining[i];
+            }
+        }
+        for (size_t w = 0; w < level_words; w++) {
+            level_array[w] &= ~collisions[w];
+        }
+        free(collisions);
+
+        hash->level_start[level] = word_count * 64;
+        hash->level_bits[level] = level_bits;
+        hash->level_count = level + 1;
+        word_count += level_words;
+        count = next_count;
+    }
+
+    /* Copy the bits and build the rank index in their final memory */
+    size_t rank_count = PERFECT_HASH_RANK_COUNT(word_count);
+    hash->bits = perfect_hash_malloc(hash->arena, word_count * sizeof(uint64_t));
+    hash->ranks = perfect_hash_malloc(hash->arena, rank_count * sizeof(uint64_t));
+    if (!hash->bits || !hash->ranks) {
+        free(bits);
+        return false;
+    }
+    if (word_count > 0) {
+        memcpy(hash->bits, bits, word_count * sizeof(uint64_t));
+    }
+    free(bits);
+    hash->word_count = word_count;
+
+    uint64_t total = 0;
+    for (size_t w = 0; w < word_count; w++) {
+        if ((w & ((1u << PERFECT_HASH_RANK_SHIFT) - 1)) == 0) {
+            hash->ranks[w >> PERFECT_HASH_RANK_SHIFT] = total;
+        }
+        total += popcount64(hash->bits[w]);
+    }
+    hash->fallback_base = (size_t)total;
+
+    *remaining_count = count;
+    return true;
+}
+
+/* Puts the keys left over into the fallback table */
+static bool build_fallback(myrtx_perfect_hash_t* hash, const void* const* keys,
+                           const size_t* sizes, const size_t* remaining, size_t count) {
+    myrtx_hash_table_options_t options = {0};
+    options.arena = hash->arena;
+    options.hash_function = hash->hash_func;
+    options.hash64_function = hash->hash64_func;
+    options.seed = hash->seed;
+    options.compare_function = hash->compare_func;
+    options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+    hash->fallback = myrtx_hash_table_create_ex(&options);
+    if (!hash->fallback) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const void* key = keys[remaining[i]];
+        size_t key_size = sizes[remaining[i]];
+        uint64_t index = hash->fallback_base + i;
+        bool inserted;
+        if (!myrtx_hash_table_get_or_insert(hash->fallback, key, key_size, &index,
+                                            sizeof(index), &inserted) ||
+            !inserted) {
+            /* Equal keys always collide, so a duplicate surfaces here */
+            return false;
+        }
+    }
+    return true;
+}
+
+static inline size_t pad8(size_t size) {
+    return (size + 7) & ~(size_t)7;
+}
+
+/* Record of an index: its key, key size and value */
+static inline const unsigned char* record_of(const myrtx_perfect_hash_t* hash, size_t index,
+                                             size_t* key_size, const unsigned char** value) {
+    const unsigned char* record;
+    if (hash->key_size) {
+        record = hash->records + index * hash->record_stride;
+        *key_size = hash->key_size;
+    } else {
+        uint64_t size;
+        memcpy(&size, hash->records + hash->record_offsets[index], sizeof(size));
+        record = hash->records + hash->record_offsets[index] + sizeof(uint64_t);
+        *key_size = (size_t)size;
+    }
+    *value = record + pad8(*key_size);
+    return record;
+}
+
+/* Copies keys and values in index order */
+static bool store_entries(myrtx_perfect_hash_t* hash, const void* const* keys,
+                          const size_t* sizes, const uint64_t* hashes, const void* values) {
+    size_t count = hash->count;
+    size_t* order = malloc((count ? count : 1) * sizeof(size_t));
+    if (!order) {
+        return false;
+    }
+
+    hash->key_size = count > 0 ? sizes[0] : 0;
+    size_t padded_value = pad8(hash->value_size);
+    size_t record_bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t index;
+        if (!index_of(hash, keys[i], sizes[i], hashes[i], &index) || index >= count ||
+            sizes[i] > SIZE_MAX / 2 - padded_value ||
+            record_bytes > SIZE_MAX / 2 - pad8(sizes[i]) - padded_value) {
+            free(order);
+            return false;
+        }
+        order[index] = i;
+        if (sizes[i] != hash->key_size) {
+            hash->key_size = 0;
+        }
+        record_bytes += sizeof(uint64_t) + pad8(sizes[i]) + padded_value;
+    }
+
+    if (hash->key_size) {
+        hash->record_stride = pad8(hash->key_size) + padded_value;
+        record_bytes = count * hash->record_stride;
+    } else {
+        hash->record_offsets = perfect_hash_malloc(hash->arena, count * sizeof(size_t));
+        if (!hash->record_offsets) {
+            free(order);
+            return false;
+        }
+    }
+    hash->records = perfect_hash_malloc(hash->arena, record_bytes);
+    if (!hash->records) {
+        free(order);
+        return false;
+    }
+    memset(hash->records, 0, record_bytes);
+
+    size_t offset = 0;
+    for (size_t index = 0; index < count; index++) {
+        size_t i = order[index];
+        unsigned char* record = hash->records + offset;
+        if (!hash->key_size) {
+            uint64_t size = sizes[i];
+            hash->record_offsets[index] = offset;
+            memcpy(record, &size, sizeof(size));
+            record += sizeof(uint64_t);
+        }
+        memcpy(record, keys[i], sizes[i]);
+        if (values) {
+            memcpy(record + pad8(sizes[i]),
+                   (const unsigned char*)values + i * hash->value_size, hash->value_size);
+        }
+        offset = (size_t)(record - hash->records) + pad8(sizes[i]) + padded_value;
+    }
+
+    free(order);
+    return true;
+}
+
+myrtx_perfect_hash_t* myrtx_perfect_hash_build(const myrtx_perfect_hash_options_t* options,
+                                               const void* const* keys, const size_t* key_sizes,
+                                               size_t count, const void* values,
+                                               size_t value_size) {
+    if (!options || !options->compare_function ||
+        (options->hash_function != NULL) == (options->hash64_function != NULL) ||
+        (count > 0 && !keys) || (values && value_size == 0) ||
+        (values && count > SIZE_MAX / value_size) || count > SIZE_MAX / sizeof(uint64_t)) {
+        return NULL;
+    }
+    double gamma = options->gamma == 0.0 ? PERFECT_HASH_DEFAULT_GAMMA : options->gamma;
+    if (!(gamma >= 1.0)) {
+        return NULL;
+    }
+
+    myrtx_perfect_hash_t* hash = perfect_hash_malloc(options->arena, sizeof(*hash));
+    if (!hash) {
+        return NULL;
+    }
+    memset(hash, 0, sizeof(*hash));
+    hash->arena = options->arena;
+    hash->hash_func = options->hash_function;
+    hash->hash64_func = options->hash64_function;
+    hash->compare_func = options->compare_function;
+    hash->seed = options->seed;
+    if (hash->hash64_func && hash->seed == 0) {
+        hash->seed = myrtx_hash_random_seed();
+    }
+    hash->count = count;
+    hash->value_size = values ? value_size : 0;
+
+    size_t alloc_count = count ? count : 1;
+    size_t* sizes = malloc(alloc_count * sizeof(size_t));
+    uint64_t* hashes = malloc(alloc_count * sizeof(uint64_t));
+    size_t* remaining = malloc(alloc_count * sizeof(size_t));
+    bool ok = sizes && hashes && remaining;
+
+    for (size_t i = 0; ok && i < count; i++) {
+        if (!keys[i]) {
+            ok = false;
+            break;
+        }
+        sizes[i] = key_sizes && key_sizes[i] ? key_sizes[i] : strlen(keys[i]) + 1;
+        hashes[i] = key_hash(hash, keys[i], sizes[i]);
+        remaining[i] = i;
+    }
+
+    size_t remaining_count = count;
+    ok = ok && build_levels(hash, hashes, remaining, &remaining_count, gamma);
+    if (ok && remaining_count > 0) {
+        ok = build_fallback(hash, keys, sizes, remaining, remaining_count);
+    }
+    ok = ok && store_entries(hash, keys, sizes, hashes, values);
+
+    free(sizes);
+    free(hashes);
+    free(remaining);
+    if (!ok) {
+        myrtx_perfect_hash_free(hash);
+        return NULL;
+    }
+    return hash;
+}
+
+void myrtx_perfect_hash_free(myrtx_perfect_hash_t* hash) {
+    if (!hash) {
+        return;
+    }
+
+    myrtx_hash_table_free(hash->fallback, true, true);
+    if (!hash->arena) {
+        free(hash->bits);
+        free(hash->ranks);
+        free(hash->records);
+        free(hash->record_offsets);
+        free(hash);
+    }
+}
+
+/* Finds the record of a key and verifies the key */
+static const unsigned char* find_value(const myrtx_perfect_hash_t* hash, const void* key,
+                                       size_t key_size, size_t* index_out) {
+    if (key_size == 0) {
+        key_size = strlen(key) + 1;
+    }
+
+    size_t index;
+    if (!index_of(hash, key, key_size, key_hash(hash, key, key_size), &index) ||
+        index >= hash->count) {
+        return NULL;
+    }
+
+    /* A key outside the set can land on a set bit; the stored key decides */
+    size_t stored_size;
+    const unsigned char* value;
+    const unsigned char* stored = record_of(hash, index, &stored_size, &value);
+    if (!hash->compare_func(stored, stored_size, key, key_size)) {
+        return NULL;
+    }
+
+    *index_out = index;
+    return value;
+}
+
+bool myrtx_perfect_hash_lookup(const myrtx_perfect_hash_t* hash, const void* key,
+                               size_t key_size, size_t* index_out) {
+    if (!hash || !key || !index_out) {
+        return false;
+    }
+
+    return find_value(hash, key, key_size, index_out) != NULL;
+}
+
+const void* myrtx_perfect_hash_get(const myrtx_perfect_hash_t* hash, const void* key,
+                                   size_t key_size) {
+    size_t index;
+    if (!hash || !key || hash->value_size == 0) {
+        return NULL;
+    }
+    return find_value(hash, key, key_size, &index);
+}
+
+size_t myrtx_perfect_hash_size(const myrtx_perfect_hash_t* hash) {
+    return hash ? hash->count : 0;
+}
+
+double myrtx_perfect_hash_bits_per_key(const myrtx_perfect_hash_t* hash) {
+    if (!hash || hash->count == 0) {
+        return 0.0;
+    }
+
+    size_t rank_count = PERFECT_HASH_RANK_COUNT(hash->word_count);
+    return (double)(hash->word_count + rank_count) * 64.0 / (double)hash->count;
+}
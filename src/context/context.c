@@ -1,4 +1,7 @@
 #include "myrtx/context/context.h"
+#include "myrtx/context/trace.h"
+#include "platform/atomic.h"
+#include "platform/thread.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
@@ -16,34 +19,116 @@ static __thread myrtx_context_t* current_context = NULL;
 static myrtx_extension_info_t extension_registry[MYRTX_MAX_EXTENSION_TYPES];
 static int extension_count = 0;
 
+/* Registry of live contexts for process-wide statistics */
+static myrtx_mutex_t registry_lock = MYRTX_MUTEX_INITIALIZER;
+static myrtx_context_t* registry_head = NULL;
+
+/* Synchronization state of a context that has been forked */
+struct myrtx_context_shared {
+    myrtx_mutex_t lock;               /* Guards the global arena */
+    unsigned int fork_count;          /* Number of live forks */
+};
+
+/* Allocate from a forked context's reserved batch in the parent's global arena */
+static void* context_promote_alloc(myrtx_context_t* context, size_t size) {
+    myrtx_context_t* parent = context->parent;
+    size = (size + (MYRTX_ARENA_ALIGNMENT - 1)) & ~(size_t)(MYRTX_ARENA_ALIGNMENT - 1);
+    
+    /* Fast path: serve from the batch without locking */
+    if ((size_t)(context->promote_end - context->promote_cursor) >= size) {
+        void* ptr = context->promote_cursor;
+        context->promote_cursor += size;
+        return ptr;
+    }
+    
+    myrtx_mutex_lock(&parent->shared->lock);
+    
+    void* ptr;
+    if (size > MYRTX_CONTEXT_PROMOTE_BATCH / 4) {
+        /* Large requests bypass the batch so they don't waste its remainder */
+        ptr = myrtx_arena_alloc(parent->global_arena, size);
+    } else {
+        /* Reserve a new batch and carve the request from its start */
+        uint8_t* batch = myrtx_arena_alloc(parent->global_arena, MYRTX_CONTEXT_PROMOTE_BATCH);
+        ptr = batch;
+        if (batch) {
+            context->promote_cursor = batch + size;
+            context->promote_end = batch + MYRTX_CONTEXT_PROMOTE_BATCH;
+        }
+    }
+    
+    myrtx_mutex_unlock(&parent->shared->lock);
+    return ptr;
+}
+
 /* Initialize a scratch pool */
 static void scratch_pool_init(myrtx_scratch_pool_t* pool, myrtx_arena_t* arena) {
     assert(pool != NULL);
     
     pool->parent_arena = arena;
+    pool->created = 0;
     pool->count = 0;
-    memset(pool->arenas, 0, sizeof(pool->arenas));
+    pool->gets = 0;
+    pool->hits = 0;
+    pool->depth = 0;
+    pool->peak_depth = 0;
+    memset(pool->regions, 0, sizeof(pool->regions));
+    memset(pool->idle, 0, sizeof(pool->idle));
 }
 
-/* Get a scratch arena from the pool or create a new one */
-static bool scratch_pool_get(myrtx_scratch_pool_t* pool, myrtx_scratch_arena_t* scratch) {
+/* Free the blocks of all pooled regions */
+static void scratch_pool_free(myrtx_scratch_pool_t* pool) {
+    for (size_t i = 0; i < pool->created; i++) {
+        myrtx_arena_free(&pool->regions[i]);
+    }
+    pool->created = 0;
+    pool->count = 0;
+}
+
+/* Whether a scratch arena is one of the pool's own regions */
+static bool scratch_pool_owns(const myrtx_scratch_pool_t* pool, const myrtx_arena_t* arena) {
+    return arena >= &pool->regions[0] && arena < &pool->regions[MYRTX_MAX_SCRATCH_POOL_SIZE];
+}
+
+/* Get a scratch arena from the pool or create a new one; *hit tells
+ * whether an idle region was reused */
+static bool scratch_pool_get(myrtx_scratch_pool_t* pool, myrtx_scratch_arena_t* scratch,
+                             bool* hit) {
     assert(pool != NULL);
     assert(scratch != NULL);
     
+    *hit = false;
+    
+    /* Counters read by myrtx_context_stats_all() are stored atomically;
+     * only this thread writes them */
+    myrtx_atomic_store_relaxed_u64(&pool->gets, pool->gets + 1);
+    
     if (pool->count > 0) {
-        /* Get a scratch arena from the pool */
-        pool->count--;
-        *scratch = pool->arenas[pool->count];
-        
-        /* Reset the scratch arena to its initial state */
-        myrtx_arena_temp_end(scratch->arena, scratch->marker);
-        scratch->marker = myrtx_arena_temp_begin(scratch->arena);
-        
-        return true;
-    } else {
-        /* Create a new scratch arena */
-        return myrtx_scratch_begin(scratch, pool->parent_arena);
+        /* Reuse an idle region; it was rewound when it was returned */
+        myrtx_atomic_store_relaxed_u64(&pool->hits, pool->hits + 1);
+        *hit = true;
+        scratch->arena = pool->idle[--pool->count];
+        scratch->marker = 0;
+    } else if (pool->created < MYRTX_MAX_SCRATCH_POOL_SIZE) {
+        /* Create another region */
+        myrtx_arena_t* region = &pool->regions[pool->created];
+        if (!myrtx_arena_init(region, MYRTX_SCRATCH_BLOCK_SIZE)) {
+            return false;
+        }
+        /* Publishes the initialized region to myrtx_context_stats_all() */
+        myrtx_atomic_store_release_size(&pool->created, pool->created + 1);
+        scratch->arena = region;
+        scratch->marker = 0;
+    } else if (!myrtx_scratch_begin(scratch, pool->parent_arena)) {
+        /* Every region is in use and the parent arena is out of markers */
+        return false;
     }
+    
+    if (++pool->depth > pool->peak_depth) {
+        myrtx_atomic_store_relaxed_size(&pool->peak_depth, pool->depth);
+    }
+    
+    return true;
 }
 
 /* Return a scratch arena to the pool */
@@ -51,12 +136,17 @@ static void scratch_pool_return(myrtx_scratch_pool_t* pool, myrtx_scratch_arena_
     assert(pool != NULL);
     assert(scratch != NULL);
     
-    if (pool->count < MYRTX_MAX_SCRATCH_POOL_SIZE) {
-        /* Add the scratch arena to the pool */
-        pool->arenas[pool->count] = *scratch;
-        pool->count++;
+    if (pool->depth > 0) {
+        pool->depth--;
+    }
+    
+    if (scratch_pool_owns(pool, scratch->arena)) {
+        /* Keep the region's blocks for the next user */
+        myrtx_arena_rewind(scratch->arena);
+        pool->idle[pool->count++] = scratch->arena;
+        scratch->arena = NULL;
     } else {
-        /* Pool is full, just end the scratch arena */
+        /* Overflow scratch arena on a temporary marker */
         myrtx_scratch_end(scratch);
     }
 }
@@ -125,6 +215,15 @@ myrtx_context_t* myrtx_context_create(myrtx_arena_t* global_arena) {
         }
     }
     
+    /* Register for process-wide statistics */
+    myrtx_mutex_lock(&registry_lock);
+    context->registry_next = registry_head;
+    if (registry_head) {
+        registry_head->registry_prev = context;
+    }
+    registry_head = context;
+    myrtx_mutex_unlock(&registry_lock);
+    
     return context;
 }
 
@@ -138,6 +237,31 @@ void myrtx_context_destroy(myrtx_context_t* context) {
         current_context = NULL;
     }
     
+    /* Unregister from process-wide statistics */
+    myrtx_mutex_lock(&registry_lock);
+    if (context->registry_prev) {
+        context->registry_prev->registry_next = context->registry_next;
+    } else {
+        registry_head = context->registry_next;
+    }
+    if (context->registry_next) {
+        context->registry_next->registry_prev = context->registry_prev;
+    }
+    myrtx_mutex_unlock(&registry_lock);
+    
+    /* A fork detaches from its parent; a parent must outlive its forks */
+    if (context->parent) {
+        myrtx_mutex_lock(&context->parent->shared->lock);
+        context->parent->shared->fork_count--;
+        myrtx_mutex_unlock(&context->parent->shared->lock);
+    }
+    
+    if (context->shared) {
+        assert(context->shared->fork_count == 0);
+        myrtx_mutex_destroy(&context->shared->lock);
+        free(context->shared);
+    }
+    
     /* Finalize extensions */
     for (int i = 0; i < extension_count; i++) {
         if (context->extension_data[i] && extension_registry[i].finalize) {
@@ -146,7 +270,11 @@ void myrtx_context_destroy(myrtx_context_t* context) {
         }
     }
     
+    /* Release the trace ring, if any */
+    myrtx_trace_disable(context);
+    
     /* Free arenas */
+    scratch_pool_free(&context->scratch_pool);
     myrtx_arena_free(context->temp_arena);
     free(context->temp_arena);
     
@@ -160,6 +288,52 @@ void myrtx_context_destroy(myrtx_context_t* context) {
     free(context);
 }
 
+myrtx_context_t* myrtx_context_fork(myrtx_context_t* parent) {
+    if (!parent) {
+        return NULL;
+    }
+    
+    /* Forks of forks share the original parent's global arena */
+    if (parent->parent) {
+        parent = parent->parent;
+    }
+    
+    if (!parent->shared) {
+        parent->shared = (struct myrtx_context_shared*)malloc(sizeof(struct myrtx_context_shared));
+        if (!parent->shared) {
+            return NULL;
+        }
+        myrtx_mutex_init(&parent->shared->lock);
+        parent->shared->fork_count = 0;
+    }
+    
+    /* The fork references the parent's arena without owning it */
+    myrtx_context_t* fork = myrtx_context_create(parent->global_arena);
+    if (!fork) {
+        return NULL;
+    }
+    fork->parent = parent;
+    
+    myrtx_mutex_lock(&parent->shared->lock);
+    parent->shared->fork_count++;
+    myrtx_mutex_unlock(&parent->shared->lock);
+    
+    return fork;
+}
+
+void* myrtx_context_promote(myrtx_context_t* context, const void* data, size_t size) {
+    if (!data) {
+        return NULL;
+    }
+    
+    void* copy = myrtx_context_alloc(context, size);
+    if (copy) {
+        memcpy(copy, data, size);
+    }
+    
+    return copy;
+}
+
 int myrtx_register_extension(const myrtx_extension_info_t* info) {
     if (!info || extension_count >= MYRTX_MAX_EXTENSION_TYPES) {
         return -1;
@@ -189,10 +363,22 @@ myrtx_context_t* myrtx_get_current_context(void) {
 }
 
 void* myrtx_context_alloc(myrtx_context_t* context, size_t size) {
-    if (!context || !context->global_arena) {
+    if (!context || !context->global_arena || size == 0) {
         return NULL;
     }
     
+    if (context->parent) {
+        return context_promote_alloc(context, size);
+    }
+    
+    /* Forks reserve batches from this arena concurrently */
+    if (context->shared) {
+        myrtx_mutex_lock(&context->shared->lock);
+        void* ptr = myrtx_arena_alloc(context->global_arena, size);
+        myrtx_mutex_unlock(&context->shared->lock);
+        return ptr;
+    }
+    
     return myrtx_arena_alloc(context->global_arena, size);
 }
 
@@ -209,7 +395,13 @@ bool myrtx_context_scratch_begin(myrtx_context_t* context, myrtx_scratch_arena_t
         return false;
     }
     
-    return scratch_pool_get(&context->scratch_pool, scratch);
+    bool hit;
+    if (!scratch_pool_get(&context->scratch_pool, scratch, &hit)) {
+        return false;
+    }
+    
+    MYRTX_TRACE_RECORD(context, MYRTX_TRACE_SCRATCH_BEGIN, hit, (uintptr_t)scratch->arena);
+    return true;
 }
 
 void myrtx_context_scratch_end(myrtx_context_t* context, myrtx_scratch_arena_t* scratch) {
@@ -217,15 +409,380 @@ void myrtx_context_scratch_end(myrtx_context_t* context, myrtx_scratch_arena_t*
         return;
     }
     
+    MYRTX_TRACE_RECORD(context, MYRTX_TRACE_SCRATCH_END, 0, (uintptr_t)scratch->arena);
     scratch_pool_return(&context->scratch_pool, scratch);
 }
 
+/* Length modifiers understood by the deferred error formatter */
+typedef enum {
+    ERROR_LEN_NONE,
+    ERROR_LEN_HH,
+    ERROR_LEN_H,
+    ERROR_LEN_L,
+    ERROR_LEN_LL,
+    ERROR_LEN_Z,
+    ERROR_LEN_J,
+    ERROR_LEN_T,
+    ERROR_LEN_BIG_L
+} error_length_t;
+
+/* Longest flags and width or precision digits a replayable specification
+ * may have, so that error_format() can rebuild it in its buffer. Longer
+ * ones are valid printf but are formatted eagerly. */
+#define ERROR_SPEC_MAX_FLAGS 8
+#define ERROR_SPEC_MAX_DIGITS 9
+
+/* One parsed conversion specification */
+typedef struct {
+    const char* flags;          /* Flag characters */
+    size_t flags_len;
+    const char* width;          /* Width digits (unless width_star) */
+    size_t width_len;
+    bool width_star;
+    bool has_precision;
+    const char* precision;      /* Precision digits (unless precision_star) */
+    size_t precision_len;
+    long precision_value;       /* Value of the precision digits */
+    bool precision_star;
+    error_length_t length;
+    char conversion;
+    const char* end;            /* First character after the specification */
+} error_spec_t;
+
+/* Parse the specification following a '%'; false if the formatter can't replay it */
+static bool error_parse_spec(const char* p, error_spec_t* spec) {
+    memset(spec, 0, sizeof(*spec));
+    
+    spec->flags = p;
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') {
+        p++;
+    }
+    spec->flags_len = (size_t)(p - spec->flags);
+    
+    if (*p == '*') {
+        spec->width_star = true;
+        p++;
+    } else {
+        spec->width = p;
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+        spec->width_len = (size_t)(p - spec->width);
+    }
+    
+    if (*p == '.') {
+        spec->has_precision = true;
+        p++;
+        if (*p == '*') {
+            spec->precision_star = true;
+            p++;
+        } else {
+            spec->precision = p;
+            while (*p >= '0' && *p <= '9') {
+                p++;
+            }
+            spec->precision_len = (size_t)(p - spec->precision);
+        }
+    }
+    
+    switch (*p) {
+    case 'h':
+        p++;
+        spec->length = ERROR_LEN_H;
+        if (*p == 'h') {
+            p++;
+            spec->length = ERROR_LEN_HH;
+        }
+        break;
+    case 'l':
+        p++;
+        spec->length = ERROR_LEN_L;
+        if (*p == 'l') {
+            p++;
+            spec->length = ERROR_LEN_LL;
+        }
+        break;
+    case 'z': p++; spec->length = ERROR_LEN_Z; break;
+    case 'j': p++; spec->length = ERROR_LEN_J; break;
+    case 't': p++; spec->length = ERROR_LEN_T; break;
+    case 'L': p++; spec->length = ERROR_LEN_BIG_L; break;
+    default: break;
+    }
+    
+    spec->conversion = *p;
+    spec->end = *p ? p + 1 : p;
+    
+    if (spec->flags_len > ERROR_SPEC_MAX_FLAGS || spec->width_len > ERROR_SPEC_MAX_DIGITS ||
+        spec->precision_len > ERROR_SPEC_MAX_DIGITS) {
+        return false;
+    }
+    for (size_t i = 0; i < spec->precision_len; i++) {
+        spec->precision_value = spec->precision_value * 10 + (spec->precision[i] - '0');
+    }
+    
+    switch (spec->conversion) {
+    case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+        return spec->length != ERROR_LEN_BIG_L;
+    case 'c': case 's': case 'p': case '%':
+        return spec->length == ERROR_LEN_NONE;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        return spec->length == ERROR_LEN_NONE || spec->length == ERROR_LEN_L;
+    default:
+        return false; /* %n, wide characters, malformed */
+    }
+}
+
+/* Copy a string argument into the record, honouring a precision limit */
+static size_t error_copy_string(myrtx_error_record_t* record, const char* s, long limit) {
+    if (!s) {
+        s = "(null)";
+    }
+    
+    size_t avail = MYRTX_ERROR_STRING_SPACE - record->string_used;
+    if (avail == 0) {
+        return MYRTX_ERROR_STRING_SPACE - 1; /* Terminator of the previous copy */
+    }
+    
+    size_t offset = record->string_used;
+    size_t len = 0;
+    while (len + 1 < avail && (limit < 0 || (long)len < limit) && s[len]) {
+        len++;
+    }
+    memcpy(record->strings + offset, s, len);
+    record->strings[offset + len] = '\0';
+    record->string_used += len + 1;
+    return offset;
+}
+
+/* Capture the arguments of @p format; false if it has to be formatted eagerly */
+static bool error_capture(myrtx_error_record_t* record, const char* format, va_list* args) {
+    record->arg_count = 0;
+    record->string_used = 0;
+    
+    for (const char* p = format; *p; ) {
+        if (*p++ != '%') {
+            continue;
+        }
+        
+        error_spec_t spec;
+        if (!error_parse_spec(p, &spec)) {
+            return false;
+        }
+        p = spec.end;
+        if (spec.conversion == '%') {
+            continue;
+        }
+        
+        size_t needed = 1 + (spec.width_star ? 1 : 0) + (spec.precision_star ? 1 : 0);
+        if (record->arg_count + needed > MYRTX_ERROR_MAX_ARGS) {
+            return false;
+        }
+        
+        myrtx_error_arg_t* arg = &record->args[record->arg_count];
+        long precision = -1;
+        if (spec.width_star) {
+            (arg++)->i = va_arg(*args, int);
+        }
+        if (spec.precision_star) {
+            precision = va_arg(*args, int);
+            (arg++)->i = precision;
+        } else if (spec.has_precision) {
+            precision = spec.precision_value;
+        }
+        record->arg_count += (unsigned int)needed;
+        
+        switch (spec.conversion) {
+        case 'd': case 'i':
+            switch (spec.length) {
+            case ERROR_LEN_HH: arg->i = (signed char)va_arg(*args, int); break;
+            case ERROR_LEN_H: arg->i = (short)va_arg(*args, int); break;
+            case ERROR_LEN_L: arg->i = va_arg(*args, long); break;
+            case ERROR_LEN_LL: arg->i = va_arg(*args, long long); break;
+            case ERROR_LEN_Z: arg->i = (intmax_t)va_arg(*args, size_t); break;
+            case ERROR_LEN_J: arg->i = va_arg(*args, intmax_t); break;
+            case ERROR_LEN_T: arg->i = va_arg(*args, ptrdiff_t); break;
+            default: arg->i = va_arg(*args, int); break;
+            }
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            switch (spec.length) {
+            case ERROR_LEN_HH: arg->u = (unsigned char)va_arg(*args, unsigned int); break;
+            case ERROR_LEN_H: arg->u = (unsigned short)va_arg(*args, unsigned int); break;
+            case ERROR_LEN_L: arg->u = va_arg(*args, unsigned long); break;
+            case ERROR_LEN_LL: arg->u = va_arg(*args, unsigned long long); break;
+            case ERROR_LEN_Z: arg->u = va_arg(*args, size_t); break;
+            case ERROR_LEN_J: arg->u = va_arg(*args, uintmax_t); break;
+            case ERROR_LEN_T: arg->u = (uintmax_t)va_arg(*args, ptrdiff_t); break;
+            default: arg->u = va_arg(*args, unsigned int); break;
+            }
+            break;
+        case 'c':
+            arg->i = va_arg(*args, int);
+            break;
+        case 's':
+            arg->offset = error_copy_string(record, va_arg(*args, const char*), precision);
+            break;
+        case 'p':
+            arg->p = va_arg(*args, void*);
+            break;
+        default:
+            arg->d = va_arg(*args, double);
+            break;
+        }
+    }
+    
+    return true;
+}
+
+/* Append bytes to a bounded buffer, tracking the untruncated length */
+static void error_append(char* out, size_t size, size_t* pos, const char* s, size_t len) {
+    if (*pos < size - 1) {
+        size_t room = size - 1 - *pos;
+        memcpy(out + *pos, s, len < room ? len : room);
+    }
+    *pos += len;
+}
+
+/* Write a star width or precision in decimal; returns the number of characters */
+static size_t error_write_int(char* out, intmax_t value) {
+    char digits[24];
+    size_t n = 0;
+    uintmax_t magnitude = value < 0 ? (uintmax_t)0 - (uintmax_t)value : (uintmax_t)value;
+    do {
+        digits[n++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude && n < 11);
+    
+    size_t len = 0;
+    if (value < 0) {
+        out[len++] = '-';
+    }
+    while (n > 0) {
+        out[len++] = digits[--n];
+    }
+    return len;
+}
+
+/* Format a captured error into @p out */
+static void error_format(const myrtx_error_record_t* record, char* out, size_t size) {
+    size_t pos = 0;
+    unsigned int next = 0;
+    const char* p = record->format;
+    
+    while (*p) {
+        const char* literal = p;
+        while (*p && *p != '%') {
+            p++;
+        }
+        error_append(out, size, &pos, literal, (size_t)(p - literal));
+        if (!*p) {
+            break;
+        }
+        
+        error_spec_t spec;
+        error_parse_spec(++p, &spec);
+        p = spec.end;
+        if (spec.conversion == '%') {
+            error_append(out, size, &pos, "%", 1);
+            continue;
+        }
+        
+        /* Rebuild the specification with star arguments resolved and
+         * integer lengths widened to the captured intmax_t/uintmax_t.
+         * error_parse_spec() bounds the copied parts: at most 1 + 8 flags
+         * + 12 width + 13 precision + 3 characters. */
+        char conv[64];
+        char* c = conv;
+        *c++ = '%';
+        memcpy(c, spec.flags, spec.flags_len);
+        c += spec.flags_len;
+        if (spec.width_star) {
+            c += error_write_int(c, record->args[next++].i);
+        } else {
+            memcpy(c, spec.width, spec.width_len);
+            c += spec.width_len;
+        }
+        if (spec.precision_star) {
+            /* A negative precision is taken as if it were omitted */
+            intmax_t precision = record->args[next++].i;
+            if (precision >= 0) {
+                *c++ = '.';
+                c += error_write_int(c, precision);
+            }
+        } else if (spec.has_precision) {
+            *c++ = '.';
+            memcpy(c, spec.precision, spec.precision_len);
+            c += spec.precision_len;
+        }
+        
+        const myrtx_error_arg_t* arg = &record->args[next++];
+        char* dest = pos < size ? out + pos : out + size - 1;
+        size_t room = pos < size ? size - pos : 1;
+        int written = 0;
+        
+        switch (spec.conversion) {
+        case 'd': case 'i':
+            *c++ = 'j';
+            *c++ = spec.conversion;
+            *c = '\0';
+            written = snprintf(dest, room, conv, arg->i);
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            *c++ = 'j';
+            *c++ = spec.conversion;
+            *c = '\0';
+            written = snprintf(dest, room, conv, arg->u);
+            break;
+        case 'c':
+            *c++ = 'c';
+            *c = '\0';
+            written = snprintf(dest, room, conv, (int)arg->i);
+            break;
+        case 's':
+            if (c == conv + 1) {
+                /* Plain %s needs no printf */
+                const char* str = record->strings + arg->offset;
+                size_t len = strlen(str);
+                error_append(out, size, &pos, str, len);
+                continue;
+            }
+            *c++ = 's';
+            *c = '\0';
+            written = snprintf(dest, room, conv, record->strings + arg->offset);
+            break;
+        case 'p':
+            *c++ = 'p';
+            *c = '\0';
+            written = snprintf(dest, room, conv, arg->p);
+            break;
+        default:
+            *c++ = spec.conversion;
+            *c = '\0';
+            written = snprintf(dest, room, conv, arg->d);
+            break;
+        }
+        
+        if (written > 0) {
+            pos += (size_t)written;
+        }
+    }
+    
+    out[pos < size ? pos : size - 1] = '\0';
+}
+
 void myrtx_context_set_error(myrtx_context_t* context, int error_code, const char* format, ...) {
     if (!context || !format) {
         return;
     }
     
     context->error_code = error_code;
+    myrtx_atomic_store_relaxed_u64(&context->error_count, context->error_count + 1);
+    
+    /* The format may live in a buffer the caller reuses, so it is neither
+     * kept nor replayed later */
+    myrtx_error_record_t* record = &context->error_record;
+    record->format = NULL;
+    record->formatted = true;
     
     va_list args;
     va_start(args, format);
@@ -233,14 +790,50 @@ void myrtx_context_set_error(myrtx_context_t* context, int error_code, const cha
     va_end(args);
 }
 
+void myrtx_context_set_error_static(myrtx_context_t* context, int error_code,
+                                    const char* format, ...) {
+    if (!context || !format) {
+        return;
+    }
+    
+    context->error_code = error_code;
+    myrtx_atomic_store_relaxed_u64(&context->error_count, context->error_count + 1);
+    
+    myrtx_error_record_t* record = &context->error_record;
+    record->format = format;
+    record->formatted = false;
+    
+    va_list args;
+    va_start(args, format);
+    va_list replay;
+    va_copy(replay, args);
+    if (!error_capture(record, format, &args)) {
+        /* Not replayable later; pay for formatting now */
+        vsnprintf(context->error_buffer, sizeof(context->error_buffer), format, replay);
+        record->formatted = true;
+    }
+    va_end(replay);
+    va_end(args);
+}
+
 const char* myrtx_context_get_error(myrtx_context_t* context) {
     if (!context) {
         return "Invalid context";
     }
     
+    myrtx_error_record_t* record = &context->error_record;
+    if (record->format && !record->formatted) {
+        error_format(record, context->error_buffer, sizeof(context->error_buffer));
+        record->formatted = true;
+    }
+    
     return context->error_buffer;
 }
 
+const char* myrtx_context_get_error_format(const myrtx_context_t* context) {
+    return context ? context->error_record.format : NULL;
+}
+
 int myrtx_context_get_error_code(myrtx_context_t* context) {
     if (!context) {
         return -1;
@@ -248,3 +841,86 @@ int myrtx_context_get_error_code(myrtx_context_t* context) {
     
     return context->error_code;
 } 
+
+/* Add the counters that need no arena walk */
+static void context_stats_add_counters(const myrtx_context_t* context, myrtx_context_stats_t* out) {
+    const myrtx_scratch_pool_t* pool = &context->scratch_pool;
+    out->context_count++;
+    out->scratch_gets += myrtx_atomic_load_relaxed_u64(&pool->gets);
+    out->scratch_hits += myrtx_atomic_load_relaxed_u64(&pool->hits);
+    size_t peak_depth = myrtx_atomic_load_relaxed_size(&pool->peak_depth);
+    if (peak_depth > out->scratch_peak_depth) {
+        out->scratch_peak_depth = peak_depth;
+    }
+    out->error_count += myrtx_atomic_load_relaxed_u64(&context->error_count);
+    
+    size_t created = myrtx_atomic_load_acquire_size(&pool->created);
+    for (size_t i = 0; i < created; i++) {
+        out->scratch_reserved += myrtx_atomic_load_relaxed_size(&pool->regions[i].total_allocated);
+    }
+    
+    for (int i = 0; i < extension_count; i++) {
+        if (context->extension_data[i]) {
+            out->extension_bytes += extension_registry[i].data_size;
+        }
+    }
+}
+
+static void context_stats_finish(myrtx_context_stats_t* out) {
+    out->scratch_hit_rate = out->scratch_gets > 0
+        ? (double)out->scratch_hits / (double)out->scratch_gets
+        : 0.0;
+}
+
+bool myrtx_context_stats(myrtx_context_t* context, myrtx_context_stats_t* out) {
+    if (!context || !out) {
+        return false;
+    }
+    
+    memset(out, 0, sizeof(*out));
+    context_stats_add_counters(context, out);
+    
+    /* A fork only aliases the global arena; its parent reports it */
+    if (!context->parent) {
+        if (context->shared) {
+            myrtx_mutex_lock(&context->shared->lock);
+        }
+        myrtx_arena_stats(context->global_arena, &out->global_reserved,
+                          &out->global_used, &out->global_blocks);
+        if (context->shared) {
+            myrtx_mutex_unlock(&context->shared->lock);
+        }
+    }
+    
+    myrtx_arena_stats(context->temp_arena, &out->temp_reserved,
+                      &out->temp_used, &out->temp_blocks);
+    
+    context_stats_finish(out);
+    return true;
+}
+
+void myrtx_context_stats_all(myrtx_context_stats_t* out) {
+    if (!out) {
+        return;
+    }
+    
+    memset(out, 0, sizeof(*out));
+    
+    myrtx_mutex_lock(&registry_lock);
+    for (const myrtx_context_t* context = registry_head; context;
+         context = context->registry_next) {
+        context_stats_add_counters(context, out);
+        
+        /* Block counters only: walking another thread's arena is unsafe */
+        if (!context->parent && context->global_arena) {
+            const myrtx_arena_t* global = context->global_arena;
+            out->global_reserved += myrtx_atomic_load_relaxed_size(&global->total_allocated);
+            out->global_blocks += myrtx_atomic_load_relaxed_size(&global->block_count);
+        }
+        out->temp_reserved += myrtx_atomic_load_relaxed_size(&context->temp_arena->total_allocated);
+        out->temp_blocks += myrtx_atomic_load_relaxed_size(&context->temp_arena->block_count);
+    }
+    myrtx_mutex_unlock(&registry_lock);
+    
+    context_stats_finish(out);
+}
@@ -0,0 +1,290 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "myrtx/context/trace.h"
+#include "platform/atomic.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define MYRTX_TRACE_HAVE_TSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define MYRTX_TRACE_HAVE_TSC 1
+#endif
+
+/* Ring buffer attached to a context */
+struct myrtx_trace_buffer {
+    myrtx_trace_event_t* events;
+    uint64_t head;           /* Total number of events ever written */
+    uint64_t mask;           /* Capacity - 1 (capacity is a power of 2) */
+    uint64_t start_ticks;    /* Clock reading when tracing was enabled */
+    uint64_t start_ns;       /* Wall time in ns at start_ticks */
+    unsigned int id;         /* Track id used as "tid" in exports */
+};
+
+/* Monotonic nanoseconds, used to calibrate the tick clock */
+static uint64_t trace_now_ns(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+#if defined(CLOCK_MONOTONIC_RAW)
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* Raw event timestamp: TSC where available, nanoseconds otherwise */
+static inline uint64_t trace_ticks(void) {
+#if defined(MYRTX_TRACE_HAVE_TSC)
+    return (uint64_t)__rdtsc();
+#else
+    return trace_now_ns();
+#endif
+}
+
+#if defined(MYRTX_ENABLE_TRACING) && MYRTX_ENABLE_TRACING
+/* Contexts may enable tracing on different threads */
+static uint32_t trace_next_id = 1;
+
+static size_t trace_round_capacity(size_t capacity) {
+    size_t power = 1;
+    while (power < capacity) {
+        power *= 2;
+    }
+    return power;
+}
+#endif
+
+bool myrtx_trace_enable(myrtx_context_t* context, size_t capacity) {
+#if defined(MYRTX_ENABLE_TRACING) && MYRTX_ENABLE_TRACING
+    if (!context) {
+        return false;
+    }
+
+    capacity = trace_round_capacity(capacity > 0 ? capacity : MYRTX_TRACE_DEFAULT_CAPACITY);
+
+    struct myrtx_trace_buffer* trace = (struct myrtx_trace_buffer*)malloc(sizeof(*trace));
+    if (!trace) {
+        return false;
+    }
+
+    trace->events = (myrtx_trace_event_t*)calloc(capacity, sizeof(myrtx_trace_event_t));
+    if (!trace->events) {
+        free(trace);
+        return false;
+    }
+
+    trace->head = 0;
+    trace->mask = (uint64_t)capacity - 1;
+    trace->id = myrtx_atomic_fetch_add_u32(&trace_next_id, 1);
+    trace->start_ns = trace_now_ns();
+    trace->start_ticks = trace_ticks();
+
+    myrtx_trace_disable(context);
+    context->trace = trace;
+    return true;
+#else
+    (void)context;
+    (void)capacity;
+    return false;
+#endif
+}
+
+void myrtx_trace_disable(myrtx_context_t* context) {
+    if (!context || !context->trace) {
+        return;
+    }
+
+    free(context->trace->events);
+    free(context->trace);
+    context->trace = NULL;
+}
+
+void myrtx_trace_record(myrtx_context_t* context, myrtx_trace_event_type_t type,
+                        uint64_t arg0, uint64_t arg1) {
+    if (!context || !context->trace) {
+        return;
+    }
+
+    struct myrtx_trace_buffer* trace = context->trace;
+    myrtx_trace_event_t* event = &trace->events[trace->head & trace->mask];
+    event->timestamp = trace_ticks();
+    event->type = (uint32_t)type;
+    event->reserved = 0;
+    event->arg0 = arg0;
+    event->arg1 = arg1;
+    trace->head++;
+}
+
+void myrtx_trace_emit(myrtx_trace_event_type_t type, uint64_t arg0, uint64_t arg1) {
+    myrtx_trace_record(myrtx_get_current_context(), type, arg0, arg1);
+}
+
+size_t myrtx_trace_count(const myrtx_context_t* context) {
+    if (!context || !context->trace) {
+        return 0;
+    }
+
+    uint64_t capacity = context->trace->mask + 1;
+    return (size_t)(context->trace->head < capacity ? context->trace->head : capacity);
+}
+
+uint64_t myrtx_trace_dropped(const myrtx_context_t* context) {
+    if (!context || !context->trace) {
+        return 0;
+    }
+
+    uint64_t capacity = context->trace->mask + 1;
+    return context->trace->head > capacity ? context->trace->head - capacity : 0;
+}
+
+size_t myrtx_trace_snapshot(const myrtx_context_t* context, myrtx_trace_event_t* out,
+                            size_t max_events) {
+    if (!context || !context->trace || !out) {
+        return 0;
+    }
+
+    const struct myrtx_trace_buffer* trace = context->trace;
+    size_t count = myrtx_trace_count(context);
+    if (count > max_events) {
+        count = max_events;
+    }
+
+    /* Oldest retained event first */
+    uint64_t first = trace->head - myrtx_trace_count(context);
+    for (size_t i = 0; i < count; i++) {
+        out[i] = trace->events[(first + i) & trace->mask];
+    }
+
+    return count;
+}
+
+/* Write a span name as a JSON string */
+static void trace_write_json_string(FILE* out, const char* s) {
+    fputc('"', out);
+    for (; s && *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+            fputc(c, out);
+        } else if (c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+bool myrtx_trace_export_chrome(const myrtx_context_t* context, FILE* out) {
+    if (!context || !out) {
+        return false;
+    }
+
+    fputs("{\"traceEvents\":[", out);
+
+    const struct myrtx_trace_buffer* trace = context->trace;
+    if (trace) {
+        /* Calibrate ticks against the monotonic clock over the traced interval */
+        uint64_t end_ticks = trace_ticks();
+        uint64_t end_ns = trace_now_ns();
+        double ns_per_tick = 1.0;
+        if (end_ticks > trace->start_ticks && end_ns > trace->start_ns) {
+            ns_per_tick = (double)(end_ns - trace->start_ns) /
+                          (double)(end_ticks - trace->start_ticks);
+        }
+
+        size_t count = myrtx_trace_count(context);
+        uint64_t first = trace->head - count;
+        bool first_record = true;
+
+        for (size_t i = 0; i < count; i++) {
+            const myrtx_trace_event_t* e = &trace->events[(first + i) & trace->mask];
+            double ts_us = (double)(int64_t)(e->timestamp - trace->start_ticks) * ns_per_tick /
+                           1000.0;
+
+            fputs(first_record ? "\n" : ",\n", out);
+            first_record = false;
+
+            switch ((myrtx_trace_event_type_t)e->type) {
+            case MYRTX_TRACE_ARENA_BLOCK:
+                fprintf(out,
+                        "{\"name\":\"arena_block\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,"
+                        "\"pid\":1,\"tid\":%u,\"args\":{\"block_size\":%llu,\"total\":%llu}},\n",
+                        ts_us, trace->id, (unsigned long long)e->arg0,
+                        (unsigned long long)e->arg1);
+                fprintf(out,
+                        "{\"name\":\"arena_bytes\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,"
+                        "\"tid\":%u,\"args\":{\"total\":%llu}}",
+                        ts_us, trace->id, (unsigned long long)e->arg1);
+                break;
+            /* Markers and scratch regions need not end in reverse order, so
+             * they are async slices keyed by arena (and marker), not B/E */
+            case MYRTX_TRACE_TEMP_BEGIN:
+            case MYRTX_TRACE_TEMP_END:
+                fprintf(out,
+                        "{\"name\":\"arena_temp\",\"cat\":\"arena\",\"ph\":\"%s\","
+                        "\"id\":\"0x%llx.%llu\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+                        "\"args\":{\"marker\":%llu}}",
+                        e->type == MYRTX_TRACE_TEMP_BEGIN ? "b" : "e",
+                        (unsigned long long)e->arg1, (unsigned long long)e->arg0, ts_us,
+                        trace->id, (unsigned long long)e->arg0);
+                break;
+            case MYRTX_TRACE_SCRATCH_BEGIN:
+                fprintf(out,
+                        "{\"name\":\"scratch\",\"cat\":\"scratch\",\"ph\":\"b\","
+                        "\"id\":\"0x%llx\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+                        "\"args\":{\"pool_hit\":%llu}}",
+                        (unsigned long long)e->arg1, ts_us, trace->id,
+                        (unsigned long long)e->arg0);
+                break;
+            case MYRTX_TRACE_SCRATCH_END:
+                fprintf(out,
+                        "{\"name\":\"scratch\",\"cat\":\"scratch\",\"ph\":\"e\","
+                        "\"id\":\"0x%llx\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                        (unsigned long long)e->arg1, ts_us, trace->id);
+                break;
+            case MYRTX_TRACE_HASH_RESIZE:
+                fprintf(out,
+                        "{\"name\":\"hash_resize\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,"
+                        "\"pid\":1,\"tid\":%u,\"args\":{\"old_capacity\":%llu,"
+                        "\"new_capacity\":%llu}}",
+                        ts_us, trace->id, (unsigned long long)e->arg0,
+                        (unsigned long long)e->arg1);
+                break;
+            case MYRTX_TRACE_SPAN_BEGIN:
+            case MYRTX_TRACE_SPAN_END:
+                fputs("{\"name\":", out);
+                trace_write_json_string(out, (const char*)(uintptr_t)e->arg0);
+                fprintf(out, ",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                        e->type == MYRTX_TRACE_SPAN_BEGIN ? "B" : "E", ts_us, trace->id);
+                break;
+            default:
+                fprintf(out,
+                        "{\"name\":\"event_%u\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,"
+                        "\"pid\":1,\"tid\":%u}",
+                        e->type, ts_us, trace->id);
+                break;
+            }
+        }
+    }
+
+    fputs("\n],\"displayTimeUnit\":\"ns\"}\n", out);
+    return !ferror(out);
+}
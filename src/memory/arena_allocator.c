@@ -1,10 +1,22 @@
 #include "myrtx/memory/arena_allocator.h"
+#include "myrtx/context/trace.h"
+#include "platform/atomic.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
 /* Private helper functions */
 
+/* Block statistics are stored atomically (relaxed) because
+ * myrtx_context_stats_all() reads them from other threads. Only the owning
+ * thread writes them, so a load followed by a store suffices. */
+static inline void arena_set_stats(myrtx_arena_t* arena, size_t total_allocated,
+                                   size_t block_count) {
+    myrtx_atomic_store_relaxed_size(&arena->total_allocated, total_allocated);
+    myrtx_atomic_store_relaxed_size(&arena->block_count, block_count);
+}
+
 /**
  * @brief Aligns an address to the specified alignment
  */
@@ -44,19 +56,23 @@ static myrtx_arena_block_t* arena_add_block(myrtx_arena_t* arena, size_t min_siz
     block->used = 0;
     
     /* Add block size to statistics */
-    arena->total_allocated += block_size;
+    arena_set_stats(arena, arena->total_allocated + block_size, arena->block_count + 1);
     
-    /* Add block to arena chain */
+    /* Add block to arena chain right after the current block, keeping any
+       blocks retained by myrtx_arena_rewind() behind it */
     if (!arena->first) {
         arena->first = block;
     }
     
     if (arena->current) {
+        block->next = arena->current->next;
         arena->current->next = block;
     }
     
     arena->current = block;
     
+    MYRTX_TRACE_EMIT(MYRTX_TRACE_ARENA_BLOCK, block_size, arena->total_allocated);
+    
     return block;
 }
 
@@ -104,7 +120,8 @@ void myrtx_arena_free(myrtx_arena_t* arena) {
 }
 
 void* myrtx_arena_alloc_aligned(myrtx_arena_t* arena, size_t size, size_t alignment) {
-    if (!arena || !size) {
+    /* No block can be that large; the size arithmetic below must not wrap */
+    if (!arena || !size || size > SIZE_MAX / 2) {
         return NULL;
     }
     
@@ -116,10 +133,17 @@ void* myrtx_arena_alloc_aligned(myrtx_arena_t* arena, size_t size, size_t alignm
     size_t padding = aligned_ptr - current_ptr;
     
     if (block->used + padding + size > block->size) {
-        /* Create a new block that's large enough for the request */
-        block = arena_add_block(arena, size + alignment - 1);
-        if (!block) {
-            return NULL;
+        if (block->next && block->next->size >= size + alignment - 1) {
+            /* Reuse the next block retained by a rewind */
+            block = block->next;
+            block->used = 0;
+            arena->current = block;
+        } else {
+            /* Create a new block that's large enough for the request */
+            block = arena_add_block(arena, size + alignment - 1);
+            if (!block) {
+                return NULL;
+            }
         }
         
         /* Calculate new pointer */
@@ -176,8 +200,19 @@ void myrtx_arena_reset(myrtx_arena_t* arena) {
         arena->current = arena->first;
         
         /* Update total allocated memory */
-        arena->total_allocated = arena->first->size;
+        arena_set_stats(arena, arena->first->size, 1);
+    }
+}
+
+void myrtx_arena_rewind(myrtx_arena_t* arena) {
+    if (!arena || !arena->first) {
+        return;
     }
+    
+    /* Later blocks keep their memory and are reset when allocation reaches them */
+    arena->temp_count = 0;
+    arena->current = arena->first;
+    arena->first->used = 0;
 }
 
 size_t myrtx_arena_temp_begin(myrtx_arena_t* arena) {
@@ -193,6 +228,8 @@ size_t myrtx_arena_temp_begin(myrtx_arena_t* arena) {
     m.used = (arena->current) ? arena->current->used : 0;
     arena->temp_markers[arena->temp_count++] = m;
 
+    MYRTX_TRACE_EMIT(MYRTX_TRACE_TEMP_BEGIN, marker, (uintptr_t)arena);
+
     return marker;
 }
 
@@ -204,6 +241,11 @@ void myrtx_arena_temp_end(myrtx_arena_t* arena, size_t marker) {
     myrtx_arena_marker_t m = arena->temp_markers[marker];
     myrtx_arena_block_t* target = m.block;
 
+    /* Every dropped marker ends, the innermost first */
+    for (size_t dropped = arena->temp_count; dropped > marker; dropped--) {
+        MYRTX_TRACE_EMIT(MYRTX_TRACE_TEMP_END, dropped - 1, (uintptr_t)arena);
+    }
+
     if (!target) {
         /* Nothing to restore; should not happen for a valid arena */
         arena->temp_count = marker; /* drop this and later markers */
@@ -226,7 +268,7 @@ void myrtx_arena_temp_end(myrtx_arena_t* arena, size_t marker) {
         if (to_free->base) {
             free(to_free->base);
         }
-        arena->total_allocated -= to_free->size;
+        arena_set_stats(arena, arena->total_allocated - to_free->size, arena->block_count - 1);
         free(to_free);
         to_free = next;
     }
@@ -279,11 +321,18 @@ void myrtx_arena_stats(myrtx_arena_t* arena, size_t* total_size, size_t* used_si
     size_t total = 0;
     size_t used = 0;
     size_t count = 0;
+    bool past_current = false;
     
     myrtx_arena_block_t* block = arena->first;
     while (block) {
         total += block->size;
-        used += block->used;
+        /* Blocks behind the current one are retained but hold nothing live */
+        if (!past_current) {
+            used += block->used;
+        }
+        if (block == arena->current) {
+            past_current = true;
+        }
         count++;
         block = block->next;
     }
@@ -0,0 +1,179 @@
+/**
+ * @file atomic.h
+ * @brief Private atomic loads, stores and fences shared by the library sources
+ *
+ * Maps to the GCC/Clang __atomic builtins and to volatile accesses plus
+ * barriers on MSVC (whose volatile accesses are acquire/release on x86 and
+ * x64). Only what the sequence locks and shared counters need. Not
+ * installed.
+ *
+ * ThreadSanitizer does not model standalone fences, and GCC rejects them
+ * under -fsanitize=thread (-Wtsan). In such builds the fences are empty,
+ * and the optimistic reads of a sequence lock, which race with writers by
+ * design, are bracketed with MYRTX_SPECULATIVE_READS_BEGIN/END so that
+ * ThreadSanitizer ignores them. Writers, locks and every other access
+ * stay checked.
+ */
+
+#ifndef MYRTX_PLATFORM_ATOMIC_H
+#define MYRTX_PLATFORM_ATOMIC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SANITIZE_THREAD__)
+#define MYRTX_THREAD_SANITIZER 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define MYRTX_THREAD_SANITIZER 1
+#endif
+#endif
+
+#if defined(MYRTX_THREAD_SANITIZER)
+/* Annotations exported by the ThreadSanitizer runtime */
+void AnnotateIgnoreReadsBegin(const char* file, int line);
+void AnnotateIgnoreReadsEnd(const char* file, int line);
+#define MYRTX_SPECULATIVE_READS_BEGIN() AnnotateIgnoreReadsBegin(__FILE__, __LINE__)
+#define MYRTX_SPECULATIVE_READS_END() AnnotateIgnoreReadsEnd(__FILE__, __LINE__)
+#else
+#define MYRTX_SPECULATIVE_READS_BEGIN() ((void)0)
+#define MYRTX_SPECULATIVE_READS_END() ((void)0)
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#include <windows.h>
+
+static inline uint64_t myrtx_atomic_load_acquire_u64(const uint64_t* ptr) {
+    uint64_t value = *(const volatile uint64_t*)ptr;
+    _ReadWriteBarrier();
+    return value;
+}
+
+static inline uint64_t myrtx_atomic_load_relaxed_u64(const uint64_t* ptr) {
+    return *(const volatile uint64_t*)ptr;
+}
+
+static inline uint8_t myrtx_atomic_load_relaxed_u8(const uint8_t* ptr) {
+    return *(const volatile uint8_t*)ptr;
+}
+
+/* Copies @p size bytes (a multiple of 8, 8-byte aligned) with relaxed word loads */
+static inline void myrtx_atomic_copy_relaxed(void* dst, const void* src, size_t size) {
+    for (size_t i = 0; i < size; i += 8) {
+        uint64_t word = *(const volatile uint64_t*)((const unsigned char*)src + i);
+        memcpy((unsigned char*)dst + i, &word, 8);
+    }
+}
+
+static inline void myrtx_atomic_store_release_u64(uint64_t* ptr, uint64_t value) {
+    _ReadWriteBarrier();
+    *(volatile uint64_t*)ptr = value;
+}
+
+static inline void myrtx_atomic_store_relaxed_u64(uint64_t* ptr, uint64_t value) {
+    *(volatile uint64_t*)ptr = value;
+}
+
+static inline size_t myrtx_atomic_load_acquire_size(const size_t* ptr) {
+    size_t value = *(const volatile size_t*)ptr;
+    _ReadWriteBarrier();
+    return value;
+}
+
+static inline size_t myrtx_atomic_load_relaxed_size(const size_t* ptr) {
+    return *(const volatile size_t*)ptr;
+}
+
+static inline void myrtx_atomic_store_release_size(size_t* ptr, size_t value) {
+    _ReadWriteBarrier();
+    *(volatile size_t*)ptr = value;
+}
+
+static inline void myrtx_atomic_store_relaxed_size(size_t* ptr, size_t value) {
+    *(volatile size_t*)ptr = value;
+}
+
+static inline uint32_t myrtx_atomic_fetch_add_u32(uint32_t* ptr, uint32_t value) {
+    return (uint32_t)InterlockedExchangeAdd((volatile LONG*)ptr, (LONG)value);
+}
+
+static inline void myrtx_atomic_fence_acquire(void) {
+    MemoryBarrier();
+}
+
+static inline void myrtx_atomic_fence_release(void) {
+    MemoryBarrier();
+}
+#else
+static inline uint64_t myrtx_atomic_load_acquire_u64(const uint64_t* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline uint64_t myrtx_atomic_load_relaxed_u64(const uint64_t* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+}
+
+static inline uint8_t myrtx_atomic_load_relaxed_u8(const uint8_t* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+}
+
+/* Word alias for copying structures of any type */
+typedef uint64_t __attribute__((may_alias)) myrtx_atomic_word_t;
+
+/* Copies @p size bytes (a multiple of 8, 8-byte aligned) with relaxed word loads */
+static inline void myrtx_atomic_copy_relaxed(void* dst, const void* src, size_t size) {
+    for (size_t i = 0; i < size; i += 8) {
+        uint64_t word = __atomic_load_n((const myrtx_atomic_word_t*)((const unsigned char*)src + i),
+                                        __ATOMIC_RELAXED);
+        memcpy((unsigned char*)dst + i, &word, 8);
+    }
+}
+
+static inline void myrtx_atomic_store_release_u64(uint64_t* ptr, uint64_t value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+static inline void myrtx_atomic_store_relaxed_u64(uint64_t* ptr, uint64_t value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELAXED);
+}
+
+static inline size_t myrtx_atomic_load_acquire_size(const size_t* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline size_t myrtx_atomic_load_relaxed_size(const size_t* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+}
+
+static inline void myrtx_atomic_store_release_size(size_t* ptr, size_t value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+static inline void myrtx_atomic_store_relaxed_size(size_t* ptr, size_t value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELAXED);
+}
+
+static inline uint32_t myrtx_atomic_fetch_add_u32(uint32_t* ptr, uint32_t value) {
+    return __atomic_fetch_add(ptr, value, __ATOMIC_RELAXED);
+}
+
+#if defined(MYRTX_THREAD_SANITIZER)
+static inline void myrtx_atomic_fence_acquire(void) {
+}
+
+static inline void myrtx_atomic_fence_release(void) {
+}
+#else
+static inline void myrtx_atomic_fence_acquire(void) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+static inline void myrtx_atomic_fence_release(void) {
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+#endif
+#endif
+
+#endif /* MYRTX_PLATFORM_ATOMIC_H */
@@ -0,0 +1,101 @@
+/**
+ * @file file_map.h
+ * @brief Private read-only file mappings shared by the library sources
+ *
+ * Maps to CreateFileMapping/MapViewOfFile on Windows and mmap elsewhere.
+ * POSIX sources must define _POSIX_C_SOURCE before including this header.
+ * Not installed.
+ */
+
+#ifndef MYRTX_PLATFORM_FILE_MAP_H
+#define MYRTX_PLATFORM_FILE_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+
+typedef struct {
+    const void* data;
+    size_t size;
+    HANDLE mapping;
+} myrtx_file_map_t;
+
+static inline bool myrtx_file_map_open(myrtx_file_map_t* map, const char* path) {
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_FLAG_RANDOM_ACCESS, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 ||
+        (uint64_t)size.QuadPart > (uint64_t)SIZE_MAX) {
+        CloseHandle(file);
+        return false;
+    }
+
+    /* The view keeps the mapping alive; the file handle is not needed */
+    map->mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!map->mapping) {
+        return false;
+    }
+    map->data = MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!map->data) {
+        CloseHandle(map->mapping);
+        return false;
+    }
+    map->size = (size_t)size.QuadPart;
+    return true;
+}
+
+static inline void myrtx_file_map_close(myrtx_file_map_t* map) {
+    UnmapViewOfFile(map->data);
+    CloseHandle(map->mapping);
+}
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef struct {
+    const void* data;
+    size_t size;
+} myrtx_file_map_t;
+
+static inline bool myrtx_file_map_open(myrtx_file_map_t* map, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || (uint64_t)st.st_size > (uint64_t)SIZE_MAX) {
+        close(fd);
+        return false;
+    }
+
+    /* The mapping stays valid after the descriptor is closed */
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    /* Lookups touch scattered pages; read-ahead would only waste cache */
+    posix_madvise(data, (size_t)st.st_size, POSIX_MADV_RANDOM);
+    map->data = data;
+    map->size = (size_t)st.st_size;
+    return true;
+}
+
+static inline void myrtx_file_map_close(myrtx_file_map_t* map) {
+    munmap((void*)map->data, map->size);
+}
+#endif
+
+#endif /* MYRTX_PLATFORM_FILE_MAP_H */
@@ -0,0 +1,104 @@
+/**
+ * @file thread.h
+ * @brief Private mutex and thread wrappers shared by the library sources
+ *
+ * Maps to SRW locks and Win32 threads on Windows and to pthreads
+ * elsewhere. Not installed.
+ */
+
+#ifndef MYRTX_PLATFORM_THREAD_H
+#define MYRTX_PLATFORM_THREAD_H
+
+#include <stdbool.h>
+
+#ifdef _WIN32
+#include <windows.h>
+
+typedef SRWLOCK myrtx_mutex_t;
+
+#define MYRTX_MUTEX_INITIALIZER SRWLOCK_INIT
+
+static inline void myrtx_mutex_init(myrtx_mutex_t* mutex) {
+    InitializeSRWLock(mutex);
+}
+
+static inline void myrtx_mutex_destroy(myrtx_mutex_t* mutex) {
+    (void)mutex;
+}
+
+static inline void myrtx_mutex_lock(myrtx_mutex_t* mutex) {
+    AcquireSRWLockExclusive(mutex);
+}
+
+static inline void myrtx_mutex_unlock(myrtx_mutex_t* mutex) {
+    ReleaseSRWLockExclusive(mutex);
+}
+
+typedef struct {
+    HANDLE handle;
+    void (*func)(void*);
+    void* arg;
+} myrtx_thread_t;
+
+static inline DWORD WINAPI myrtx_thread_main(LPVOID thread) {
+    ((myrtx_thread_t*)thread)->func(((myrtx_thread_t*)thread)->arg);
+    return 0;
+}
+
+static inline bool myrtx_thread_start(myrtx_thread_t* thread, void (*func)(void*), void* arg) {
+    thread->func = func;
+    thread->arg = arg;
+    thread->handle = CreateThread(NULL, 0, myrtx_thread_main, thread, 0, NULL);
+    return thread->handle != NULL;
+}
+
+static inline void myrtx_thread_join(myrtx_thread_t* thread) {
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+}
+#else
+#include <pthread.h>
+
+typedef pthread_mutex_t myrtx_mutex_t;
+
+#define MYRTX_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+
+static inline void myrtx_mutex_init(myrtx_mutex_t* mutex) {
+    pthread_mutex_init(mutex, NULL);
+}
+
+static inline void myrtx_mutex_destroy(myrtx_mutex_t* mutex) {
+    pthread_mutex_destroy(mutex);
+}
+
+static inline void myrtx_mutex_lock(myrtx_mutex_t* mutex) {
+    pthread_mutex_lock(mutex);
+}
+
+static inline void myrtx_mutex_unlock(myrtx_mutex_t* mutex) {
+    pthread_mutex_unlock(mutex);
+}
+
+typedef struct {
+    pthread_t handle;
+    void (*func)(void*);
+    void* arg;
+} myrtx_thread_t;
+
+static inline void* myrtx_thread_main(void* thread) {
+    ((myrtx_thread_t*)thread)->func(((myrtx_thread_t*)thread)->arg);
+    return NULL;
+}
+
+static inline bool myrtx_thread_start(myrtx_thread_t* thread, void (*func)(void*), void* arg) {
+    thread->func = func;
+    thread->arg = arg;
+    return pthread_create(&thread->handle, NULL, myrtx_thread_main, thread) == 0;
+}
+
+static inline void myrtx_thread_join(myrtx_thread_t* thread) {
+    pthread_join(thread->handle, NULL);
+}
+#endif
+
+#endif /* MYRTX_PLATFORM_THREAD_H */
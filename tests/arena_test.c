@@ -460,6 +460,56 @@ void test_arena_aligned(void) {
     TEST_PASSED();
 }
 
+void test_arena_rewind(void) {
+    myrtx_arena_t arena = {0};
+    if (!myrtx_arena_init(&arena, 1024)) {
+        TEST_FAILED("Could not initialize arena");
+    }
+    
+    /* Spread allocations over three blocks */
+    void* first = myrtx_arena_alloc(&arena, 800);
+    void* second = myrtx_arena_alloc(&arena, 800);
+    void* third = myrtx_arena_alloc(&arena, 800);
+    if (!first || !second || !third) {
+        TEST_FAILED("Allocation failed");
+    }
+    
+    size_t total_before, used, blocks_before;
+    myrtx_arena_stats(&arena, &total_before, &used, &blocks_before);
+    if (blocks_before != 3) {
+        TEST_FAILED("Expected three blocks");
+    }
+    
+    /* Rewind keeps every block */
+    myrtx_arena_rewind(&arena);
+    size_t total, blocks;
+    myrtx_arena_stats(&arena, &total, &used, &blocks);
+    if (total != total_before || blocks != blocks_before || used != 0) {
+        TEST_FAILED("Rewind released blocks or left bytes in use");
+    }
+    
+    /* The same addresses come back without new blocks */
+    if (myrtx_arena_alloc(&arena, 800) != first ||
+        myrtx_arena_alloc(&arena, 800) != second ||
+        myrtx_arena_alloc(&arena, 800) != third) {
+        TEST_FAILED("Rewound arena did not reuse its blocks");
+    }
+    
+    /* A request larger than the retained block gets a new block in between */
+    myrtx_arena_rewind(&arena);
+    myrtx_arena_alloc(&arena, 800);
+    void* big = myrtx_arena_alloc(&arena, 4096);
+    void* after_big = myrtx_arena_alloc(&arena, 800);
+    myrtx_arena_stats(&arena, &total, &used, &blocks);
+    if (!big || !after_big || blocks != 4 || arena.block_count != 4) {
+        TEST_FAILED("Oversized allocation after rewind broke the block chain");
+    }
+    
+    myrtx_arena_free(&arena);
+    
+    TEST_PASSED();
+}
+
 int main(void) {
     printf("=== myrtx Arena Allocator Tests ===\n\n");
     
@@ -471,6 +521,7 @@ int main(void) {
     test_arena_calloc();
     test_arena_temp_multiblock();
     test_arena_aligned();
+    test_arena_rewind();
     
     printf("\nAll tests successful!\n");
     return 0;
@@ -0,0 +1,310 @@
+/**
+ * @file cache_test.c
+ * @brief Tests for the bounded LRU/CLOCK cache
+ */
+
+#include "myrtx/collections/cache.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_PASSED() printf("PASSED: %s\n", __func__)
+#define TEST_FAILED(msg) do { printf("FAILED: %s - %s\n", __func__, msg); exit(1); } while(0)
+
+typedef struct {
+    size_t calls;
+    uint64_t key_sum;
+    uint64_t value_sum;
+} evict_log_t;
+
+static void log_eviction(const void* key, size_t key_size, void* value, size_t value_size,
+                         void* user_data) {
+    evict_log_t* log = user_data;
+    uint64_t k = 0, v = 0;
+    memcpy(&k, key, key_size < sizeof(k) ? key_size : sizeof(k));
+    memcpy(&v, value, value_size < sizeof(v) ? value_size : sizeof(v));
+    log->calls++;
+    log->key_sum += k;
+    log->value_sum += v;
+}
+
+static myrtx_cache_t* create_cache(myrtx_cache_policy_t policy, size_t max_entries,
+                                   size_t max_bytes, myrtx_arena_t* arena, evict_log_t* log) {
+    myrtx_cache_options_t options = {0};
+    options.arena = arena;
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.policy = policy;
+    options.max_entries = max_entries;
+    options.max_bytes = max_bytes;
+    options.evict_function = log ? log_eviction : NULL;
+    options.user_data = log;
+    return myrtx_cache_create(&options);
+}
+
+static bool put_u64(myrtx_cache_t* cache, uint64_t key, uint64_t value) {
+    return myrtx_cache_put(cache, &key, sizeof(key), &value, sizeof(value));
+}
+
+static bool has(const myrtx_cache_t* cache, uint64_t key) {
+    return myrtx_cache_contains_key(cache, &key, sizeof(key));
+}
+
+/* Test that LRU evicts the least recently used entry and counts correctly */
+void test_lru(void) {
+    evict_log_t log = {0};
+    myrtx_cache_t* cache = create_cache(MYRTX_CACHE_LRU, 3, 0, NULL, &log);
+    if (!cache) {
+        TEST_FAILED("Failed to create cache");
+    }
+
+    put_u64(cache, 1, 10);
+    put_u64(cache, 2, 20);
+    put_u64(cache, 3, 30);
+    uint64_t key = 1;
+    size_t size = 0;
+    const uint64_t* value = myrtx_cache_get(cache, &key, sizeof(key), &size);
+    if (!value || *value != 10 || size != sizeof(uint64_t)) {
+        TEST_FAILED("Wrong value");
+    }
+
+    /* 2 is now least recently used */
+    put_u64(cache, 4, 40);
+    if (has(cache, 2) || !has(cache, 1) || !has(cache, 3) || !has(cache, 4)) {
+        TEST_FAILED("Evicted the wrong entry");
+    }
+    if (log.calls != 1 || log.key_sum != 2 || log.value_sum != 20) {
+        TEST_FAILED("Eviction callback not called for the victim");
+    }
+
+    /* Replacing a value reports the old one and refreshes the entry */
+    put_u64(cache, 3, 31);
+    if (log.calls != 2 || log.value_sum != 20 + 30) {
+        TEST_FAILED("Replaced value not reported");
+    }
+    put_u64(cache, 5, 50);
+    if (has(cache, 1) || !has(cache, 3)) {
+        TEST_FAILED("Replacing did not refresh the entry");
+    }
+
+    key = 2;
+    if (myrtx_cache_get(cache, &key, sizeof(key), NULL)) {
+        TEST_FAILED("Found an evicted key");
+    }
+
+    myrtx_cache_stats_t stats;
+    myrtx_cache_stats(cache, &stats);
+    if (stats.hits != 1 || stats.misses != 1 || stats.evictions != 2 || stats.entries != 3 ||
+        stats.bytes != 3 * 16) {
+        TEST_FAILED("Wrong counters");
+    }
+
+    myrtx_cache_free(cache);
+    if (log.calls != 3 + 3) {
+        TEST_FAILED("Free did not report the remaining entries");
+    }
+    TEST_PASSED();
+}
+
+/* Test that CLOCK gives referenced entries a second chance */
+void test_clock(void) {
+    myrtx_cache_t* cache = create_cache(MYRTX_CACHE_CLOCK, 4, 0, NULL, NULL);
+    if (!cache) {
+        TEST_FAILED("Failed to create cache");
+    }
+
+    for (uint64_t key = 0; key < 4; key++) {
+        put_u64(cache, key, key);
+    }
+    uint64_t key = 0;
+    myrtx_cache_get(cache, &key, sizeof(key), NULL);
+    key = 2;
+    myrtx_cache_get(cache, &key, sizeof(key), NULL);
+
+    /* The hand skips 0, evicts 1, then skips 2 and evicts 3 */
+    put_u64(cache, 4, 4);
+    if (!has(cache, 0) || has(cache, 1) || !has(cache, 2) || !has(cache, 3)) {
+        TEST_FAILED("First eviction chose the wrong entry");
+    }
+    put_u64(cache, 5, 5);
+    if (!has(cache, 0) || !has(cache, 2) || has(cache, 3) || !has(cache, 4) || !has(cache, 5)) {
+        TEST_FAILED("Second eviction chose the wrong entry");
+    }
+
+    /* A long scan never grows the cache beyond its budget */
+    for (uint64_t k = 100; k < 10000; k++) {
+        put_u64(cache, k, k);
+        if (myrtx_cache_size(cache) > 4) {
+            TEST_FAILED("Cache exceeds its entry budget");
+        }
+    }
+
+    myrtx_cache_free(cache);
+    TEST_PASSED();
+}
+
+/* Test a byte budget with values of different sizes, in an arena */
+void test_byte_budget(void) {
+    for (int policy = MYRTX_CACHE_LRU; policy <= MYRTX_CACHE_CLOCK; policy++) {
+        myrtx_arena_t arena = {0};
+        if (!myrtx_arena_init(&arena, 0)) {
+            TEST_FAILED("Failed to initialize arena");
+        }
+        evict_log_t log = {0};
+        myrtx_cache_t* cache =
+            create_cache((myrtx_cache_policy_t)policy, 0, 1000, &arena, &log);
+        if (!cache) {
+            TEST_FAILED("Failed to create cache");
+        }
+
+        static unsigned char buffer[1000];
+        for (uint64_t key = 0; key < 5000; key++) {
+            size_t size = (size_t)(key * 37 % 200);
+            memset(buffer, (int)(key & 0xFF), size);
+            if (!myrtx_cache_put(cache, &key, sizeof(key), buffer, size)) {
+                TEST_FAILED("Put failed");
+            }
+            myrtx_cache_stats_t stats;
+            myrtx_cache_stats(cache, &stats);
+            if (stats.bytes > 1000) {
+                TEST_FAILED("Cache exceeds its byte budget");
+            }
+
+            size_t value_size;
+            const unsigned char* value = myrtx_cache_get(cache, &key, sizeof(key), &value_size);
+            if (!value || value_size != size || (size > 0 && value[size - 1] != (key & 0xFF)) ||
+                ((uintptr_t)value & 7) != 0) {
+                TEST_FAILED("Newest entry missing, wrong or misaligned");
+            }
+        }
+
+        uint64_t key = 1;
+        if (myrtx_cache_put(cache, &key, sizeof(key), buffer, 1000)) {
+            TEST_FAILED("Stored an entry larger than the budget");
+        }
+
+        myrtx_cache_stats_t stats;
+        myrtx_cache_stats(cache, &stats);
+        if (stats.evictions + stats.entries != 5000 || log.calls != stats.evictions) {
+            TEST_FAILED("Evictions do not add up");
+        }
+
+        myrtx_cache_free(cache);
+        myrtx_arena_free(&arena);
+    }
+    TEST_PASSED();
+}
+
+/* Test that callbacks get the right key while the key table grows and moves
+ * its entries, on every probing strategy */
+void test_keys_across_growth(void) {
+    for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT; probing++) {
+        evict_log_t log = {0};
+        myrtx_cache_options_t options = {0};
+        options.hash64_function = myrtx_hash64_bytes;
+        options.compare_function = myrtx_compare_integer_keys;
+        options.probing = (myrtx_hash_probing_t)probing;
+        options.max_entries = 1000;
+        options.evict_function = log_eviction;
+        options.user_data = &log;
+        myrtx_cache_t* cache = myrtx_cache_create(&options);
+        if (!cache) {
+            TEST_FAILED("Failed to create cache");
+        }
+
+        /* 3000 keys, the last 1000 replaced once and the last 10 with an empty value */
+        uint64_t expected_keys = 0;
+        for (uint64_t key = 0; key < 3000; key++) {
+            put_u64(cache, key, key + 1);
+            if (key < 2000) {
+                expected_keys += key;
+            }
+        }
+        for (uint64_t key = 2000; key < 3000; key++) {
+            if (key < 2990) {
+                put_u64(cache, key, key + 1);
+            } else if (!myrtx_cache_put(cache, &key, sizeof(key), NULL, 0)) {
+                TEST_FAILED("Put of an empty value failed");
+            }
+            expected_keys += key;
+        }
+        if (log.calls != 3000 || log.key_sum != expected_keys) {
+            TEST_FAILED("Callbacks got wrong keys");
+        }
+
+        uint64_t key = 2995;
+        size_t value_size = 1;
+        if (!myrtx_cache_get(cache, &key, sizeof(key), &value_size) || value_size != 0) {
+            TEST_FAILED("Empty value not found");
+        }
+
+        myrtx_cache_free(cache);
+        if (log.calls != 4000 || log.key_sum != expected_keys + 2000 * 1000 + 999 * 1000 / 2) {
+            TEST_FAILED("Free passed wrong keys");
+        }
+    }
+    TEST_PASSED();
+}
+
+/* Test remove, clear, string keys and option validation */
+void test_remove_and_clear(void) {
+    myrtx_cache_options_t options = {0};
+    options.hash_function = myrtx_hash_string;
+    options.compare_function = myrtx_compare_string_keys;
+    if (myrtx_cache_create(&options)) {
+        TEST_FAILED("Created a cache without a budget");
+    }
+    options.max_entries = 100;
+    evict_log_t log = {0};
+    options.evict_function = log_eviction;
+    options.user_data = &log;
+    myrtx_cache_t* cache = myrtx_cache_create(&options);
+    if (!cache) {
+        TEST_FAILED("Failed to create cache");
+    }
+
+    const char* long_key = "a key that is longer than sixteen bytes";
+    myrtx_cache_put(cache, "short", 0, "v1", 3);
+    myrtx_cache_put(cache, long_key, 0, "v2", 3);
+    if (!myrtx_cache_remove(cache, long_key, 0) || myrtx_cache_remove(cache, long_key, 0) ||
+        myrtx_cache_contains_key(cache, long_key, 0) || log.calls != 1) {
+        TEST_FAILED("Remove failed");
+    }
+    if (strcmp(myrtx_cache_get(cache, "short", 0, NULL), "v1") != 0) {
+        TEST_FAILED("Wrong value after remove");
+    }
+
+    myrtx_cache_clear(cache);
+    if (myrtx_cache_size(cache) != 0 || myrtx_cache_contains_key(cache, "short", 0) ||
+        log.calls != 2) {
+        TEST_FAILED("Clear failed");
+    }
+    myrtx_cache_put(cache, long_key, 0, "v3", 3);
+    if (strcmp(myrtx_cache_get(cache, long_key, 0, NULL), "v3") != 0) {
+        TEST_FAILED("Cache unusable after clear");
+    }
+
+    myrtx_cache_stats_t stats;
+    myrtx_cache_stats(cache, &stats);
+    if (stats.hits != 2 || stats.entries != 1) {
+        TEST_FAILED("Wrong counters after clear");
+    }
+
+    myrtx_cache_free(cache);
+    myrtx_cache_free(NULL);
+    TEST_PASSED();
+}
+
+int main(void) {
+    printf("=== myrtx Cache Tests ===\n\n");
+
+    test_lru();
+    test_clock();
+    test_byte_budget();
+    test_keys_across_growth();
+    test_remove_and_clear();
+
+    printf("\nAll cache tests successful!\n");
+    return 0;
+}
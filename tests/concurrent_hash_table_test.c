@@ -0,0 +1,336 @@
+/**
+ * @file concurrent_hash_table_test.c
+ * @brief Tests for the sharded concurrent hash table
+ */
+
+#include "myrtx/collections/concurrent_hash_table.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_PASSED() printf("PASSED: %s\n", __func__)
+#define TEST_FAILED(msg) do { printf("FAILED: %s - %s\n", __func__, msg); exit(1); } while(0)
+
+static myrtx_concurrent_hash_table_t* create_table(size_t shard_count) {
+    myrtx_concurrent_hash_table_options_t options = {0};
+    options.shard_count = shard_count;
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    return myrtx_concurrent_hash_table_create(&options);
+}
+
+/* Test option validation */
+void test_create_free(void) {
+    myrtx_concurrent_hash_table_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    if (myrtx_concurrent_hash_table_create(&options)) {
+        TEST_FAILED("Created a table without a compare function");
+    }
+
+    options.compare_function = myrtx_compare_integer_keys;
+    options.hash_function = myrtx_hash_integer;
+    if (myrtx_concurrent_hash_table_create(&options)) {
+        TEST_FAILED("Created a table with two hash functions");
+    }
+
+    options.hash_function = NULL;
+    options.shard_count = 12;
+    if (myrtx_concurrent_hash_table_create(&options)) {
+        TEST_FAILED("Created a table with a non-power-of-two shard count");
+    }
+
+    options.shard_count = 0;
+    myrtx_concurrent_hash_table_t* table = myrtx_concurrent_hash_table_create(&options);
+    if (!table) {
+        TEST_FAILED("Failed to create table with default options");
+    }
+    if (myrtx_concurrent_hash_table_shard_count(table) != MYRTX_CONCURRENT_HASH_DEFAULT_SHARDS) {
+        TEST_FAILED("Wrong default shard count");
+    }
+    myrtx_concurrent_hash_table_free(table);
+
+    table = create_table(1);
+    if (!table || myrtx_concurrent_hash_table_shard_count(table) != 1) {
+        TEST_FAILED("Failed to create single-shard table");
+    }
+    myrtx_concurrent_hash_table_free(table);
+    myrtx_concurrent_hash_table_free(NULL);
+
+    TEST_PASSED();
+}
+
+/* Test put, get, overwrite and remove from one thread */
+void test_basic_operations(void) {
+    myrtx_concurrent_hash_table_t* table = create_table(8);
+    if (!table) {
+        TEST_FAILED("Failed to create table");
+    }
+
+    const size_t count = 10000;
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t value = i * 3;
+        if (!myrtx_concurrent_hash_table_put(table, &i, sizeof(i), &value, sizeof(value))) {
+            TEST_FAILED("Put failed");
+        }
+    }
+    if (myrtx_concurrent_hash_table_size(table) != count) {
+        TEST_FAILED("Wrong size after puts");
+    }
+
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t value = 0;
+        size_t value_size = 0;
+        if (!myrtx_concurrent_hash_table_get(table, &i, sizeof(i), &value, sizeof(value),
+                                             &value_size) ||
+            value != i * 3 || value_size != sizeof(value)) {
+            TEST_FAILED("Wrong value after puts");
+        }
+    }
+
+    /* Replace every other value with a larger one, which no longer fits inline */
+    for (uint64_t i = 0; i < count; i += 2) {
+        uint64_t value[4] = {i, i + 1, i + 2, i + 3};
+        if (!myrtx_concurrent_hash_table_put(table, &i, sizeof(i), value, sizeof(value))) {
+            TEST_FAILED("Overwrite failed");
+        }
+    }
+    for (uint64_t i = 0; i < count; i += 2) {
+        uint64_t value[4] = {0};
+        size_t value_size = 0;
+        if (!myrtx_concurrent_hash_table_get(table, &i, sizeof(i), value, sizeof(value),
+                                             &value_size) ||
+            value_size != sizeof(value) || value[0] != i || value[3] != i + 3) {
+            TEST_FAILED("Wrong value after overwrite");
+        }
+    }
+
+    /* A short buffer receives a prefix and the full size */
+    uint64_t key = 4;
+    uint64_t prefix = 0;
+    size_t value_size = 0;
+    if (!myrtx_concurrent_hash_table_get(table, &key, sizeof(key), &prefix, sizeof(prefix),
+                                         &value_size) ||
+        prefix != 4 || value_size != 4 * sizeof(uint64_t)) {
+        TEST_FAILED("Wrong truncated read");
+    }
+
+    for (uint64_t i = 0; i < count; i += 3) {
+        if (!myrtx_concurrent_hash_table_remove(table, &i, sizeof(i))) {
+            TEST_FAILED("Remove failed");
+        }
+    }
+    for (uint64_t i = 0; i < count; i++) {
+        if (myrtx_concurrent_hash_table_contains_key(table, &i, sizeof(i)) != (i % 3 != 0)) {
+            TEST_FAILED("Wrong membership after remove");
+        }
+    }
+    key = 0;
+    if (myrtx_concurrent_hash_table_remove(table, &key, sizeof(key))) {
+        TEST_FAILED("Removed a missing key");
+    }
+    if (myrtx_concurrent_hash_table_size(table) != count - (count + 2) / 3) {
+        TEST_FAILED("Wrong size after remove");
+    }
+
+    myrtx_concurrent_hash_table_free(table);
+    TEST_PASSED();
+}
+
+/* Test string keys, including keys too long to store inline */
+void test_string_keys(void) {
+    myrtx_concurrent_hash_table_options_t options = {0};
+    options.shard_count = 4;
+    options.hash_function = myrtx_hash_string;
+    options.compare_function = myrtx_compare_string_keys;
+    myrtx_concurrent_hash_table_t* table = myrtx_concurrent_hash_table_create(&options);
+    if (!table) {
+        TEST_FAILED("Failed to create table");
+    }
+
+    const char* keys[] = {"a", "apple", "a key that does not fit into an entry"};
+    for (int i = 0; i < 3; i++) {
+        if (!myrtx_concurrent_hash_table_put(table, keys[i], 0, &i, sizeof(i))) {
+            TEST_FAILED("Put failed");
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        int value = -1;
+        if (!myrtx_concurrent_hash_table_get(table, keys[i], 0, &value, sizeof(value), NULL) ||
+            value != i) {
+            TEST_FAILED("Wrong value for string key");
+        }
+    }
+    if (myrtx_concurrent_hash_table_contains_key(table, "a key that does not fit", 0)) {
+        TEST_FAILED("Found a prefix of a key");
+    }
+
+    myrtx_concurrent_hash_table_free(table);
+    TEST_PASSED();
+}
+
+/* Concurrent stress test: writers rewrite and remove records whose fields
+ * depend on each other, readers check every record they see */
+
+#define STRESS_KEYS 4096
+#define STRESS_WRITERS 2
+#define STRESS_READERS 4
+#define STRESS_WRITES 100000
+#define STRESS_READS 200000
+
+typedef struct {
+    uint64_t key;
+    uint64_t version;
+    uint64_t check;
+    uint64_t pad[3];  /* Written only for odd versions, which are larger */
+} stress_record_t;
+
+typedef struct {
+    myrtx_concurrent_hash_table_t* table;
+    unsigned int id;
+    uint64_t versions[STRESS_KEYS];  /* Writer: last version per key, 0 if removed */
+    size_t found;                    /* Reader: successful lookups */
+    const char* error;
+} stress_worker_t;
+
+static uint64_t stress_check(uint64_t key, uint64_t version) {
+    return (key * 0x9E3779B97F4A7C15ull) ^ (version * 0xBF58476D1CE4E5B9ull);
+}
+
+static size_t stress_record_size(uint64_t version) {
+    return (version & 1) ? sizeof(stress_record_t) : 3 * sizeof(uint64_t);
+}
+
+static uint64_t stress_next(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void* stress_writer(void* arg) {
+    stress_worker_t* worker = arg;
+    uint64_t state = 0x1234567ull + worker->id;
+
+    for (uint64_t i = 1; i <= STRESS_WRITES; i++) {
+        uint64_t r = stress_next(&state);
+        /* Each writer owns the keys congruent to its id */
+        uint64_t key = (r % (STRESS_KEYS / STRESS_WRITERS)) * STRESS_WRITERS + worker->id;
+
+        if ((r >> 32) % 8 == 0) {
+            bool removed = myrtx_concurrent_hash_table_remove(worker->table, &key, sizeof(key));
+            if (removed != (worker->versions[key] != 0)) {
+                worker->error = "Remove disagreed with the writer's own state";
+                return NULL;
+            }
+            worker->versions[key] = 0;
+            continue;
+        }
+
+        stress_record_t record = {key, i, stress_check(key, i), {i, i, i}};
+        if (!myrtx_concurrent_hash_table_put(worker->table, &key, sizeof(key), &record,
+                                             stress_record_size(i))) {
+            worker->error = "Put failed";
+            return NULL;
+        }
+        worker->versions[key] = i;
+    }
+    return NULL;
+}
+
+static void* stress_reader(void* arg) {
+    stress_worker_t* worker = arg;
+    uint64_t state = 0x9876543ull + worker->id;
+
+    for (size_t i = 0; i < STRESS_READS; i++) {
+        uint64_t key = stress_next(&state) % STRESS_KEYS;
+        stress_record_t record;
+        size_t size = 0;
+        if (!myrtx_concurrent_hash_table_get(worker->table, &key, sizeof(key), &record,
+                                             sizeof(record), &size)) {
+            continue;
+        }
+        worker->found++;
+
+        if (size != stress_record_size(record.version) || record.key != key ||
+            record.check != stress_check(key, record.version)) {
+            worker->error = "Torn or foreign record";
+            return NULL;
+        }
+        if ((record.version & 1) &&
+            (record.pad[0] != record.version || record.pad[2] != record.version)) {
+            worker->error = "Torn record tail";
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+void test_concurrent_readers_writers(void) {
+    myrtx_concurrent_hash_table_t* table = create_table(4);
+    if (!table) {
+        TEST_FAILED("Failed to create table");
+    }
+
+    static stress_worker_t workers[STRESS_WRITERS + STRESS_READERS];
+    pthread_t threads[STRESS_WRITERS + STRESS_READERS];
+    memset(workers, 0, sizeof(workers));
+
+    for (unsigned int i = 0; i < STRESS_WRITERS + STRESS_READERS; i++) {
+        workers[i].table = table;
+        workers[i].id = i < STRESS_WRITERS ? i : i - STRESS_WRITERS;
+        if (pthread_create(&threads[i], NULL, i < STRESS_WRITERS ? stress_writer : stress_reader,
+                           &workers[i]) != 0) {
+            TEST_FAILED("Failed to start thread");
+        }
+    }
+    for (unsigned int i = 0; i < STRESS_WRITERS + STRESS_READERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    size_t found = 0;
+    for (unsigned int i = 0; i < STRESS_WRITERS + STRESS_READERS; i++) {
+        if (workers[i].error) {
+            TEST_FAILED(workers[i].error);
+        }
+        found += workers[i].found;
+    }
+
+    /* The final contents match what each writer last did to its keys */
+    size_t expected = 0;
+    for (uint64_t key = 0; key < STRESS_KEYS; key++) {
+        uint64_t version = workers[key % STRESS_WRITERS].versions[key];
+        stress_record_t record;
+        size_t size = 0;
+        bool present = myrtx_concurrent_hash_table_get(table, &key, sizeof(key), &record,
+                                                       sizeof(record), &size);
+        if (present != (version != 0)) {
+            TEST_FAILED("Final membership differs from the writers");
+        }
+        if (present) {
+            expected++;
+            if (record.version != version || size != stress_record_size(version)) {
+                TEST_FAILED("Final value differs from the writers");
+            }
+        }
+    }
+    if (myrtx_concurrent_hash_table_size(table) != expected) {
+        TEST_FAILED("Final size differs from the writers");
+    }
+
+    printf("  %zu of %d reads found a record\n", found, STRESS_READERS * STRESS_READS);
+    myrtx_concurrent_hash_table_free(table);
+    TEST_PASSED();
+}
+
+int main(void) {
+    printf("=== myrtx Concurrent Hash Table Tests ===\n\n");
+
+    test_create_free();
+    test_basic_operations();
+    test_string_keys();
+    test_concurrent_readers_writers();
+
+    printf("\nAll concurrent hash table tests successful!\n");
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
 
 #define TEST_PASSED() printf("PASSED: %s\n", __func__)
 #define TEST_FAILED(msg) do { printf("FAILED: %s - %s\n", __func__, msg); exit(1); } while(0)
@@ -196,6 +197,71 @@ void test_context_scratch_pool(void) {
     TEST_PASSED();
 }
 
+/* Test that pooled scratch regions keep their blocks between uses */
+void test_context_scratch_retained(void) {
+    myrtx_context_t* ctx = myrtx_context_create(NULL);
+    if (!ctx) {
+        TEST_FAILED("Failed to create context");
+    }
+    
+    /* Grow a region past its first block */
+    myrtx_scratch_arena_t scratch = {0};
+    if (!myrtx_context_scratch_begin(ctx, &scratch)) {
+        TEST_FAILED("Failed to begin scratch arena");
+    }
+    myrtx_arena_t* region = scratch.arena;
+    void* p1 = myrtx_arena_alloc(region, MYRTX_SCRATCH_BLOCK_SIZE / 2);
+    void* p2 = myrtx_arena_alloc(region, MYRTX_SCRATCH_BLOCK_SIZE / 2 + 64);
+    myrtx_context_scratch_end(ctx, &scratch);
+    
+    size_t reserved = region->total_allocated;
+    size_t blocks = region->block_count;
+    size_t temp_blocks = ctx->temp_arena->block_count;
+    
+    /* Reuse hands out the same region with the same blocks */
+    for (int i = 0; i < 1000; i++) {
+        if (!myrtx_context_scratch_begin(ctx, &scratch) || scratch.arena != region) {
+            TEST_FAILED("Pooled region was not reused");
+        }
+        if (myrtx_arena_alloc(scratch.arena, MYRTX_SCRATCH_BLOCK_SIZE / 2) != p1 ||
+            myrtx_arena_alloc(scratch.arena, MYRTX_SCRATCH_BLOCK_SIZE / 2 + 64) != p2) {
+            TEST_FAILED("Region did not reuse its retained blocks");
+        }
+        myrtx_context_scratch_end(ctx, &scratch);
+    }
+    
+    if (region->total_allocated != reserved || region->block_count != blocks) {
+        TEST_FAILED("Region blocks were freed or added during reuse");
+    }
+    
+    /* Pooled regions leave the temporary arena alone */
+    if (ctx->temp_arena->temp_count != 0 || ctx->temp_arena->block_count != temp_blocks) {
+        TEST_FAILED("Pooled scratch touched the temporary arena");
+    }
+    
+    /* Beyond the pool size, scratch falls back to markers in the temp arena */
+    myrtx_scratch_arena_t nested[MYRTX_MAX_SCRATCH_POOL_SIZE + 1];
+    for (int i = 0; i <= MYRTX_MAX_SCRATCH_POOL_SIZE; i++) {
+        if (!myrtx_context_scratch_begin(ctx, &nested[i])) {
+            TEST_FAILED("Failed to begin nested scratch arena");
+        }
+    }
+    if (nested[MYRTX_MAX_SCRATCH_POOL_SIZE].arena != ctx->temp_arena) {
+        TEST_FAILED("Overflow scratch arena is not on the temporary arena");
+    }
+    for (int i = MYRTX_MAX_SCRATCH_POOL_SIZE; i >= 0; i--) {
+        myrtx_context_scratch_end(ctx, &nested[i]);
+    }
+    if (ctx->temp_arena->temp_count != 0 ||
+        ctx->scratch_pool.count != MYRTX_MAX_SCRATCH_POOL_SIZE) {
+        TEST_FAILED("Nested scratch arenas were not returned");
+    }
+    
+    myrtx_context_destroy(ctx);
+    
+    TEST_PASSED();
+}
+
 /* Test the MYRTX_WITH_CONTEXT_SCRATCH macro */
 void test_context_scratch_macro(void) {
     myrtx_context_t* ctx = myrtx_context_create(NULL);
@@ -396,6 +462,113 @@ void test_context_ownership(void) {
     TEST_PASSED();
 }
 
+/* Check that a deferred error formats exactly like snprintf */
+#define CHECK_DEFERRED(ctx, ...) do { \
+    char expected[1024]; \
+    snprintf(expected, sizeof(expected), __VA_ARGS__); \
+    expected[sizeof(ctx->error_buffer) - 1] = '\0'; \
+    myrtx_context_set_error_static(ctx, 7, __VA_ARGS__); \
+    if (strcmp(myrtx_context_get_error(ctx), expected) != 0) { \
+        printf("  got \"%s\", expected \"%s\"\n", myrtx_context_get_error(ctx), expected); \
+        TEST_FAILED("Deferred error differs from snprintf"); \
+    } \
+} while (0)
+
+/* Test that static-format errors are recorded unformatted and formatted on read */
+void test_context_error_deferred(void) {
+    myrtx_context_t* ctx = myrtx_context_create(NULL);
+    if (!ctx) {
+        TEST_FAILED("Failed to create context");
+    }
+    
+    if (myrtx_context_get_error_format(ctx) != NULL || myrtx_context_get_error(ctx)[0] != '\0') {
+        TEST_FAILED("New context has an error");
+    }
+    
+    /* Nothing is formatted until the message is read */
+    static const char not_found[] = "key %d not found in %s";
+    myrtx_context_set_error_static(ctx, 3, not_found, 17, "table");
+    if (myrtx_context_get_error_format(ctx) != not_found || ctx->error_buffer[0] != '\0') {
+        TEST_FAILED("Error was formatted eagerly");
+    }
+    
+    /* String arguments are copied, so temporary buffers are fine */
+    char name[16];
+    strcpy(name, "first");
+    myrtx_context_set_error_static(ctx, 4, "open %s failed", name);
+    strcpy(name, "second");
+    if (strcmp(myrtx_context_get_error(ctx), "open first failed") != 0) {
+        TEST_FAILED("String argument was not copied");
+    }
+    
+    /* Conversions, lengths, flags, star width and precision */
+    CHECK_DEFERRED(ctx, "plain message");
+    CHECK_DEFERRED(ctx, "100%% done, %c%c", 'o', 'k');
+    CHECK_DEFERRED(ctx, "%d %i %u %x %X %o", -5, 12, 4000000000u, 255, 255, 8);
+    CHECK_DEFERRED(ctx, "%hhd %hu %ld %lld %zu %jd %td", 300, 70000, -7L, -9000000000LL,
+                   (size_t)42, (intmax_t)-1, (ptrdiff_t)-3);
+    CHECK_DEFERRED(ctx, "[%-6d] [%+05d] [%#x] [% d]", 42, 42, 42, 42);
+    CHECK_DEFERRED(ctx, "[%*d] [%-*s] [%.*s] [%*.*f]", 6, 1, 5, "ab", 3, "abcdef", 9, 2, 3.14159);
+    CHECK_DEFERRED(ctx, "%.2s|%10.3s|%s", "xyz", "abcdef", "");
+    CHECK_DEFERRED(ctx, "[%*d] [%.*s]", -4, 7, -1, "negative precision");
+    CHECK_DEFERRED(ctx, "%f %e %g %a %.3f %lf", 1.5, 12345.678, 0.0001, 2.0, 2.0 / 3.0, 9.25);
+    CHECK_DEFERRED(ctx, "%p", (void*)ctx);
+    
+    /* Messages are truncated like vsnprintf into the buffer */
+    char big[400];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    CHECK_DEFERRED(ctx, "%s and %d more", big, 5);
+    CHECK_DEFERRED(ctx, "%200d|%200d", 1, 2);
+    
+    /* Formats that cannot be replayed are formatted immediately */
+    CHECK_DEFERRED(ctx, "%Lf", (long double)1.25);
+    CHECK_DEFERRED(ctx, "%d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9);
+    if (ctx->error_record.formatted != true) {
+        TEST_FAILED("Overlong argument list was not formatted eagerly");
+    }
+    
+    /* Specifications too long to rebuild for replay; held in variables to
+     * keep the compiler's format checks quiet about repeated flags */
+    const char* long_flags = "[%00000000000000000000000000000000000000000000000000000000000000000"
+                             "00000000000000005d]";
+    const char* long_digits = "[%0000000000012d] [%.0000000000003s]";
+    const char* at_limits = "[%-+ -+ -+d] [%000000012.000000003d]";
+    myrtx_context_set_error_static(ctx, 7, long_flags, 7);
+    if (ctx->error_record.formatted != true) {
+        TEST_FAILED("Overlong flags were not formatted eagerly");
+    }
+    myrtx_context_set_error_static(ctx, 7, long_digits, 7, "abcdef");
+    if (ctx->error_record.formatted != true) {
+        TEST_FAILED("Overlong digits were not formatted eagerly");
+    }
+    myrtx_context_set_error_static(ctx, 7, at_limits, 7, 7);
+    if (ctx->error_record.formatted != false) {
+        TEST_FAILED("Specification within the limits was formatted eagerly");
+    }
+    CHECK_DEFERRED(ctx, long_flags, 7);
+    CHECK_DEFERRED(ctx, long_digits, 7, "abcdef");
+    CHECK_DEFERRED(ctx, at_limits, 7, 7);
+    
+    if (myrtx_context_get_error_code(ctx) != 7 || ctx->error_count != 22) {
+        TEST_FAILED("Error code or count not recorded");
+    }
+    
+    /* The plain API formats at once, so the format may be a reused buffer */
+    char format[32];
+    strcpy(format, "dyn %d");
+    myrtx_context_set_error(ctx, 2, format, 7);
+    strcpy(format, "XXXXXXXXXX %s");
+    if (strcmp(myrtx_context_get_error(ctx), "dyn 7") != 0 ||
+        myrtx_context_get_error_format(ctx) != NULL || myrtx_context_get_error_code(ctx) != 2) {
+        TEST_FAILED("Error from a reused format buffer was not formatted eagerly");
+    }
+    
+    myrtx_context_destroy(ctx);
+    
+    TEST_PASSED();
+}
+
 /* Test thread-local context */
 void test_context_thread_local(void) {
     /* Create context */
@@ -432,16 +605,258 @@ void test_context_thread_local(void) {
     TEST_PASSED();
 }
 
+/* Worker state for the fork test */
+typedef struct {
+    myrtx_context_t* fork;
+    const int* shared_data;
+    int id;
+    int* promoted[256];
+    int sum;
+} fork_worker_t;
+
+static void* fork_worker(void* arg) {
+    fork_worker_t* w = (fork_worker_t*)arg;
+    
+    /* Read the parent's dataset, scratch in the fork's own arenas */
+    MYRTX_WITH_CONTEXT_SCRATCH(w->fork, scratch) {
+        int* tmp = myrtx_arena_alloc(scratch.arena, 1024 * sizeof(int));
+        for (int i = 0; i < 1024; i++) {
+            tmp[i] = w->shared_data[i];
+            w->sum += tmp[i];
+        }
+    }
+    
+    /* Promote results into the parent */
+    for (int i = 0; i < 256; i++) {
+        int value = w->id * 1000 + i;
+        w->promoted[i] = myrtx_context_promote(w->fork, &value, sizeof(int));
+    }
+    
+    /* A large promotion bypasses the batch */
+    char big[MYRTX_CONTEXT_PROMOTE_BATCH / 2];
+    memset(big, w->id, sizeof(big));
+    char* big_copy = myrtx_context_promote(w->fork, big, sizeof(big));
+    if (!big_copy || big_copy[0] != w->id || big_copy[sizeof(big) - 1] != w->id) {
+        w->sum = -1;
+    }
+    
+    return NULL;
+}
+
+/* Test forking a context across threads */
+void test_context_fork(void) {
+    myrtx_context_t* parent = myrtx_context_create(NULL);
+    if (!parent) {
+        TEST_FAILED("Failed to create context");
+    }
+    
+    int* data = myrtx_context_alloc(parent, 1024 * sizeof(int));
+    int expected_sum = 0;
+    for (int i = 0; i < 1024; i++) {
+        data[i] = i;
+        expected_sum += i;
+    }
+    
+    enum { WORKERS = 4 };
+    fork_worker_t workers[WORKERS];
+    pthread_t threads[WORKERS];
+    
+    for (int i = 0; i < WORKERS; i++) {
+        memset(&workers[i], 0, sizeof(workers[i]));
+        workers[i].fork = myrtx_context_fork(parent);
+        if (!workers[i].fork) {
+            TEST_FAILED("Failed to fork context");
+        }
+        if (workers[i].fork->global_arena != parent->global_arena ||
+            workers[i].fork->owns_global_arena ||
+            workers[i].fork->temp_arena == parent->temp_arena) {
+            TEST_FAILED("Fork does not alias the parent's global arena only");
+        }
+        workers[i].shared_data = data;
+        workers[i].id = i + 1;
+    }
+    
+    /* A fork of a fork attaches to the original parent */
+    myrtx_context_t* nested = myrtx_context_fork(workers[0].fork);
+    if (!nested || nested->parent != parent) {
+        TEST_FAILED("Nested fork does not attach to the original parent");
+    }
+    myrtx_context_destroy(nested);
+    
+    for (int i = 0; i < WORKERS; i++) {
+        pthread_create(&threads[i], NULL, fork_worker, &workers[i]);
+    }
+    
+    /* The parent keeps allocating while forks promote */
+    for (int i = 0; i < 1000; i++) {
+        if (!myrtx_context_alloc(parent, 48)) {
+            TEST_FAILED("Parent allocation failed during fork activity");
+        }
+    }
+    
+    for (int i = 0; i < WORKERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    
+    for (int i = 0; i < WORKERS; i++) {
+        if (workers[i].sum != expected_sum) {
+            TEST_FAILED("Fork read wrong shared data or promotion failed");
+        }
+        myrtx_context_destroy(workers[i].fork);
+    }
+    
+    /* Promoted values outlive the forks */
+    for (int i = 0; i < WORKERS; i++) {
+        for (int j = 0; j < 256; j++) {
+            if (!workers[i].promoted[j] || *workers[i].promoted[j] != (i + 1) * 1000 + j) {
+                TEST_FAILED("Promoted value was lost");
+            }
+        }
+    }
+    
+    myrtx_context_destroy(parent);
+    
+    TEST_PASSED();
+}
+
+/* Test allocation telemetry */
+void test_context_stats(void) {
+    myrtx_context_stats_t before;
+    myrtx_context_stats_all(&before);
+    
+    myrtx_context_t* ctx = myrtx_context_create(NULL);
+    if (!ctx) {
+        TEST_FAILED("Failed to create context");
+    }
+    
+    if (!myrtx_context_alloc(ctx, 1000) || !myrtx_context_temp_alloc(ctx, 500)) {
+        TEST_FAILED("Allocation failed");
+    }
+    
+    /* One miss, then nested scratch: one hit and one miss, then two hits */
+    myrtx_scratch_arena_t a = {0}, b = {0};
+    myrtx_context_scratch_begin(ctx, &a);
+    myrtx_context_scratch_end(ctx, &a);
+    myrtx_context_scratch_begin(ctx, &a);
+    myrtx_context_scratch_begin(ctx, &b);
+    myrtx_context_scratch_end(ctx, &b);
+    myrtx_context_scratch_end(ctx, &a);
+    myrtx_context_scratch_begin(ctx, &a);
+    myrtx_context_scratch_end(ctx, &a);
+    
+    myrtx_context_set_error(ctx, 1, "first");
+    myrtx_context_set_error(ctx, 2, "second");
+    
+    myrtx_context_stats_t stats;
+    if (!myrtx_context_stats(ctx, &stats)) {
+        TEST_FAILED("myrtx_context_stats failed");
+    }
+    
+    if (stats.context_count != 1 || stats.global_used < 1000 || stats.temp_used < 500 ||
+        stats.global_blocks != 1 || stats.global_reserved != MYRTX_ARENA_DEFAULT_SIZE) {
+        TEST_FAILED("Arena figures are wrong");
+    }
+    if (stats.scratch_gets != 4 || stats.scratch_hits != 2 || stats.scratch_peak_depth != 2 ||
+        stats.scratch_hit_rate != 0.5) {
+        TEST_FAILED("Scratch pool figures are wrong");
+    }
+    if (stats.error_count != 2) {
+        TEST_FAILED("Error count is wrong");
+    }
+    
+    /* A fork does not count the parent's global arena again */
+    myrtx_context_t* fork = myrtx_context_fork(ctx);
+    myrtx_context_stats_t fork_stats;
+    myrtx_context_stats(fork, &fork_stats);
+    if (fork_stats.global_reserved != 0 || fork_stats.temp_reserved == 0) {
+        TEST_FAILED("Fork reports the parent's global arena");
+    }
+    
+    myrtx_context_stats_t all;
+    myrtx_context_stats_all(&all);
+    if (all.context_count != before.context_count + 2 ||
+        all.global_reserved != before.global_reserved + MYRTX_ARENA_DEFAULT_SIZE ||
+        all.scratch_gets != before.scratch_gets + 4 ||
+        all.error_count != before.error_count + 2) {
+        TEST_FAILED("Aggregate figures are wrong");
+    }
+    
+    myrtx_context_destroy(fork);
+    myrtx_context_destroy(ctx);
+    
+    myrtx_context_stats_all(&all);
+    if (all.context_count != before.context_count) {
+        TEST_FAILED("Destroyed contexts are still registered");
+    }
+    
+    TEST_PASSED();
+}
+
+/* Worker for test_context_stats_concurrent: allocates, uses scratch and sets errors */
+static void* stats_worker(void* arg) {
+    myrtx_context_t* ctx = (myrtx_context_t*)arg;
+    for (int i = 0; i < 2000; i++) {
+        myrtx_scratch_arena_t scratch = {0};
+        myrtx_context_scratch_begin(ctx, &scratch);
+        myrtx_arena_alloc(scratch.arena, 64 * 1024);
+        myrtx_context_scratch_end(ctx, &scratch);
+        myrtx_context_temp_alloc(ctx, 4096);
+        if (i % 100 == 99) {
+            myrtx_arena_reset(ctx->temp_arena);
+        }
+        myrtx_context_set_error(ctx, 1, "error %d", i);
+    }
+    return NULL;
+}
+
+/* Test aggregating telemetry while another thread updates it */
+void test_context_stats_concurrent(void) {
+    myrtx_context_t* ctx = myrtx_context_create(NULL);
+    if (!ctx) {
+        TEST_FAILED("Failed to create context");
+    }
+    
+    pthread_t thread;
+    pthread_create(&thread, NULL, stats_worker, ctx);
+    
+    /* Counters only grow while the worker runs */
+    uint64_t last_errors = 0;
+    myrtx_context_stats_t all;
+    for (int i = 0; i < 500; i++) {
+        myrtx_context_stats_all(&all);
+        if (all.error_count < last_errors) {
+            TEST_FAILED("Error count went backwards");
+        }
+        last_errors = all.error_count;
+    }
+    pthread_join(thread, NULL);
+    
+    myrtx_context_stats_t stats;
+    myrtx_context_stats(ctx, &stats);
+    if (stats.error_count != 2000 || stats.scratch_gets != 2000) {
+        TEST_FAILED("Counters lost updates");
+    }
+    
+    myrtx_context_destroy(ctx);
+    
+    TEST_PASSED();
+}
+
 int main(void) {
     printf("=== myrtx Context System Tests ===\n\n");
     
     test_context_create_destroy();
     test_context_memory();
     test_context_scratch_pool();
+    test_context_scratch_retained();
     test_context_scratch_macro();
     test_context_extensions();
     test_context_error_handling();
+    test_context_error_deferred();
     test_context_thread_local();
+    test_context_fork();
+    test_context_stats();
+    test_context_stats_concurrent();
     
     printf("\nAll context tests successful!\n");
     return 0;
@@ -0,0 +1,209 @@
+/**
+ * @file hash_file_test.c
+ * @brief Tests for read-only hash table files
+ */
+
+#include "myrtx/collections/hash_file.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_PASSED() printf("PASSED: %s\n", __func__)
+#define TEST_FAILED(msg) do { printf("FAILED: %s - %s\n", __func__, msg); exit(1); } while(0)
+
+#define TEST_FILE "hash_file_test.tmp"
+#define FILE_KEYS 5000
+
+static myrtx_hash_table_t* create_table(myrtx_hash_probing_t probing) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = probing;
+    options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+    return myrtx_hash_table_create_ex(&options);
+}
+
+/* Test that a file answers like the table it was written from */
+void test_write_and_open(void) {
+    for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT;
+         probing++) {
+        myrtx_hash_table_t* table = create_table((myrtx_hash_probing_t)probing);
+        if (!table) {
+            TEST_FAILED("Failed to create table");
+        }
+        /* Value sizes 0 to 24 bytes cover inline and allocated values and padding */
+        for (uint64_t key = 0; key < FILE_KEYS; key++) {
+            uint64_t value[3] = {key * 3, key * 3 + 1, key * 3 + 2};
+            myrtx_hash_table_put(table, &key, sizeof(key), value, (size_t)(key % 25));
+        }
+        for (uint64_t key = 0; key < FILE_KEYS; key += 5) {
+            myrtx_hash_table_remove(table, &key, sizeof(key), true, true);
+        }
+
+        if (!myrtx_hash_file_write(table, TEST_FILE)) {
+            TEST_FAILED("Failed to write file");
+        }
+        myrtx_hash_table_free(table, true, true);
+
+        myrtx_hash_file_t* file = myrtx_hash_file_open(TEST_FILE);
+        if (!file) {
+            TEST_FAILED("Failed to open file");
+        }
+        if (myrtx_hash_file_size(file) != FILE_KEYS - FILE_KEYS / 5) {
+            TEST_FAILED("Wrong entry count");
+        }
+        for (uint64_t key = 0; key < FILE_KEYS + 100; key++) {
+            const void* value = NULL;
+            size_t value_size = 0;
+            bool found = myrtx_hash_file_get(file, &key, sizeof(key), &value, &value_size);
+            bool expected = key < FILE_KEYS && key % 5 != 0;
+            if (found != expected || myrtx_hash_file_contains_key(file, &key, sizeof(key)) != expected) {
+                TEST_FAILED("Wrong membership");
+            }
+            if (!found) {
+                continue;
+            }
+            uint64_t expected_value[3] = {key * 3, key * 3 + 1, key * 3 + 2};
+            if (value_size != key % 25 || ((uintptr_t)value & 7) != 0 ||
+                memcmp(value, expected_value, value_size) != 0) {
+                TEST_FAILED("Wrong or misaligned value");
+            }
+        }
+        myrtx_hash_file_close(file);
+    }
+
+    remove(TEST_FILE);
+    TEST_PASSED();
+}
+
+/* Test string keys, including ones longer than the inline limit */
+void test_string_keys(void) {
+    myrtx_hash_table_t* table = myrtx_hash_table_create(NULL, 16, myrtx_hash_string,
+                                                        myrtx_compare_string_keys);
+    if (!table) {
+        TEST_FAILED("Failed to create table");
+    }
+    const char* keys[] = {"a", "dictionary", "a key that is longer than sixteen bytes"};
+    const char* values[] = {"first", "second", "a value that is longer than sixteen bytes"};
+    for (size_t i = 0; i < 3; i++) {
+        myrtx_hash_table_put(table, keys[i], 0, values[i], strlen(values[i]) + 1);
+    }
+    if (!myrtx_hash_file_write(table, TEST_FILE)) {
+        TEST_FAILED("Failed to write file");
+    }
+    myrtx_hash_table_free(table, true, true);
+
+    myrtx_hash_file_t* file = myrtx_hash_file_open(TEST_FILE);
+    if (!file) {
+        TEST_FAILED("Failed to open file");
+    }
+    for (size_t i = 0; i < 3; i++) {
+        const void* value;
+        if (!myrtx_hash_file_get(file, keys[i], 0, &value, NULL) ||
+            strcmp(value, values[i]) != 0) {
+            TEST_FAILED("Wrong value for a string key");
+        }
+    }
+    if (myrtx_hash_file_contains_key(file, "missing", 0)) {
+        TEST_FAILED("Found a missing key");
+    }
+    myrtx_hash_file_close(file);
+
+    remove(TEST_FILE);
+    TEST_PASSED();
+}
+
+/* Test an empty table and files that are not valid */
+void test_empty_and_invalid(void) {
+    myrtx_hash_table_t* table = create_table(MYRTX_HASH_PROBING_LINEAR);
+    if (!myrtx_hash_file_write(table, TEST_FILE)) {
+        TEST_FAILED("Failed to write an empty table");
+    }
+    myrtx_hash_file_t* file = myrtx_hash_file_open(TEST_FILE);
+    uint64_t key = 1;
+    if (!file || myrtx_hash_file_size(file) != 0 ||
+        myrtx_hash_file_contains_key(file, &key, sizeof(key))) {
+        TEST_FAILED("Empty file not read back as empty");
+    }
+    myrtx_hash_file_close(file);
+
+    myrtx_hash_table_put(table, &key, sizeof(key), &key, sizeof(key));
+    if (!myrtx_hash_file_write(table, TEST_FILE)) {
+        TEST_FAILED("Failed to write file");
+    }
+    myrtx_hash_table_free(table, true, true);
+
+    /* Read the file, then write back damaged copies */
+    FILE* in = fopen(TEST_FILE, "rb");
+    static unsigned char data[4096];
+    size_t size = in ? fread(data, 1, sizeof(data), in) : 0;
+    if (in) {
+        fclose(in);
+    }
+    if (size < 64) {
+        TEST_FAILED("Failed to read file back");
+    }
+
+    for (int damage = 0; damage < 3; damage++) {
+        FILE* out = fopen(TEST_FILE, "wb");
+        if (!out) {
+            TEST_FAILED("Failed to rewrite file");
+        }
+        if (damage == 0) {
+            fwrite(data, 1, size - 1, out);         /* Truncated */
+        } else {
+            unsigned char copy[4096];
+            memcpy(copy, data, size);
+            copy[damage == 1 ? 0 : 8] ^= 0xFF;     /* Magic, then version */
+            fwrite(copy, 1, size, out);
+        }
+        fclose(out);
+        if (myrtx_hash_file_open(TEST_FILE)) {
+            TEST_FAILED("Opened a damaged file");
+        }
+    }
+
+    /* A slot pointing at a misaligned record: the header still checks out */
+    uint64_t slot_count;
+    memcpy(&slot_count, data + 24, sizeof(slot_count));
+    for (uint64_t i = 0; i < slot_count; i++) {
+        unsigned char* slot = data + 64 + i * sizeof(uint64_t);
+        uint64_t value;
+        memcpy(&value, slot, sizeof(value));
+        if (value != 0) {
+            value += 1;
+            memcpy(slot, &value, sizeof(value));
+        }
+    }
+    FILE* out = fopen(TEST_FILE, "wb");
+    if (!out) {
+        TEST_FAILED("Failed to rewrite file");
+    }
+    fwrite(data, 1, size, out);
+    fclose(out);
+    file = myrtx_hash_file_open(TEST_FILE);
+    if (!file || myrtx_hash_file_contains_key(file, &key, sizeof(key))) {
+        TEST_FAILED("Misaligned record offset not rejected");
+    }
+    myrtx_hash_file_close(file);
+
+    remove(TEST_FILE);
+    if (myrtx_hash_file_open(TEST_FILE) || myrtx_hash_file_open(NULL) ||
+        myrtx_hash_file_write(NULL, TEST_FILE)) {
+        TEST_FAILED("Invalid arguments not rejected");
+    }
+    myrtx_hash_file_close(NULL);
+    TEST_PASSED();
+}
+
+int main(void) {
+    printf("=== myrtx Hash File Tests ===\n\n");
+
+    test_write_and_open();
+    test_string_keys();
+    test_empty_and_invalid();
+
+    printf("\nAll hash file tests successful!\n");
+    return 0;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file hash_multimap_test.c
+ * @brief Tests for the hash multimap
+ */
+
+#include "myrtx/collections/hash_multimap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_PASSED() printf("PASSED: %s\n", __func__)
+#define TEST_FAILED(msg) do { printf("FAILED: %s - %s\n", __func__, msg); exit(1); } while(0)
+
+#define MULTIMAP_KEYS 500
+
+static myrtx_hash_multimap_t* create_multimap(myrtx_arena_t* arena,
+                                              myrtx_hash_probing_t probing) {
+    myrtx_hash_table_options_t options = {0};
+    options.arena = arena;
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = probing;
+    return myrtx_hash_multimap_create(&options, sizeof(uint32_t));
+}
+
+/* Key k receives k % 7 + 1 values: k * 100, k * 100 + 1, ... */
+static void fill(myrtx_hash_multimap_t* map) {
+    for (uint32_t round = 0; round < 7; round++) {
+        for (uint64_t key = 0; key < MULTIMAP_KEYS; key++) {
+            if (round <= key % 7) {
+                uint32_t value = (uint32_t)key * 100 + round;
+                if (!myrtx_hash_multimap_add(map, &key, sizeof(key), &value)) {
+                    TEST_FAILED("Failed to add a value");
+                }
+            }
+        }
+    }
+}
+
+static void check_values(uint64_t key, const uint32_t* values, size_t count) {
+    if (count != key % 7 + 1 || !values) {
+        TEST_FAILED("Wrong number of values");
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (values[i] != (uint32_t)key * 100 + i) {
+            TEST_FAILED("Values not kept in insertion order");
+        }
+    }
+}
+
+/* Test add, get and remove under every probing strategy, with and without an arena */
+void test_basic_operations(void) {
+    for (int use_arena = 0; use_arena <= 1; use_arena++) {
+        for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT;
+             probing++) {
+            myrtx_arena_t arena = {0};
+            if (use_arena && !myrtx_arena_init(&arena, 0)) {
+                TEST_FAILED("Failed to initialize arena");
+            }
+            myrtx_hash_multimap_t* map =
+                create_multimap(use_arena ? &arena : NULL, (myrtx_hash_probing_t)probing);
+            if (!map) {
+                TEST_FAILED("Failed to create multimap");
+            }
+
+            fill(map);
+            size_t expected_values = 0;
+            for (uint64_t key = 0; key < MULTIMAP_KEYS; key++) {
+                size_t count;
+                const uint32_t* values = myrtx_hash_multimap_get(map, &key, sizeof(key), &count);
+                check_values(key, values, count);
+                expected_values += count;
+            }
+            if (myrtx_hash_multimap_key_count(map) != MULTIMAP_KEYS ||
+                myrtx_hash_multimap_value_count(map) != expected_values) {
+                TEST_FAILED("Wrong counts after adding");
+            }
+
+            for (uint64_t key = 0; key < MULTIMAP_KEYS; key += 3) {
+                if (!myrtx_hash_multimap_remove(map, &key, sizeof(key))) {
+                    TEST_FAILED("Failed to remove a key");
+                }
+                expected_values -= key % 7 + 1;
+            }
+            uint64_t missing = MULTIMAP_KEYS;
+            size_t count = 1;
+            if (myrtx_hash_multimap_remove(map, &missing, sizeof(missing)) ||
+                myrtx_hash_multimap_get(map, &missing, sizeof(missing), &count) || count != 0) {
+                TEST_FAILED("Missing key reported as present");
+            }
+            for (uint64_t key = 0; key < MULTIMAP_KEYS; key++) {
+                const uint32_t* values = myrtx_hash_multimap_get(map, &key, sizeof(key), &count);
+                if (key % 3 == 0) {
+                    if (values) {
+                        TEST_FAILED("Found a removed key");
+                    }
+                } else {
+                    check_values(key, values, count);
+                }
+            }
+            if (myrtx_hash_multimap_value_count(map) != expected_values) {
+                TEST_FAILED("Wrong value count after removing");
+            }
+
+            /* Re-adding a removed key starts a fresh value array */
+            uint64_t key = 0;
+            uint32_t value = 42;
+            if (!myrtx_hash_multimap_add(map, &key, sizeof(key), &value) ||
+                *(const uint32_t*)myrtx_hash_multimap_get(map, &key, sizeof(key), &count) != 42 ||
+                count != 1) {
+                TEST_FAILED("Re-added key has stale values");
+            }
+
+            myrtx_hash_multimap_free(map);
+            if (use_arena) {
+                myrtx_arena_free(&arena);
+            }
+        }
+    }
+
+    myrtx_hash_multimap_free(NULL);
+    myrtx_hash_table_options_t options = {0};
+    options.compare_function = myrtx_compare_integer_keys;
+    options.hash64_function = myrtx_hash64_bytes;
+    if (myrtx_hash_multimap_create(NULL, 4) || myrtx_hash_multimap_create(&options, 0)) {
+        TEST_FAILED("Invalid arguments not rejected");
+    }
+    TEST_PASSED();
+}
+
+/* Test long string keys and many values for one key */
+void test_string_keys(void) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash_function = myrtx_hash_string;
+    options.compare_function = myrtx_compare_string_keys;
+    myrtx_hash_multimap_t* map = myrtx_hash_multimap_create(&options, sizeof(uint64_t));
+    if (!map) {
+        TEST_FAILED("Failed to create multimap");
+    }
+
+    const char* long_key = "a key that is longer than sixteen bytes";
+    for (uint64_t i = 0; i < 10000; i++) {
+        if (!myrtx_hash_multimap_add(map, i % 2 ? long_key : "short", 0, &i)) {
+            TEST_FAILED("Failed to add a value");
+        }
+    }
+
+    size_t count;
+    const uint64_t* values = myrtx_hash_multimap_get(map, long_key, 0, &count);
+    if (!values || count != 5000) {
+        TEST_FAILED("Wrong number of values for the long key");
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (values[i] != 2 * i + 1) {
+            TEST_FAILED("Wrong value for the long key");
+        }
+    }
+    if (myrtx_hash_multimap_key_count(map) != 2 ||
+        myrtx_hash_multimap_value_count(map) != 10000) {
+        TEST_FAILED("Wrong counts");
+    }
+
+    myrtx_hash_multimap_free(map);
+    TEST_PASSED();
+}
+
+/* Test that iteration visits every key once with all its values */
+void test_iteration(void) {
+    myrtx_hash_multimap_t* map = create_multimap(NULL, MYRTX_HASH_PROBING_ROBIN_HOOD);
+    if (!map) {
+        TEST_FAILED("Failed to create multimap");
+    }
+    fill(map);
+
+    static unsigned char seen[MULTIMAP_KEYS];
+    memset(seen, 0, sizeof(seen));
+    size_t visited = 0;
+    myrtx_hash_multimap_iter_t iter;
+    const void* key;
+    size_t key_size;
+    const void* values;
+    size_t count;
+    myrtx_hash_multimap_iter_init(&iter, map);
+    while (myrtx_hash_multimap_iter_next(&iter, &key, &key_size, &values, &count)) {
+        uint64_t k;
+        memcpy(&k, key, sizeof(k));
+        if (key_size != sizeof(k) || k >= MULTIMAP_KEYS || seen[k]) {
+            TEST_FAILED("Iteration returned a wrong or repeated key");
+        }
+        seen[k] = 1;
+        check_values(k, values, count);
+        visited++;
+    }
+    if (visited != MULTIMAP_KEYS) {
+        TEST_FAILED("Iteration missed keys");
+    }
+
+    myrtx_hash_multimap_free(map);
+    TEST_PASSED();
+}
+
+int main(void) {
+    printf("=== myrtx Hash Multimap Tests ===\n\n");
+
+    test_basic_operations();
+    test_string_keys();
+    test_iteration();
+
+    printf("\nAll hash multimap tests successful!\n");
+    return 0;
+}
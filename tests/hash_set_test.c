@@ -0,0 +1,172 @@
+/**
+ * @file hash_set_test.c
+ * @brief Tests for the hash set
+ */
+
+#include "myrtx/collections/hash_set.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_PASSED() printf("PASSED: %s\n", __func__)
+#define TEST_FAILED(msg) do { printf("FAILED: %s - %s\n", __func__, msg); exit(1); } while(0)
+
+#define SET_KEYS 2000
+
+static myrtx_hash_set_t* create_set(myrtx_arena_t* arena, myrtx_hash_probing_t probing) {
+    myrtx_hash_table_options_t options = {0};
+    options.arena = arena;
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = probing;
+    return myrtx_hash_set_create(&options);
+}
+
+/* Test add, contains and remove under every probing strategy */
+void test_basic_operations(void) {
+    for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT;
+         probing++) {
+        myrtx_hash_set_t* set = create_set(NULL, (myrtx_hash_probing_t)probing);
+        if (!set) {
+            TEST_FAILED("Failed to create set");
+        }
+
+        for (uint64_t key = 0; key < SET_KEYS; key++) {
+            bool added = false;
+            if (!myrtx_hash_set_add(set, &key, sizeof(key), &added) || !added) {
+                TEST_FAILED("Failed to add a new key");
+            }
+        }
+        for (uint64_t key = 0; key < SET_KEYS; key += 2) {
+            bool added = true;
+            if (!myrtx_hash_set_add(set, &key, sizeof(key), &added) || added) {
+                TEST_FAILED("Added an existing key twice");
+            }
+        }
+        if (myrtx_hash_set_size(set) != SET_KEYS) {
+            TEST_FAILED("Wrong size after adding");
+        }
+
+        for (uint64_t key = 0; key < SET_KEYS; key += 2) {
+            if (!myrtx_hash_set_remove(set, &key, sizeof(key))) {
+                TEST_FAILED("Failed to remove a key");
+            }
+        }
+        uint64_t missing = SET_KEYS;
+        if (myrtx_hash_set_remove(set, &missing, sizeof(missing))) {
+            TEST_FAILED("Removed a missing key");
+        }
+        for (uint64_t key = 0; key < SET_KEYS + 10; key++) {
+            bool expected = key < SET_KEYS && key % 2 == 1;
+            if (myrtx_hash_set_contains(set, &key, sizeof(key)) != expected) {
+                TEST_FAILED("Wrong membership after removing");
+            }
+        }
+        if (myrtx_hash_set_size(set) != SET_KEYS / 2) {
+            TEST_FAILED("Wrong size after removing");
+        }
+
+        myrtx_hash_set_clear(set);
+        if (myrtx_hash_set_size(set) != 0) {
+            TEST_FAILED("Set not empty after clear");
+        }
+        uint64_t key = 1;
+        if (myrtx_hash_set_contains(set, &key, sizeof(key))) {
+            TEST_FAILED("Found a key after clear");
+        }
+        myrtx_hash_set_free(set);
+    }
+
+    myrtx_hash_set_free(NULL);
+    if (myrtx_hash_set_create(NULL) || myrtx_hash_set_size(NULL) != 0) {
+        TEST_FAILED("NULL arguments not rejected");
+    }
+    TEST_PASSED();
+}
+
+/* Test string keys on both sides of the 16-byte inline limit, in an arena */
+void test_string_keys(void) {
+    myrtx_arena_t arena = {0};
+    if (!myrtx_arena_init(&arena, 0)) {
+        TEST_FAILED("Failed to initialize arena");
+    }
+
+    myrtx_hash_table_options_t options = {0};
+    options.arena = &arena;
+    options.hash_function = myrtx_hash_string;
+    options.compare_function = myrtx_compare_string_keys;
+    myrtx_hash_set_t* set = myrtx_hash_set_create(&options);
+    if (!set) {
+        TEST_FAILED("Failed to create set");
+    }
+
+    const char* keys[] = {"a", "short key", "a key that is longer than sixteen bytes",
+                          "another rather long key for the set"};
+    for (size_t i = 0; i < 4; i++) {
+        if (!myrtx_hash_set_add(set, keys[i], 0, NULL)) {
+            TEST_FAILED("Failed to add a string key");
+        }
+    }
+    for (size_t i = 0; i < 4; i++) {
+        char copy[64];
+        strcpy(copy, keys[i]);
+        if (!myrtx_hash_set_contains(set, copy, 0)) {
+            TEST_FAILED("String key not found");
+        }
+    }
+    if (myrtx_hash_set_contains(set, "missing", 0)) {
+        TEST_FAILED("Found a missing string key");
+    }
+    if (!myrtx_hash_set_remove(set, keys[2], 0) || myrtx_hash_set_contains(set, keys[2], 0)) {
+        TEST_FAILED("Failed to remove a long string key");
+    }
+
+    myrtx_hash_set_free(set);
+    myrtx_arena_free(&arena);
+    TEST_PASSED();
+}
+
+/* Test that iteration visits every key exactly once */
+void test_iteration(void) {
+    myrtx_hash_set_t* set = create_set(NULL, MYRTX_HASH_PROBING_SWISS);
+    if (!set) {
+        TEST_FAILED("Failed to create set");
+    }
+    for (uint64_t key = 0; key < SET_KEYS; key++) {
+        myrtx_hash_set_add(set, &key, sizeof(key), NULL);
+    }
+
+    static unsigned char seen[SET_KEYS];
+    memset(seen, 0, sizeof(seen));
+    size_t visited = 0;
+    myrtx_hash_set_iter_t iter;
+    const void* key;
+    size_t key_size;
+    myrtx_hash_set_iter_init(&iter, set);
+    while (myrtx_hash_set_iter_next(&iter, &key, &key_size)) {
+        uint64_t k;
+        memcpy(&k, key, sizeof(k));
+        if (key_size != sizeof(k) || k >= SET_KEYS || seen[k]) {
+            TEST_FAILED("Iteration returned a wrong or repeated key");
+        }
+        seen[k] = 1;
+        visited++;
+    }
+    if (visited != SET_KEYS) {
+        TEST_FAILED("Iteration missed keys");
+    }
+
+    myrtx_hash_set_free(set);
+    TEST_PASSED();
+}
+
+int main(void) {
+    printf("=== myrtx Hash Set Tests ===\n\n");
+
+    test_basic_operations();
+    test_string_keys();
+    test_iteration();
+
+    printf("\nAll hash set tests successful!\n");
+    return 0;
+}
@@ -508,6 +508,1449 @@ void test_no_arena(void) {
     TEST_PASSED();
 }
 
+/* Run a random put/update/remove/get workload and compare with a plain array */
+static void run_reference_workload(const myrtx_hash_table_options_t* options, unsigned int seed) {
+    enum { KEY_RANGE = 3000, OPERATIONS = 60000 };
+    static int reference[KEY_RANGE];
+    static bool present[KEY_RANGE];
+    memset(present, 0, sizeof(present));
+    
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(options);
+    if (!table) {
+        TEST_FAILED("Failed to create hash table");
+    }
+    
+    size_t expected_size = 0;
+    srand(seed);
+    for (int op = 0; op < OPERATIONS; op++) {
+        int key = rand() % KEY_RANGE;
+        int action = rand() % 4;
+        
+        if (action <= 1) {
+            int value = rand();
+            if (!myrtx_hash_table_put(table, &key, sizeof(int), &value, sizeof(int))) {
+                TEST_FAILED("Put failed in reference workload");
+            }
+            if (!present[key]) {
+                present[key] = true;
+                expected_size++;
+            }
+            reference[key] = value;
+        } else if (action == 2) {
+            bool removed = myrtx_hash_table_remove(table, &key, sizeof(int), true, true);
+            if (removed != present[key]) {
+                TEST_FAILED("Remove result differs from reference");
+            }
+            if (removed) {
+                present[key] = false;
+                expected_size--;
+            }
+        } else {
+            void* out_value;
+            size_t out_size;
+            bool found = myrtx_hash_table_get(table, &key, sizeof(int), &out_value, &out_size);
+            if (found != present[key] ||
+                (found && (out_size != sizeof(int) || *(int*)out_value != reference[key]))) {
+                TEST_FAILED("Get result differs from reference");
+            }
+        }
+        
+        if (myrtx_hash_table_size(table) != expected_size) {
+            TEST_FAILED("Size differs from reference");
+        }
+    }
+    
+    /* Every key must still be found exactly as recorded */
+    for (int key = 0; key < KEY_RANGE; key++) {
+        if (myrtx_hash_table_contains_key(table, &key, sizeof(int)) != present[key]) {
+            TEST_FAILED("Final contents differ from reference");
+        }
+    }
+    
+    myrtx_hash_table_clear(table, true, true);
+    if (myrtx_hash_table_size(table) != 0 || myrtx_hash_table_contains_key(table, &(int){1}, sizeof(int))) {
+        TEST_FAILED("Clear left entries behind");
+    }
+    
+    myrtx_hash_table_free(table, true, true);
+}
+
+/* Test the Swiss table probing strategy */
+void test_swiss_probing(void) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash_function = myrtx_hash_integer;
+    options.compare_function = myrtx_compare_integer_keys;
+    
+    /* Same workload on the default strategy as a baseline */
+    run_reference_workload(&options, 1);
+    
+    /* Malloc-backed, starting small so the table grows and rehashes */
+    options.probing = MYRTX_HASH_PROBING_SWISS;
+    run_reference_workload(&options, 1);
+    
+    /* Arena-backed */
+    myrtx_arena_t arena = {0};
+    if (!myrtx_arena_init(&arena, 0)) {
+        TEST_FAILED("Failed to initialize arena");
+    }
+    options.arena = &arena;
+    run_reference_workload(&options, 2);
+    
+    /* Variable-length string keys */
+    options.arena = NULL;
+    options.hash_function = myrtx_hash_string;
+    options.compare_function = myrtx_compare_string_keys;
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+    if (!table) {
+        TEST_FAILED("Failed to create Swiss table with string keys");
+    }
+    char key[32];
+    for (int i = 0; i < 500; i++) {
+        sprintf(key, "key_%d", i);
+        if (!myrtx_hash_table_put(table, key, 0, &i, sizeof(int))) {
+            TEST_FAILED("Failed to put string key");
+        }
+    }
+    for (int i = 0; i < 500; i += 2) {
+        sprintf(key, "key_%d", i);
+        if (!myrtx_hash_table_remove(table, key, 0, true, true)) {
+            TEST_FAILED("Failed to remove string key");
+        }
+    }
+    for (int i = 0; i < 500; i++) {
+        void* out_value;
+        sprintf(key, "key_%d", i);
+        bool found = myrtx_hash_table_get(table, key, 0, &out_value, NULL);
+        if (found != (i % 2 == 1) || (found && *(int*)out_value != i)) {
+            TEST_FAILED("String key lookup wrong after removals");
+        }
+    }
+    myrtx_hash_table_free(table, true, true);
+    
+    /* Invalid probing values are rejected */
+    options.probing = (myrtx_hash_probing_t)99;
+    if (myrtx_hash_table_create_ex(&options) || myrtx_hash_table_create_ex(NULL)) {
+        TEST_FAILED("Invalid options accepted");
+    }
+    
+    myrtx_arena_free(&arena);
+    TEST_PASSED();
+}
+
+/* Test Robin Hood probing with backward-shift removal */
+void test_robin_hood_probing(void) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash_function = myrtx_hash_integer;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = MYRTX_HASH_PROBING_ROBIN_HOOD;
+    
+    run_reference_workload(&options, 3);
+    
+    /* Churn at a constant size: remove one key, insert a new one */
+    myrtx_hash_table_t* tables[2];
+    options.probing = MYRTX_HASH_PROBING_LINEAR;
+    tables[0] = myrtx_hash_table_create_ex(&options);
+    options.probing = MYRTX_HASH_PROBING_ROBIN_HOOD;
+    tables[1] = myrtx_hash_table_create_ex(&options);
+    if (!tables[0] || !tables[1]) {
+        TEST_FAILED("Failed to create tables");
+    }
+    
+    for (int t = 0; t < 2; t++) {
+        for (int key = 0; key < 100; key++) {
+            myrtx_hash_table_put(tables[t], &key, sizeof(int), &key, sizeof(int));
+        }
+    }
+    size_t start_capacity = myrtx_hash_table_capacity(tables[1]);
+    
+    for (int key = 100; key < 100000; key++) {
+        int old_key = key - 100;
+        for (int t = 0; t < 2; t++) {
+            if (!myrtx_hash_table_remove(tables[t], &old_key, sizeof(int), true, true) ||
+                !myrtx_hash_table_put(tables[t], &key, sizeof(int), &key, sizeof(int))) {
+                TEST_FAILED("Churn operation failed");
+            }
+        }
+    }
+    
+    if (myrtx_hash_table_capacity(tables[1]) != start_capacity) {
+        TEST_FAILED("Robin Hood table grew under churn");
+    }
+    if (myrtx_hash_table_capacity(tables[0]) <= start_capacity) {
+        TEST_FAILED("Expected the tombstone-based table to grow under churn");
+    }
+    
+    for (int key = 0; key < 100000; key++) {
+        void* out_value;
+        bool found = myrtx_hash_table_get(tables[1], &key, sizeof(int), &out_value, NULL);
+        if (found != (key >= 99900) || (found && *(int*)out_value != key)) {
+            TEST_FAILED("Lookup wrong after churn");
+        }
+    }
+    
+    myrtx_hash_table_free(tables[0], true, true);
+    myrtx_hash_table_free(tables[1], true, true);
+    
+    TEST_PASSED();
+}
+
+/* Test inline and joined key/value storage */
+void test_inline_storage(void) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash_function = myrtx_hash_integer;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+    
+    /* Same results as the reference on every backend, malloc and arena */
+    myrtx_arena_t arena;
+    if (!myrtx_arena_init(&arena, 0)) {
+        TEST_FAILED("Failed to initialize arena");
+    }
+    for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT; probing++) {
+        options.probing = (myrtx_hash_probing_t)probing;
+        options.arena = NULL;
+        run_reference_workload(&options, 11u + (unsigned int)probing);
+        options.arena = &arena;
+        run_reference_workload(&options, 21u + (unsigned int)probing);
+        myrtx_arena_reset(&arena);
+    }
+    myrtx_arena_free(&arena);
+    
+    /* All four combinations of small and large keys and values */
+    options.hash_function = myrtx_hash_string;
+    options.compare_function = myrtx_compare_string_keys;
+    options.probing = MYRTX_HASH_PROBING_LINEAR;
+    options.arena = NULL;
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+    if (!table) {
+        TEST_FAILED("Failed to create inline table");
+    }
+    
+    const char* keys[4] = {"short", "a key that is longer than sixteen bytes",
+                           "short 2", "another key that does not fit inline"};
+    char large_value[100];
+    memset(large_value, 'v', sizeof(large_value));
+    large_value[sizeof(large_value) - 1] = '\0';
+    for (int i = 0; i < 4; i++) {
+        const char* value = (i & 2) ? large_value : "small";
+        if (!myrtx_hash_table_put(table, keys[i], 0, value, strlen(value) + 1)) {
+            TEST_FAILED("Put failed for mixed sizes");
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        void* out_value;
+        size_t out_size;
+        const char* expected = (i & 2) ? large_value : "small";
+        if (!myrtx_hash_table_get(table, keys[i], 0, &out_value, &out_size) ||
+            out_size != strlen(expected) + 1 || strcmp(out_value, expected) != 0) {
+            TEST_FAILED("Get returned wrong value for mixed sizes");
+        }
+    }
+    
+    /* Grow a small value out of line and shrink a large one back */
+    if (!myrtx_hash_table_put(table, keys[1], 0, large_value, sizeof(large_value)) ||
+        !myrtx_hash_table_put(table, keys[3], 0, "tiny", 5)) {
+        TEST_FAILED("Update failed for mixed sizes");
+    }
+    void* out_value;
+    if (!myrtx_hash_table_get(table, keys[1], 0, &out_value, NULL) ||
+        strcmp(out_value, large_value) != 0 ||
+        !myrtx_hash_table_get(table, keys[3], 0, &out_value, NULL) ||
+        strcmp(out_value, "tiny") != 0) {
+        TEST_FAILED("Updated values are wrong");
+    }
+    
+    /* The table owns its storage; the free flags do not matter */
+    if (!myrtx_hash_table_remove(table, keys[3], 0, false, false) ||
+        myrtx_hash_table_contains_key(table, keys[3], 0)) {
+        TEST_FAILED("Remove failed for joined entry");
+    }
+    myrtx_hash_table_free(table, false, false);
+    
+    /* Unknown flags are rejected */
+    options.flags = 0x80000000u;
+    if (myrtx_hash_table_create_ex(&options) != NULL) {
+        TEST_FAILED("Unknown flag accepted");
+    }
+    
+    TEST_PASSED();
+}
+
+/* Test that updates which fit the stored value are written in place */
+void test_in_place_update(void) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash_function = myrtx_hash_integer;
+    options.compare_function = myrtx_compare_integer_keys;
+    
+    for (int inline_storage = 0; inline_storage <= 1; inline_storage++) {
+        options.flags = inline_storage ? MYRTX_HASH_TABLE_INLINE_STORAGE : 0;
+        myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+        if (!table) {
+            TEST_FAILED("Failed to create hash table");
+        }
+        
+        int key = 7;
+        double first = 1.5, second = 2.5;
+        void* before;
+        void* after;
+        myrtx_hash_table_put(table, &key, sizeof(int), &first, sizeof(double));
+        myrtx_hash_table_get(table, &key, sizeof(int), &before, NULL);
+        if (!myrtx_hash_table_put(table, &key, sizeof(int), &second, sizeof(double))) {
+            TEST_FAILED("Update failed");
+        }
+        myrtx_hash_table_get(table, &key, sizeof(int), &after, NULL);
+        if (before != after || *(double*)after != second) {
+            TEST_FAILED("Update that fits was not done in place");
+        }
+        
+        /* A smaller value also fits */
+        int smaller = 3;
+        size_t out_size;
+        myrtx_hash_table_put(table, &key, sizeof(int), &smaller, sizeof(int));
+        myrtx_hash_table_get(table, &key, sizeof(int), &after, &out_size);
+        if (before != after || out_size != sizeof(int) || *(int*)after != smaller) {
+            TEST_FAILED("Smaller update was not done in place");
+        }
+        
+        myrtx_hash_table_free(table, true, true);
+    }
+    
+    TEST_PASSED();
+}
+
+/* Test the seeded 64-bit hash family */
+void test_hash64(void) {
+    /* Published wyhash test vectors (seed = index) */
+    static const char* messages[] = {
+        "", "a", "abc", "message digest", "abcdefghijklmnopqrstuvwxyz",
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+        "12345678901234567890123456789012345678901234567890123456789012345678901234567890"
+    };
+    static const uint64_t expected[] = {
+        0x93228a4de0eec5a2ull, 0xc5bac3db178713c4ull, 0xa97f2f7b1d9b3314ull,
+        0x786d1f1df3801df4ull, 0xdca5a8138ad37c87ull, 0xb9e734f117cfaf70ull,
+        0x6cc5eab49a92d617ull
+    };
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        if (myrtx_hash64_bytes(messages[i], strlen(messages[i]), i) != expected[i] ||
+            myrtx_hash64_string(messages[i], 0, i) != expected[i]) {
+            TEST_FAILED("Hash differs from wyhash test vector");
+        }
+    }
+    
+    /* Unaligned keys hash like aligned ones, and the seed changes every size */
+    unsigned char buffer[80];
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (unsigned char)(i * 37 + 11);
+    }
+    for (size_t size = 0; size <= 64; size++) {
+        unsigned char aligned[64];
+        memcpy(aligned, buffer + 3, size);
+        if (myrtx_hash64_bytes(buffer + 3, size, 7) != myrtx_hash64_bytes(aligned, size, 7)) {
+            TEST_FAILED("Unaligned key hashes differently");
+        }
+        if (myrtx_hash64_bytes(aligned, size, 7) == myrtx_hash64_bytes(aligned, size, 8)) {
+            TEST_FAILED("Seed does not change the hash");
+        }
+    }
+    
+    /* Flipping one bit of an 8-byte key flips about half the output bits */
+    uint64_t key = 0x0123456789abcdefull;
+    uint64_t base = myrtx_hash64_bytes(&key, sizeof(key), 1);
+    int total = 0;
+    for (int bit = 0; bit < 64; bit++) {
+        uint64_t flipped = key ^ (1ull << bit);
+        uint64_t diff = base ^ myrtx_hash64_bytes(&flipped, sizeof(flipped), 1);
+        for (; diff; diff &= diff - 1) {
+            total++;
+        }
+    }
+    if (total < 64 * 24 || total > 64 * 40) {
+        TEST_FAILED("Poor avalanche on 8-byte keys");
+    }
+    
+    uint64_t seed1 = myrtx_hash_random_seed();
+    uint64_t seed2 = myrtx_hash_random_seed();
+    if (seed1 == 0 || seed2 == 0 || seed1 == seed2) {
+        TEST_FAILED("Random seeds are not distinct");
+    }
+    
+    /* Tables with a seeded hash behave like the reference on every backend */
+    myrtx_hash_table_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT; probing++) {
+        options.probing = (myrtx_hash_probing_t)probing;
+        run_reference_workload(&options, 31u + (unsigned int)probing);
+    }
+    
+    /* Exactly one hash function must be given */
+    options.hash_function = myrtx_hash_integer;
+    if (myrtx_hash_table_create_ex(&options) != NULL) {
+        TEST_FAILED("Two hash functions accepted");
+    }
+    options.hash_function = NULL;
+    options.hash64_function = NULL;
+    if (myrtx_hash_table_create_ex(&options) != NULL) {
+        TEST_FAILED("Missing hash function accepted");
+    }
+    
+    TEST_PASSED();
+}
+
+/* Test 64-bit integer keys with the default integer functions */
+void test_integer_key_size(void) {
+    int64_t a = 1, b = a + ((int64_t)1 << 32);
+    if (myrtx_hash_integer(&a, sizeof(a)) == myrtx_hash_integer(&b, sizeof(b)) ||
+        myrtx_compare_integer_keys(&a, sizeof(a), &b, sizeof(b))) {
+        TEST_FAILED("64-bit keys are truncated to int");
+    }
+    
+    myrtx_hash_table_t* table = myrtx_hash_table_create(NULL, 0, myrtx_hash_integer,
+                                                       myrtx_compare_integer_keys);
+    if (!table) {
+        TEST_FAILED("Failed to create hash table");
+    }
+    
+    /* Keys that differ only in their upper 32 bits */
+    for (int64_t i = 0; i < 1000; i++) {
+        int64_t key = i << 32;
+        if (!myrtx_hash_table_put(table, &key, sizeof(key), &i, sizeof(i))) {
+            TEST_FAILED("Put failed");
+        }
+    }
+    if (myrtx_hash_table_size(table) != 1000) {
+        TEST_FAILED("64-bit keys collapsed into each other");
+    }
+    for (int64_t i = 0; i < 1000; i++) {
+        int64_t key = i << 32;
+        void* value;
+        if (!myrtx_hash_table_get(table, &key, sizeof(key), &value, NULL) || *(int64_t*)value != i) {
+            TEST_FAILED("64-bit key lookup failed");
+        }
+    }
+    
+    myrtx_hash_table_free(table, true, true);
+    TEST_PASSED();
+}
+
+/* Test incremental resizing: the table grows a few slots at a time */
+void test_incremental_resize(void) {
+    myrtx_hash_table_options_t options = {0};
+    options.hash_function = myrtx_hash_integer;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.flags = MYRTX_HASH_TABLE_INCREMENTAL_RESIZE;
+    
+    /* Same results as the reference on every backend, malloc and arena */
+    myrtx_arena_t arena;
+    if (!myrtx_arena_init(&arena, 0)) {
+        TEST_FAILED("Failed to initialize arena");
+    }
+    for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT; probing++) {
+        options.probing = (myrtx_hash_probing_t)probing;
+        options.arena = NULL;
+        run_reference_workload(&options, 41u + (unsigned int)probing);
+        options.arena = &arena;
+        run_reference_workload(&options, 51u + (unsigned int)probing);
+        myrtx_arena_reset(&arena);
+        
+        options.arena = NULL;
+        options.flags |= MYRTX_HASH_TABLE_INLINE_STORAGE;
+        run_reference_workload(&options, 61u + (unsigned int)probing);
+        options.flags &= ~(unsigned int)MYRTX_HASH_TABLE_INLINE_STORAGE;
+    }
+    myrtx_arena_free(&arena);
+    
+    /* Every key stays visible while entries move between the arrays */
+    for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT; probing++) {
+        options.probing = (myrtx_hash_probing_t)probing;
+        myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+        if (!table) {
+            TEST_FAILED("Failed to create incremental table");
+        }
+        
+        enum { COUNT = 1500 };
+        for (int i = 0; i < COUNT; i++) {
+            if (!myrtx_hash_table_put(table, &i, sizeof(int), &i, sizeof(int))) {
+                TEST_FAILED("Put failed during incremental resize");
+            }
+            /* Remove every third key again, possibly from the old arrays */
+            if (i % 3 == 2) {
+                int victim = i - 1;
+                if (!myrtx_hash_table_remove(table, &victim, sizeof(int), true, true)) {
+                    TEST_FAILED("Remove failed during incremental resize");
+                }
+            }
+            for (int j = 0; j <= i; j++) {
+                bool expected = j % 3 != 1 || j == i;
+                if (myrtx_hash_table_contains_key(table, &j, sizeof(int)) != expected) {
+                    TEST_FAILED("Key lost during incremental resize");
+                }
+            }
+            /* Compact tables keep insertion order while they grow */
+            if (probing == MYRTX_HASH_PROBING_COMPACT) {
+                myrtx_hash_table_iter_t iter;
+                const void* key;
+                int previous = -1;
+                size_t seen = 0;
+                myrtx_hash_table_iter_init(&iter, table);
+                while (myrtx_hash_table_iter_next(&iter, &key, NULL, NULL, NULL)) {
+                    if (*(const int*)key <= previous) {
+                        TEST_FAILED("Compact table lost insertion order while growing");
+                    }
+                    previous = *(const int*)key;
+                    seen++;
+                }
+                if (seen != myrtx_hash_table_size(table)) {
+                    TEST_FAILED("Compact table iteration missed entries while growing");
+                }
+            }
+        }
+        
+        if (myrtx_hash_table_capacity(table) < COUNT) {
+            TEST_FAILED("Incremental table did not grow");
+        }
+        myrtx_hash_table_free(table, true, true);
+    }
+    
+    /* Unknown flags are still rejected */
+    options.flags = 1u << 30;
+    if (myrtx_hash_table_create_ex(&options) != NULL) {
+        TEST_FAILED("Unknown flag accepted");
+    }
+    
+    TEST_PASSED();
+}
+
+/* Bytes in use in an arena */
+static size_t arena_used(myrtx_arena_t* arena) {
+    size_t used;
+    myrtx_arena_stats(arena, NULL, &used, NULL);
+    return used;
+}
+
+/* Test that arena-backed tables reuse the arrays and buffers they release */
+void test_arena_recycling(void) {
+    enum { COUNT = 20000, ROUNDS = 12 };
+    static const unsigned int flag_sets[3] = {0, MYRTX_HASH_TABLE_INLINE_STORAGE,
+                                              MYRTX_HASH_TABLE_INCREMENTAL_RESIZE};
+    char small_value[24] = {0};
+    char large_value[200] = {0};
+    
+    for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT; probing++) {
+        for (int f = 0; f < 3; f++) {
+            myrtx_arena_t arena;
+            if (!myrtx_arena_init(&arena, 0)) {
+                TEST_FAILED("Failed to initialize arena");
+            }
+            myrtx_hash_table_options_t options = {0};
+            options.arena = &arena;
+            options.hash_function = myrtx_hash_integer;
+            options.compare_function = myrtx_compare_integer_keys;
+            options.probing = (myrtx_hash_probing_t)probing;
+            options.flags = flag_sets[f];
+            
+            /* Growing: keys and values fill the arrays left behind, so the
+             * arena holds little more than the arrays themselves */
+            size_t start = arena_used(&arena);
+            myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+            if (!table) {
+                TEST_FAILED("Failed to create arena table");
+            }
+            for (int i = 0; i < COUNT; i++) {
+                if (!myrtx_hash_table_put(table, &i, sizeof(int), small_value, sizeof(small_value))) {
+                    TEST_FAILED("Put failed in arena table");
+                }
+            }
+            size_t grown = arena_used(&arena) - start;
+            
+            myrtx_arena_t sizing;
+            if (!myrtx_arena_init(&sizing, 0)) {
+                TEST_FAILED("Failed to initialize arena");
+            }
+            myrtx_hash_table_options_t presized = options;
+            presized.arena = &sizing;
+            presized.initial_capacity = myrtx_hash_table_capacity(table);
+            if (!myrtx_hash_table_create_ex(&presized)) {
+                TEST_FAILED("Failed to create presized table");
+            }
+            size_t array_bytes = arena_used(&sizing);
+            myrtx_arena_free(&sizing);
+            
+            /* The outgrown arrays add up to less than the last one. Without
+             * reuse the values (COUNT * 24 bytes) would come on top. */
+            if (grown > 2 * array_bytes + COUNT * sizeof(small_value) / 8) {
+                TEST_FAILED("Growing does not reuse outgrown arrays");
+            }
+            
+            /* Updates between value sizes and remove/reinsert cycles reach a steady state */
+            size_t steady = 0;
+            for (int round = 0; round < ROUNDS; round++) {
+                for (int i = 0; i < COUNT; i++) {
+                    bool large = (round + i) % 2 == 0;
+                    if (!myrtx_hash_table_put(table, &i, sizeof(int), large ? large_value : small_value,
+                                              large ? sizeof(large_value) : sizeof(small_value))) {
+                        TEST_FAILED("Update failed in arena table");
+                    }
+                }
+                for (int i = 0; i < COUNT; i += 2) {
+                    if (!myrtx_hash_table_remove(table, &i, sizeof(int), true, true) ||
+                        !myrtx_hash_table_put(table, &i, sizeof(int), small_value, sizeof(small_value))) {
+                        TEST_FAILED("Remove/reinsert failed in arena table");
+                    }
+                }
+                if (round == 3) {
+                    steady = arena_used(&arena);
+                }
+            }
+            if (arena_used(&arena) != steady) {
+                TEST_FAILED("Arena table keeps growing under updates");
+            }
+            
+            for (int i = 0; i < COUNT; i++) {
+                void* value;
+                size_t value_size;
+                if (!myrtx_hash_table_get(table, &i, sizeof(int), &value, &value_size)) {
+                    TEST_FAILED("Entry lost in arena table");
+                }
+            }
+            
+            myrtx_arena_free(&arena);
+        }
+    }
+    
+    TEST_PASSED();
+}
+
+/* Count how often each key in [0, range) is visited by an iterator */
+static void check_iteration(const myrtx_hash_table_t* table, int range, const bool* present) {
+    static int seen[4096];
+    memset(seen, 0, sizeof(seen));
+    
+    myrtx_hash_table_iter_t iter;
+    myrtx_hash_table_iter_init(&iter, table);
+    const void* key;
+    size_t key_size;
+    void* value;
+    size_t visited = 0;
+    while (myrtx_hash_table_iter_next(&iter, &key, &key_size, &value, NULL)) {
+        int k = *(const int*)key;
+        if (key_size != sizeof(int) || k < 0 || k >= range || *(int*)value != k * 3) {
+            TEST_FAILED("Iterator returned a wrong entry");
+        }
+        seen[k]++;
+        visited++;
+    }
+    if (visited != myrtx_hash_table_size(table)) {
+        TEST_FAILED("Iterator count differs from table size");
+    }
+    for (int k = 0; k < range; k++) {
+        if (seen[k] != (present[k] ? 1 : 0)) {
+            TEST_FAILED("Iterator missed or repeated an entry");
+        }
+    }
+}
+
+/* Test iteration on every backend and the insertion order of compact tables */
+void test_iteration(void) {
+    enum { RANGE = 4096 };
+    static bool present[RANGE];
+    myrtx_hash_table_options_t options = {0};
+    options.hash_function = myrtx_hash_integer;
+    options.compare_function = myrtx_compare_integer_keys;
+    
+    /* Every entry exactly once, also in the middle of an incremental resize */
+    for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT; probing++) {
+        for (unsigned int flags = 0; flags <= MYRTX_HASH_TABLE_INCREMENTAL_RESIZE;
+             flags += MYRTX_HASH_TABLE_INCREMENTAL_RESIZE) {
+            options.probing = (myrtx_hash_probing_t)probing;
+            options.flags = flags;
+            myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+            if (!table) {
+                TEST_FAILED("Failed to create hash table");
+            }
+            memset(present, 0, sizeof(present));
+            check_iteration(table, RANGE, present);
+            
+            srand(71u + (unsigned int)probing);
+            for (int op = 0; op < 3000; op++) {
+                int key = rand() % RANGE;
+                int value = key * 3;
+                if (rand() % 4 == 0) {
+                    myrtx_hash_table_remove(table, &key, sizeof(int), true, true);
+                    present[key] = false;
+                } else {
+                    if (!myrtx_hash_table_put(table, &key, sizeof(int), &value, sizeof(int))) {
+                        TEST_FAILED("Put failed");
+                    }
+                    present[key] = true;
+                }
+                if (op % 97 == 0) {
+                    check_iteration(table, RANGE, present);
+                }
+            }
+            check_iteration(table, RANGE, present);
+            myrtx_hash_table_free(table, true, true);
+        }
+    }
+    
+    /* Compact tables iterate in insertion order; updates keep the position,
+     * removed and re-added keys move to the end */
+    options.probing = MYRTX_HASH_PROBING_COMPACT;
+    options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+    myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+    if (!table) {
+        TEST_FAILED("Failed to create compact table");
+    }
+    
+    static int order[RANGE];
+    int count = 0;
+    for (int i = 0; i < 1000; i++) {
+        int key = (i * 7919) % 1000;
+        int value = key * 3;
+        myrtx_hash_table_put(table, &key, sizeof(int), &value, sizeof(int));
+        order[count++] = key;
+    }
+    for (int i = 0; i < 1000; i += 3) {
+        int key = order[i];
+        int value = key * 3;
+        myrtx_hash_table_put(table, &key, sizeof(int), &value, sizeof(int));
+    }
+    for (int i = 0; i < 1000; i += 5) {
+        myrtx_hash_table_remove(table, &order[i], sizeof(int), true, true);
+    }
+    for (int i = 0; i < 1000; i += 10) {
+        int key = order[i];
+        int value = key * 3;
+        myrtx_hash_table_put(table, &key, sizeof(int), &value, sizeof(int));
+        order[count++] = key;
+    }
+    
+    myrtx_hash_table_iter_t iter;
+    myrtx_hash_table_iter_init(&iter, table);
+    const void* key;
+    int expected = 0;
+    while (myrtx_hash_table_iter_next(&iter, &key, NULL, NULL, NULL)) {
+        /* Skip positions whose key was removed (and possibly re-added later) */
+        while (expected < count && expected < 1000 && expected % 5 == 0) {
+            expected++;
+        }
+        if (expected >= count || *(const int*)key != order[expected]) {
+            TEST_FAILED("Compact table does not iterate in insertion order");
+        }
+        expected++;
+    }
+    if (expected != count) {
+        TEST_FAILED("Compact table iteration ended early");
+    }
+    
+    /* Remove/insert churn compacts the entries instead of growing */
+    size_t capacity = myrtx_hash_table_capacity(table);
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 200; i++) {
+            int k = 10000 + round * 200 + i;
+            myrtx_hash_table_put(table, &k, sizeof(int), &k, sizeof(int));
+        }
+        for (int i = 0; i < 200; i++) {
+            int k = 10000 + round * 200 + i;
+            myrtx_hash_table_remove(table, &k, sizeof(int), true, true);
+        }
+    }
+    if (myrtx_hash_table_capacity(table) > capacity * 2 || myrtx_hash_table_size(table) != 900) {
+        TEST_FAILED("Compact table grows under churn");
+    }
+    
+    myrtx_hash_table_free(table, true, true);
+    TEST_PASSED();
+}
+
+/* Test batched lookups and inserts against the single-key functions */
+void test_batch(void) {
+    enum { COUNT = 1000 };
+    static int keys[COUNT], values[COUNT];
+    static const void* key_ptrs[COUNT];
+    static const void* value_ptrs[COUNT];
+    static size_t key_sizes[COUNT], value_sizes[COUNT];
+    static void* found_values[COUNT];
+    
+    for (int i = 0; i < COUNT; i++) {
+        /* Every tenth key repeats an earlier one; the later value must win */
+        keys[i] = (i % 10 == 9) ? i - 5 : i;
+        values[i] = i * 7;
+        key_ptrs[i] = &keys[i];
+        value_ptrs[i] = &values[i];
+        key_sizes[i] = sizeof(int);
+        value_sizes[i] = sizeof(int);
+    }
+    
+    myrtx_hash_table_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    
+    for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT; probing++) {
+        for (unsigned int flags = 0; flags <= MYRTX_HASH_TABLE_INCREMENTAL_RESIZE;
+             flags += MYRTX_HASH_TABLE_INCREMENTAL_RESIZE) {
+            options.probing = (myrtx_hash_probing_t)probing;
+            options.flags = flags | MYRTX_HASH_TABLE_INLINE_STORAGE;
+            myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+            if (!table) {
+                TEST_FAILED("Failed to create hash table");
+            }
+            
+            /* Grows from the default capacity in the middle of batches */
+            if (myrtx_hash_table_put_batch(table, COUNT, key_ptrs, key_sizes,
+                                           value_ptrs, value_sizes) != COUNT) {
+                TEST_FAILED("put_batch failed");
+            }
+            if (myrtx_hash_table_size(table) != COUNT - COUNT / 10) {
+                TEST_FAILED("Wrong size after put_batch");
+            }
+            
+            /* Keys 0..COUNT-1 again: the repeats' own numbers were never stored */
+            static int lookup[COUNT];
+            static const void* lookup_ptrs[COUNT];
+            size_t found_sizes[COUNT];
+            for (int i = 0; i < COUNT; i++) {
+                lookup[i] = i;
+                lookup_ptrs[i] = &lookup[i];
+            }
+            size_t found = myrtx_hash_table_get_batch(table, COUNT, lookup_ptrs, key_sizes,
+                                                      found_values, found_sizes);
+            if (found != COUNT - COUNT / 10) {
+                TEST_FAILED("Wrong number of keys found by get_batch");
+            }
+            for (int i = 0; i < COUNT; i++) {
+                void* value = NULL;
+                bool single = myrtx_hash_table_get(table, &i, sizeof(int), &value, NULL);
+                if (single != (found_values[i] != NULL) || (single && value != found_values[i])) {
+                    TEST_FAILED("get_batch disagrees with get");
+                }
+                if (single && found_sizes[i] != sizeof(int)) {
+                    TEST_FAILED("Wrong value size from get_batch");
+                }
+                int expected = (i % 10 == 4) ? (i + 5) * 7 : i * 7;
+                if (single && *(int*)value != expected) {
+                    TEST_FAILED("Wrong value after put_batch");
+                }
+            }
+            
+            myrtx_hash_table_free(table, true, true);
+        }
+    }
+    
+    /* String keys without a size array */
+    myrtx_hash_table_t* table = myrtx_hash_table_create(NULL, 0, myrtx_hash_string,
+                                                        myrtx_compare_string_keys);
+    const void* words[] = {"alpha", "beta", "gamma"};
+    const void* word_values[] = {"1", "22", "333"};
+    size_t word_value_sizes[] = {2, 3, 4};
+    if (!table || myrtx_hash_table_put_batch(table, 3, words, NULL, word_values,
+                                             word_value_sizes) != 3) {
+        TEST_FAILED("put_batch with string keys failed");
+    }
+    const void* queries[] = {"gamma", "delta", "alpha"};
+    if (myrtx_hash_table_get_batch(table, 3, queries, NULL, found_values, NULL) != 2 ||
+        strcmp(found_values[0], "333") != 0 || found_values[1] != NULL ||
+        strcmp(found_values[2], "1") != 0) {
+        TEST_FAILED("Wrong get_batch result for string keys");
+    }
+    myrtx_hash_table_free(table, true, true);
+    
+    TEST_PASSED();
+}
+
+/* Merge function for test_get_or_insert: adds an int to the stored int */
+static void merge_add(void* stored_value, size_t stored_size, const void* value,
+                      size_t value_size, void* user_data) {
+    (void)stored_size;
+    (void)value_size;
+    *(int*)stored_value += *(const int*)value;
+    (*(int*)user_data)++;
+}
+
+/* Test single-probe counting with get_or_insert and upsert */
+void test_get_or_insert(void) {
+    enum { KEYS = 300, ROUNDS = 5 };
+    myrtx_hash_table_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    
+    for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT; probing++) {
+        for (unsigned int flags = 0; flags <= 3; flags++) {
+            options.probing = (myrtx_hash_probing_t)probing;
+            options.flags = flags;
+            myrtx_hash_table_t* counts = myrtx_hash_table_create_ex(&options);
+            myrtx_hash_table_t* sums = myrtx_hash_table_create_ex(&options);
+            if (!counts || !sums) {
+                TEST_FAILED("Failed to create hash table");
+            }
+            
+            int merges = 0;
+            for (int round = 0; round < ROUNDS; round++) {
+                for (int key = 0; key < KEYS; key++) {
+                    int zero = 0;
+                    bool inserted = false;
+                    int* count = myrtx_hash_table_get_or_insert(counts, &key, sizeof(int), &zero,
+                                                                sizeof(int), &inserted);
+                    if (!count || inserted != (round == 0)) {
+                        TEST_FAILED("get_or_insert returned the wrong slot");
+                    }
+                    (*count)++;
+                    
+                    if (!myrtx_hash_table_upsert(sums, &key, sizeof(int), &key, sizeof(int),
+                                                 merge_add, &merges)) {
+                        TEST_FAILED("upsert failed");
+                    }
+                }
+            }
+            
+            if (merges != KEYS * (ROUNDS - 1)) {
+                TEST_FAILED("upsert merged the wrong number of times");
+            }
+            if (myrtx_hash_table_size(counts) != KEYS || myrtx_hash_table_size(sums) != KEYS) {
+                TEST_FAILED("Wrong size after counting");
+            }
+            for (int key = 0; key < KEYS; key++) {
+                void* value;
+                if (!myrtx_hash_table_get(counts, &key, sizeof(int), &value, NULL) ||
+                    *(int*)value != ROUNDS) {
+                    TEST_FAILED("Wrong count");
+                }
+                if (!myrtx_hash_table_get(sums, &key, sizeof(int), &value, NULL) ||
+                    *(int*)value != key * ROUNDS) {
+                    TEST_FAILED("Wrong sum");
+                }
+            }
+            
+            myrtx_hash_table_free(counts, true, true);
+            myrtx_hash_table_free(sums, true, true);
+        }
+    }
+    
+    /* A string key, and the inserted flag may be omitted */
+    myrtx_hash_table_t* table = myrtx_hash_table_create(NULL, 0, myrtx_hash_string,
+                                                        myrtx_compare_string_keys);
+    long zero = 0;
+    long* total = myrtx_hash_table_get_or_insert(table, "total", 0, &zero, sizeof(long), NULL);
+    if (!total) {
+        TEST_FAILED("get_or_insert with a string key failed");
+    }
+    *total = 42;
+    void* value;
+    if (!myrtx_hash_table_get(table, "total", 0, &value, NULL) || *(long*)value != 42) {
+        TEST_FAILED("Update through the returned pointer was lost");
+    }
+    if (myrtx_hash_table_get_or_insert(table, "total", 0, NULL, sizeof(long), NULL) ||
+        myrtx_hash_table_upsert(table, "total", 0, &zero, sizeof(long), NULL, NULL)) {
+        TEST_FAILED("Accepted invalid arguments");
+    }
+    myrtx_hash_table_free(table, true, true);
+    
+    TEST_PASSED();
+}
+
+/* Test the _with_hash functions on tables that share one hash */
+void test_with_hash(void) {
+    enum { COUNT = 500 };
+    myrtx_hash_table_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    options.seed = 0x5eed;
+    options.compare_function = myrtx_compare_integer_keys;
+    
+    /* Same function and seed, different layouts: one hash fits all */
+    options.probing = MYRTX_HASH_PROBING_SWISS;
+    myrtx_hash_table_t* cache = myrtx_hash_table_create_ex(&options);
+    options.probing = MYRTX_HASH_PROBING_ROBIN_HOOD;
+    options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE | MYRTX_HASH_TABLE_INCREMENTAL_RESIZE;
+    myrtx_hash_table_t* index = myrtx_hash_table_create_ex(&options);
+    if (!cache || !index) {
+        TEST_FAILED("Failed to create hash tables");
+    }
+    
+    for (int key = 0; key < COUNT; key++) {
+        uint64_t hash = myrtx_hash_table_hash(cache, &key, sizeof(int));
+        if (hash != myrtx_hash_table_hash(index, &key, sizeof(int))) {
+            TEST_FAILED("Tables with the same seed disagree on a hash");
+        }
+        int value = key * 2;
+        if (!myrtx_hash_table_put_with_hash(cache, &key, sizeof(int), &value, sizeof(int), hash) ||
+            !myrtx_hash_table_put_with_hash(index, &key, sizeof(int), &value, sizeof(int), hash)) {
+            TEST_FAILED("put_with_hash failed");
+        }
+    }
+    
+    for (int key = 0; key < COUNT; key++) {
+        uint64_t hash = myrtx_hash_table_hash(cache, &key, sizeof(int));
+        void* value;
+        /* Entries stored with a supplied hash are found without one, and vice versa */
+        if (!myrtx_hash_table_get(cache, &key, sizeof(int), &value, NULL) ||
+            *(int*)value != key * 2 ||
+            !myrtx_hash_table_get_with_hash(index, &key, sizeof(int), hash, &value, NULL) ||
+            *(int*)value != key * 2 ||
+            !myrtx_hash_table_contains_key_with_hash(index, &key, sizeof(int), hash)) {
+            TEST_FAILED("Lookup after put_with_hash failed");
+        }
+        if (key % 2 == 0 &&
+            !myrtx_hash_table_remove_with_hash(index, &key, sizeof(int), hash, true, true)) {
+            TEST_FAILED("remove_with_hash failed");
+        }
+    }
+    for (int key = 0; key < COUNT; key++) {
+        if (myrtx_hash_table_contains_key(index, &key, sizeof(int)) != (key % 2 != 0)) {
+            TEST_FAILED("Wrong membership after remove_with_hash");
+        }
+    }
+    myrtx_hash_table_free(cache, true, true);
+    myrtx_hash_table_free(index, true, true);
+    
+    /* 32-bit hash functions and string keys */
+    myrtx_hash_table_t* strings = myrtx_hash_table_create(NULL, 0, myrtx_hash_string,
+                                                          myrtx_compare_string_keys);
+    uint64_t hash = myrtx_hash_table_hash(strings, "key", 0);
+    if (hash != myrtx_hash_table_hash(strings, "key", 4)) {
+        TEST_FAILED("Implicit and explicit string sizes hash differently");
+    }
+    int value = 7;
+    void* found;
+    if (!myrtx_hash_table_put_with_hash(strings, "key", 4, &value, sizeof(int), hash) ||
+        !myrtx_hash_table_get(strings, "key", 0, &found, NULL) || *(int*)found != 7 ||
+        !myrtx_hash_table_remove_with_hash(strings, "key", 0, hash, true, true) ||
+        myrtx_hash_table_size(strings) != 0) {
+        TEST_FAILED("String key with a supplied hash failed");
+    }
+    myrtx_hash_table_free(strings, true, true);
+    
+    TEST_PASSED();
+}
+
+/* Every key hashes to the same home slot */
+static uint32_t constant_hash(const void* key, size_t key_size) {
+    (void)key;
+    (void)key_size;
+    return 42;
+}
+
+/* Test occupancy and probe-length diagnostics on good and clustering hashes */
+void test_stats(void) {
+    enum { COUNT = 200 };
+    const myrtx_hash_probing_t strategies[] = {
+        MYRTX_HASH_PROBING_LINEAR, MYRTX_HASH_PROBING_SWISS,
+        MYRTX_HASH_PROBING_ROBIN_HOOD, MYRTX_HASH_PROBING_COMPACT
+    };
+    
+    for (size_t s = 0; s < sizeof(strategies) / sizeof(strategies[0]); s++) {
+        for (int clustered = 0; clustered < 2; clustered++) {
+            myrtx_hash_table_options_t options = {0};
+            options.compare_function = myrtx_compare_integer_keys;
+            options.probing = strategies[s];
+            if (clustered) {
+                options.hash_function = constant_hash;
+            } else {
+                options.hash64_function = myrtx_hash64_bytes;
+                options.flags = MYRTX_HASH_TABLE_INLINE_STORAGE;
+            }
+            myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+            if (!table) {
+                TEST_FAILED("Failed to create hash table");
+            }
+            
+            for (int key = 0; key < COUNT; key++) {
+                double value = key;
+                myrtx_hash_table_put(table, &key, sizeof(int), &value, sizeof(value));
+            }
+            for (int key = 0; key < COUNT; key += 4) {
+                myrtx_hash_table_remove(table, &key, sizeof(int), true, true);
+            }
+            size_t size = COUNT - COUNT / 4;
+            
+            myrtx_hash_table_stats_t stats;
+            myrtx_hash_table_stats(table, &stats);
+            if (stats.size != size || stats.capacity != myrtx_hash_table_capacity(table) ||
+                stats.expired != 0 || stats.load != (double)size / (double)stats.capacity) {
+                TEST_FAILED("Wrong size, capacity or load");
+            }
+            
+            size_t counted = 0;
+            for (size_t i = 0; i < MYRTX_HASH_STATS_BUCKETS; i++) {
+                counted += stats.probe_histogram[i];
+            }
+            if (counted != size || stats.max_probe_length < 1 ||
+                stats.average_probe_length < 1.0 ||
+                stats.average_probe_length > (double)stats.max_probe_length) {
+                TEST_FAILED("Inconsistent probe lengths");
+            }
+            
+            if (clustered) {
+                /* One long run: every lookup walks past the keys stored
+                 * before it, a group at a time in Swiss tables */
+                bool swiss = strategies[s] == MYRTX_HASH_PROBING_SWISS;
+                if (stats.average_probe_length < (swiss ? 3.0 : COUNT / 4) ||
+                    (!swiss && stats.probe_histogram[MYRTX_HASH_STATS_BUCKETS - 1] == 0)) {
+                    TEST_FAILED("Clustering not visible in the probe lengths");
+                }
+                if (stats.key_bytes != size * sizeof(int) ||
+                    stats.value_bytes != size * sizeof(double)) {
+                    TEST_FAILED("Wrong key or value bytes for copied entries");
+                }
+            } else {
+                /* Robin Hood reaches about 2.8 for unlucky seeds */
+                if (stats.average_probe_length > 4.0) {
+                    TEST_FAILED("Probe lengths too long for a good hash");
+                }
+                if (stats.key_bytes != 0 || stats.value_bytes != 0) {
+                    TEST_FAILED("Inline keys and values counted outside the slots");
+                }
+            }
+            if (stats.slot_bytes < stats.capacity * 32) {
+                TEST_FAILED("Slot bytes smaller than the entry array");
+            }
+            
+            myrtx_hash_table_free(table, true, true);
+        }
+    }
+    
+    /* During an incremental resize both arrays are walked */
+    myrtx_hash_table_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.flags = MYRTX_HASH_TABLE_INCREMENTAL_RESIZE;
+    myrtx_hash_table_t* growing = myrtx_hash_table_create_ex(&options);
+    for (int key = 0; key < 13; key++) {
+        myrtx_hash_table_put(growing, &key, sizeof(int), &key, sizeof(int));
+    }
+    myrtx_hash_table_stats_t stats;
+    myrtx_hash_table_stats(growing, &stats);
+    size_t counted = 0;
+    for (size_t i = 0; i < MYRTX_HASH_STATS_BUCKETS; i++) {
+        counted += stats.probe_histogram[i];
+    }
+    if (counted != 13 || stats.capacity != 32 ||
+        stats.slot_bytes <= stats.capacity * sizeof(void*) * 4) {
+        TEST_FAILED("Stats during an incremental resize");
+    }
+    myrtx_hash_table_free(growing, true, true);
+    
+    myrtx_hash_table_stats(NULL, &stats);
+    if (stats.capacity != 0 || stats.size != 0) {
+        TEST_FAILED("Stats of a NULL table are not zero");
+    }
+    
+    TEST_PASSED();
+}
+
+/* Test generation-tagged clearing across the wraparound */
+void test_generations(void) {
+    enum { COUNT = 40, ROUNDS = MYRTX_HASH_TABLE_GENERATIONS_MAX + 100 };
+    const myrtx_hash_probing_t strategies[] = {
+        MYRTX_HASH_PROBING_LINEAR, MYRTX_HASH_PROBING_SWISS,
+        MYRTX_HASH_PROBING_ROBIN_HOOD, MYRTX_HASH_PROBING_COMPACT
+    };
+    const unsigned int flags[] = {
+        MYRTX_HASH_TABLE_GENERATIONS | MYRTX_HASH_TABLE_INLINE_STORAGE,
+        MYRTX_HASH_TABLE_GENERATIONS | MYRTX_HASH_TABLE_INLINE_STORAGE |
+            MYRTX_HASH_TABLE_INCREMENTAL_RESIZE,
+        MYRTX_HASH_TABLE_GENERATIONS
+    };
+    
+    for (size_t s = 0; s < sizeof(strategies) / sizeof(strategies[0]); s++) {
+        for (size_t f = 0; f < sizeof(flags) / sizeof(flags[0]); f++) {
+            for (int use_arena = 0; use_arena < 2; use_arena++) {
+                myrtx_arena_t arena = {0};
+                if (use_arena && !myrtx_arena_init(&arena, 0)) {
+                    TEST_FAILED("Failed to initialize arena");
+                }
+                
+                myrtx_hash_table_options_t options = {0};
+                options.arena = use_arena ? &arena : NULL;
+                options.hash64_function = myrtx_hash64_bytes;
+                options.compare_function = myrtx_compare_integer_keys;
+                options.probing = strategies[s];
+                options.flags = flags[f];
+                myrtx_hash_table_t* table = myrtx_hash_table_create_ex(&options);
+                if (!table) {
+                    TEST_FAILED("Failed to create hash table");
+                }
+                
+                for (int round = 0; round < ROUNDS; round++) {
+                    /* Every third round stores values outside the slots */
+                    char value[32] = {0};
+                    size_t value_size = round % 3 == 0 ? sizeof(value) : sizeof(int);
+                    int count = COUNT / 2 + round % COUNT;
+                    
+                    for (int i = 0; i < count; i++) {
+                        int key = round % 7 * 1000 + i;
+                        memcpy(value, &key, sizeof(int));
+                        if (!myrtx_hash_table_put(table, &key, sizeof(int), value, value_size)) {
+                            TEST_FAILED("Put after clear failed");
+                        }
+                    }
+                    for (int i = 0; i < count; i += 3) {
+                        int key = round % 7 * 1000 + i;
+                        myrtx_hash_table_remove(table, &key, sizeof(int), true, true);
+                    }
+                    
+                    /* Keys of the previous rounds (other multiples of 1000) are gone */
+                    for (int other = 0; other < 7; other++) {
+                        for (int i = 0; i < COUNT + COUNT / 2; i++) {
+                            int key = other * 1000 + i;
+                            bool expected = other == round % 7 && i < count && i % 3 != 0;
+                            void* found = NULL;
+                            if (myrtx_hash_table_get(table, &key, sizeof(int), &found, NULL) !=
+                                expected) {
+                                TEST_FAILED("Stale or missing key after clear");
+                            }
+                            if (expected && memcmp(found, &key, sizeof(int)) != 0) {
+                                TEST_FAILED("Wrong value after clear");
+                            }
+                        }
+                    }
+                    
+                    size_t iterated = 0;
+                    myrtx_hash_table_iter_t iter;
+                    myrtx_hash_table_iter_init(&iter, table);
+                    while (myrtx_hash_table_iter_next(&iter, NULL, NULL, NULL, NULL)) {
+                        iterated++;
+                    }
+                    if (iterated != myrtx_hash_table_size(table) ||
+                        iterated != (size_t)(count - (count + 2) / 3)) {
+                        TEST_FAILED("Iteration sees stale slots");
+                    }
+                    
+                    size_t capacity = myrtx_hash_table_capacity(table);
+                    myrtx_hash_table_clear(table, true, true);
+                    if (myrtx_hash_table_size(table) != 0 ||
+                        myrtx_hash_table_capacity(table) != capacity) {
+                        TEST_FAILED("Clear changed the capacity or kept entries");
+                    }
+                }
+                
+                myrtx_hash_table_free(table, true, true);
+                if (use_arena) {
+                    myrtx_arena_free(&arena);
+                }
+            }
+        }
+    }
+    
+    TEST_PASSED();
+}
+
+/* Test parallel bulk builds against the sequential put semantics */
+void test_build_parallel(void) {
+    enum { COUNT = 20000, KEYS = 15000, WIDE = 6 };
+    const unsigned int thread_counts[] = {1, 3, 4};
+    static int values[COUNT][WIDE];
+    static int keys[COUNT];
+    static const void* key_ptrs[COUNT];
+    static const void* value_ptrs[COUNT];
+    static size_t key_sizes[COUNT];
+    static size_t value_sizes[COUNT];
+    
+    /* Every key from 0 to 4999 twice; the later value must win */
+    for (int i = 0; i < COUNT; i++) {
+        keys[i] = i % KEYS;
+        values[i][0] = i;
+        key_ptrs[i] = &keys[i];
+        value_ptrs[i] = values[i];
+        key_sizes[i] = sizeof(int);
+        value_sizes[i] = i % 5 == 0 ? sizeof(values[i]) : sizeof(int);
+    }
+    
+    for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT; probing++) {
+        for (unsigned int flags = 0; flags <= MYRTX_HASH_TABLE_INLINE_STORAGE; flags++) {
+            for (int use_arena = 0; use_arena < 2; use_arena++) {
+                for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+                    myrtx_arena_t arena = {0};
+                    if (use_arena && !myrtx_arena_init(&arena, 0)) {
+                        TEST_FAILED("Failed to initialize arena");
+                    }
+                    
+                    myrtx_hash_table_options_t options = {0};
+                    options.arena = use_arena ? &arena : NULL;
+                    options.hash64_function = myrtx_hash64_bytes;
+                    options.compare_function = myrtx_compare_integer_keys;
+                    options.probing = (myrtx_hash_probing_t)probing;
+                    options.flags = flags;
+                    myrtx_hash_table_t* table = myrtx_hash_table_build_parallel(
+                        &options, COUNT, key_ptrs, key_sizes, value_ptrs, value_sizes,
+                        thread_counts[t]);
+                    if (!table) {
+                        TEST_FAILED("Failed to build hash table");
+                    }
+                    if (myrtx_hash_table_size(table) != KEYS) {
+                        TEST_FAILED("Wrong size after build");
+                    }
+                    
+                    for (int key = 0; key < KEYS; key++) {
+                        int* found = NULL;
+                        size_t found_size = 0;
+                        int last = key + KEYS < COUNT ? key + KEYS : key;
+                        if (!myrtx_hash_table_get(table, &key, sizeof(int), (void**)&found,
+                                                  &found_size) ||
+                            found[0] != last || found_size != value_sizes[last]) {
+                            TEST_FAILED("Built table lost a key or kept an earlier value");
+                        }
+                    }
+                    
+                    size_t iterated = 0;
+                    myrtx_hash_table_iter_t iter;
+                    myrtx_hash_table_iter_init(&iter, table);
+                    while (myrtx_hash_table_iter_next(&iter, NULL, NULL, NULL, NULL)) {
+                        iterated++;
+                    }
+                    if (iterated != KEYS) {
+                        TEST_FAILED("Iteration disagrees with the size after build");
+                    }
+                    
+                    /* Presized: putting the input again must not grow the table */
+                    size_t capacity = myrtx_hash_table_capacity(table);
+                    if (myrtx_hash_table_put_batch(table, COUNT, key_ptrs, key_sizes, value_ptrs,
+                                                   value_sizes) != COUNT ||
+                        myrtx_hash_table_capacity(table) != capacity) {
+                        TEST_FAILED("Built table was not presized");
+                    }
+                    
+                    myrtx_hash_table_free(table, true, true);
+                    if (use_arena) {
+                        myrtx_arena_free(&arena);
+                    }
+                }
+            }
+        }
+    }
+    
+    /* String keys: key_sizes may be NULL */
+    static char names[KEYS][16];
+    for (int i = 0; i < KEYS; i++) {
+        snprintf(names[i], sizeof(names[i]), "key%d", i);
+        key_ptrs[i] = names[i];
+    }
+    myrtx_hash_table_options_t options = {0};
+    options.hash_function = myrtx_hash_string;
+    options.compare_function = myrtx_compare_string_keys;
+    options.probing = MYRTX_HASH_PROBING_SWISS;
+    myrtx_hash_table_t* table = myrtx_hash_table_build_parallel(&options, KEYS, key_ptrs, NULL,
+                                                                value_ptrs, value_sizes, 4);
+    if (!table || myrtx_hash_table_size(table) != KEYS) {
+        TEST_FAILED("Failed to build a table with string keys");
+    }
+    for (int i = 0; i < KEYS; i++) {
+        int* found = NULL;
+        if (!myrtx_hash_table_get(table, names[i], 0, (void**)&found, NULL) || found[0] != i) {
+            TEST_FAILED("String key missing after build");
+        }
+    }
+    myrtx_hash_table_free(table, true, true);
+    
+    TEST_PASSED();
+}
+
+/* Test moving entries between tables with and without a merge function */
+void test_merge(void) {
+    enum { DST_KEYS = 1000, SRC_FIRST = 500, SRC_LAST = 2500 };
+    
+    for (int probing = MYRTX_HASH_PROBING_LINEAR; probing <= MYRTX_HASH_PROBING_COMPACT; probing++) {
+        for (int variant = 0; variant < 4; variant++) {
+            for (int with_merge = 0; with_merge < 2; with_merge++) {
+                myrtx_arena_t arena = {0};
+                bool use_arena = variant & 1;
+                if (use_arena && !myrtx_arena_init(&arena, 0)) {
+                    TEST_FAILED("Failed to initialize arena");
+                }
+                
+                myrtx_hash_table_options_t options = {0};
+                options.arena = use_arena ? &arena : NULL;
+                options.hash64_function = myrtx_hash64_bytes;
+                options.compare_function = myrtx_compare_integer_keys;
+                options.probing = (myrtx_hash_probing_t)probing;
+                options.flags = variant & 2 ? MYRTX_HASH_TABLE_INLINE_STORAGE : 0;
+                options.seed = 1;
+                myrtx_hash_table_t* dst = myrtx_hash_table_create_ex(&options);
+                /* A different seed: the hashes must be recomputed */
+                options.seed = with_merge ? 2 : 1;
+                myrtx_hash_table_t* src = myrtx_hash_table_create_ex(&options);
+                if (!dst || !src) {
+                    TEST_FAILED("Failed to create hash tables");
+                }
+                
+                for (int key = 0; key < DST_KEYS; key++) {
+                    myrtx_hash_table_put(dst, &key, sizeof(int), &key, sizeof(int));
+                }
+                for (int key = SRC_FIRST; key < SRC_LAST; key++) {
+                    int value[8] = {key * 10};
+                    size_t value_size = key % 4 == 0 ? sizeof(value) : sizeof(int);
+                    myrtx_hash_table_put(src, &key, sizeof(int), value, value_size);
+                }
+                int expiring = SRC_LAST;
+                myrtx_hash_table_put_ttl(src, &expiring, sizeof(int), &expiring, sizeof(int), 100);
+                
+                int merged = 0;
+                if (!myrtx_hash_table_merge(dst, src, with_merge ? merge_add : NULL, &merged)) {
+                    TEST_FAILED("Merge failed");
+                }
+                if (myrtx_hash_table_size(src) != 0 ||
+                    myrtx_hash_table_size(dst) != SRC_LAST + 1) {
+                    TEST_FAILED("Wrong sizes after merge");
+                }
+                if (merged != (with_merge ? DST_KEYS - SRC_FIRST : 0)) {
+                    TEST_FAILED("Merge function called for the wrong keys");
+                }
+                
+                for (int key = 0; key < SRC_LAST; key++) {
+                    int* found = NULL;
+                    int expected = key < SRC_FIRST ? key
+                                 : key >= DST_KEYS ? key * 10
+                                 : with_merge     ? key * 11
+                                                  : key * 10;
+                    if (!myrtx_hash_table_get(dst, &key, sizeof(int), (void**)&found, NULL) ||
+                        *found != expected) {
+                        TEST_FAILED("Wrong value after merge");
+                    }
+                }
+                
+                if (myrtx_hash_table_get_expiry(dst, &expiring, sizeof(int)) != 100 ||
+                    myrtx_hash_table_expire(dst, 100, 0) != 1 ||
+                    myrtx_hash_table_contains_key(dst, &expiring, sizeof(int))) {
+                    TEST_FAILED("Expiry did not move with the entry");
+                }
+                
+                /* The emptied source table stays usable */
+                int key = 7;
+                if (!myrtx_hash_table_put(src, &key, sizeof(int), &key, sizeof(int)) ||
+                    !myrtx_hash_table_contains_key(src, &key, sizeof(int))) {
+                    TEST_FAILED("Source table unusable after merge");
+                }
+                
+                myrtx_hash_table_free(dst, true, true);
+                myrtx_hash_table_free(src, true, true);
+                if (use_arena) {
+                    myrtx_arena_free(&arena);
+                }
+            }
+        }
+    }
+    
+    /* Buffers cannot change between arena and malloc tables */
+    myrtx_arena_t arena = {0};
+    if (!myrtx_arena_init(&arena, 0)) {
+        TEST_FAILED("Failed to initialize arena");
+    }
+    myrtx_hash_table_t* in_arena = myrtx_hash_table_create(&arena, 0, myrtx_hash_string,
+                                                           myrtx_compare_string_keys);
+    myrtx_hash_table_t* on_heap = myrtx_hash_table_create(NULL, 0, myrtx_hash_string,
+                                                          myrtx_compare_string_keys);
+    myrtx_hash_table_put(on_heap, "key", 0, "value", 6);
+    if (myrtx_hash_table_merge(in_arena, on_heap, NULL, NULL) ||
+        myrtx_hash_table_size(on_heap) != 1) {
+        TEST_FAILED("Merge between arena and malloc tables accepted");
+    }
+    myrtx_hash_table_free(in_arena, true, true);
+    myrtx_hash_table_free(on_heap, true, true);
+    myrtx_arena_free(&arena);
+    
+    TEST_PASSED();
+}
+
 int main(void) {
     printf("=== myrtx Hash Table Tests ===\n\n");
     
@@ -519,6 +1962,22 @@ int main(void) {
     test_integer_keys();
     test_binary_keys();
     test_no_arena();
+    test_swiss_probing();
+    test_robin_hood_probing();
+    test_inline_storage();
+    test_in_place_update();
+    test_hash64();
+    test_integer_key_size();
+    test_incremental_resize();
+    test_arena_recycling();
+    test_iteration();
+    test_batch();
+    test_get_or_insert();
+    test_with_hash();
+    test_stats();
+    test_generations();
+    test_build_parallel();
+    test_merge();
     
     printf("\nAll hash table tests successful!\n");
     return 0;
@@ -0,0 +1,330 @@
+/**
+ * @file hash_table_ttl_test.c
+ * @brief Tests for hash table entry expiry
+ */
+
+#include "myrtx/collections/hash_table.h"
+#include "myrtx/memory/arena_allocator.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_PASSED() printf("PASSED: %s\n", __func__)
+#define TEST_FAILED(msg) do { printf("FAILED: %s - %s\n", __func__, msg); exit(1); } while(0)
+
+static myrtx_hash_table_t* create_table(myrtx_hash_probing_t probing, unsigned int flags,
+                                        myrtx_arena_t* arena) {
+    myrtx_hash_table_options_t options = {0};
+    options.arena = arena;
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+    options.probing = probing;
+    options.flags = flags;
+    return myrtx_hash_table_create_ex(&options);
+}
+
+static bool has(const myrtx_hash_table_t* table, uint64_t key) {
+    return myrtx_hash_table_contains_key(table, &key, sizeof(key));
+}
+
+static bool put_ttl(myrtx_hash_table_t* table, uint64_t key, uint64_t value, uint64_t expires_at) {
+    return myrtx_hash_table_put_ttl(table, &key, sizeof(key), &value, sizeof(value), expires_at);
+}
+
+/* Test that entries disappear once the clock reaches their expiry */
+void test_basic_expiry(void) {
+    myrtx_hash_table_t* table = create_table(MYRTX_HASH_PROBING_LINEAR,
+                                             MYRTX_HASH_TABLE_INLINE_STORAGE, NULL);
+    if (!table) {
+        TEST_FAILED("Failed to create table");
+    }
+
+    uint64_t key = 7, value = 70;
+    myrtx_hash_table_put(table, &key, sizeof(key), &value, sizeof(value));
+    for (uint64_t k = 1; k <= 5; k++) {
+        if (!put_ttl(table, k, k * 10, k * 100)) {
+            TEST_FAILED("put_ttl failed");
+        }
+    }
+    if (myrtx_hash_table_get_expiry(table, &key, sizeof(key)) != 0) {
+        TEST_FAILED("Entry without a TTL reports an expiry");
+    }
+    key = 3;
+    if (myrtx_hash_table_get_expiry(table, &key, sizeof(key)) != 300) {
+        TEST_FAILED("Wrong expiry");
+    }
+
+    if (myrtx_hash_table_expire(table, 99, 0) != 0 || myrtx_hash_table_size(table) != 6) {
+        TEST_FAILED("Entries expired early");
+    }
+    if (myrtx_hash_table_expire(table, 300, 0) != 3) {
+        TEST_FAILED("Expected three entries to expire at 300");
+    }
+    if (has(table, 1) || has(table, 3) || !has(table, 4) || !has(table, 7)) {
+        TEST_FAILED("Wrong entries expired");
+    }
+    if (myrtx_hash_table_size(table) != 3) {
+        TEST_FAILED("Expired entries still counted");
+    }
+
+    /* The clock does not move backwards */
+    if (myrtx_hash_table_expire(table, 10, 0) != 0 || has(table, 1)) {
+        TEST_FAILED("Clock moved backwards");
+    }
+
+    /* A far jump expires everything with a TTL */
+    if (myrtx_hash_table_expire(table, MYRTX_HASH_TABLE_MAX_EXPIRY, 0) != 2 ||
+        myrtx_hash_table_size(table) != 1 || !has(table, 7)) {
+        TEST_FAILED("Far jump did not expire the rest");
+    }
+
+    if (put_ttl(table, 1, 1, MYRTX_HASH_TABLE_MAX_EXPIRY + 1)) {
+        TEST_FAILED("Expiry beyond the maximum was accepted");
+    }
+
+    myrtx_hash_table_free(table, true, true);
+    TEST_PASSED();
+}
+
+/* Test that expired entries count as missing before they are reclaimed */
+void test_lazy_expiry(void) {
+    myrtx_hash_table_t* table = create_table(MYRTX_HASH_PROBING_SWISS, 0, NULL);
+    if (!table) {
+        TEST_FAILED("Failed to create table");
+    }
+
+    for (uint64_t k = 0; k < 100; k++) {
+        put_ttl(table, k, k, 50);
+    }
+
+    /* A budget of one handles a single timer (the newest, key 99), the rest stay stored */
+    if (myrtx_hash_table_expire(table, 50, 1) != 1 || myrtx_hash_table_size(table) != 99) {
+        TEST_FAILED("Budget not respected");
+    }
+
+    uint64_t key = 42;
+    void* value;
+    if (myrtx_hash_table_get(table, &key, sizeof(key), &value, NULL) || has(table, 42)) {
+        TEST_FAILED("Expired entry was found");
+    }
+    if (myrtx_hash_table_get_expiry(table, &key, sizeof(key)) != 0 ||
+        myrtx_hash_table_set_expiry(table, &key, sizeof(key), 100)) {
+        TEST_FAILED("Expired entry accepted a new expiry");
+    }
+
+    myrtx_hash_table_iter_t iter;
+    myrtx_hash_table_iter_init(&iter, table);
+    if (myrtx_hash_table_iter_next(&iter, NULL, NULL, NULL, NULL)) {
+        TEST_FAILED("Iteration returned an expired entry");
+    }
+
+    /* Removing an expired key reclaims it but reports it missing */
+    if (myrtx_hash_table_remove(table, &key, sizeof(key), true, true) ||
+        myrtx_hash_table_size(table) != 98) {
+        TEST_FAILED("Remove of an expired key");
+    }
+
+    /* A put replaces an expired entry with a permanent one */
+    key = 43;
+    uint64_t fresh = 4300;
+    if (!myrtx_hash_table_put(table, &key, sizeof(key), &fresh, sizeof(fresh)) ||
+        !myrtx_hash_table_get(table, &key, sizeof(key), &value, NULL) ||
+        *(uint64_t*)value != 4300 || myrtx_hash_table_get_expiry(table, &key, sizeof(key)) != 0) {
+        TEST_FAILED("Put over an expired entry");
+    }
+
+    /* get_or_insert stores its default over an expired entry */
+    key = 44;
+    bool inserted = false;
+    uint64_t* stored = myrtx_hash_table_get_or_insert(table, &key, sizeof(key), &fresh,
+                                                      sizeof(fresh), &inserted);
+    if (!stored || !inserted || *stored != 4300) {
+        TEST_FAILED("get_or_insert over an expired entry");
+    }
+
+    /* The remaining timers: 96 expired entries, two revived ones survive */
+    size_t removed = 0;
+    for (int round = 0; round < 20; round++) {
+        removed += myrtx_hash_table_expire(table, 50, 10);
+    }
+    if (removed != 96 || myrtx_hash_table_size(table) != 2 || !has(table, 43) || !has(table, 44)) {
+        TEST_FAILED("Budgeted rounds did not reclaim the expired entries");
+    }
+
+    myrtx_hash_table_free(table, true, true);
+    TEST_PASSED();
+}
+
+/* Test pushing back, bringing forward and clearing an expiry */
+void test_change_expiry(void) {
+    myrtx_hash_table_t* table = create_table(MYRTX_HASH_PROBING_ROBIN_HOOD,
+                                             MYRTX_HASH_TABLE_INLINE_STORAGE, NULL);
+    if (!table) {
+        TEST_FAILED("Failed to create table");
+    }
+
+    uint64_t later = 1, sooner = 2, cleared = 3, renewed = 4;
+    put_ttl(table, later, 0, 100);
+    put_ttl(table, sooner, 0, 5000);
+    put_ttl(table, cleared, 0, 100);
+    put_ttl(table, renewed, 0, 100);
+
+    myrtx_hash_table_set_expiry(table, &later, sizeof(later), 5000);
+    myrtx_hash_table_set_expiry(table, &sooner, sizeof(sooner), 100);
+    myrtx_hash_table_set_expiry(table, &cleared, sizeof(cleared), 0);
+    /* Cleared while its timer is pending, then set again */
+    myrtx_hash_table_set_expiry(table, &renewed, sizeof(renewed), 0);
+    myrtx_hash_table_set_expiry(table, &renewed, sizeof(renewed), 200);
+
+    if (myrtx_hash_table_expire(table, 150, 0) != 1 || has(table, sooner) || !has(table, later) ||
+        !has(table, cleared) || !has(table, renewed)) {
+        TEST_FAILED("Wrong entries expired at 150");
+    }
+    if (myrtx_hash_table_expire(table, 4999, 0) != 1 || has(table, renewed) ||
+        !has(table, later)) {
+        TEST_FAILED("Renewed expiry not honored");
+    }
+    if (myrtx_hash_table_expire(table, 5000, 0) != 1 || has(table, later) ||
+        !has(table, cleared)) {
+        TEST_FAILED("Pushed-back expiry not honored");
+    }
+
+    /* An expiry in the past takes effect at once */
+    put_ttl(table, 9, 0, 10);
+    if (has(table, 9) || myrtx_hash_table_expire(table, 5000, 0) != 1) {
+        TEST_FAILED("Expiry in the past");
+    }
+
+    myrtx_hash_table_free(table, true, true);
+    TEST_PASSED();
+}
+
+/* Compare against a reference model with random expiries. With a budget,
+ * expired entries may stay stored, so only lookups are checked per tick. */
+static void run_model(myrtx_hash_probing_t probing, unsigned int flags, myrtx_arena_t* arena,
+                      size_t budget) {
+    enum { KEYS = 2000, STEPS = 20000 };
+    static uint64_t expiry[KEYS];
+    static bool present[KEYS];
+    memset(present, 0, sizeof(present));
+
+    myrtx_hash_table_t* table = create_table(probing, flags, arena);
+    if (!table) {
+        printf("FAILED: run_model - Failed to create table\n");
+        exit(1);
+    }
+
+    uint64_t now = 1000;
+    uint64_t state = 0x243F6A8885A308D3ull;
+    for (int step = 0; step < STEPS; step++) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        uint64_t key = (state >> 33) % KEYS;
+        uint64_t r = state >> 20;
+
+        switch (r % 8) {
+        case 0: case 1: case 2: {
+            /* Spread the TTLs over several wheel levels */
+            uint64_t ttl = 1 + ((r >> 8) % 4 == 0 ? (r >> 12) % 300000 : (r >> 12) % 200);
+            put_ttl(table, key, key, now + ttl);
+            present[key] = true;
+            expiry[key] = now + ttl;
+            break;
+        }
+        case 3:
+            /* A plain put keeps the expiry of a live key */
+            myrtx_hash_table_put(table, &key, sizeof(key), &key, sizeof(key));
+            if (!present[key]) {
+                expiry[key] = 0;
+            }
+            present[key] = true;
+            break;
+        case 4:
+            if (present[key]) {
+                uint64_t at = (r >> 8) % 3 == 0 ? 0 : now + 1 + (r >> 12) % 5000;
+                if (!myrtx_hash_table_set_expiry(table, &key, sizeof(key), at)) {
+                    printf("FAILED: run_model - set_expiry on a live key\n");
+                    exit(1);
+                }
+                expiry[key] = at;
+            }
+            break;
+        case 5:
+            myrtx_hash_table_remove(table, &key, sizeof(key), true, true);
+            present[key] = false;
+            break;
+        default: {
+            now += (r >> 8) % 16 == 0 ? (r >> 12) % 100000 : (r >> 12) % 40;
+            myrtx_hash_table_expire(table, now, budget);
+            size_t live = 0;
+            for (uint64_t k = 0; k < KEYS; k++) {
+                if (present[k] && expiry[k] != 0 && expiry[k] <= now) {
+                    present[k] = false;
+                }
+                live += present[k];
+                if (budget != 0 && has(table, k) != present[k]) {
+                    printf("FAILED: run_model - key %llu at step %d\n", (unsigned long long)k, step);
+                    exit(1);
+                }
+            }
+            if (budget == 0 && myrtx_hash_table_size(table) != live) {
+                printf("FAILED: run_model - size %zu, expected %zu at step %d\n",
+                       myrtx_hash_table_size(table), live, step);
+                exit(1);
+            }
+            break;
+        }
+        }
+    }
+
+    size_t live = 0;
+    for (uint64_t k = 0; k < KEYS; k++) {
+        bool alive = present[k] && !(expiry[k] != 0 && expiry[k] <= now);
+        if (has(table, k) != alive) {
+            printf("FAILED: run_model - key %llu\n", (unsigned long long)k);
+            exit(1);
+        }
+        live += alive;
+    }
+    myrtx_hash_table_expire(table, now, 0);
+    if (myrtx_hash_table_size(table) != live) {
+        printf("FAILED: run_model - expired entries left after an unlimited expire\n");
+        exit(1);
+    }
+
+    myrtx_hash_table_clear(table, true, true);
+    if (myrtx_hash_table_expire(table, now + 1000000, 0) != 0) {
+        printf("FAILED: run_model - timers survived clear\n");
+        exit(1);
+    }
+    myrtx_hash_table_free(table, true, true);
+}
+
+void test_model(void) {
+    run_model(MYRTX_HASH_PROBING_LINEAR, 0, NULL, 0);
+    run_model(MYRTX_HASH_PROBING_SWISS, MYRTX_HASH_TABLE_INLINE_STORAGE, NULL, 0);
+    run_model(MYRTX_HASH_PROBING_ROBIN_HOOD, MYRTX_HASH_TABLE_INCREMENTAL_RESIZE, NULL, 0);
+    run_model(MYRTX_HASH_PROBING_COMPACT, MYRTX_HASH_TABLE_INLINE_STORAGE, NULL, 0);
+    run_model(MYRTX_HASH_PROBING_ROBIN_HOOD, MYRTX_HASH_TABLE_INLINE_STORAGE, NULL, 3);
+
+    myrtx_arena_t arena;
+    if (!myrtx_arena_init(&arena, 0)) {
+        TEST_FAILED("Failed to initialize arena");
+    }
+    run_model(MYRTX_HASH_PROBING_SWISS,
+              MYRTX_HASH_TABLE_INLINE_STORAGE | MYRTX_HASH_TABLE_INCREMENTAL_RESIZE, &arena, 0);
+    myrtx_arena_free(&arena);
+    TEST_PASSED();
+}
+
+int main(void) {
+    printf("=== myrtx Hash Table TTL Tests ===\n\n");
+
+    test_basic_expiry();
+    test_lazy_expiry();
+    test_change_expiry();
+    test_model();
+
+    printf("\nAll hash table TTL tests successful!\n");
+    return 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file hashmap_cpp_test.cpp
+ * @brief Tests for the myrtx::hash_map C++ template
+ */
+
+#include "myrtx/collections/hashmap.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+
+#define TEST_PASSED() std::printf("PASSED: %s\n", __func__)
+#define TEST_FAILED(msg) do { std::printf("FAILED: %s - %s\n", __func__, msg); std::exit(1); } while(0)
+
+/* Test an int -> int map against std::map */
+void test_int_map() {
+    myrtx::hash_map<int, int> map;
+    std::map<int, int> reference;
+    
+    std::srand(3);
+    for (int op = 0; op < 60000; op++) {
+        int key = std::rand() % 3000;
+        int action = std::rand() % 4;
+        
+        if (action <= 1) {
+            int value = std::rand();
+            if (!map.put(key, value)) {
+                TEST_FAILED("Put failed");
+            }
+            reference[key] = value;
+        } else if (action == 2) {
+            if (map.remove(key) != (reference.erase(key) == 1)) {
+                TEST_FAILED("Remove result differs from reference");
+            }
+        } else {
+            int* value = map.get(key);
+            std::map<int, int>::const_iterator it = reference.find(key);
+            if ((value != NULL) != (it != reference.end()) || (value && *value != it->second)) {
+                TEST_FAILED("Get result differs from reference");
+            }
+        }
+        
+        if (map.size() != reference.size()) {
+            TEST_FAILED("Size differs from reference");
+        }
+    }
+    
+    std::size_t visited = 0;
+    map.for_each([&](int key, int value) {
+        if (reference.at(key) != value) {
+            TEST_FAILED("Iteration returned an unexpected entry");
+        }
+        visited++;
+    });
+    if (visited != reference.size()) {
+        TEST_FAILED("Iteration missed entries");
+    }
+    
+    TEST_PASSED();
+}
+
+/* Test non-trivial keys and values: every constructed object is destroyed */
+void test_string_map() {
+    myrtx_arena_t arena;
+    if (!myrtx_arena_init(&arena, 0)) {
+        TEST_FAILED("Failed to initialize arena");
+    }
+    
+    {
+        myrtx::hash_map<std::string, std::string> map(&arena);
+        for (int i = 0; i < 1000; i++) {
+            map.put("key-" + std::to_string(i), std::string(40, static_cast<char>('a' + i % 26)));
+        }
+        for (int i = 0; i < 1000; i += 2) {
+            if (!map.remove("key-" + std::to_string(i))) {
+                TEST_FAILED("Remove failed");
+            }
+        }
+        for (int i = 0; i < 1000; i++) {
+            const std::string* value = map.get("key-" + std::to_string(i));
+            if ((value != NULL) != (i % 2 == 1) ||
+                (value && *value != std::string(40, static_cast<char>('a' + i % 26)))) {
+                TEST_FAILED("Lookup wrong after removals");
+            }
+        }
+        
+        myrtx::hash_map<std::string, std::string> moved(std::move(map));
+        if (moved.size() != 500 || map.size() != 0 || !moved.contains("key-1")) {
+            TEST_FAILED("Move did not transfer the entries");
+        }
+    }
+    
+    /* The maps destroyed their strings before the arena goes away */
+    myrtx_arena_free(&arena);
+    
+    TEST_PASSED();
+}
+
+/* Test that oversized capacities leave the map empty instead of wrapping */
+void test_capacity_overflow() {
+    myrtx::hash_map<int, int> too_large(NULL, SIZE_MAX / 2 + 2);
+    myrtx::hash_map<int, int> too_many_bytes(NULL, SIZE_MAX / 2 + 1);
+    if (too_large.capacity() != 0 || too_many_bytes.capacity() != 0 ||
+        too_large.put(1, 1) || too_many_bytes.put(1, 1)) {
+        TEST_FAILED("Oversized capacity accepted");
+    }
+    
+    TEST_PASSED();
+}
+
+int main() {
+    std::printf("=== myrtx Hash Map C++ Tests ===\n\n");
+    
+    test_int_map();
+    test_string_map();
+    test_capacity_overflow();
+    
+    std::printf("\nAll hash map C++ tests successful!\n");
+    return 0;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file hashmap_test.c
+ * @brief Tests for the macro-generated hash maps
+ */
+
+#include "myrtx/collections/hashmap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define TEST_PASSED() printf("PASSED: %s\n", __func__)
+#define TEST_FAILED(msg) do { printf("FAILED: %s - %s\n", __func__, msg); exit(1); } while(0)
+
+MYRTX_HASHMAP_DEFINE(int_map, int, int, myrtx_hashmap_hash_int, myrtx_hashmap_eq_int)
+MYRTX_HASHMAP_DEFINE(str_map, const char*, double, myrtx_hashmap_hash_str, myrtx_hashmap_eq_str)
+
+/* Constant hash: every key collides, which exercises the backward shift */
+#define COLLIDING_HASH(key) ((void)(key), 5u)
+MYRTX_HASHMAP_DEFINE(collide_map, int, int, COLLIDING_HASH, myrtx_hashmap_eq_int)
+
+/* Run random put/remove/get operations on an int map and compare with an array */
+static void run_int_workload(myrtx_arena_t* arena, unsigned int seed) {
+    enum { KEY_RANGE = 3000, OPERATIONS = 60000 };
+    static int reference[KEY_RANGE];
+    static bool present[KEY_RANGE];
+    memset(present, 0, sizeof(present));
+    
+    int_map map;
+    if (!int_map_init(&map, arena, 0)) {
+        TEST_FAILED("Failed to initialize map");
+    }
+    
+    size_t expected_size = 0;
+    srand(seed);
+    for (int op = 0; op < OPERATIONS; op++) {
+        int key = rand() % KEY_RANGE;
+        int action = rand() % 4;
+        
+        if (action <= 1) {
+            int value = rand();
+            if (!int_map_put(&map, key, value)) {
+                TEST_FAILED("Put failed");
+            }
+            if (!present[key]) {
+                present[key] = true;
+                expected_size++;
+            }
+            reference[key] = value;
+        } else if (action == 2) {
+            bool removed = int_map_remove(&map, key);
+            if (removed != present[key]) {
+                TEST_FAILED("Remove result differs from reference");
+            }
+            if (removed) {
+                present[key] = false;
+                expected_size--;
+            }
+        } else {
+            int* value = int_map_get(&map, key);
+            if ((value != NULL) != present[key] || (value && *value != reference[key])) {
+                TEST_FAILED("Get result differs from reference");
+            }
+        }
+        
+        if (int_map_size(&map) != expected_size) {
+            TEST_FAILED("Size differs from reference");
+        }
+    }
+    
+    /* Iteration visits every entry exactly once */
+    size_t cursor = 0, visited = 0;
+    int key;
+    int* value;
+    while (int_map_next(&map, &cursor, &key, &value)) {
+        if (key < 0 || key >= KEY_RANGE || !present[key] || *value != reference[key]) {
+            TEST_FAILED("Iteration returned an unexpected entry");
+        }
+        visited++;
+    }
+    if (visited != expected_size) {
+        TEST_FAILED("Iteration missed entries");
+    }
+    
+    int_map_clear(&map);
+    if (int_map_size(&map) != 0 || int_map_contains(&map, 1)) {
+        TEST_FAILED("Clear left entries behind");
+    }
+    
+    int_map_destroy(&map);
+}
+
+/* Test an int -> int map with malloc and with an arena */
+void test_int_map(void) {
+    run_int_workload(NULL, 1);
+    
+    myrtx_arena_t arena;
+    if (!myrtx_arena_init(&arena, 0)) {
+        TEST_FAILED("Failed to initialize arena");
+    }
+    run_int_workload(&arena, 2);
+    myrtx_arena_free(&arena);
+    
+    TEST_PASSED();
+}
+
+/* Test string keys stored as pointers */
+void test_string_map(void) {
+    str_map map;
+    if (!str_map_init(&map, NULL, 4)) {
+        TEST_FAILED("Failed to initialize map");
+    }
+    
+    char keys[100][16];
+    for (int i = 0; i < 100; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "key-%d", i);
+        if (!str_map_put(&map, keys[i], i * 0.5)) {
+            TEST_FAILED("Put failed");
+        }
+    }
+    
+    /* Lookups with a different pointer to equal contents */
+    char probe[16];
+    for (int i = 0; i < 100; i++) {
+        snprintf(probe, sizeof(probe), "key-%d", i);
+        double* value = str_map_get(&map, probe);
+        if (!value || *value != i * 0.5) {
+            TEST_FAILED("Lookup by equal string failed");
+        }
+    }
+    if (str_map_get(&map, "key-100") != NULL) {
+        TEST_FAILED("Found a key that was never inserted");
+    }
+    
+    str_map_put(&map, "key-7", 42.0);
+    if (str_map_size(&map) != 100 || *str_map_get(&map, keys[7]) != 42.0) {
+        TEST_FAILED("Overwrite changed the size or lost the value");
+    }
+    
+    str_map_destroy(&map);
+    TEST_PASSED();
+}
+
+/* Test removal inside a single long collision run */
+void test_collisions(void) {
+    collide_map map;
+    if (!collide_map_init(&map, NULL, 0)) {
+        TEST_FAILED("Failed to initialize map");
+    }
+    
+    for (int i = 0; i < 10; i++) {
+        collide_map_put(&map, i, i * 10);
+    }
+    
+    /* Remove from the front, middle and end of the run */
+    if (!collide_map_remove(&map, 0) || !collide_map_remove(&map, 5) ||
+        !collide_map_remove(&map, 9) || collide_map_remove(&map, 5)) {
+        TEST_FAILED("Remove in collision run failed");
+    }
+    for (int i = 0; i < 10; i++) {
+        int* value = collide_map_get(&map, i);
+        bool expected = i != 0 && i != 5 && i != 9;
+        if ((value != NULL) != expected || (value && *value != i * 10)) {
+            TEST_FAILED("Run broken after removal");
+        }
+    }
+    
+    collide_map_destroy(&map);
+    TEST_PASSED();
+}
+
+/* Test that oversized capacities fail instead of wrapping around */
+void test_capacity_overflow(void) {
+    myrtx_arena_t arena;
+    if (!myrtx_arena_init(&arena, 0)) {
+        TEST_FAILED("Failed to initialize arena");
+    }
+    
+    /* Above the largest power of 2, then a power of 2 too large in bytes */
+    size_t capacities[2] = {SIZE_MAX / 2 + 2, SIZE_MAX / 2 + 1};
+    for (int i = 0; i < 2; i++) {
+        int_map map;
+        if (int_map_init(&map, NULL, capacities[i]) || map.capacity != 0 ||
+            int_map_put(&map, 1, 1)) {
+            TEST_FAILED("Oversized capacity accepted");
+        }
+        if (int_map_init(&map, &arena, capacities[i]) || map.capacity != 0) {
+            TEST_FAILED("Oversized capacity accepted with an arena");
+        }
+    }
+    
+    myrtx_arena_free(&arena);
+    TEST_PASSED();
+}
+
+int main(void) {
+    printf("=== myrtx Hash Map Tests ===\n\n");
+    
+    test_int_map();
+    test_string_map();
+    test_collisions();
+    test_capacity_overflow();
+    
+    printf("\nAll hash map tests successful!\n");
+    return 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file perfect_hash_test.c
+ * @brief Tests for the minimal perfect hash
+ */
+
+#include "myrtx/collections/perfect_hash.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_PASSED() printf("PASSED: %s\n", __func__)
+#define TEST_FAILED(msg) do { printf("FAILED: %s - %s\n", __func__, msg); exit(1); } while(0)
+
+#define PH_KEYS 20000
+
+static uint64_t key_storage[PH_KEYS];
+static const void* key_pointers[PH_KEYS];
+static size_t key_sizes[PH_KEYS];
+static uint32_t values[PH_KEYS];
+
+static void make_keys(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        key_storage[i] = i * 0x9E3779B97F4A7C15ull;
+        key_pointers[i] = &key_storage[i];
+        key_sizes[i] = sizeof(uint64_t);
+        values[i] = (uint32_t)i * 7;
+    }
+}
+
+/* Every key gets a distinct index and its own value; other keys are rejected */
+static void check_function(const myrtx_perfect_hash_t* hash, size_t count) {
+    static unsigned char seen[PH_KEYS];
+    memset(seen, 0, sizeof(seen));
+
+    if (myrtx_perfect_hash_size(hash) != count) {
+        TEST_FAILED("Wrong size");
+    }
+    for (size_t i = 0; i < count; i++) {
+        size_t index;
+        if (!myrtx_perfect_hash_lookup(hash, key_pointers[i], key_sizes[i], &index) ||
+            index >= count || seen[index]) {
+            TEST_FAILED("Index missing, out of range or not unique");
+        }
+        seen[index] = 1;
+        const uint32_t* value = myrtx_perfect_hash_get(hash, key_pointers[i], key_sizes[i]);
+        if (!value || *value != values[i]) {
+            TEST_FAILED("Wrong value");
+        }
+    }
+    for (uint64_t i = 0; i < 1000; i++) {
+        uint64_t missing = i * 0x9E3779B97F4A7C15ull + 1;
+        size_t index;
+        if (myrtx_perfect_hash_lookup(hash, &missing, sizeof(missing), &index) ||
+            myrtx_perfect_hash_get(hash, &missing, sizeof(missing))) {
+            TEST_FAILED("Found a key outside the set");
+        }
+    }
+}
+
+/* Test 64-bit hashing with several gammas, with and without an arena */
+void test_build_and_lookup(void) {
+    make_keys(PH_KEYS);
+    const double gammas[] = {0.0, 1.0, 1.5, 4.0};
+
+    for (int use_arena = 0; use_arena <= 1; use_arena++) {
+        for (size_t g = 0; g < sizeof(gammas) / sizeof(gammas[0]); g++) {
+            myrtx_arena_t arena = {0};
+            if (use_arena && !myrtx_arena_init(&arena, 0)) {
+                TEST_FAILED("Failed to initialize arena");
+            }
+
+            myrtx_perfect_hash_options_t options = {0};
+            options.arena = use_arena ? &arena : NULL;
+            options.hash64_function = myrtx_hash64_bytes;
+            options.compare_function = myrtx_compare_integer_keys;
+            options.gamma = gammas[g];
+            myrtx_perfect_hash_t* hash = myrtx_perfect_hash_build(
+                &options, key_pointers, key_sizes, PH_KEYS, values, sizeof(uint32_t));
+            if (!hash) {
+                TEST_FAILED("Failed to build");
+            }
+            check_function(hash, PH_KEYS);
+
+            double bits = myrtx_perfect_hash_bits_per_key(hash);
+            if (bits < 1.0 || bits > gammas[g] * 2.5 + 2.0 + (gammas[g] == 0.0 ? 5.0 : 0.0)) {
+                TEST_FAILED("Unexpected bits per key");
+            }
+            if (g == 0) {
+                printf("  default gamma: %.2f bits per key\n", bits);
+            }
+
+            myrtx_perfect_hash_free(hash);
+            if (use_arena) {
+                myrtx_arena_free(&arena);
+            }
+        }
+    }
+    TEST_PASSED();
+}
+
+/* Test string keys with the 32-bit hash function and without values */
+void test_string_keys(void) {
+    static char storage[PH_KEYS][24];
+    static const void* keys[PH_KEYS];
+    for (size_t i = 0; i < PH_KEYS; i++) {
+        snprintf(storage[i], sizeof(storage[i]), "%s-%zu", i % 2 ? "symbol" : "a longer name", i);
+        keys[i] = storage[i];
+    }
+
+    myrtx_perfect_hash_options_t options = {0};
+    options.hash_function = myrtx_hash_string;
+    options.compare_function = myrtx_compare_string_keys;
+    myrtx_perfect_hash_t* hash = myrtx_perfect_hash_build(&options, keys, NULL, PH_KEYS, NULL, 0);
+    if (!hash) {
+        TEST_FAILED("Failed to build");
+    }
+
+    static unsigned char seen[PH_KEYS];
+    memset(seen, 0, sizeof(seen));
+    for (size_t i = 0; i < PH_KEYS; i++) {
+        char copy[24];
+        strcpy(copy, storage[i]);
+        size_t index;
+        if (!myrtx_perfect_hash_lookup(hash, copy, 0, &index) || seen[index]) {
+            TEST_FAILED("String key missing or index not unique");
+        }
+        seen[index] = 1;
+    }
+    size_t index;
+    if (myrtx_perfect_hash_lookup(hash, "symbol", 0, &index) ||
+        myrtx_perfect_hash_get(hash, storage[0], 0)) {
+        TEST_FAILED("Unexpected lookup result");
+    }
+
+    myrtx_perfect_hash_free(hash);
+    TEST_PASSED();
+}
+
+/* Every key hashes alike, so none can be placed in a level */
+static uint32_t constant_hash(const void* key, size_t key_size) {
+    (void)key;
+    (void)key_size;
+    return 42;
+}
+
+/* Test keys that only the fallback table can separate */
+void test_equal_hashes(void) {
+    make_keys(64);
+
+    myrtx_perfect_hash_options_t options = {0};
+    options.hash_function = constant_hash;
+    options.compare_function = myrtx_compare_integer_keys;
+    myrtx_perfect_hash_t* hash = myrtx_perfect_hash_build(&options, key_pointers, key_sizes, 64,
+                                                          values, sizeof(uint32_t));
+    if (!hash) {
+        TEST_FAILED("Failed to build");
+    }
+    check_function(hash, 64);
+    myrtx_perfect_hash_free(hash);
+    TEST_PASSED();
+}
+
+/* Test empty sets, duplicates and invalid options */
+void test_edge_cases(void) {
+    myrtx_perfect_hash_options_t options = {0};
+    options.hash64_function = myrtx_hash64_bytes;
+    options.compare_function = myrtx_compare_integer_keys;
+
+    myrtx_perfect_hash_t* hash = myrtx_perfect_hash_build(&options, NULL, NULL, 0, NULL, 0);
+    uint64_t key = 1;
+    size_t index;
+    if (!hash || myrtx_perfect_hash_size(hash) != 0 ||
+        myrtx_perfect_hash_lookup(hash, &key, sizeof(key), &index)) {
+        TEST_FAILED("Empty set misbehaves");
+    }
+    myrtx_perfect_hash_free(hash);
+
+    make_keys(100);
+    key_pointers[50] = key_pointers[10];
+    if (myrtx_perfect_hash_build(&options, key_pointers, key_sizes, 100, NULL, 0)) {
+        TEST_FAILED("Built a function over duplicate keys");
+    }
+    make_keys(100);
+
+    options.gamma = 0.5;
+    if (myrtx_perfect_hash_build(&options, key_pointers, key_sizes, 100, NULL, 0)) {
+        TEST_FAILED("Accepted a gamma below 1");
+    }
+    options.gamma = 0.0;
+    options.hash_function = myrtx_hash_integer;
+    if (myrtx_perfect_hash_build(&options, key_pointers, key_sizes, 100, NULL, 0)) {
+        TEST_FAILED("Accepted two hash functions");
+    }
+    options.hash_function = NULL;
+    options.compare_function = NULL;
+    if (myrtx_perfect_hash_build(&options, key_pointers, key_sizes, 100, NULL, 0)) {
+        TEST_FAILED("Accepted a missing compare function");
+    }
+
+    myrtx_perfect_hash_free(NULL);
+    TEST_PASSED();
+}
+
+int main(void) {
+    printf("=== myrtx Perfect Hash Tests ===\n\n");
+
+    test_build_and_lookup();
+    test_string_keys();
+    test_equal_hashes();
+    test_edge_cases();
+
+    printf("\nAll perfect hash tests successful!\n");
+    return 0;
+}
@@ -0,0 +1,267 @@
+/**
+ * @file trace_test.c
+ * @brief Tests for the myrtx per-context event tracer
+ */
+
+#include "myrtx/context/trace.h"
+#include "myrtx/collections/hash_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define TEST_PASSED() printf("PASSED: %s\n", __func__)
+#define TEST_FAILED(msg) do { printf("FAILED: %s - %s\n", __func__, msg); exit(1); } while(0)
+
+#if defined(MYRTX_ENABLE_TRACING) && MYRTX_ENABLE_TRACING
+
+/* Count events of one type in a snapshot */
+static size_t count_type(const myrtx_trace_event_t* events, size_t n, uint32_t type) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (events[i].type == type) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/* Test that library hooks record into the current context */
+void test_trace_library_events(void) {
+    myrtx_context_t* ctx = myrtx_context_create(NULL);
+    if (!ctx) {
+        TEST_FAILED("Failed to create context");
+    }
+
+    if (!myrtx_trace_enable(ctx, 256)) {
+        TEST_FAILED("Failed to enable tracing");
+    }
+    myrtx_set_current_context(ctx);
+
+    /* Temp markers and block additions in any arena */
+    size_t marker = myrtx_arena_temp_begin(ctx->global_arena);
+    if (!myrtx_arena_alloc(ctx->global_arena, MYRTX_ARENA_DEFAULT_SIZE * 2)) {
+        TEST_FAILED("Large allocation failed");
+    }
+    myrtx_arena_temp_end(ctx->global_arena, marker);
+
+    MYRTX_WITH_CONTEXT_SCRATCH(ctx, scratch) {
+        if (!myrtx_arena_alloc(scratch.arena, 64)) {
+            TEST_FAILED("Scratch allocation failed");
+        }
+    }
+
+    /* Hash table growth records resizes */
+    myrtx_hash_table_t* table = myrtx_hash_table_create(NULL, 4, myrtx_hash_integer,
+                                                       myrtx_compare_integer_keys);
+    for (int i = 0; i < 64; i++) {
+        myrtx_hash_table_put(table, &i, sizeof(int), &i, sizeof(int));
+    }
+    myrtx_hash_table_free(table, true, true);
+
+    MYRTX_TRACE_SPAN_BEGIN(ctx, "request");
+    MYRTX_TRACE_SPAN_END(ctx, "request");
+
+    myrtx_trace_event_t events[256];
+    size_t n = myrtx_trace_snapshot(ctx, events, 256);
+
+    if (count_type(events, n, MYRTX_TRACE_SCRATCH_BEGIN) != 1 ||
+        count_type(events, n, MYRTX_TRACE_SCRATCH_END) != 1) {
+        TEST_FAILED("Scratch events not recorded");
+    }
+    if (count_type(events, n, MYRTX_TRACE_TEMP_BEGIN) < 1 ||
+        count_type(events, n, MYRTX_TRACE_TEMP_END) < 1) {
+        TEST_FAILED("Temp marker events not recorded");
+    }
+    if (count_type(events, n, MYRTX_TRACE_ARENA_BLOCK) < 1) {
+        TEST_FAILED("Arena block event not recorded");
+    }
+    if (count_type(events, n, MYRTX_TRACE_HASH_RESIZE) < 1) {
+        TEST_FAILED("Hash resize event not recorded");
+    }
+    if (n < 2 || events[n - 2].type != MYRTX_TRACE_SPAN_BEGIN ||
+        events[n - 1].type != MYRTX_TRACE_SPAN_END ||
+        strcmp((const char*)(uintptr_t)events[n - 1].arg0, "request") != 0) {
+        TEST_FAILED("User span not recorded last");
+    }
+
+    /* Timestamps must not go backwards */
+    for (size_t i = 1; i < n; i++) {
+        if (events[i].timestamp < events[i - 1].timestamp) {
+            TEST_FAILED("Timestamps are not monotonic");
+        }
+    }
+
+    myrtx_set_current_context(NULL);
+    myrtx_context_destroy(ctx);
+
+    TEST_PASSED();
+}
+
+/* Test ring wraparound keeps the newest events */
+void test_trace_wraparound(void) {
+    myrtx_context_t* ctx = myrtx_context_create(NULL);
+    if (!ctx || !myrtx_trace_enable(ctx, 10)) {
+        TEST_FAILED("Failed to set up traced context");
+    }
+
+    /* Capacity is rounded up to 16 */
+    for (uint64_t i = 0; i < 40; i++) {
+        myrtx_trace_record(ctx, MYRTX_TRACE_SPAN_BEGIN, i, 0);
+    }
+
+    if (myrtx_trace_count(ctx) != 16 || myrtx_trace_dropped(ctx) != 24) {
+        TEST_FAILED("Unexpected count after wraparound");
+    }
+
+    myrtx_trace_event_t events[16];
+    size_t n = myrtx_trace_snapshot(ctx, events, 16);
+    if (n != 16 || events[0].arg0 != 24 || events[15].arg0 != 39) {
+        TEST_FAILED("Snapshot does not hold the newest events in order");
+    }
+
+    myrtx_context_destroy(ctx);
+    TEST_PASSED();
+}
+
+/* Test marker ends, pool hits and their async export */
+void test_trace_markers_and_scratch(void) {
+    myrtx_context_t* ctx = myrtx_context_create(NULL);
+    if (!ctx || !myrtx_trace_enable(ctx, 64)) {
+        TEST_FAILED("Failed to set up traced context");
+    }
+    myrtx_set_current_context(ctx);
+
+    /* Ending the outer marker ends all three, innermost first */
+    size_t outer = myrtx_arena_temp_begin(ctx->global_arena);
+    myrtx_arena_temp_begin(ctx->global_arena);
+    myrtx_arena_temp_begin(ctx->global_arena);
+    myrtx_arena_temp_end(ctx->global_arena, outer);
+
+    /* The first region is created, the second get reuses it */
+    for (int i = 0; i < 2; i++) {
+        MYRTX_WITH_CONTEXT_SCRATCH(ctx, scratch) {
+            myrtx_arena_alloc(scratch.arena, 64);
+        }
+    }
+
+    myrtx_trace_event_t events[64];
+    size_t n = myrtx_trace_snapshot(ctx, events, 64);
+    uint64_t ends[3];
+    size_t end_count = 0;
+    uint64_t hits[2];
+    size_t begin_count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (events[i].type == MYRTX_TRACE_TEMP_END && end_count < 3) {
+            ends[end_count++] = events[i].arg0;
+        } else if (events[i].type == MYRTX_TRACE_SCRATCH_BEGIN && begin_count < 2) {
+            hits[begin_count++] = events[i].arg0;
+        }
+    }
+    if (count_type(events, n, MYRTX_TRACE_TEMP_END) != 3 || end_count != 3 ||
+        ends[0] != outer + 2 || ends[1] != outer + 1 || ends[2] != outer) {
+        TEST_FAILED("Dropped markers not ended one by one");
+    }
+    if (begin_count != 2 || hits[0] != 0 || hits[1] != 1) {
+        TEST_FAILED("Scratch pool hits not recorded");
+    }
+
+    FILE* f = tmpfile();
+    if (!f || !myrtx_trace_export_chrome(ctx, f)) {
+        TEST_FAILED("Export failed");
+    }
+    static char buffer[8192];
+    rewind(f);
+    size_t len = fread(buffer, 1, sizeof(buffer) - 1, f);
+    buffer[len] = '\0';
+    fclose(f);
+
+    if (!strstr(buffer, "\"name\":\"arena_temp\",\"cat\":\"arena\",\"ph\":\"e\",\"id\":\"0x") ||
+        !strstr(buffer, "\"name\":\"scratch\",\"cat\":\"scratch\",\"ph\":\"b\"") ||
+        strstr(buffer, "\"ph\":\"B\"") || strstr(buffer, "\"ph\":\"E\"")) {
+        TEST_FAILED("Markers and scratch regions not exported as async slices");
+    }
+
+    myrtx_set_current_context(NULL);
+    myrtx_context_destroy(ctx);
+    TEST_PASSED();
+}
+
+/* Test the Chrome trace JSON exporter */
+void test_trace_export_chrome(void) {
+    myrtx_context_t* ctx = myrtx_context_create(NULL);
+    if (!ctx || !myrtx_trace_enable(ctx, 0)) {
+        TEST_FAILED("Failed to set up traced context");
+    }
+
+    MYRTX_TRACE_SPAN_BEGIN(ctx, "handle \"quoted\"");
+    myrtx_trace_record(ctx, MYRTX_TRACE_ARENA_BLOCK, 4096, 8192);
+    MYRTX_TRACE_SPAN_END(ctx, "handle \"quoted\"");
+
+    FILE* f = tmpfile();
+    if (!f) {
+        TEST_FAILED("Failed to open temporary file");
+    }
+    if (!myrtx_trace_export_chrome(ctx, f)) {
+        TEST_FAILED("Export failed");
+    }
+
+    char buffer[2048];
+    rewind(f);
+    size_t len = fread(buffer, 1, sizeof(buffer) - 1, f);
+    buffer[len] = '\0';
+    fclose(f);
+
+    if (strncmp(buffer, "{\"traceEvents\":[", 16) != 0 ||
+        !strstr(buffer, "\"name\":\"handle \\\"quoted\\\"\",\"ph\":\"B\"") ||
+        !strstr(buffer, "\"ph\":\"E\"") ||
+        !strstr(buffer, "\"name\":\"arena_bytes\",\"ph\":\"C\"") ||
+        !strstr(buffer, "\"total\":8192")) {
+        TEST_FAILED("Exported JSON is missing expected records");
+    }
+
+    myrtx_context_destroy(ctx);
+    TEST_PASSED();
+}
+
+#else
+
+/* Test that tracing reports itself unavailable when compiled out */
+void test_trace_compiled_out(void) {
+    myrtx_context_t* ctx = myrtx_context_create(NULL);
+    if (!ctx) {
+        TEST_FAILED("Failed to create context");
+    }
+
+    if (myrtx_trace_enable(ctx, 0)) {
+        TEST_FAILED("Tracing enabled although compiled out");
+    }
+
+    MYRTX_TRACE_SPAN_BEGIN(ctx, "ignored");
+    MYRTX_TRACE_SPAN_END(ctx, "ignored");
+
+    if (ctx->trace != NULL || myrtx_trace_count(ctx) != 0) {
+        TEST_FAILED("Events recorded although tracing is compiled out");
+    }
+
+    myrtx_context_destroy(ctx);
+    TEST_PASSED();
+}
+
+#endif
+
+int main(void) {
+    printf("=== myrtx Trace Tests ===\n\n");
+
+#if defined(MYRTX_ENABLE_TRACING) && MYRTX_ENABLE_TRACING
+    test_trace_library_events();
+    test_trace_wraparound();
+    test_trace_markers_and_scratch();
+    test_trace_export_chrome();
+#else
+    test_trace_compiled_out();
+#endif
+
+    printf("\nAll trace tests successful!\n");
+    return 0;
+}